@@ -0,0 +1,149 @@
+#include "Precomp.h"
+
+#include <random>
+#include <span>
+
+#include <glm/gtx/transform.hpp>
+
+#include <Core/Vertex.h>
+#include <Engine/Animation/CPUSkinning.h>
+#include <Engine/Animation/SkinnedVerts.h>
+
+// Compares a straightforward glm implementation of linear blend skinning
+// against the SSE kernels of CPUSkinning. Args are vertex count and
+// influence count per vertex.
+
+constexpr static uint32_t kBoneCount = 64;
+
+static void Init(std::vector<SkinnedVertex>& aVerts, std::vector<glm::mat4>& aMatrices, size_t aVertCount)
+{
+	std::mt19937 generator(1234);
+	std::uniform_real_distribution<float> posDist(-1.f, 1.f);
+	std::uniform_int_distribution<uint32_t> boneDist(0, kBoneCount - 1);
+
+	aMatrices.resize(kBoneCount);
+	for (glm::mat4& matrix : aMatrices)
+	{
+		const glm::vec3 offset(posDist(generator), posDist(generator), posDist(generator));
+		const glm::vec3 axis = glm::normalize(glm::vec3(posDist(generator), posDist(generator), 1.f));
+		matrix = glm::translate(offset) * glm::rotate(posDist(generator), axis);
+	}
+
+	aVerts.resize(aVertCount);
+	for (SkinnedVertex& vert : aVerts)
+	{
+		vert.myPos = glm::vec3(posDist(generator), posDist(generator), posDist(generator));
+		vert.myNormal = glm::vec3(0, 1, 0);
+		vert.myUv = glm::vec2(0);
+		for (uint8_t i = 0; i < CPUSkinning::kMaxInfluences; i++)
+		{
+			vert.myBoneIndices[i] = boneDist(generator);
+		}
+		const glm::vec4 weights = glm::abs(glm::vec4(posDist(generator), posDist(generator), 
+			posDist(generator), posDist(generator))) + 0.01f;
+		vert.myBoneWeights = weights / (weights.x + weights.y + weights.z + weights.w);
+	}
+}
+
+static void ScalarSkinning(benchmark::State& aState)
+{
+	std::vector<SkinnedVertex> verts;
+	std::vector<glm::mat4> matrices;
+	Init(verts, matrices, aState.range(0));
+	const uint8_t influenceCount = static_cast<uint8_t>(aState.range(1));
+
+	std::vector<glm::vec3> positions(verts.size());
+	for (auto _ : aState)
+	{
+		for (size_t vertInd = 0; vertInd < verts.size(); vertInd++)
+		{
+			const SkinnedVertex& vert = verts[vertInd];
+			const glm::vec4 pos(vert.myPos, 1.f);
+			glm::vec4 result(0.f);
+			for (uint8_t i = 0; i < influenceCount; i++)
+			{
+				result += matrices[vert.myBoneIndices[i]] * pos * vert.myBoneWeights[i];
+			}
+			positions[vertInd] = result;
+		}
+		benchmark::DoNotOptimize(positions.data());
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * verts.size());
+}
+
+static void SimdSkinning(benchmark::State& aState)
+{
+	std::vector<SkinnedVertex> verts;
+	std::vector<glm::mat4> matrices;
+	Init(verts, matrices, aState.range(0));
+	const uint8_t influenceCount = static_cast<uint8_t>(aState.range(1));
+
+	std::vector<glm::vec3> positions(verts.size());
+	for (auto _ : aState)
+	{
+		CPUSkinning::SkinPositions(verts, matrices, positions, influenceCount);
+		benchmark::DoNotOptimize(positions.data());
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * verts.size());
+}
+
+static void ScalarAABB(benchmark::State& aState)
+{
+	std::vector<SkinnedVertex> verts;
+	std::vector<glm::mat4> matrices;
+	Init(verts, matrices, aState.range(0));
+	const uint8_t influenceCount = static_cast<uint8_t>(aState.range(1));
+
+	for (auto _ : aState)
+	{
+		glm::vec3 min(std::numeric_limits<float>::max());
+		glm::vec3 max(std::numeric_limits<float>::lowest());
+		for (const SkinnedVertex& vert : verts)
+		{
+			const glm::vec4 pos(vert.myPos, 1.f);
+			glm::vec4 result(0.f);
+			for (uint8_t i = 0; i < influenceCount; i++)
+			{
+				result += matrices[vert.myBoneIndices[i]] * pos * vert.myBoneWeights[i];
+			}
+			min = glm::min(min, glm::vec3(result));
+			max = glm::max(max, glm::vec3(result));
+		}
+		benchmark::DoNotOptimize(min);
+		benchmark::DoNotOptimize(max);
+	}
+	aState.SetItemsProcessed(aState.iterations() * verts.size());
+}
+
+static void SimdAABB(benchmark::State& aState)
+{
+	std::vector<SkinnedVertex> verts;
+	std::vector<glm::mat4> matrices;
+	Init(verts, matrices, aState.range(0));
+	const uint8_t influenceCount = static_cast<uint8_t>(aState.range(1));
+
+	for (auto _ : aState)
+	{
+		Shapes::AABB aabb = CPUSkinning::CalcAABB(verts, matrices, influenceCount);
+		benchmark::DoNotOptimize(aabb);
+	}
+	aState.SetItemsProcessed(aState.iterations() * verts.size());
+}
+
+static void SkinningArgs(benchmark::internal::Benchmark* aBench)
+{
+	for (int64_t vertCount : { 1'000, 10'000, 100'000 })
+	{
+		for (int64_t influenceCount = 1; influenceCount <= CPUSkinning::kMaxInfluences; influenceCount++)
+		{
+			aBench->Args({ vertCount, influenceCount });
+		}
+	}
+}
+
+BENCHMARK(ScalarSkinning)->Apply(SkinningArgs);
+BENCHMARK(SimdSkinning)->Apply(SkinningArgs);
+BENCHMARK(ScalarAABB)->Apply(SkinningArgs);
+BENCHMARK(SimdAABB)->Apply(SkinningArgs);
@@ -0,0 +1,151 @@
+#include "Precomp.h"
+
+#include <Engine/Components/TestComponent.h>
+
+// Compares the old component storage (heap allocated components, looked up
+// via dynamic_cast over a per-object list) against per-type ComponentPools
+// with a ComponentSet lookup. Every object has 3 components, and the
+// benchmarks look up (or iterate) the last one
+// Args: object count
+
+namespace
+{
+	using CompA = TestComponent<0>;
+	using CompB = TestComponent<1>;
+	using CompC = TestComponent<2>;
+
+	struct HeapObject
+	{
+		~HeapObject()
+		{
+			for (ComponentBase* comp : myComponents)
+			{
+				delete comp;
+			}
+		}
+
+		template<class TComp>
+		TComp* GetComponent() const
+		{
+			for (ComponentBase* comp : myComponents)
+			{
+				if (TComp* dynComp = dynamic_cast<TComp*>(comp))
+				{
+					return dynComp;
+				}
+			}
+			return nullptr;
+		}
+
+		std::vector<ComponentBase*> myComponents;
+	};
+
+	struct PooledObject
+	{
+		~PooledObject()
+		{
+			for (size_t i = 0; i < myComponents.GetCount(); i++)
+			{
+				ComponentPools::Free(myComponents.GetAt(i));
+			}
+		}
+
+		template<class TComp>
+		void AddComponent()
+		{
+			TComp& comp = ComponentPools::Get<TComp>().Allocate();
+			comp.Init(nullptr);
+			myComponents.Add(comp);
+		}
+
+		ComponentSet myComponents;
+	};
+
+	std::vector<std::unique_ptr<HeapObject>> CreateHeapObjects(size_t aCount)
+	{
+		std::vector<std::unique_ptr<HeapObject>> objects(aCount);
+		for (std::unique_ptr<HeapObject>& object : objects)
+		{
+			object = std::make_unique<HeapObject>();
+			object->myComponents.push_back(new CompA());
+			object->myComponents.push_back(new CompB());
+			object->myComponents.push_back(new CompC());
+		}
+		return objects;
+	}
+
+	std::vector<std::unique_ptr<PooledObject>> CreatePooledObjects(size_t aCount)
+	{
+		std::vector<std::unique_ptr<PooledObject>> objects(aCount);
+		for (std::unique_ptr<PooledObject>& object : objects)
+		{
+			object = std::make_unique<PooledObject>();
+			object->AddComponent<CompA>();
+			object->AddComponent<CompB>();
+			object->AddComponent<CompC>();
+		}
+		return objects;
+	}
+}
+
+static void HeapLookup(benchmark::State& aState)
+{
+	const auto objects = CreateHeapObjects(aState.range(0));
+	for (auto _ : aState)
+	{
+		for (const std::unique_ptr<HeapObject>& object : objects)
+		{
+			benchmark::DoNotOptimize(object->GetComponent<CompC>());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+static void PooledLookup(benchmark::State& aState)
+{
+	const auto objects = CreatePooledObjects(aState.range(0));
+	for (auto _ : aState)
+	{
+		for (const std::unique_ptr<PooledObject>& object : objects)
+		{
+			benchmark::DoNotOptimize(object->myComponents.Get<CompC>());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+// System-style update, going over every object to find its component
+static void HeapIterate(benchmark::State& aState)
+{
+	const auto objects = CreateHeapObjects(aState.range(0));
+	for (auto _ : aState)
+	{
+		for (const std::unique_ptr<HeapObject>& object : objects)
+		{
+			CompC* comp = object->GetComponent<CompC>();
+			comp->myPos += comp->myVelocity;
+		}
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+// Same update, but iterating the pages of the pool directly
+static void PooledIterate(benchmark::State& aState)
+{
+	const auto objects = CreatePooledObjects(aState.range(0));
+	ComponentPool<CompC>& pool = ComponentPools::Get<CompC>();
+	for (auto _ : aState)
+	{
+		pool.ForEach([](CompC& aComp) {
+			aComp.myPos += aComp.myVelocity;
+		});
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+
+BENCHMARK(HeapLookup)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(PooledLookup)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(HeapIterate)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(PooledIterate)->Arg(100'000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,164 @@
+#include "Precomp.h"
+
+#include <Core/GridOverlaps.h>
+#include <Core/Shapes.h>
+#include <Core/Transform.h>
+
+#include <random>
+
+// Compares StressTest's ball-vs-tank collision pass over a Grid. Serial
+// walks cells one by one and calculates bounds from transforms per pair,
+// like StressTest used to. ParallelCached gathers pairs via GridOverlaps,
+// same as StressTest does now, and resolves them serially in cell order.
+// Both produce the same hits; grid contents aren't modified between runs
+// Args: entity count
+
+namespace
+{
+	constexpr float kBallRadius = 0.2f;
+	constexpr glm::vec3 kTankHalfExtents{ 0.6f, 0.4f, 0.9f };
+
+	struct Entity
+	{
+		Transform myTransf;
+		uint32_t myIndex;
+		bool myTeam;
+		bool myIsTank;
+	};
+
+	Shapes::AABB CalcAABB(const Entity& anEntity)
+	{
+		const glm::mat4 matrix = anEntity.myTransf.GetMatrix();
+		const glm::vec3 center = matrix[3];
+		if (!anEntity.myIsTank)
+		{
+			return { center - kBallRadius, center + kBallRadius };
+		}
+
+		const glm::mat3 absRotation{
+			glm::abs(glm::vec3(matrix[0])),
+			glm::abs(glm::vec3(matrix[1])),
+			glm::abs(glm::vec3(matrix[2]))
+		};
+		const glm::vec3 extents = absRotation * kTankHalfExtents;
+		return { center - extents, center + extents };
+	}
+
+	struct Scene
+	{
+		Scene(size_t aCount)
+			: mySide(std::bit_ceil(std::max<uint32_t>(64, static_cast<uint32_t>(std::sqrt(aCount) * 2))))
+			, myGrid(glm::vec2{ mySide / -2.f }, static_cast<float>(mySide), 50)
+		{
+			std::mt19937 engine(0);
+			std::uniform_real_distribution<float> posDistr(mySide / -2.f, mySide / 2.f);
+			std::uniform_real_distribution<float> angleDistr(0, glm::two_pi<float>());
+			myEntities.resize(aCount);
+			for (uint32_t i = 0; i < aCount; i++)
+			{
+				Entity& entity = myEntities[i];
+				entity.myIndex = i;
+				entity.myTeam = i & 1;
+				// roughly the StressTest ratio of balls to tanks
+				entity.myIsTank = i % 3 == 0;
+				entity.myTransf.SetPos({ posDistr(engine), 0, posDistr(engine) });
+				entity.myTransf.SetRotation(glm::quat(glm::vec3{ 0, angleDistr(engine), 0 }));
+
+				const Shapes::AABB aabb = CalcAABB(entity);
+				myGrid.Add({ aabb.myMin.x, aabb.myMin.z }, { aabb.myMax.x, aabb.myMax.z }, &entity);
+			}
+		}
+
+		uint32_t mySide;
+		std::vector<Entity> myEntities;
+		Grid<Entity*> myGrid;
+	};
+}
+
+static void Serial(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Scene scene(count);
+	std::vector<uint8_t> isDead(count);
+	size_t hitCount = 0;
+	for (auto _ : aState)
+	{
+		std::ranges::fill(isDead, 0);
+		hitCount = 0;
+		scene.myGrid.ForEachCell([&](std::vector<Entity*>& aCell)
+		{
+			if (aCell.size() < 2)
+			{
+				return;
+			}
+			for (uint32_t ballInd = 0; ballInd < aCell.size() - 1; ballInd++)
+			{
+				const Entity& ball = *aCell[ballInd];
+				if (ball.myIsTank || isDead[ball.myIndex])
+				{
+					continue;
+				}
+				const Shapes::AABB ballAABB = CalcAABB(ball);
+				for (uint32_t tankInd = ballInd + 1; tankInd < aCell.size(); tankInd++)
+				{
+					const Entity& tank = *aCell[tankInd];
+					if (!tank.myIsTank || isDead[tank.myIndex] || ball.myTeam == tank.myTeam)
+					{
+						continue;
+					}
+					if (Shapes::Intersects(ballAABB, CalcAABB(tank)))
+					{
+						isDead[ball.myIndex] = 1;
+						isDead[tank.myIndex] = 1;
+						hitCount++;
+						break;
+					}
+				}
+			}
+		});
+	}
+	aState.counters["Hits"] = static_cast<double>(hitCount);
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(Serial)->Arg(10'000)->Arg(50'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+static void ParallelCached(benchmark::State& aState)
+{
+	using Overlaps = GridOverlaps<Entity*>;
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Scene scene(count);
+	std::vector<uint8_t> isDead(count);
+	Overlaps overlaps;
+	size_t hitCount = 0;
+	for (auto _ : aState)
+	{
+		const std::span<const Overlaps::Pair> pairs = overlaps.Gather(scene.myGrid,
+			[](Entity* anEntity, Overlaps::Bounds& aBounds)
+			{
+				const Shapes::AABB aabb = CalcAABB(*anEntity);
+				aBounds.myMin = aabb.myMin;
+				aBounds.myMax = aabb.myMax;
+				aBounds.myGroup = anEntity->myTeam;
+				return anEntity->myIsTank ? Overlaps::Kind::Second : Overlaps::Kind::First;
+			}
+		);
+
+		std::ranges::fill(isDead, 0);
+		hitCount = 0;
+		for (const Overlaps::Pair& pair : pairs)
+		{
+			const uint32_t ball = pair.myFirst.myItem->myIndex;
+			const uint32_t tank = pair.mySecond.myItem->myIndex;
+			if (isDead[ball] || isDead[tank])
+			{
+				continue;
+			}
+			isDead[ball] = 1;
+			isDead[tank] = 1;
+			hitCount++;
+		}
+	}
+	aState.counters["Hits"] = static_cast<double>(hitCount);
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(ParallelCached)->Arg(10'000)->Arg(50'000)->Arg(100'000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,162 @@
+#include "Precomp.h"
+
+#include <Core/Grid.h>
+
+#include <random>
+
+// Compares native nearest-neighbour and radius queries of Grid against
+// emulating them via ForEachCell over a box around the query point, then
+// filtering by distance (and sorting, for nearest). Items can span cells,
+// so box emulation also has to drop duplicates
+// Args: item count, nearest count for Nearest benchmarks
+
+namespace
+{
+	constexpr float kGridSize = 1024;
+	constexpr uint16_t kCellCount = 64;
+	constexpr float kItemSize = 2.f;
+	constexpr float kRadius = 16.f;
+	constexpr uint32_t kQueryCount = 1024;
+
+	const glm::vec2 kGridMin{ kGridSize / -2.f };
+
+	struct Setup
+	{
+		Setup(size_t anItemCount)
+			: myGrid(kGridMin, kGridSize, kCellCount)
+		{
+			std::mt19937 engine(12345);
+			std::uniform_real_distribution<float> posDistrib(kGridSize / -2.f, kGridSize / 2.f);
+
+			myPositions.resize(anItemCount);
+			for (uint32_t i = 0; i < anItemCount; i++)
+			{
+				myPositions[i] = { posDistrib(engine), posDistrib(engine) };
+				myGrid.Add(myPositions[i] - kItemSize / 2, myPositions[i] + kItemSize / 2, i);
+			}
+
+			myQueries.resize(kQueryCount);
+			for (glm::vec2& query : myQueries)
+			{
+				query = { posDistrib(engine), posDistrib(engine) };
+			}
+		}
+
+		glm::vec2 GetPos(uint32_t anItem) const { return myPositions[anItem]; }
+
+		std::vector<glm::vec2> myPositions;
+		std::vector<glm::vec2> myQueries;
+		Grid<uint32_t> myGrid;
+	};
+
+	float GetDistanceSq(glm::vec2 aLeft, glm::vec2 aRight)
+	{
+		const glm::vec2 delta = aLeft - aRight;
+		return glm::dot(delta, delta);
+	}
+
+	bool IsCloser(const Grid<uint32_t>::Nearest& aLeft, const Grid<uint32_t>::Nearest& aRight)
+	{
+		return aLeft.myDistanceSq < aRight.myDistanceSq;
+	}
+}
+
+static void GridNearestBox(benchmark::State& aState)
+{
+	Setup setup(aState.range(0));
+	const size_t nearestCount = aState.range(1);
+	std::vector<Grid<uint32_t>::Nearest> found;
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			found.clear();
+			setup.myGrid.ForEachCell(query - kRadius, query + kRadius, [&](const std::vector<uint32_t>& aCell)
+			{
+				for (uint32_t item : aCell)
+				{
+					found.push_back({ item, GetDistanceSq(setup.GetPos(item), query) });
+				}
+			});
+			std::sort(found.begin(), found.end(), [](const auto& aLeft, const auto& aRight)
+			{
+				return IsCloser(aLeft, aRight) 
+					|| (aLeft.myDistanceSq == aRight.myDistanceSq && aLeft.myItem < aRight.myItem);
+			});
+			found.erase(std::unique(found.begin(), found.end(), [](const auto& aLeft, const auto& aRight)
+			{
+				return aLeft.myItem == aRight.myItem;
+			}), found.end());
+			found.resize(std::min(nearestCount, found.size()));
+			benchmark::DoNotOptimize(found.data());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(GridNearestBox)->Args({ 10'000, 8 })->Args({ 100'000, 8 })->Args({ 100'000, 32 });
+
+static void GridNearest(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	std::vector<Grid<uint32_t>::Nearest> found(aState.range(1));
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			const uint32_t count = setup.myGrid.FindNearest(query, found, [&](uint32_t anItem)
+			{
+				return setup.GetPos(anItem);
+			});
+			benchmark::DoNotOptimize(count);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(GridNearest)->Args({ 10'000, 8 })->Args({ 100'000, 8 })->Args({ 100'000, 32 });
+
+static void GridRadiusBox(benchmark::State& aState)
+{
+	Setup setup(aState.range(0));
+	std::vector<uint32_t> found;
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			found.clear();
+			setup.myGrid.ForEachCell(query - kRadius, query + kRadius, [&](const std::vector<uint32_t>& aCell)
+			{
+				for (uint32_t item : aCell)
+				{
+					if (GetDistanceSq(setup.GetPos(item), query) <= kRadius * kRadius)
+					{
+						found.push_back(item);
+					}
+				}
+			});
+			std::sort(found.begin(), found.end());
+			found.erase(std::unique(found.begin(), found.end()), found.end());
+			benchmark::DoNotOptimize(found.data());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(GridRadiusBox)->Arg(10'000)->Arg(100'000);
+
+static void GridRadius(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	std::vector<uint32_t> found(setup.myPositions.size());
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			const uint32_t count = setup.myGrid.FindInRadius(query, kRadius, found, [&](uint32_t anItem)
+			{
+				return setup.GetPos(anItem);
+			});
+			benchmark::DoNotOptimize(count);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(GridRadius)->Arg(10'000)->Arg(100'000);
@@ -0,0 +1,151 @@
+#include "Precomp.h"
+
+#include <Core/Grid.h>
+#include <Core/FlatGrid.h>
+
+#include <random>
+
+// Compares keeping items in a Grid up to date when all of them move every
+// frame: moving them one by one through Grid::Move, against rebuilding a
+// FlatGrid from scratch, serially and in parallel. Items move by about
+// as much as StressTest's tanks do in a frame. Iterate benchmarks walk
+// every cell afterwards, to show the cost of reading the results
+// Args: item count
+
+namespace
+{
+	constexpr float kGridSize = 512;
+	constexpr uint16_t kCellCount = 50;
+	constexpr float kItemSize = 1.f;
+	constexpr float kMoveDistance = 0.1f;
+
+	// Positions of items in 2 consecutive frames - benchmarks flip between them
+	struct Frames
+	{
+		Frames(size_t aCount)
+		{
+			std::mt19937 engine(0);
+			std::uniform_real_distribution<float> posDistr(kGridSize / -2.f, kGridSize / 2.f - kItemSize);
+			std::uniform_real_distribution<float> moveDistr(-kMoveDistance, kMoveDistance);
+			for (std::vector<FlatGrid<uint32_t>::Entry>& frame : myFrames)
+			{
+				frame.resize(aCount);
+			}
+			for (uint32_t i = 0; i < aCount; i++)
+			{
+				const glm::vec2 pos{ posDistr(engine), posDistr(engine) };
+				const glm::vec2 movedPos = pos + glm::vec2{ moveDistr(engine), moveDistr(engine) };
+				myFrames[0][i] = { pos, pos + kItemSize, i };
+				myFrames[1][i] = { movedPos, movedPos + kItemSize, i };
+			}
+		}
+
+		std::vector<FlatGrid<uint32_t>::Entry> myFrames[2];
+	};
+
+	const glm::vec2 kGridMin{ kGridSize / -2.f };
+}
+
+static void IncrementalMoves(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Frames frames(count);
+	Grid<uint32_t> grid(kGridMin, kGridSize, kCellCount);
+	for (const FlatGrid<uint32_t>::Entry& entry : frames.myFrames[0])
+	{
+		grid.Add(entry.myMin, entry.myMax, entry.myItem);
+	}
+
+	uint8_t frame = 0;
+	for (auto _ : aState)
+	{
+		const std::vector<FlatGrid<uint32_t>::Entry>& from = frames.myFrames[frame];
+		const std::vector<FlatGrid<uint32_t>::Entry>& to = frames.myFrames[frame ^ 1];
+		for (size_t i = 0; i < count; i++)
+		{
+			grid.Move(from[i].myMin, from[i].myMax, to[i].myMin, to[i].myMax, to[i].myItem);
+		}
+		frame ^= 1;
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(IncrementalMoves)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+static void FlatRebuild(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Frames frames(count);
+	FlatGrid<uint32_t> grid(kGridMin, kGridSize, kCellCount);
+
+	uint8_t frame = 0;
+	for (auto _ : aState)
+	{
+		grid.Rebuild(frames.myFrames[frame]);
+		frame ^= 1;
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(FlatRebuild)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+
+static void FlatParallelRebuild(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Frames frames(count);
+	FlatGrid<uint32_t> grid(kGridMin, kGridSize, kCellCount);
+
+	uint8_t frame = 0;
+	for (auto _ : aState)
+	{
+		grid.ParallelRebuild(frames.myFrames[frame]);
+		frame ^= 1;
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(FlatParallelRebuild)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void GridIterate(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Frames frames(count);
+	Grid<uint32_t> grid(kGridMin, kGridSize, kCellCount);
+	for (const FlatGrid<uint32_t>::Entry& entry : frames.myFrames[0])
+	{
+		grid.Add(entry.myMin, entry.myMax, entry.myItem);
+	}
+
+	for (auto _ : aState)
+	{
+		uint64_t sum = 0;
+		grid.ForEachCell([&](std::vector<uint32_t>& aCell) {
+			for (uint32_t item : aCell)
+			{
+				sum += item;
+			}
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(GridIterate)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+
+static void FlatIterate(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	Frames frames(count);
+	FlatGrid<uint32_t> grid(kGridMin, kGridSize, kCellCount);
+	grid.Rebuild(frames.myFrames[0]);
+
+	for (auto _ : aState)
+	{
+		uint64_t sum = 0;
+		grid.ForEachCell([&](std::span<const uint32_t> aCell) {
+			for (uint32_t item : aCell)
+			{
+				sum += item;
+			}
+		});
+		benchmark::DoNotOptimize(sum);
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+BENCHMARK(FlatIterate)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,90 @@
+#include "Precomp.h"
+
+#include <Core/RefCounted.h>
+
+// Compares the cost of taking a handle to a resource per object, like
+// render passes do every frame. Shared variants have every thread pointing
+// at the same resource, so atomic ref counting contends on one cache line.
+// Local variants give each thread its own resource, which is the only valid
+// setup for the ThreadConfined policy
+// Args: none, thread count is part of the benchmark name
+
+namespace
+{
+	constexpr size_t kCopiesPerIter = 1024;
+
+	struct Resource : RefCounted
+	{
+		explicit Resource(RefPolicy aPolicy = RefPolicy::Atomic)
+			: RefCounted(aPolicy)
+		{
+		}
+		uint32_t myState = 1;
+	};
+
+	Handle<Resource> ourSharedResource;
+
+	void SetupShared(const benchmark::State& aState)
+	{
+		if (aState.thread_index() == 0)
+		{
+			ourSharedResource = new Resource();
+		}
+	}
+
+	void TeardownShared(const benchmark::State& aState)
+	{
+		if (aState.thread_index() == 0)
+		{
+			ourSharedResource = Handle<Resource>();
+		}
+	}
+
+	template<class THandle>
+	void CopyHandles(benchmark::State& aState, const Handle<Resource>& aResource)
+	{
+		uint32_t validCount = 0;
+		for (auto _ : aState)
+		{
+			for (size_t i = 0; i < kCopiesPerIter; i++)
+			{
+				THandle copy = aResource;
+				benchmark::DoNotOptimize(copy);
+				validCount += copy->myState;
+			}
+		}
+		benchmark::DoNotOptimize(validCount);
+		aState.SetItemsProcessed(aState.iterations() * kCopiesPerIter);
+	}
+}
+
+static void SharedAtomicHandle(benchmark::State& aState)
+{
+	SetupShared(aState);
+	CopyHandles<Handle<Resource>>(aState, ourSharedResource);
+	TeardownShared(aState);
+}
+
+static void SharedBorrowedHandle(benchmark::State& aState)
+{
+	SetupShared(aState);
+	CopyHandles<BorrowedHandle<Resource>>(aState, ourSharedResource);
+	TeardownShared(aState);
+}
+
+static void LocalAtomicHandle(benchmark::State& aState)
+{
+	Handle<Resource> resource = new Resource(RefCounted::RefPolicy::Atomic);
+	CopyHandles<Handle<Resource>>(aState, resource);
+}
+
+static void LocalConfinedHandle(benchmark::State& aState)
+{
+	Handle<Resource> resource = new Resource(RefCounted::RefPolicy::ThreadConfined);
+	CopyHandles<Handle<Resource>>(aState, resource);
+}
+
+BENCHMARK(SharedAtomicHandle)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(SharedBorrowedHandle)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(LocalAtomicHandle)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(LocalConfinedHandle)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,180 @@
+#include "Precomp.h"
+
+#include <Core/HexFlowField.h>
+
+#include <random>
+
+// Compares moving units towards targets over a hex grid with random costs
+// and 20% walls. PerUnitSearch runs a Dijkstra search for every unit, like
+// HexSolver used to. Compute and ParallelCompute build a HexFlowField from
+// all targets at once, and FlowFieldSteps has every unit walk the field by
+// looking up its next hex until it reaches a target
+// Args: grid size, target count
+
+namespace
+{
+	constexpr uint32_t kUnitCount = 10'000;
+	// per-unit searches are too slow to run for all of the units
+	constexpr uint32_t kSearchUnitCount = 16;
+
+	struct Setup
+	{
+		Setup(int aSize, uint32_t aTargetCount)
+			: myField({ aSize, aSize })
+		{
+			std::mt19937 engine(12345);
+			std::uniform_int_distribution<int> posDistrib(0, aSize - 1);
+			std::uniform_int_distribution<int> costDistrib(1, 4);
+			std::uniform_real_distribution<float> wallDistrib(0.f, 1.f);
+			for (int y = 0; y < aSize; y++)
+			{
+				for (int x = 0; x < aSize; x++)
+				{
+					const bool isWall = wallDistrib(engine) < 0.2f;
+					myField.SetCost({ x, y }, isWall ? HexFlowField::kWall : static_cast<uint8_t>(costDistrib(engine)));
+				}
+			}
+
+			auto GetFreeHex = [&]
+			{
+				glm::ivec2 hex;
+				do
+				{
+					hex = { posDistrib(engine), posDistrib(engine) };
+				} while (myField.GetCost(hex) == HexFlowField::kWall);
+				return hex;
+			};
+			myTargets.resize(aTargetCount);
+			for (glm::ivec2& target : myTargets)
+			{
+				target = GetFreeHex();
+			}
+			myUnits.resize(kUnitCount);
+			for (glm::ivec2& unit : myUnits)
+			{
+				unit = GetFreeHex();
+			}
+		}
+
+		HexFlowField myField;
+		std::vector<glm::ivec2> myTargets;
+		std::vector<glm::ivec2> myUnits;
+	};
+
+	// Dijkstra from a unit until the first target is reached,
+	// using the same costs as HexFlowField
+	uint32_t SearchPath(const HexFlowField& aField, glm::ivec2 aStart, std::span<const glm::ivec2> aTargets,
+		std::vector<uint32_t>& aCosts)
+	{
+		using Entry = std::pair<uint32_t, glm::ivec2>;
+		constexpr auto IsWorse = [](const Entry& aLeft, const Entry& aRight)
+		{
+			return aLeft.first > aRight.first;
+		};
+
+		const glm::ivec2 size = aField.GetSize();
+		std::ranges::fill(aCosts, HexFlowField::kUnreachable);
+		std::vector<Entry> open;
+		aCosts[aStart.y * size.x + aStart.x] = 0;
+		open.push_back({ 0, aStart });
+		while (!open.empty())
+		{
+			std::pop_heap(open.begin(), open.end(), IsWorse);
+			const auto [cost, hex] = open.back();
+			open.pop_back();
+			if (cost != aCosts[hex.y * size.x + hex.x])
+			{
+				continue;
+			}
+			if (std::ranges::find(aTargets, hex) != aTargets.end())
+			{
+				return cost;
+			}
+
+			const uint32_t newCost = cost + aField.GetCost(hex);
+			for (uint8_t i = 0; i < HexFlowField::kDirectionCount; i++)
+			{
+				const glm::ivec2 neighbor = HexFlowField::GetNeighbor(hex, i);
+				if (!aField.IsValid(neighbor) || aField.GetCost(neighbor) == HexFlowField::kWall)
+				{
+					continue;
+				}
+
+				uint32_t& neighborCost = aCosts[neighbor.y * size.x + neighbor.x];
+				if (newCost < neighborCost)
+				{
+					neighborCost = newCost;
+					open.push_back({ newCost, neighbor });
+					std::push_heap(open.begin(), open.end(), IsWorse);
+				}
+			}
+		}
+		return HexFlowField::kUnreachable;
+	}
+}
+
+static void PerUnitSearch(benchmark::State& aState)
+{
+	const Setup setup(static_cast<int>(aState.range(0)), static_cast<uint32_t>(aState.range(1)));
+	std::vector<uint32_t> costs(setup.myField.GetSize().x * setup.myField.GetSize().y);
+	for (auto _ : aState)
+	{
+		uint64_t totalCost = 0;
+		for (uint32_t i = 0; i < kSearchUnitCount; i++)
+		{
+			totalCost += SearchPath(setup.myField, setup.myUnits[i], setup.myTargets, costs);
+		}
+		benchmark::DoNotOptimize(totalCost);
+	}
+	aState.SetItemsProcessed(aState.iterations() * kSearchUnitCount);
+}
+BENCHMARK(PerUnitSearch)->Args({ 1024, 1 })->Args({ 1024, 16 })->Unit(benchmark::kMillisecond);
+
+static void Compute(benchmark::State& aState)
+{
+	Setup setup(static_cast<int>(aState.range(0)), static_cast<uint32_t>(aState.range(1)));
+	for (auto _ : aState)
+	{
+		setup.myField.Compute(setup.myTargets);
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0) * aState.range(0));
+}
+BENCHMARK(Compute)->Args({ 1024, 1 })->Args({ 1024, 16 })->Unit(benchmark::kMillisecond);
+
+static void ParallelCompute(benchmark::State& aState)
+{
+	Setup setup(static_cast<int>(aState.range(0)), static_cast<uint32_t>(aState.range(1)));
+	for (auto _ : aState)
+	{
+		setup.myField.ParallelCompute(setup.myTargets);
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0) * aState.range(0));
+}
+BENCHMARK(ParallelCompute)->Args({ 1024, 1 })->Args({ 1024, 16 })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void FlowFieldSteps(benchmark::State& aState)
+{
+	Setup setup(static_cast<int>(aState.range(0)), static_cast<uint32_t>(aState.range(1)));
+	setup.myField.Compute(setup.myTargets);
+	std::vector<glm::ivec2> units;
+	uint64_t stepCount = 0;
+	for (auto _ : aState)
+	{
+		units = setup.myUnits;
+		for (glm::ivec2& unit : units)
+		{
+			for (glm::ivec2 next = setup.myField.GetNextHex(unit); next != unit; next = setup.myField.GetNextHex(unit))
+			{
+				unit = next;
+				stepCount++;
+			}
+		}
+		benchmark::DoNotOptimize(units.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * kUnitCount);
+	aState.counters["steps"] = benchmark::Counter(static_cast<double>(stepCount),
+		benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(FlowFieldSteps)->Args({ 1024, 1 })->Args({ 1024, 16 })->Unit(benchmark::kMillisecond);
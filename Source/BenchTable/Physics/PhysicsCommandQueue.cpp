@@ -0,0 +1,174 @@
+#include "Precomp.h"
+
+#include <cstring>
+#include <span>
+
+#include <Core/CmdBuffer.h>
+#include <Physics/PhysicsCommands.h>
+
+// Compares the old PhysicsWorld command queue (heap allocated polymorphic
+// commands in a locked vector) against the per-thread CmdBuffer one.
+// Commands get enqueued from multiple threads, then resolved on one
+// Args: command count
+
+namespace Legacy
+{
+	struct PhysicsCommand
+	{
+		enum Type
+		{
+			AddBody,
+			RemoveBody,
+			DeleteBody,
+			ChangeBody
+		};
+
+		explicit PhysicsCommand(Type aType)
+			: myType(aType)
+		{
+		}
+		virtual ~PhysicsCommand() = default;
+
+		Type myType;
+	};
+
+	struct PhysicsCommandEntity : PhysicsCommand
+	{
+		PhysicsCommandEntity(Type aType, PhysicsEntity* anEntity)
+			: PhysicsCommand(aType)
+			, myEntity(anEntity)
+		{
+		}
+
+		PhysicsEntity* myEntity;
+	};
+
+	struct Queue
+	{
+		tbb::spin_mutex myLock;
+		std::vector<const PhysicsCommand*> myCommands;
+	};
+}
+
+struct CommandSlot
+{
+	tbb::spin_mutex myLock;
+	CmdBuffer myWriteBuffer{ 4 * 1024 };
+	CmdBuffer myReadBuffer{ 4 * 1024 };
+};
+
+static PhysicsEntity* GetFakeEntity(size_t anIndex)
+{
+	return reinterpret_cast<PhysicsEntity*>((anIndex + 1) * 64);
+}
+
+static void LegacyQueue(benchmark::State& aState)
+{
+	const size_t cmdCount = aState.range(0);
+	Legacy::Queue queue;
+	queue.myCommands.reserve(200);
+	for (auto _ : aState)
+	{
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, cmdCount),
+			[&](const tbb::blocked_range<size_t>& aRange) {
+			for (size_t i = aRange.begin(); i < aRange.end(); i++)
+			{
+				const Legacy::PhysicsCommand::Type type = i % 2
+					? Legacy::PhysicsCommand::RemoveBody
+					: Legacy::PhysicsCommand::AddBody;
+				const Legacy::PhysicsCommand* cmd = new Legacy::PhysicsCommandEntity(type, GetFakeEntity(i));
+				tbb::spin_mutex::scoped_lock lock(queue.myLock);
+				queue.myCommands.push_back(cmd);
+			}
+		});
+
+		size_t checksum = 0;
+		for (const Legacy::PhysicsCommand* cmd : queue.myCommands)
+		{
+			switch (cmd->myType)
+			{
+			case Legacy::PhysicsCommand::AddBody:
+				checksum += reinterpret_cast<size_t>(static_cast<const Legacy::PhysicsCommandEntity*>(cmd)->myEntity);
+				break;
+			case Legacy::PhysicsCommand::RemoveBody:
+				checksum -= reinterpret_cast<size_t>(static_cast<const Legacy::PhysicsCommandEntity*>(cmd)->myEntity);
+				break;
+			default:
+				break;
+			}
+			delete cmd;
+		}
+		queue.myCommands.clear();
+		benchmark::DoNotOptimize(checksum);
+	}
+	aState.SetItemsProcessed(aState.iterations() * cmdCount);
+}
+
+template<class T>
+static T GetCommand(std::span<const std::byte> aBytes, uint32_t& anIndex)
+{
+	T cmd;
+	std::memcpy(&cmd, &aBytes[anIndex], sizeof(T));
+	anIndex += sizeof(T);
+	return cmd;
+}
+
+static void CmdBufferQueue(benchmark::State& aState)
+{
+	const size_t cmdCount = aState.range(0);
+	tbb::enumerable_thread_specific<CommandSlot> slots;
+	for (auto _ : aState)
+	{
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, cmdCount),
+			[&](const tbb::blocked_range<size_t>& aRange) {
+			CommandSlot& slot = slots.local();
+			for (size_t i = aRange.begin(); i < aRange.end(); i++)
+			{
+				tbb::spin_mutex::scoped_lock lock(slot.myLock);
+				if (i % 2)
+				{
+					PhysicsCommandRemoveBody& cmd = slot.myWriteBuffer.Write<PhysicsCommandRemoveBody>();
+					cmd.myEntity = GetFakeEntity(i);
+				}
+				else
+				{
+					PhysicsCommandAddBody& cmd = slot.myWriteBuffer.Write<PhysicsCommandAddBody>();
+					cmd.myEntity = GetFakeEntity(i);
+				}
+			}
+		});
+
+		size_t checksum = 0;
+		for (CommandSlot& slot : slots)
+		{
+			{
+				tbb::spin_mutex::scoped_lock lock(slot.myLock);
+				std::swap(slot.myWriteBuffer, slot.myReadBuffer);
+			}
+
+			const std::span<const std::byte> bytes = slot.myReadBuffer.GetBuffer();
+			uint32_t index = 0;
+			while (index < bytes.size())
+			{
+				const uint8_t cmdId = static_cast<uint8_t>(bytes[index++]);
+				switch (cmdId)
+				{
+				case PhysicsCommandAddBody::kId:
+					checksum += reinterpret_cast<size_t>(GetCommand<PhysicsCommandAddBody>(bytes, index).myEntity);
+					break;
+				case PhysicsCommandRemoveBody::kId:
+					checksum -= reinterpret_cast<size_t>(GetCommand<PhysicsCommandRemoveBody>(bytes, index).myEntity);
+					break;
+				default:
+					break;
+				}
+			}
+			slot.myReadBuffer.Clear();
+		}
+		benchmark::DoNotOptimize(checksum);
+	}
+	aState.SetItemsProcessed(aState.iterations() * cmdCount);
+}
+
+BENCHMARK(LegacyQueue)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(CmdBufferQueue)->Arg(1'000)->Arg(10'000)->Arg(100'000);
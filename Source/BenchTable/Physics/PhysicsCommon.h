@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/PhysicsEntity.h>
+#include <Physics/PhysicsShapes.h>
+
+#include <glm/gtx/transform.hpp>
+
+// A world of dynamic boxes, stacked in columns so that there's a steady
+// amount of contacts and islands to solve, instead of just free-falling bodies
+constexpr static uint32_t kStackHeight = 4;
+
+struct PhysicsScene
+{
+	std::unique_ptr<PhysicsWorld> myWorld;
+	std::vector<std::unique_ptr<PhysicsEntity>> myEntities;
+
+	PhysicsScene(uint32_t aBodyCount, PhysicsWorld::Threading aThreading)
+	{
+		myWorld = std::make_unique<PhysicsWorld>(aThreading);
+
+		const uint32_t columnCount = aBodyCount / kStackHeight;
+		const uint32_t side = static_cast<uint32_t>(glm::ceil(glm::sqrt(static_cast<float>(columnCount))));
+		constexpr float kSpacing = 1.5f;
+		const float halfSize = side * kSpacing / 2.f;
+
+		myEntities.reserve(aBodyCount + 1);
+		{
+			PhysicsEntity::InitParams params;
+			params.myType = PhysicsEntity::Type::Static;
+			params.myShape = std::make_shared<PhysicsShapeBox>(glm::vec3(halfSize + 1.f, 0.5f, halfSize + 1.f));
+			params.myTranfs = glm::translate(glm::vec3(0, -0.5f, 0));
+			myEntities.push_back(std::make_unique<PhysicsEntity>(params));
+		}
+
+		std::shared_ptr<PhysicsShapeBase> boxShape = std::make_shared<PhysicsShapeBox>(glm::vec3(0.5f));
+		for (uint32_t i = 0; i < aBodyCount; i++)
+		{
+			const uint32_t column = i / kStackHeight;
+			const uint32_t level = i % kStackHeight;
+			const glm::vec3 pos(
+				(column % side) * kSpacing - halfSize,
+				0.55f + level * 1.05f,
+				(column / side) * kSpacing - halfSize
+			);
+
+			PhysicsEntity::InitParams params;
+			params.myType = PhysicsEntity::Type::Dynamic;
+			params.myShape = boxShape;
+			params.myTranfs = glm::translate(pos);
+			params.myMass = 1.f;
+			myEntities.push_back(std::make_unique<PhysicsEntity>(params));
+		}
+
+		for (std::unique_ptr<PhysicsEntity>& entity : myEntities)
+		{
+			myWorld->AddEntity(entity.get());
+		}
+		// resolves pending additions
+		myWorld->Simulate(0);
+	}
+
+	~PhysicsScene()
+	{
+		// world marks all entities as NotInWorld, so they're safe to delete after
+		myWorld.reset();
+		myEntities.clear();
+	}
+};
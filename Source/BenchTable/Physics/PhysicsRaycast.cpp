@@ -0,0 +1,114 @@
+#include "Precomp.h"
+
+#include <memory>
+#include <random>
+#include <span>
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/PhysicsEntity.h>
+#include <Physics/PhysicsShapes.h>
+
+#include <glm/gtx/transform.hpp>
+
+// Compares firing rays one by one through PhysicsWorld::RaycastClosest
+// against the batched version, on a static scene of scattered boxes
+// Args: ray count
+
+struct StaticScene
+{
+	std::unique_ptr<PhysicsWorld> myWorld;
+	std::vector<std::unique_ptr<PhysicsEntity>> myEntities;
+	std::vector<PhysicsWorld::RayQuery> myRays;
+
+	StaticScene(size_t aRayCount)
+	{
+		constexpr uint32_t kBoxCount = 10'000;
+		constexpr float kSceneSize = 500.f;
+
+		myWorld = std::make_unique<PhysicsWorld>();
+
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> posDist(-kSceneSize / 2.f, kSceneSize / 2.f);
+		std::uniform_real_distribution<float> sizeDist(0.5f, 4.f);
+
+		myEntities.reserve(kBoxCount);
+		for (uint32_t i = 0; i < kBoxCount; i++)
+		{
+			PhysicsEntity::InitParams params;
+			params.myType = PhysicsEntity::Type::Static;
+			params.myShape = std::make_shared<PhysicsShapeBox>(glm::vec3(sizeDist(generator)));
+			params.myTranfs = glm::translate(glm::vec3(posDist(generator), posDist(generator) / 10.f, posDist(generator)));
+			myEntities.push_back(std::make_unique<PhysicsEntity>(params));
+			myWorld->AddEntity(myEntities.back().get());
+		}
+		// resolves pending additions and updates the broadphase
+		myWorld->Simulate(0);
+
+		myRays.resize(aRayCount);
+		std::uniform_real_distribution<float> lengthDist(10.f, 100.f);
+		for (PhysicsWorld::RayQuery& ray : myRays)
+		{
+			ray.myFrom = glm::vec3(posDist(generator), posDist(generator) / 10.f, posDist(generator));
+			const glm::vec3 dir = glm::normalize(glm::vec3(posDist(generator), posDist(generator), posDist(generator)));
+			ray.myTo = ray.myFrom + dir * lengthDist(generator);
+		}
+	}
+
+	~StaticScene()
+	{
+		myWorld.reset();
+		myEntities.clear();
+	}
+};
+
+static void RaycastSingle(benchmark::State& aState)
+{
+	StaticScene scene(aState.range(0));
+	for (auto _ : aState)
+	{
+		size_t hitCount = 0;
+		for (const PhysicsWorld::RayQuery& ray : scene.myRays)
+		{
+			PhysicsEntity* hitEntity = nullptr;
+			hitCount += scene.myWorld->RaycastClosest(ray.myFrom, ray.myTo, hitEntity);
+		}
+		benchmark::DoNotOptimize(hitCount);
+	}
+	aState.SetItemsProcessed(aState.iterations() * scene.myRays.size());
+}
+
+static void RaycastBatched(benchmark::State& aState)
+{
+	StaticScene scene(aState.range(0));
+	std::vector<PhysicsWorld::QueryHit> hits(scene.myRays.size());
+	for (auto _ : aState)
+	{
+		scene.myWorld->RaycastClosest(scene.myRays, hits);
+		benchmark::DoNotOptimize(hits.data());
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * scene.myRays.size());
+}
+
+static void SweepBatched(benchmark::State& aState)
+{
+	StaticScene scene(aState.range(0));
+	std::vector<PhysicsWorld::SweepQuery> sweeps;
+	sweeps.reserve(scene.myRays.size());
+	for (const PhysicsWorld::RayQuery& ray : scene.myRays)
+	{
+		sweeps.push_back({ ray.myFrom, ray.myTo, 0.25f });
+	}
+	std::vector<PhysicsWorld::QueryHit> hits(sweeps.size());
+	for (auto _ : aState)
+	{
+		scene.myWorld->SweepClosest(sweeps, hits);
+		benchmark::DoNotOptimize(hits.data());
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * sweeps.size());
+}
+
+BENCHMARK(RaycastSingle)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(RaycastBatched)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(SweepBatched)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,37 @@
+#include "Precomp.h"
+
+#include "Physics/PhysicsCommon.h"
+#include <Physics/PhysicsSnapshot.h>
+
+// Measures cost of capturing and restoring the full dynamic state
+// of the world, to make sure it's cheap enough to do every frame
+// Args: body count
+
+static void TakeSnapshot(benchmark::State& aState)
+{
+	PhysicsScene scene(static_cast<uint32_t>(aState.range(0)), PhysicsWorld::Threading::Single);
+	PhysicsSnapshot snapshot;
+	for (auto _ : aState)
+	{
+		scene.myWorld->TakeSnapshot(snapshot);
+		benchmark::DoNotOptimize(snapshot.GetBuffer().data());
+		benchmark::ClobberMemory();
+	}
+	aState.SetBytesProcessed(aState.iterations() * snapshot.GetBuffer().size());
+}
+
+static void RestoreSnapshot(benchmark::State& aState)
+{
+	PhysicsScene scene(static_cast<uint32_t>(aState.range(0)), PhysicsWorld::Threading::Single);
+	PhysicsSnapshot snapshot;
+	scene.myWorld->TakeSnapshot(snapshot);
+	for (auto _ : aState)
+	{
+		scene.myWorld->RestoreSnapshot(snapshot);
+		benchmark::ClobberMemory();
+	}
+	aState.SetBytesProcessed(aState.iterations() * snapshot.GetBuffer().size());
+}
+
+BENCHMARK(TakeSnapshot)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(RestoreSnapshot)->Arg(1'000)->Arg(10'000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,27 @@
+#include "Precomp.h"
+
+#include "Physics/PhysicsCommon.h"
+
+// Steps a world of stacked boxes with a single and multi-threaded solver
+// Args: body count, threading (0 - Single, 1 - Multi)
+
+constexpr static float kStepLength = 1.f / 30.f;
+
+static void PhysicsStep(benchmark::State& aState)
+{
+	const PhysicsWorld::Threading threading = aState.range(1) 
+		? PhysicsWorld::Threading::Multi 
+		: PhysicsWorld::Threading::Single;
+	PhysicsScene scene(static_cast<uint32_t>(aState.range(0)), threading);
+	for (auto _ : aState)
+	{
+		scene.myWorld->Simulate(kStepLength);
+	}
+	aState.SetItemsProcessed(aState.iterations() * aState.range(0));
+}
+// fixed amount of iterations to make sure both configurations
+// simulate the same timeline (falling, stacking, settling)
+BENCHMARK(PhysicsStep)
+	->ArgsProduct({ { 1'000, 10'000 }, { 0, 1 } })
+	->Iterations(150)
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,146 @@
+#include "Precomp.h"
+
+#include <Core/QuadTree.h>
+
+#include <random>
+
+// Compares filling Core's QuadTreeBF by Adding items one by one against
+// bulk Build and ParallelBuild, which sort items by Morton-ordered quad
+// index and fill each quad in 1 go. Query benchmarks test every item's
+// bounds against the tree, serially and from many TBB workers at once
+// via the read-only mode
+// Args: item count
+
+namespace
+{
+	constexpr float kWorldSize = 1024;
+	constexpr float kMinItemSize = 1.f;
+	constexpr float kMaxItemSize = 8.f;
+	constexpr uint8_t kMaxDepth = 8;
+
+	using Tree = QuadTreeBF<uint32_t>;
+
+	std::vector<Tree::Entry> GenerateEntries(size_t aCount)
+	{
+		std::mt19937 engine(12345);
+		std::uniform_real_distribution<float> posDistrib(-kWorldSize / 2, kWorldSize / 2 - kMaxItemSize);
+		std::uniform_real_distribution<float> sizeDistrib(kMinItemSize, kMaxItemSize);
+
+		std::vector<Tree::Entry> entries(aCount);
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			Tree::Entry& entry = entries[i];
+			entry.myMin = { posDistrib(engine), posDistrib(engine) };
+			entry.myMax = entry.myMin + glm::vec2{ sizeDistrib(engine), sizeDistrib(engine) };
+			entry.myItem = i;
+		}
+		return entries;
+	}
+
+	Tree CreateTree()
+	{
+		return Tree(glm::vec2(-kWorldSize / 2), glm::vec2(kWorldSize / 2), kMaxDepth);
+	}
+
+	size_t TestEntry(const Tree& aTree, const Tree::Entry& anEntry)
+	{
+		size_t found = 0;
+		aTree.Test(anEntry.myMin, anEntry.myMax, [&](uint32_t)
+		{
+			found++;
+			return true;
+		});
+		return found;
+	}
+}
+
+static void QuadTreeBuildAdd(benchmark::State& aState)
+{
+	const std::vector<Tree::Entry> entries = GenerateEntries(aState.range(0));
+	std::vector<Tree::Info> infos(entries.size());
+	Tree tree = CreateTree();
+	for (auto _ : aState)
+	{
+		tree.Clear();
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			infos[i] = tree.Add(entries[i].myMin, entries[i].myMax, entries[i].myItem);
+		}
+		benchmark::DoNotOptimize(infos.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * entries.size());
+}
+BENCHMARK(QuadTreeBuildAdd)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeBuildBulk(benchmark::State& aState)
+{
+	const std::vector<Tree::Entry> entries = GenerateEntries(aState.range(0));
+	std::vector<Tree::Info> infos(entries.size());
+	Tree tree = CreateTree();
+	for (auto _ : aState)
+	{
+		tree.Build(entries, infos);
+		benchmark::DoNotOptimize(infos.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * entries.size());
+}
+BENCHMARK(QuadTreeBuildBulk)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeBuildParallel(benchmark::State& aState)
+{
+	const std::vector<Tree::Entry> entries = GenerateEntries(aState.range(0));
+	std::vector<Tree::Info> infos(entries.size());
+	Tree tree = CreateTree();
+	for (auto _ : aState)
+	{
+		tree.ParallelBuild(entries, infos);
+		benchmark::DoNotOptimize(infos.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * entries.size());
+}
+BENCHMARK(QuadTreeBuildParallel)->Arg(10'000)->Arg(100'000)->UseRealTime();
+
+static void QuadTreeQuerySerial(benchmark::State& aState)
+{
+	const std::vector<Tree::Entry> entries = GenerateEntries(aState.range(0));
+	Tree tree = CreateTree();
+	tree.Build(entries);
+	for (auto _ : aState)
+	{
+		size_t found = 0;
+		for (const Tree::Entry& entry : entries)
+		{
+			found += TestEntry(tree, entry);
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	aState.SetItemsProcessed(aState.iterations() * entries.size());
+}
+BENCHMARK(QuadTreeQuerySerial)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeQueryParallel(benchmark::State& aState)
+{
+	const std::vector<Tree::Entry> entries = GenerateEntries(aState.range(0));
+	Tree tree = CreateTree();
+	tree.Build(entries);
+	tree.SetReadOnly(true);
+	for (auto _ : aState)
+	{
+		std::atomic<size_t> found = 0;
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, entries.size()),
+			[&](const tbb::blocked_range<size_t>& aRange)
+			{
+				size_t localFound = 0;
+				for (size_t i = aRange.begin(); i < aRange.end(); i++)
+				{
+					localFound += TestEntry(tree, entries[i]);
+				}
+				found += localFound;
+			}
+		);
+		benchmark::DoNotOptimize(found.load());
+	}
+	tree.SetReadOnly(false);
+	aState.SetItemsProcessed(aState.iterations() * entries.size());
+}
+BENCHMARK(QuadTreeQueryParallel)->Arg(10'000)->Arg(100'000)->UseRealTime();
@@ -0,0 +1,150 @@
+#include "Precomp.h"
+
+#include <Core/QuadTree.h>
+
+#include <random>
+
+// Compares native nearest-neighbour and radius queries of Core's QuadTreeBF
+// against emulating them via Test over a box around the query point, then
+// filtering by distance (and sorting, for nearest). Box emulation can miss
+// neighbours further than the box, native queries can't
+// Args: item count, nearest count for Nearest benchmarks
+
+namespace
+{
+	constexpr float kWorldSize = 1024;
+	constexpr float kItemSize = 2.f;
+	constexpr uint8_t kMaxDepth = 8;
+	constexpr float kRadius = 16.f;
+	constexpr uint32_t kQueryCount = 1024;
+
+	using Tree = QuadTreeBF<uint32_t>;
+
+	struct Setup
+	{
+		Setup(size_t anItemCount)
+			: myTree(glm::vec2(-kWorldSize / 2), glm::vec2(kWorldSize / 2), kMaxDepth)
+		{
+			std::mt19937 engine(12345);
+			std::uniform_real_distribution<float> posDistrib(-kWorldSize / 2 + kItemSize, kWorldSize / 2 - kItemSize);
+
+			myPositions.resize(anItemCount);
+			std::vector<Tree::Entry> entries(anItemCount);
+			for (uint32_t i = 0; i < anItemCount; i++)
+			{
+				myPositions[i] = { posDistrib(engine), posDistrib(engine) };
+				entries[i] = { myPositions[i] - kItemSize / 2, myPositions[i] + kItemSize / 2, i };
+			}
+			myTree.Build(entries);
+
+			myQueries.resize(kQueryCount);
+			for (glm::vec2& query : myQueries)
+			{
+				query = { posDistrib(engine), posDistrib(engine) };
+			}
+		}
+
+		glm::vec2 GetPos(uint32_t anItem) const { return myPositions[anItem]; }
+
+		std::vector<glm::vec2> myPositions;
+		std::vector<glm::vec2> myQueries;
+		Tree myTree;
+	};
+
+	float GetDistanceSq(glm::vec2 aLeft, glm::vec2 aRight)
+	{
+		const glm::vec2 delta = aLeft - aRight;
+		return glm::dot(delta, delta);
+	}
+}
+
+static void QuadTreeNearestBox(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	const size_t nearestCount = aState.range(1);
+	std::vector<Tree::Nearest> found;
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			found.clear();
+			setup.myTree.Test(query - kRadius, query + kRadius, [&](uint32_t anItem)
+			{
+				found.push_back({ anItem, GetDistanceSq(setup.GetPos(anItem), query) });
+				return true;
+			});
+			const size_t count = std::min(nearestCount, found.size());
+			std::partial_sort(found.begin(), found.begin() + count, found.end(), 
+				[](const Tree::Nearest& aLeft, const Tree::Nearest& aRight)
+				{
+					return aLeft.myDistanceSq < aRight.myDistanceSq;
+				}
+			);
+			benchmark::DoNotOptimize(found.data());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(QuadTreeNearestBox)->Args({ 10'000, 8 })->Args({ 100'000, 8 })->Args({ 100'000, 32 });
+
+static void QuadTreeNearest(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	std::vector<Tree::Nearest> found(aState.range(1));
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			const uint32_t count = setup.myTree.FindNearest(query, found, [&](uint32_t anItem)
+			{
+				return setup.GetPos(anItem);
+			});
+			benchmark::DoNotOptimize(count);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(QuadTreeNearest)->Args({ 10'000, 8 })->Args({ 100'000, 8 })->Args({ 100'000, 32 });
+
+static void QuadTreeRadiusBox(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	std::vector<uint32_t> found;
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			found.clear();
+			setup.myTree.Test(query - kRadius, query + kRadius, [&](uint32_t anItem)
+			{
+				if (GetDistanceSq(setup.GetPos(anItem), query) <= kRadius * kRadius)
+				{
+					found.push_back(anItem);
+				}
+				return true;
+			});
+			benchmark::DoNotOptimize(found.data());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(QuadTreeRadiusBox)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeRadius(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	std::vector<uint32_t> found(setup.myPositions.size());
+	for (auto _ : aState)
+	{
+		for (glm::vec2 query : setup.myQueries)
+		{
+			const uint32_t count = setup.myTree.FindInRadius(query, kRadius, found, [&](uint32_t anItem)
+			{
+				return setup.GetPos(anItem);
+			});
+			benchmark::DoNotOptimize(count);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * kQueryCount);
+}
+BENCHMARK(QuadTreeRadius)->Arg(10'000)->Arg(100'000);
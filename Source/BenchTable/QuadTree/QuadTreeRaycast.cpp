@@ -0,0 +1,154 @@
+#include "Precomp.h"
+
+#include <Core/QuadTree.h>
+
+#include <random>
+
+// Compares ways of casting 100k 2D rays against circles stored in Core's
+// QuadTreeBF: Test over the bounding box of every ray, walking the tree
+// one ray at a time, and walking it in packets of 4 rays via RaycastBatch.
+// Rays are coherent, fanning out from a handful of origins, like
+// picking or line-of-sight checks do
+// Args: circle count
+
+namespace
+{
+	constexpr float kWorldSize = 1024;
+	constexpr float kMinRadius = 0.5f;
+	constexpr float kMaxRadius = 2.f;
+	constexpr uint8_t kMaxDepth = 8;
+	constexpr uint32_t kOriginCount = 100;
+	constexpr uint32_t kRaysPerOrigin = 1000;
+	constexpr float kRayLength = 64;
+
+	using Tree = QuadTreeBF<uint32_t>;
+
+	struct Circle
+	{
+		glm::vec2 myCenter;
+		float myRadius;
+	};
+
+	struct Setup
+	{
+		Setup(size_t aCircleCount)
+			: myTree(glm::vec2(-kWorldSize / 2), glm::vec2(kWorldSize / 2), kMaxDepth)
+		{
+			std::mt19937 engine(12345);
+			std::uniform_real_distribution<float> posDistrib(-kWorldSize / 2 + kMaxRadius, kWorldSize / 2 - kMaxRadius);
+			std::uniform_real_distribution<float> radiusDistrib(kMinRadius, kMaxRadius);
+
+			myCircles.resize(aCircleCount);
+			std::vector<Tree::Entry> entries(aCircleCount);
+			for (uint32_t i = 0; i < aCircleCount; i++)
+			{
+				const Circle circle{ { posDistrib(engine), posDistrib(engine) }, radiusDistrib(engine) };
+				myCircles[i] = circle;
+				entries[i] = { circle.myCenter - circle.myRadius, circle.myCenter + circle.myRadius, i };
+			}
+			myTree.Build(entries);
+
+			myRays.reserve(kOriginCount * kRaysPerOrigin);
+			for (uint32_t origin = 0; origin < kOriginCount; origin++)
+			{
+				const glm::vec2 pos{ posDistrib(engine), posDistrib(engine) };
+				for (uint32_t ray = 0; ray < kRaysPerOrigin; ray++)
+				{
+					const float angle = glm::two_pi<float>() * ray / kRaysPerOrigin;
+					myRays.push_back({ pos, { glm::cos(angle), glm::sin(angle) }, kRayLength });
+				}
+			}
+		}
+
+		// Returns true and the distance along aRay if it hits anItem's circle
+		bool Intersect(const Tree::Ray& aRay, uint32_t anItem, float& aRayT) const
+		{
+			const Circle& circle = myCircles[anItem];
+			const glm::vec2 toOrigin = aRay.myOrigin - circle.myCenter;
+			const float b = glm::dot(toOrigin, aRay.myDir);
+			const float c = glm::dot(toOrigin, toOrigin) - circle.myRadius * circle.myRadius;
+			if (c > 0 && b > 0)
+			{
+				return false;
+			}
+			const float discriminant = b * b - c;
+			if (discriminant < 0)
+			{
+				return false;
+			}
+			aRayT = glm::max(-b - glm::sqrt(discriminant), 0.f);
+			return true;
+		}
+
+		std::vector<Circle> myCircles;
+		std::vector<Tree::Ray> myRays;
+		Tree myTree;
+	};
+}
+
+static void QuadTreeRaycastBox(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	for (auto _ : aState)
+	{
+		uint32_t hitCount = 0;
+		for (const Tree::Ray& ray : setup.myRays)
+		{
+			const glm::vec2 end = ray.myOrigin + ray.myDir * ray.myMaxT;
+			float closestT = ray.myMaxT;
+			bool isHit = false;
+			setup.myTree.Test(glm::min(ray.myOrigin, end), glm::max(ray.myOrigin, end), [&](uint32_t anItem)
+			{
+				float rayT;
+				if (setup.Intersect(ray, anItem, rayT) && rayT < closestT)
+				{
+					closestT = rayT;
+					isHit = true;
+				}
+				return true;
+			});
+			hitCount += isHit;
+		}
+		benchmark::DoNotOptimize(hitCount);
+	}
+	aState.SetItemsProcessed(aState.iterations() * setup.myRays.size());
+}
+BENCHMARK(QuadTreeRaycastBox)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeRaycastSingle(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	auto Intersect = [&](const Tree::Ray& aRay, uint32_t anItem, float& aRayT)
+	{
+		return setup.Intersect(aRay, anItem, aRayT);
+	};
+	for (auto _ : aState)
+	{
+		uint32_t hitCount = 0;
+		for (const Tree::Ray& ray : setup.myRays)
+		{
+			const Tree::RayHit hit = setup.myTree.Raycast(ray, Intersect);
+			hitCount += hit.myT <= ray.myMaxT;
+		}
+		benchmark::DoNotOptimize(hitCount);
+	}
+	aState.SetItemsProcessed(aState.iterations() * setup.myRays.size());
+}
+BENCHMARK(QuadTreeRaycastSingle)->Arg(10'000)->Arg(100'000);
+
+static void QuadTreeRaycastBatch(benchmark::State& aState)
+{
+	const Setup setup(aState.range(0));
+	auto Intersect = [&](const Tree::Ray& aRay, uint32_t anItem, float& aRayT)
+	{
+		return setup.Intersect(aRay, anItem, aRayT);
+	};
+	std::vector<Tree::RayHit> hits(setup.myRays.size());
+	for (auto _ : aState)
+	{
+		setup.myTree.RaycastBatch(setup.myRays, hits, Intersect);
+		benchmark::DoNotOptimize(hits.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * setup.myRays.size());
+}
+BENCHMARK(QuadTreeRaycastBatch)->Arg(10'000)->Arg(100'000)->UseRealTime();
@@ -0,0 +1,83 @@
+#include "Precomp.h"
+
+#include <Engine/GameTaskManager.h>
+
+// Measures frame throughput of GameTaskManager at different pipeline depths.
+// A frame is a serial game update, followed by a wide parallel update, and
+// a serial render that reads back a snapshot of the simulated state. At depth 1
+// the render is on the critical path of every frame, at 2+ it overlaps with
+// simulation of the next frame
+// Args: pipeline depth
+
+namespace
+{
+	constexpr auto kGameUpdateTime = std::chrono::microseconds(500);
+	constexpr auto kParallelUpdateTime = std::chrono::microseconds(4000);
+	constexpr auto kRenderTime = std::chrono::microseconds(1500);
+	constexpr size_t kParallelChunks = 64;
+
+	enum Tasks : GameTask::Type
+	{
+		GameUpdate = static_cast<GameTask::Type>(GameTask::ReservedTypes::GraphBroadcast) + 1,
+		ParallelUpdate,
+		Render
+	};
+
+	// Simulates CPU-bound work, without yielding the thread
+	uint64_t Spin(std::chrono::nanoseconds aDuration)
+	{
+		const auto end = std::chrono::steady_clock::now() + aDuration;
+		uint64_t counter = 0;
+		while (std::chrono::steady_clock::now() < end)
+		{
+			benchmark::DoNotOptimize(++counter);
+		}
+		return counter;
+	}
+}
+
+static void PipelinedFrames(benchmark::State& aState)
+{
+	GameTaskManager taskManager;
+	const size_t depth = static_cast<size_t>(aState.range(0));
+	taskManager.SetPipelineDepth(depth);
+	// a copy per frame in flight, so simulation never overwrites what's being rendered
+	std::array<uint64_t, GameTaskManager::kMaxPipelineDepth> snapshots{};
+	std::atomic<uint64_t> simulated = 0;
+	uint64_t renderedSum = 0;
+
+	GameTask task(Tasks::GameUpdate, [&] {
+		simulated += Spin(kGameUpdateTime);
+	});
+	taskManager.AddTask(task);
+
+	task = GameTask(Tasks::ParallelUpdate, [&] {
+		tbb::parallel_for(size_t(0), kParallelChunks, [&](size_t) {
+			simulated += Spin(kParallelUpdateTime / kParallelChunks);
+		});
+		snapshots[taskManager.GetSimFrame() % depth] = simulated;
+	});
+	task.AddDependency(Tasks::GameUpdate);
+	taskManager.AddTask(task);
+
+	task = GameTask(Tasks::Render, [&] {
+		renderedSum += snapshots[taskManager.GetRenderFrame() % depth];
+		Spin(kRenderTime);
+	});
+	task.AddDependency(Tasks::ParallelUpdate);
+	task.SetStage(GameTask::Stage::Render);
+	taskManager.AddTask(task);
+
+	for (auto _ : aState)
+	{
+		taskManager.Run();
+		taskManager.Wait();
+	}
+	taskManager.WaitAll();
+	benchmark::DoNotOptimize(renderedSum);
+
+	aState.counters["FPS"] = benchmark::Counter(static_cast<double>(aState.iterations()), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(PipelinedFrames)->DenseRange(1, GameTaskManager::kMaxPipelineDepth)
+	->Unit(benchmark::kMillisecond)->UseRealTime();
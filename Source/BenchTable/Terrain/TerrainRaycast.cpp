@@ -0,0 +1,105 @@
+#include "Precomp.h"
+
+#include <Engine/Terrain.h>
+
+#include <random>
+
+// Compares line-of-sight checks over a generated Terrain: stepping along
+// every ray and comparing against GetHeight, against Terrain::Raycast, that
+// skips over areas via a min/max height pyramid, and against RaycastBatch,
+// that does the same for all rays in parallel. Rays go from eye height
+// above a random point to eye height above another point, 100k of them
+// Args: terrain size
+
+namespace
+{
+	constexpr uint32_t kRayCount = 100'000;
+	constexpr float kEyeHeight = 2.f;
+	constexpr float kMaxDistance = 128.f;
+	// stepping baseline samples the terrain twice per vertex
+	constexpr float kStepLength = 0.5f;
+
+	struct Setup
+	{
+		Setup(uint32_t aSize)
+		{
+			const float power = glm::log2(static_cast<float>(aSize));
+			myTerrain.Generate({ aSize, aSize }, 1, power * 4);
+
+			std::mt19937 engine(12345);
+			const float size = myTerrain.GetWidth();
+			std::uniform_real_distribution<float> posDistrib(0, size - 1);
+			std::uniform_real_distribution<float> offsetDistrib(-kMaxDistance, kMaxDistance);
+			myRays.resize(kRayCount);
+			for (Shapes::Ray& ray : myRays)
+			{
+				const glm::vec2 from{ posDistrib(engine), posDistrib(engine) };
+				const glm::vec2 to = glm::clamp(from + glm::vec2{ offsetDistrib(engine), offsetDistrib(engine) },
+					glm::vec2{ 0 }, glm::vec2{ size - 1 });
+				const glm::vec3 start{ from.x, myTerrain.GetHeight(from) + kEyeHeight, from.y };
+				const glm::vec3 end{ to.x, myTerrain.GetHeight(to) + kEyeHeight, to.y };
+				// ray spans [0, 1] between the points
+				ray = { start, end - start };
+			}
+		}
+
+		Terrain myTerrain;
+		std::vector<Shapes::Ray> myRays;
+	};
+}
+
+static void TerrainRaycastStepping(benchmark::State& aState)
+{
+	const Setup setup(static_cast<uint32_t>(aState.range(0)));
+	for (auto _ : aState)
+	{
+		uint32_t blockedCount = 0;
+		for (const Shapes::Ray& ray : setup.myRays)
+		{
+			const float length = glm::length(ray.myDir);
+			const uint32_t stepCount = static_cast<uint32_t>(length / kStepLength) + 1;
+			for (uint32_t step = 1; step < stepCount; step++)
+			{
+				const glm::vec3 pos = ray.myOrigin + ray.myDir * (static_cast<float>(step) / stepCount);
+				if (pos.y < setup.myTerrain.GetHeight({ pos.x, pos.z }))
+				{
+					blockedCount++;
+					break;
+				}
+			}
+		}
+		benchmark::DoNotOptimize(blockedCount);
+	}
+	aState.SetItemsProcessed(aState.iterations() * kRayCount);
+}
+BENCHMARK(TerrainRaycastStepping)->Arg(1024)->Arg(4096);
+
+static void TerrainRaycastMips(benchmark::State& aState)
+{
+	const Setup setup(static_cast<uint32_t>(aState.range(0)));
+	for (auto _ : aState)
+	{
+		uint32_t blockedCount = 0;
+		for (const Shapes::Ray& ray : setup.myRays)
+		{
+			float rayT;
+			blockedCount += setup.myTerrain.Raycast(ray, 1.f, rayT);
+		}
+		benchmark::DoNotOptimize(blockedCount);
+	}
+	aState.SetItemsProcessed(aState.iterations() * kRayCount);
+}
+BENCHMARK(TerrainRaycastMips)->Arg(1024)->Arg(4096);
+
+static void TerrainRaycastBatch(benchmark::State& aState)
+{
+	const Setup setup(static_cast<uint32_t>(aState.range(0)));
+	std::vector<float> rayTs(kRayCount);
+	for (auto _ : aState)
+	{
+		setup.myTerrain.RaycastBatch(setup.myRays, 1.f, rayTs);
+		benchmark::DoNotOptimize(rayTs.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * kRayCount);
+}
+BENCHMARK(TerrainRaycastBatch)->Arg(1024)->Arg(4096)->UseRealTime();
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <random>
+
+#include <Core/Transform.h>
+
+// Shared hierarchy generation for TransformStore benchmarks. Every node picks
+// a random earlier node as a parent, which keeps the tree shallow (log depth)
+// but wide, with parents scattered all over memory
+struct TransformHierarchy
+{
+	constexpr static uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+	// 1% of nodes are roots
+	constexpr static uint32_t kRootRatio = 100;
+
+	explicit TransformHierarchy(size_t aCount)
+	{
+		std::mt19937 generator(1234);
+		std::uniform_real_distribution<float> posDist(-10.f, 10.f);
+		std::uniform_real_distribution<float> angleDist(-glm::pi<float>(), glm::pi<float>());
+		std::uniform_real_distribution<float> scaleDist(0.9f, 1.1f);
+
+		const size_t rootCount = std::max<size_t>(aCount / kRootRatio, 1);
+		myParents.resize(aCount);
+		myLocals.resize(aCount);
+		for (size_t i = 0; i < aCount; i++)
+		{
+			if (i < rootCount)
+			{
+				myParents[i] = kNoParent;
+			}
+			else
+			{
+				std::uniform_int_distribution<uint32_t> parentDist(0, static_cast<uint32_t>(i - 1));
+				myParents[i] = parentDist(generator);
+			}
+
+			myLocals[i] = Transform(
+				{ posDist(generator), posDist(generator), posDist(generator) },
+				glm::quat(glm::vec3(angleDist(generator), angleDist(generator), angleDist(generator))),
+				glm::vec3(scaleDist(generator))
+			);
+		}
+	}
+
+	std::vector<uint32_t> myParents;
+	std::vector<Transform> myLocals;
+};
@@ -0,0 +1,94 @@
+#include "Precomp.h"
+
+#include "TransformStore/TransformCommon.h"
+#include <Core/TransformStore.h>
+
+// Compares dirty-list propagation against a full pass, with a percentage
+// of entries getting moved every iteration. Dirty entries are picked among
+// leaf-heavy tail of the hierarchy, which is where most moving objects are
+// Args: node count, percent of dirty nodes
+
+namespace
+{
+	struct DirtyScene
+	{
+		explicit DirtyScene(size_t aCount, size_t aDirtyPercent)
+			: myHierarchy(aCount)
+		{
+			myStore.Reserve(aCount);
+			myIds.resize(aCount);
+			for (size_t i = 0; i < aCount; i++)
+			{
+				const uint32_t parent = myHierarchy.myParents[i];
+				myIds[i] = myStore.Add(myHierarchy.myLocals[i],
+					parent != TransformHierarchy::kNoParent ? myIds[parent] : TransformStore::kInvalidId);
+			}
+			// first call sorts by depth and consumes added entries
+			std::vector<TransformStore::Id> updated;
+			myStore.PropagateDirty(updated);
+
+			const size_t dirtyCount = std::max<size_t>(aCount * aDirtyPercent / 100, 1);
+			std::mt19937 generator(5678);
+			std::uniform_int_distribution<size_t> indexDist(aCount / 2, aCount - 1);
+			myDirty.resize(dirtyCount);
+			for (size_t& index : myDirty)
+			{
+				index = aDirtyPercent == 100 ? &index - myDirty.data() : indexDist(generator);
+			}
+		}
+
+		void MoveDirty(float anOffset)
+		{
+			for (size_t index : myDirty)
+			{
+				Transform local = myHierarchy.myLocals[index];
+				local.Translate({ anOffset, 0, 0 });
+				myStore.SetLocal(myIds[index], local);
+			}
+		}
+
+		TransformHierarchy myHierarchy;
+		TransformStore myStore;
+		std::vector<TransformStore::Id> myIds;
+		std::vector<size_t> myDirty;
+	};
+}
+
+static void StoreFullAfterMove(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	DirtyScene scene(count, static_cast<size_t>(aState.range(1)));
+
+	float offset = 0;
+	for (auto _ : aState)
+	{
+		scene.MoveDirty(offset);
+		offset += 0.01f;
+		scene.myStore.Propagate();
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * scene.myDirty.size());
+}
+
+static void StoreDirtyAfterMove(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	DirtyScene scene(count, static_cast<size_t>(aState.range(1)));
+
+	std::vector<TransformStore::Id> updated;
+	float offset = 0;
+	for (auto _ : aState)
+	{
+		scene.MoveDirty(offset);
+		offset += 0.01f;
+		scene.myStore.PropagateDirty(updated);
+		benchmark::DoNotOptimize(updated.data());
+	}
+	aState.SetItemsProcessed(aState.iterations() * scene.myDirty.size());
+	aState.counters["Updated"] = static_cast<double>(updated.size());
+}
+
+BENCHMARK(StoreFullAfterMove)->ArgsProduct({ { 100'000, 1'000'000 }, { 1, 100 } })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(StoreDirtyAfterMove)->ArgsProduct({ { 100'000, 1'000'000 }, { 1, 100 } })
+	->Unit(benchmark::kMillisecond)->UseRealTime();
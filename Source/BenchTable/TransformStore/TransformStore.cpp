@@ -0,0 +1,108 @@
+#include "Precomp.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "TransformStore/TransformCommon.h"
+#include <Core/TransformStore.h>
+
+// Compares world transform propagation of a pointer-linked hierarchy,
+// (same as GameObject::UpdateHierarchyTransform used to work) against
+// TransformStore's depth-sorted SoA pass
+// Args: node count
+
+namespace
+{
+	struct Node
+	{
+		Transform myLocal;
+		Transform myWorld;
+		Node* myParent = nullptr;
+		std::vector<Node*> myChildren;
+	};
+
+	void UpdateChildren(Node& aNode)
+	{
+		for (Node* child : aNode.myChildren)
+		{
+			child->myWorld = aNode.myWorld * child->myLocal;
+			UpdateChildren(*child);
+		}
+	}
+}
+
+static void PointerHierarchy(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	const TransformHierarchy hierarchy(count);
+
+	// allocate in shuffled order to mimic objects spawned over time
+	std::vector<uint32_t> allocOrder(count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		allocOrder[i] = i;
+	}
+	std::shuffle(allocOrder.begin(), allocOrder.end(), std::mt19937(4321));
+
+	std::vector<std::unique_ptr<Node>> nodes(count);
+	for (uint32_t index : allocOrder)
+	{
+		nodes[index] = std::make_unique<Node>();
+		nodes[index]->myLocal = hierarchy.myLocals[index];
+	}
+
+	std::vector<Node*> roots;
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint32_t parent = hierarchy.myParents[i];
+		if (parent == TransformHierarchy::kNoParent)
+		{
+			roots.push_back(nodes[i].get());
+		}
+		else
+		{
+			nodes[i]->myParent = nodes[parent].get();
+			nodes[parent]->myChildren.push_back(nodes[i].get());
+		}
+	}
+
+	for (auto _ : aState)
+	{
+		for (Node* root : roots)
+		{
+			root->myWorld = root->myLocal;
+			UpdateChildren(*root);
+		}
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void StorePropagate(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	const TransformHierarchy hierarchy(count);
+
+	TransformStore store;
+	store.Reserve(count);
+	std::vector<TransformStore::Id> ids(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint32_t parent = hierarchy.myParents[i];
+		ids[i] = store.Add(hierarchy.myLocals[i], 
+			parent != TransformHierarchy::kNoParent ? ids[parent] : TransformStore::kInvalidId);
+	}
+	// first call sorts by depth
+	store.Propagate();
+
+	for (auto _ : aState)
+	{
+		store.Propagate();
+		benchmark::ClobberMemory();
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+	aState.counters["Depth"] = static_cast<double>(store.GetDepthCount());
+}
+
+BENCHMARK(PointerHierarchy)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(StorePropagate)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond)->UseRealTime();
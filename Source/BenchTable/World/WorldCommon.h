@@ -0,0 +1,24 @@
+#pragma once
+
+#include <Engine/Game.h>
+#include <Engine/GameObject.h>
+
+// Shared helpers for World benchmarks. GameObjects can only be deleted
+// during Game's cleanup stages, so benchmarks have to hold the guard for
+// as long as they keep objects alive
+struct GODeleteGuard
+{
+	GODeleteGuard() { Game::ourGODeleteEnabled = true; }
+	~GODeleteGuard() { Game::ourGODeleteEnabled = false; }
+};
+
+inline std::vector<Handle<GameObject>> CreateGameObjects(size_t aCount)
+{
+	std::vector<Handle<GameObject>> objects;
+	objects.reserve(aCount);
+	for (size_t i = 0; i < aCount; i++)
+	{
+		objects.emplace_back(new GameObject(Transform()));
+	}
+	return objects;
+}
@@ -0,0 +1,106 @@
+#include "Precomp.h"
+
+#include <queue>
+
+#include "World/WorldCommon.h"
+#include <Core/Threading/PerThreadBuffer.h>
+#include <Engine/World.h>
+
+// Compares a frame of mass spawning and despawning of GameObjects from
+// many threads: spin-locked queues drained into World one by one (how
+// Game used to do it) against per-thread buffers with bulk World updates.
+// Objects are created up front, so only queueing and World upkeep is measured
+// Args: object count
+
+namespace
+{
+	constexpr int kThreadCount = 16;
+
+	template<class TFunc>
+	void ProduceFromThreads(tbb::task_arena& anArena, size_t aCount, const TFunc& aFunc)
+	{
+		anArena.execute([&] {
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, aCount),
+				[&](const tbb::blocked_range<size_t>& aRange) {
+				for (size_t i = aRange.begin(); i < aRange.end(); i++)
+				{
+					aFunc(i);
+				}
+			});
+		});
+	}
+}
+
+static void LockedQueues(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	{
+		GODeleteGuard deleteGuard;
+		std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+		World world;
+		tbb::spin_mutex addLock;
+		tbb::spin_mutex removeLock;
+		std::queue<Handle<GameObject>> addQueue;
+		std::queue<Handle<GameObject>> removeQueue;
+		tbb::task_arena arena(kThreadCount);
+
+		for (auto _ : aState)
+		{
+			ProduceFromThreads(arena, count, [&](size_t anIndex) {
+				tbb::spin_mutex::scoped_lock lock(addLock);
+				addQueue.push(objects[anIndex]);
+			});
+			while (!addQueue.empty())
+			{
+				world.Add(addQueue.front());
+				addQueue.pop();
+			}
+
+			ProduceFromThreads(arena, count, [&](size_t anIndex) {
+				tbb::spin_mutex::scoped_lock lock(removeLock);
+				removeQueue.push(objects[anIndex]);
+			});
+			while (!removeQueue.empty())
+			{
+				world.Remove(removeQueue.front());
+				removeQueue.pop();
+			}
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void ThreadBuffers(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	{
+		GODeleteGuard deleteGuard;
+		std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+		World world;
+		PerThreadBuffer<Handle<GameObject>> addBuffer;
+		PerThreadBuffer<Handle<GameObject>> removeBuffer;
+		std::vector<Handle<GameObject>> batch;
+		tbb::task_arena arena(kThreadCount);
+
+		for (auto _ : aState)
+		{
+			ProduceFromThreads(arena, count, [&](size_t anIndex) {
+				addBuffer.Push(objects[anIndex]);
+			});
+			addBuffer.Consume(batch);
+			world.Add(batch);
+			batch.clear();
+
+			ProduceFromThreads(arena, count, [&](size_t anIndex) {
+				removeBuffer.Push(objects[anIndex]);
+			});
+			removeBuffer.Consume(batch);
+			world.Remove(batch);
+			batch.clear();
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+BENCHMARK(LockedQueues)->Arg(100'000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ThreadBuffers)->Arg(100'000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,193 @@
+#include "Precomp.h"
+
+#include <random>
+
+#include "World/WorldCommon.h"
+#include <Engine/World.h>
+
+// Compares World's dense array with generational ids against how it used
+// to store objects: a vector of Handles, with a pointer to index hash map.
+// Objects are created up front, so only World upkeep is measured
+// Args: object count
+
+namespace
+{
+	struct HashedWorld
+	{
+		void Add(Handle<GameObject>& aGameObject)
+		{
+			myGameObjIndices.insert({ aGameObject.Get(), myGameObjects.size() });
+			myGameObjects.push_back(aGameObject);
+		}
+
+		void Remove(Handle<GameObject>& aGameObject)
+		{
+			const auto objIndIter = myGameObjIndices.find(aGameObject.Get());
+			const size_t toDeleteInd = objIndIter->second;
+			const auto lastIter = myGameObjects.end() - 1;
+			if (toDeleteInd != myGameObjects.size() - 1)
+			{
+				const auto toDeleteIter = myGameObjects.begin() + toDeleteInd;
+				std::swap(*toDeleteIter, *lastIter);
+				myGameObjIndices[toDeleteIter->Get()] = toDeleteInd;
+			}
+			myGameObjects.erase(lastIter);
+			myGameObjIndices.erase(objIndIter);
+		}
+
+		std::vector<Handle<GameObject>> myGameObjects;
+		std::unordered_map<const GameObject*, size_t> myGameObjIndices;
+	};
+
+	std::vector<size_t> CreateShuffledIndices(size_t aCount)
+	{
+		std::vector<size_t> indices(aCount);
+		for (size_t i = 0; i < aCount; i++)
+		{
+			indices[i] = i;
+		}
+		std::shuffle(indices.begin(), indices.end(), std::mt19937(1234));
+		return indices;
+	}
+}
+
+static void HashedWorldLookup(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	const std::vector<size_t> lookupOrder = CreateShuffledIndices(count);
+	HashedWorld world;
+	for (Handle<GameObject>& object : objects)
+	{
+		world.Add(object);
+	}
+
+	for (auto _ : aState)
+	{
+		for (size_t index : lookupOrder)
+		{
+			const size_t denseIndex = world.myGameObjIndices.find(objects[index].Get())->second;
+			benchmark::DoNotOptimize(world.myGameObjects[denseIndex].Get());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void WorldLookup(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	const std::vector<size_t> lookupOrder = CreateShuffledIndices(count);
+	World world;
+	world.Add(objects);
+
+	std::vector<World::ObjectId> ids(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		ids[i] = objects[i]->GetWorldId();
+	}
+
+	for (auto _ : aState)
+	{
+		for (size_t index : lookupOrder)
+		{
+			benchmark::DoNotOptimize(world.Get(ids[index]));
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void HashedWorldAddRemove(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	const std::vector<size_t> removeOrder = CreateShuffledIndices(count);
+	HashedWorld world;
+
+	for (auto _ : aState)
+	{
+		for (Handle<GameObject>& object : objects)
+		{
+			world.Add(object);
+		}
+		for (size_t index : removeOrder)
+		{
+			world.Remove(objects[index]);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void WorldAddRemove(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	const std::vector<size_t> removeOrder = CreateShuffledIndices(count);
+	World world;
+
+	for (auto _ : aState)
+	{
+		for (Handle<GameObject>& object : objects)
+		{
+			world.Add(object);
+		}
+		for (size_t index : removeOrder)
+		{
+			world.Remove(objects[index]);
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+// Copying Handles while iterating, as code that used to take them by value did
+static void HashedWorldIterate(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	HashedWorld world;
+	for (Handle<GameObject>& object : objects)
+	{
+		world.Add(object);
+	}
+
+	for (auto _ : aState)
+	{
+		for (Handle<GameObject> object : world.myGameObjects)
+		{
+			benchmark::DoNotOptimize(object->GetWorld());
+		}
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+static void WorldIterate(benchmark::State& aState)
+{
+	const size_t count = static_cast<size_t>(aState.range(0));
+	GODeleteGuard deleteGuard;
+	std::vector<Handle<GameObject>> objects = CreateGameObjects(count);
+	World world;
+	world.Add(objects);
+
+	for (auto _ : aState)
+	{
+		world.Access([](std::span<GameObject* const> anObjects) {
+			for (GameObject* object : anObjects)
+			{
+				benchmark::DoNotOptimize(object->GetWorld());
+			}
+		});
+	}
+	aState.SetItemsProcessed(aState.iterations() * count);
+}
+
+BENCHMARK(HashedWorldLookup)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(WorldLookup)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(HashedWorldAddRemove)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(WorldAddRemove)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(HashedWorldIterate)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(WorldIterate)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
@@ -55,9 +55,11 @@ bool File::Write(const char* aData, size_t aLength)
 
 bool File::Write() const
 {
+	const size_t directoryEnd = myPath.rfind('/');
 	const std::string_view directory = std::string_view{myPath}
-		.substr(0, myPath.rfind('/'));
-	if (!std::filesystem::exists(directory))
+		.substr(0, directoryEnd);
+	// a bare file name has no directory to create
+	if (directoryEnd != std::string::npos && !std::filesystem::exists(directory))
 	{
 		std::filesystem::create_directories(directory);
 	}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Grid.h"
+
+#include <span>
+
+// Alternative to Grid that keeps every cell in one contiguous array, with
+// per-cell offsets into it. It can't be updated incrementally - instead it
+// gets rebuilt from scratch out of item bounds via a counting sort. When
+// most items move every frame, this is cheaper than moving them one by one,
+// has no per-cell allocations, and iteration doesn't chase a pointer per cell
+template<class T>
+class FlatGrid
+{
+public:
+	struct Entry
+	{
+		glm::vec2 myMin;
+		glm::vec2 myMax;
+		T myItem;
+	};
+
+	FlatGrid(glm::vec2 aMin, float aGridSize, uint16_t aCellCount)
+		: myLayout(aMin, aGridSize, aCellCount)
+	{
+		myCellStarts.resize(myLayout.GetTotalCellCount() + 1, 0);
+	}
+
+	// Replaces contents with anEntries. Within a cell, items
+	// keep the order they had in anEntries
+	void Rebuild(std::span<const Entry> anEntries)
+	{
+		const uint32_t cellCount = myLayout.GetTotalCellCount();
+		myRanges.resize(anEntries.size());
+		myCursors.assign(cellCount, 0);
+		for (size_t i = 0; i < anEntries.size(); i++)
+		{
+			myRanges[i] = myLayout.GetCellRange(anEntries[i].myMin, anEntries[i].myMax);
+			ForEachCellIndex(myRanges[i], [&](uint32_t aCell) {
+				myCursors[aCell]++;
+			});
+		}
+
+		uint32_t itemCount = 0;
+		for (uint32_t cell = 0; cell < cellCount; cell++)
+		{
+			myCellStarts[cell] = itemCount;
+			itemCount += myCursors[cell];
+			myCursors[cell] = myCellStarts[cell];
+		}
+		myCellStarts[cellCount] = itemCount;
+
+		myItems.resize(itemCount);
+		for (size_t i = 0; i < anEntries.size(); i++)
+		{
+			ForEachCellIndex(myRanges[i], [&](uint32_t aCell) {
+				myItems[myCursors[aCell]++] = anEntries[i].myItem;
+			});
+		}
+	}
+
+	// Same result as Rebuild, but counting and scattering of items
+	// happens in parallel over chunks of anEntries
+	void ParallelRebuild(std::span<const Entry> anEntries)
+	{
+		constexpr size_t kMinChunkSize = 4096;
+		constexpr size_t kMaxChunks = 64;
+		const size_t chunkCount = std::clamp<size_t>(anEntries.size() / kMinChunkSize, 1, kMaxChunks);
+		if (chunkCount == 1)
+		{
+			Rebuild(anEntries);
+			return;
+		}
+		const size_t chunkSize = (anEntries.size() + chunkCount - 1) / chunkCount;
+		const uint32_t cellCount = myLayout.GetTotalCellCount();
+
+		// per-chunk histograms, which become per-chunk write cursors
+		myRanges.resize(anEntries.size());
+		myCursors.assign(chunkCount * cellCount, 0);
+		tbb::parallel_for(size_t(0), chunkCount, [&](size_t aChunk) {
+			uint32_t* counts = myCursors.data() + aChunk * cellCount;
+			const size_t end = std::min(anEntries.size(), (aChunk + 1) * chunkSize);
+			for (size_t i = aChunk * chunkSize; i < end; i++)
+			{
+				myRanges[i] = myLayout.GetCellRange(anEntries[i].myMin, anEntries[i].myMax);
+				ForEachCellIndex(myRanges[i], [counts](uint32_t aCell) {
+					counts[aCell]++;
+				});
+			}
+		});
+
+		// earlier chunks write first within a cell, same as the serial order
+		uint32_t itemCount = 0;
+		for (uint32_t cell = 0; cell < cellCount; cell++)
+		{
+			myCellStarts[cell] = itemCount;
+			for (size_t chunk = 0; chunk < chunkCount; chunk++)
+			{
+				uint32_t& cursor = myCursors[chunk * cellCount + cell];
+				const uint32_t count = cursor;
+				cursor = itemCount;
+				itemCount += count;
+			}
+		}
+		myCellStarts[cellCount] = itemCount;
+
+		myItems.resize(itemCount);
+		tbb::parallel_for(size_t(0), chunkCount, [&](size_t aChunk) {
+			uint32_t* cursors = myCursors.data() + aChunk * cellCount;
+			const size_t end = std::min(anEntries.size(), (aChunk + 1) * chunkSize);
+			for (size_t i = aChunk * chunkSize; i < end; i++)
+			{
+				ForEachCellIndex(myRanges[i], [&](uint32_t aCell) {
+					myItems[cursors[aCell]++] = anEntries[i].myItem;
+				});
+			}
+		});
+	}
+
+	std::span<const T> GetCell(uint32_t anIndex) const
+	{
+		return { myItems.data() + myCellStarts[anIndex], myItems.data() + myCellStarts[anIndex + 1] };
+	}
+
+	uint32_t GetCellCount() const { return myLayout.GetTotalCellCount(); }
+	// Items spanning multiple cells are counted once per cell
+	size_t GetItemCount() const { return myItems.size(); }
+
+	template<class TFunc>
+	void ForEachCell(const TFunc& aFunc) const
+	{
+		for (uint32_t i = 0; i < GetCellCount(); i++)
+		{
+			std::span<const T> cell = GetCell(i);
+			if constexpr (requires(glm::vec2 a) { aFunc(a, a, cell); })
+			{
+				const glm::vec2 min = myLayout.GetCellMin(i);
+				const glm::vec2 max = min + glm::vec2{ myLayout.GetCellSize() };
+				aFunc(min, max, cell);
+			}
+			else
+			{
+				aFunc(cell);
+			}
+		}
+	}
+
+	template<class TFunc>
+	void ForEachCell(glm::vec2 aMin, glm::vec2 aMax, const TFunc& aFunc) const
+	{
+		ForEachCellIndex(myLayout.GetCellRange(aMin, aMax), [&](uint32_t aCell) {
+			aFunc(GetCell(aCell));
+		});
+	}
+
+	// Calls aFunc(cellIndex, cell) for cells in parallel
+	template<class TFunc>
+	void ParallelForEachCell(const TFunc& aFunc) const
+	{
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(0, GetCellCount()),
+			[&](const tbb::blocked_range<uint32_t>& aRange)
+			{
+				for (uint32_t i = aRange.begin(); i < aRange.end(); i++)
+				{
+					aFunc(i, GetCell(i));
+				}
+			}
+		);
+	}
+
+	void Clear()
+	{
+		std::ranges::fill(myCellStarts, 0);
+		myItems.clear();
+	}
+
+private:
+	template<class TFunc>
+	void ForEachCellIndex(const GridLayout::CellRange& aRange, const TFunc& aFunc) const
+	{
+		for (uint16_t y = aRange.myMin.y; y <= aRange.myMax.y; y++)
+		{
+			for (uint16_t x = aRange.myMin.x; x <= aRange.myMax.x; x++)
+			{
+				aFunc(myLayout.GetCellIndex(x, y));
+			}
+		}
+	}
+
+	std::vector<T> myItems;
+	// cell i occupies [myCellStarts[i], myCellStarts[i + 1]) of myItems
+	std::vector<uint32_t> myCellStarts;
+	// rebuild scratch, kept around to avoid reallocating every frame
+	std::vector<GridLayout::CellRange> myRanges;
+	std::vector<uint32_t> myCursors;
+	GridLayout myLayout;
+};
@@ -1,5 +1,83 @@
 #pragma once
 
+#include <emmintrin.h>
+#include <span>
+
+// Maps positions to cells of a square grid, shared by Grid and FlatGrid
+class GridLayout
+{
+public:
+	struct CellRange
+	{
+		glm::u16vec2 myMin;
+		glm::u16vec2 myMax;
+	};
+
+	GridLayout(glm::vec2 aMin, float aGridSize, uint16_t aCellCount)
+		: myMin(aMin)
+		, myGridSize(aGridSize)
+		, myCellSize(aGridSize / aCellCount)
+		, myCellCount(aCellCount)
+	{
+	}
+
+	// Returns the cells covered by the [aMin, aMax] rect, clamped to the grid.
+	// Converts both corners in 1 go
+	CellRange GetCellRange(glm::vec2 aMin, glm::vec2 aMax) const
+	{
+		const __m128 corners = _mm_setr_ps(aMin.x, aMin.y, aMax.x, aMax.y);
+		const __m128 gridMin = _mm_setr_ps(myMin.x, myMin.y, myMin.x, myMin.y);
+		__m128 coords = _mm_div_ps(_mm_sub_ps(corners, gridMin), _mm_set1_ps(myCellSize));
+		// clamping before truncating gives the same result as after
+		coords = _mm_max_ps(coords, _mm_setzero_ps());
+		coords = _mm_min_ps(coords, _mm_set1_ps(static_cast<float>(myCellCount - 1)));
+
+		alignas(16) int32_t indices[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(coords));
+		return {
+			{ static_cast<uint16_t>(indices[0]), static_cast<uint16_t>(indices[1]) },
+			{ static_cast<uint16_t>(indices[2]), static_cast<uint16_t>(indices[3]) }
+		};
+	}
+
+	// Returns the cell containing aPos, clamped to the grid
+	glm::u16vec2 GetCellCoords(glm::vec2 aPos) const { return GetCellRange(aPos, aPos).myMin; }
+
+	// Squared distance from aPos to a cell. Border cells also hold everything
+	// outside of the grid, so they're treated as stretching out to infinity
+	float GetCellDistanceSq(uint16_t aX, uint16_t aY, glm::vec2 aPos) const
+	{
+		constexpr float kInf = std::numeric_limits<float>::infinity();
+		const glm::vec2 min = myMin + glm::vec2{ aX * myCellSize, aY * myCellSize };
+		const glm::vec2 max = min + glm::vec2{ myCellSize };
+		const glm::vec2 delta{
+			glm::max(glm::max((aX == 0 ? -kInf : min.x) - aPos.x, aPos.x - (aX == myCellCount - 1 ? kInf : max.x)), 0.f),
+			glm::max(glm::max((aY == 0 ? -kInf : min.y) - aPos.y, aPos.y - (aY == myCellCount - 1 ? kInf : max.y)), 0.f)
+		};
+		return glm::dot(delta, delta);
+	}
+
+	uint32_t GetCellIndex(uint16_t aX, uint16_t aY) const { return aY * myCellCount + aX; }
+
+	glm::vec2 GetCellMin(uint32_t anIndex) const
+	{
+		const uint16_t y = anIndex / myCellCount;
+		const uint16_t x = anIndex % myCellCount;
+		return myMin + glm::vec2{ x * myCellSize, y * myCellSize };
+	}
+
+	float GetGridSize() const { return myGridSize; }
+	float GetCellSize() const { return myCellSize; }
+	uint16_t GetCellCount() const { return myCellCount; }
+	uint32_t GetTotalCellCount() const { return myCellCount * myCellCount; }
+
+private:
+	glm::vec2 myMin;
+	float myGridSize;
+	float myCellSize;
+	uint16_t myCellCount;
+};
+
 // Avoids removing-then-adding to the same cells in Move().
 // This can save on cache thrashing if the Grid contains many
 // multi-cell objects
@@ -9,36 +87,39 @@ template<class T>
 class Grid
 {
 public:
+	struct Nearest
+	{
+		T myItem;
+		float myDistanceSq;
+	};
+
 	Grid(glm::vec2 aMin, float aGridSize, uint16_t aCellCount)
-		: myMin(aMin)
-		, myGridSize(aGridSize)
-		, myCellSize(aGridSize / aCellCount)
-		, myCellCount(aCellCount)
+		: myLayout(aMin, aGridSize, aCellCount)
 	{
-		myGridCells.resize(myCellCount * myCellCount);
+		myGridCells.resize(myLayout.GetTotalCellCount());
 	}
 
 	void Add(glm::vec2 aMin, glm::vec2 aMax, T anItem)
 	{
-		const glm::u16vec2 minCoords = GetCellIndices(aMin);
-		const glm::u16vec2 maxCoords = GetCellIndices(aMax);
-		AddInternal(minCoords, maxCoords, anItem);
+		const GridLayout::CellRange range = myLayout.GetCellRange(aMin, aMax);
+		AddInternal(range.myMin, range.myMax, anItem);
 	}
 
 	void Remove(glm::vec2 aMin, glm::vec2 aMax, T anItem)
 	{
-		const glm::u16vec2 minCoords = GetCellIndices(aMin);
-		const glm::u16vec2 maxCoords = GetCellIndices(aMax);
-		RemoveInternal(minCoords, maxCoords, anItem);
+		const GridLayout::CellRange range = myLayout.GetCellRange(aMin, aMax);
+		RemoveInternal(range.myMin, range.myMax, anItem);
 	}
 
 	void Move(glm::vec2 anOldMin, glm::vec2 anOldMax, glm::vec2 aMin, glm::vec2 aMax, T anItem)
 	{
-		const glm::u16vec2 oldMinCoords = GetCellIndices(anOldMin);
-		const glm::u16vec2 oldMaxCoords = GetCellIndices(anOldMax);
+		const GridLayout::CellRange oldRange = myLayout.GetCellRange(anOldMin, anOldMax);
+		const glm::u16vec2 oldMinCoords = oldRange.myMin;
+		const glm::u16vec2 oldMaxCoords = oldRange.myMax;
 
-		const glm::u16vec2 minCoords = GetCellIndices(aMin);
-		const glm::u16vec2 maxCoords = GetCellIndices(aMax);
+		const GridLayout::CellRange range = myLayout.GetCellRange(aMin, aMax);
+		const glm::u16vec2 minCoords = range.myMin;
+		const glm::u16vec2 maxCoords = range.myMax;
 
 		if (oldMinCoords == minCoords && oldMaxCoords == maxCoords)
 		{
@@ -61,7 +142,7 @@ public:
 					{
 						continue;
 					}
-					const uint32_t index = y * myCellCount + x;
+					const uint32_t index = myLayout.GetCellIndex(x, y);
 					RemoveFromCell(index, anItem);
 				}
 			}
@@ -76,7 +157,7 @@ public:
 					{
 						continue;
 					}
-					const uint32_t index = y * myCellCount + x;
+					const uint32_t index = myLayout.GetCellIndex(x, y);
 					AddToCell(index, anItem);
 				}
 			}
@@ -98,10 +179,8 @@ public:
 			std::vector<T>& cell = myGridCells[i];
 			if constexpr (requires(glm::vec2 a) { aFunc(a, a, cell); })
 			{
-				const uint16_t y = i / myCellCount;
-				const uint16_t x = i % myCellCount;
-				const glm::vec2 min = myMin + glm::vec2{ x * myCellSize, y * myCellSize };
-				const glm::vec2 max = min + glm::vec2{ myCellSize };
+				const glm::vec2 min = myLayout.GetCellMin(i);
+				const glm::vec2 max = min + glm::vec2{ myLayout.GetCellSize() };
 				aFunc(min, max, cell);
 			}
 			else
@@ -111,21 +190,171 @@ public:
 		}
 	}
 
+	// Processes cells in parallel, calling aFunc(cellIndex, cell). aFunc must
+	// not modify the grid - cells are independent, but items spanning
+	// multiple cells get visited concurrently
+	template<class TFunc>
+	void ParallelForEachCell(const TFunc& aFunc) const
+	{
+		const uint32_t cellCount = static_cast<uint32_t>(myGridCells.size());
+		tbb::parallel_for(tbb::blocked_range<uint32_t>(0, cellCount),
+			[&](const tbb::blocked_range<uint32_t>& aRange)
+			{
+				for (uint32_t i = aRange.begin(); i < aRange.end(); i++)
+				{
+					aFunc(i, myGridCells[i]);
+				}
+			}
+		);
+	}
+
 	template<class TFunc>
 	void ForEachCell(glm::vec2 aMin, glm::vec2 aMax, TFunc&& aFunc)
 	{
-		const glm::u16vec2 minIndices = GetCellIndices(aMin);
-		const glm::u16vec2 maxIndices = GetCellIndices(aMax);
-		for (uint16_t y = minIndices.y; y <= maxIndices.y; y++)
+		const GridLayout::CellRange range = myLayout.GetCellRange(aMin, aMax);
+		for (uint16_t y = range.myMin.y; y <= range.myMax.y; y++)
 		{
-			for (uint16_t x = minIndices.x; x <= maxIndices.x; x++)
+			for (uint16_t x = range.myMin.x; x <= range.myMax.x; x++)
 			{
-				std::vector<T>& cell = myGridCells[y * myCellCount + x];
+				std::vector<T>& cell = myGridCells[myLayout.GetCellIndex(x, y)];
 				aFunc(cell);
 			}
 		}
 	}
 
+	// Finds up to anOut.size() items closest to aPos, that are closer than aMaxDistance.
+	// Searches in rings of cells around aPos, until a ring can't have anything closer.
+	// aGetPos(item) must return a point within the bounds the item was added with -
+	// items are only checked in the cell of that point, so multi-cell items
+	// aren't reported twice. Results are sorted from closest, returns how many were found
+	template<class TGetPos>
+	uint32_t FindNearest(glm::vec2 aPos, std::span<Nearest> anOut, TGetPos&& aGetPos,
+		float aMaxDistance = std::numeric_limits<float>::max()) const
+	{
+		if (anOut.empty())
+		{
+			return 0;
+		}
+
+		// anOut is kept as a max-heap, so that the furthest found is on top
+		auto IsCloser = [](const Nearest& aLeft, const Nearest& aRight)
+		{
+			return aLeft.myDistanceSq < aRight.myDistanceSq;
+		};
+		const uint32_t maxCount = static_cast<uint32_t>(anOut.size());
+		uint32_t count = 0;
+		float maxDistSq = aMaxDistance < std::numeric_limits<float>::max()
+			? aMaxDistance * aMaxDistance : aMaxDistance;
+		auto CheckCell = [&](uint16_t aX, uint16_t aY)
+		{
+			for (const T& item : myGridCells[myLayout.GetCellIndex(aX, aY)])
+			{
+				const glm::vec2 pos = aGetPos(item);
+				const glm::vec2 delta = pos - aPos;
+				const float distSq = glm::dot(delta, delta);
+				if (distSq >= maxDistSq || myLayout.GetCellCoords(pos) != glm::u16vec2(aX, aY))
+				{
+					continue;
+				}
+
+				if (count == maxCount)
+				{
+					std::pop_heap(anOut.begin(), anOut.end(), IsCloser);
+					count--;
+				}
+				anOut[count++] = { item, distSq };
+				std::push_heap(anOut.begin(), anOut.begin() + count, IsCloser);
+				if (count == maxCount)
+				{
+					maxDistSq = anOut[0].myDistanceSq;
+				}
+			}
+		};
+
+		// rings are nested, so once all cells of a ring are out of reach, 
+		// so are all the cells of outer rings
+		const int32_t cellCount = myLayout.GetCellCount();
+		const glm::ivec2 center(myLayout.GetCellCoords(aPos));
+		for (int32_t ring = 0; ring < cellCount; ring++)
+		{
+			bool isInReach = false;
+			auto VisitCell = [&](int32_t aX, int32_t aY)
+			{
+				if (aX < 0 || aY < 0 || aX >= cellCount || aY >= cellCount)
+				{
+					return;
+				}
+				const uint16_t x = static_cast<uint16_t>(aX);
+				const uint16_t y = static_cast<uint16_t>(aY);
+				if (myLayout.GetCellDistanceSq(x, y, aPos) < maxDistSq)
+				{
+					isInReach = true;
+					CheckCell(x, y);
+				}
+			};
+
+			for (int32_t x = center.x - ring; x <= center.x + ring; x++)
+			{
+				VisitCell(x, center.y - ring);
+				if (ring)
+				{
+					VisitCell(x, center.y + ring);
+				}
+			}
+			for (int32_t y = center.y - ring + 1; y < center.y + ring; y++)
+			{
+				VisitCell(center.x - ring, y);
+				VisitCell(center.x + ring, y);
+			}
+
+			if (!isInReach)
+			{
+				break;
+			}
+		}
+		std::sort_heap(anOut.begin(), anOut.begin() + count, IsCloser);
+		return count;
+	}
+
+	// Finds items within aRadius of aCenter, up to anOut.size() of them.
+	// aGetPos has the same requirements as in FindNearest.
+	// Returns how many were found, in no particular order
+	template<class TGetPos>
+	uint32_t FindInRadius(glm::vec2 aCenter, float aRadius, std::span<T> anOut, TGetPos&& aGetPos) const
+	{
+		const uint32_t maxCount = static_cast<uint32_t>(anOut.size());
+		uint32_t count = 0;
+		const float radiusSq = aRadius * aRadius;
+		const GridLayout::CellRange range = myLayout.GetCellRange(aCenter - glm::vec2{ aRadius }, aCenter + glm::vec2{ aRadius });
+		for (uint16_t y = range.myMin.y; y <= range.myMax.y; y++)
+		{
+			for (uint16_t x = range.myMin.x; x <= range.myMax.x; x++)
+			{
+				if (myLayout.GetCellDistanceSq(x, y, aCenter) > radiusSq)
+				{
+					continue;
+				}
+
+				for (const T& item : myGridCells[myLayout.GetCellIndex(x, y)])
+				{
+					if (count == maxCount)
+					{
+						return count;
+					}
+
+					const glm::vec2 pos = aGetPos(item);
+					const glm::vec2 delta = pos - aCenter;
+					if (glm::dot(delta, delta) <= radiusSq
+						&& myLayout.GetCellCoords(pos) == glm::u16vec2(x, y))
+					{
+						anOut[count++] = item;
+					}
+				}
+			}
+		}
+		return count;
+	}
+
 	void Clear()
 	{
 		for (std::vector<T>& cell : myGridCells)
@@ -135,22 +364,13 @@ public:
 	}
 
 private:
-	// TODO: implement simd to do both min and max in 1 go
-	glm::u16vec2 GetCellIndices(glm::vec2 aPos) const 
-	{  
-		const glm::vec2 offset = aPos - myMin;
-		glm::i32vec2 coords = static_cast<glm::i32vec2>(offset / myCellSize);
-		coords = glm::clamp(coords, glm::i32vec2{ 0 }, glm::i32vec2{ myCellCount - 1 }); 
-		return static_cast<glm::u16vec2>(coords);
-	}
-
 	void AddInternal(glm::u16vec2 aMinCoords, glm::u16vec2 aMaxCoords, T anItem)
 	{
 		for (uint16_t y = aMinCoords.y; y <= aMaxCoords.y; y++)
 		{
 			for (uint16_t x = aMinCoords.x; x <= aMaxCoords.x; x++)
 			{
-				const uint32_t index = y * myCellCount + x;
+				const uint32_t index = myLayout.GetCellIndex(x, y);
 				AddToCell(index, anItem);
 			}
 		}
@@ -167,7 +387,7 @@ private:
 		{
 			for (uint16_t x = aMinCoords.x; x <= aMaxCoords.x; x++)
 			{
-				const uint32_t index = y * myCellCount + x;
+				const uint32_t index = myLayout.GetCellIndex(x, y);
 				RemoveFromCell(index, anItem);
 			}
 		}
@@ -187,10 +407,7 @@ private:
 	}
 
 	std::vector<std::vector<T>> myGridCells;
-	glm::vec2 myMin;
-	float myGridSize;
-	float myCellSize;
-	uint16_t myCellCount;
+	GridLayout myLayout;
 };
 
 #undef GRID_MOVE_OVERLAP
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Grid.h"
+#include "Threading/PerThreadBuffer.h"
+
+#include <span>
+
+// Finds overlapping pairs of items that share a Grid cell, where the first
+// item of a pair is of one kind (e.g. a projectile) and comes before the
+// second one (e.g. a target) in the cell. Cells get checked in parallel, each
+// off of a flat copy of its bounds, so the checks don't chase item pointers.
+// Pairs then get sorted in the order a serial walk over cells would find
+// them, so resolving them in order doesn't depend on thread count
+template<class T>
+class GridOverlaps
+{
+public:
+	enum class Kind : uint8_t
+	{
+		Skip,
+		First,
+		Second
+	};
+
+	struct Bounds
+	{
+		glm::vec3 myMin;
+		glm::vec3 myMax;
+		T myItem;
+		uint32_t myCellOrder;
+		// items of the same group don't pair up
+		uint8_t myGroup;
+	};
+
+	struct Pair
+	{
+		uint32_t myCell;
+		Bounds myFirst;
+		Bounds mySecond;
+	};
+
+	// Finds the pairs in aGrid. aGetBounds(const T&, Bounds&) fills in min, max
+	// and group of an item and returns its Kind. It gets called concurrently,
+	// once per cell the item is in. Pairs stay valid until the next Gather
+	template<class TGetBounds>
+	std::span<const Pair> Gather(const Grid<T>& aGrid, const TGetBounds& aGetBounds)
+	{
+		aGrid.ParallelForEachCell([&](uint32_t aCellIndex, const std::vector<T>& aCell)
+		{
+			if (aCell.size() < 2)
+			{
+				return; // nothing to do
+			}
+
+			CellCache& cache = myCellCaches.local();
+			cache.myFirsts.clear();
+			cache.mySeconds.clear();
+			cache.myPairs.clear();
+			for (uint32_t cellOrder = 0; cellOrder < aCell.size(); cellOrder++)
+			{
+				Bounds bounds;
+				bounds.myItem = aCell[cellOrder];
+				bounds.myCellOrder = cellOrder;
+				const Kind kind = aGetBounds(aCell[cellOrder], bounds);
+				if (kind == Kind::First)
+				{
+					cache.myFirsts.push_back(bounds);
+				}
+				else if (kind == Kind::Second)
+				{
+					cache.mySeconds.push_back(bounds);
+				}
+			}
+
+			// a first item only checks second items that come after it
+			// in the cell, and both lists are sorted by cell order
+			size_t secondStart = 0;
+			for (const Bounds& first : cache.myFirsts)
+			{
+				while (secondStart < cache.mySeconds.size()
+					&& cache.mySeconds[secondStart].myCellOrder < first.myCellOrder)
+				{
+					secondStart++;
+				}
+				for (size_t i = secondStart; i < cache.mySeconds.size(); i++)
+				{
+					const Bounds& second = cache.mySeconds[i];
+					if (first.myGroup == second.myGroup)
+					{
+						continue;
+					}
+
+					const bool overlaps = glm::all(glm::lessThanEqual(second.myMin, first.myMax))
+						&& glm::all(glm::lessThanEqual(first.myMin, second.myMax));
+					if (overlaps)
+					{
+						cache.myPairs.push_back({ aCellIndex, first, second });
+					}
+				}
+			}
+			myPairBuffer.Push(std::span<const Pair>(cache.myPairs));
+		});
+
+		myPairs.clear();
+		myPairBuffer.Consume(myPairs);
+		std::ranges::sort(myPairs, [](const Pair& aLeft, const Pair& aRight) {
+			return std::tie(aLeft.myCell, aLeft.myFirst.myCellOrder, aLeft.mySecond.myCellOrder)
+				< std::tie(aRight.myCell, aRight.myFirst.myCellOrder, aRight.mySecond.myCellOrder);
+		});
+		return myPairs;
+	}
+
+private:
+	struct CellCache
+	{
+		std::vector<Bounds> myFirsts;
+		std::vector<Bounds> mySeconds;
+		std::vector<Pair> myPairs;
+	};
+	tbb::enumerable_thread_specific<CellCache> myCellCaches;
+	PerThreadBuffer<Pair> myPairBuffer;
+	std::vector<Pair> myPairs;
+};
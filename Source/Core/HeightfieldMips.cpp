@@ -0,0 +1,191 @@
+#include "Precomp.h"
+#include "HeightfieldMips.h"
+
+void HeightfieldMips::Build(std::span<const float> aHeights, glm::uvec2 aSize, float aStep)
+{
+	ASSERT_STR(aSize.x >= 2 && aSize.y >= 2, "Heightfield must have at least 1 cell!");
+	ASSERT_STR(aHeights.size() == aSize.x * aSize.y, "Heights don't match the size!");
+	myHeights = aHeights;
+	mySize = aSize;
+	myStep = aStep;
+
+	myLevels.clear();
+	{
+		Level& base = myLevels.emplace_back();
+		base.mySize = aSize - 1u;
+		base.myMinMax.resize(base.mySize.x * base.mySize.y);
+		tbb::parallel_for(0u, base.mySize.y, [&](uint32_t aY)
+		{
+			for (uint32_t x = 0; x < base.mySize.x; x++)
+			{
+				const float heights[]{
+					GetHeight(x, aY),
+					GetHeight(x + 1, aY),
+					GetHeight(x, aY + 1),
+					GetHeight(x + 1, aY + 1)
+				};
+				const auto [min, max] = std::minmax_element(std::begin(heights), std::end(heights));
+				base.myMinMax[aY * base.mySize.x + x] = { *min, *max };
+			}
+		});
+	}
+
+	while (myLevels.back().mySize != glm::uvec2(1))
+	{
+		const Level& prev = myLevels.back();
+		Level next;
+		next.mySize = (prev.mySize + 1u) / 2u;
+		next.myMinMax.resize(next.mySize.x * next.mySize.y);
+		tbb::parallel_for(0u, next.mySize.y, [&](uint32_t aY)
+		{
+			for (uint32_t x = 0; x < next.mySize.x; x++)
+			{
+				// odd sized levels have cells with less than 4 children
+				const uint32_t childXEnd = glm::min(x * 2 + 2, prev.mySize.x);
+				const uint32_t childYEnd = glm::min(aY * 2 + 2, prev.mySize.y);
+				glm::vec2 minMax = prev.myMinMax[aY * 2 * prev.mySize.x + x * 2];
+				for (uint32_t childY = aY * 2; childY < childYEnd; childY++)
+				{
+					for (uint32_t childX = x * 2; childX < childXEnd; childX++)
+					{
+						const glm::vec2 childMinMax = prev.myMinMax[childY * prev.mySize.x + childX];
+						minMax.x = glm::min(minMax.x, childMinMax.x);
+						minMax.y = glm::max(minMax.y, childMinMax.y);
+					}
+				}
+				next.myMinMax[aY * next.mySize.x + x] = minMax;
+			}
+		});
+		myLevels.push_back(std::move(next));
+	}
+}
+
+bool HeightfieldMips::Raycast(const Shapes::Ray& aRay, float aMaxT, float& aRayT) const
+{
+	ASSERT_STR(!myLevels.empty(), "Heightfield mips haven't been built!");
+
+	// avoiding NaNs from 0 * inf in slab tests of axis-aligned rays
+	constexpr auto SafeInverse = [](float aValue)
+	{
+		constexpr float kMinAbs = 1e-20f;
+		return 1.f / (glm::abs(aValue) < kMinAbs ? std::copysign(kMinAbs, aValue) : aValue);
+	};
+	const glm::vec2 origin{ aRay.myOrigin.x, aRay.myOrigin.z };
+	const glm::vec2 dir{ aRay.myDir.x, aRay.myDir.z };
+	const glm::vec2 invDir{ SafeInverse(dir.x), SafeInverse(dir.y) };
+	const glm::uvec2 cellCount = myLevels[0].mySize;
+
+	// clipping the ray to the heightfield's bounds
+	float t;
+	{
+		const glm::vec2 t1 = -origin * invDir;
+		const glm::vec2 t2 = (glm::vec2(cellCount) * myStep - origin) * invDir;
+		t = glm::max(glm::max(glm::min(t1.x, t2.x), glm::min(t1.y, t2.y)), 0.f);
+		aMaxT = glm::min(glm::min(glm::max(t1.x, t2.x), glm::max(t1.y, t2.y)), aMaxT);
+		if (t > aMaxT)
+		{
+			return false;
+		}
+	}
+
+	// Walking the cells the ray passes through, like a 2D DDA, but on the
+	// coarsest level that the ray stays clear of. Descends into a cell when
+	// the ray's height range overlaps its min/max, and goes back up once
+	// the ray leaves the parent cell. Cells are visited in order along the
+	// ray, so the first hit is the closest one
+	const glm::ivec2 stepDir{ dir.x < 0 ? -1 : 1, dir.y < 0 ? -1 : 1 };
+	const glm::uvec2 nextBorder{ dir.x < 0 ? 0u : 1u, dir.y < 0 ? 0u : 1u };
+	auto GetCellAt = [&](float aT, uint8_t aLevel)
+	{
+		const float cellSize = myStep * (1u << aLevel);
+		const glm::vec2 pos = (origin + dir * aT) / cellSize;
+		const glm::vec2 maxCoords = glm::vec2(myLevels[aLevel].mySize - 1u);
+		return glm::uvec2(glm::clamp(pos, glm::vec2(0), maxCoords));
+	};
+
+	uint8_t level = static_cast<uint8_t>(myLevels.size() - 1);
+	glm::uvec2 cell{ 0 };
+	while (true)
+	{
+		const float cellSize = myStep * (1u << level);
+		const glm::vec2 border = glm::vec2(cell + nextBorder) * cellSize;
+		const glm::vec2 tBorder = (border - origin) * invDir;
+		const float tExit = glm::min(tBorder.x, tBorder.y);
+		const float tEnd = glm::min(tExit, aMaxT);
+
+		const float yStart = aRay.myOrigin.y + aRay.myDir.y * t;
+		const float yEnd = aRay.myOrigin.y + aRay.myDir.y * tEnd;
+		const glm::vec2 minMax = GetMinMax(level, cell);
+		if (glm::min(yStart, yEnd) <= minMax.y && glm::max(yStart, yEnd) >= minMax.x)
+		{
+			if (level > 0)
+			{
+				// child is picked by where the ray is, but kept inside
+				// of the current cell in case of rounding errors
+				level--;
+				const glm::uvec2 child = GetCellAt(t, level);
+				cell = glm::clamp(child, cell * 2u, glm::min(cell * 2u + 1u, myLevels[level].mySize - 1u));
+				continue;
+			}
+			if (RaycastCell(aRay, cell, aMaxT, aRayT))
+			{
+				return true;
+			}
+		}
+
+		if (tExit >= aMaxT)
+		{
+			return false;
+		}
+		t = tExit;
+		glm::uvec2 prevCell = cell;
+		if (tBorder.x <= tBorder.y)
+		{
+			cell.x += stepDir.x;
+		}
+		else
+		{
+			cell.y += stepDir.y;
+		}
+		// leaving the heightfield, which also covers wrapping below 0
+		if (cell.x >= myLevels[level].mySize.x || cell.y >= myLevels[level].mySize.y)
+		{
+			return false;
+		}
+		// going back up while the ray has left the parent cell
+		while (level + 1u < myLevels.size() && (prevCell >> 1u) != (cell >> 1u))
+		{
+			prevCell >>= 1u;
+			cell >>= 1u;
+			level++;
+		}
+	}
+}
+
+bool HeightfieldMips::RaycastCell(const Shapes::Ray& aRay, glm::uvec2 aCell, float aMaxT, float& aRayT) const
+{
+	auto GetVertex = [this](uint32_t aX, uint32_t aY)
+	{
+		return glm::vec3{ aX * myStep, GetHeight(aX, aY), aY * myStep };
+	};
+	const glm::vec3 a = GetVertex(aCell.x, aCell.y);
+	const glm::vec3 b = GetVertex(aCell.x + 1, aCell.y);
+	const glm::vec3 c = GetVertex(aCell.x, aCell.y + 1);
+	const glm::vec3 d = GetVertex(aCell.x + 1, aCell.y + 1);
+
+	// wound to face up
+	bool isHit = false;
+	float rayT;
+	if (Shapes::Intersects(aRay, a, c, b, rayT) && rayT >= 0 && rayT <= aMaxT)
+	{
+		aRayT = rayT;
+		aMaxT = rayT;
+		isHit = true;
+	}
+	if (Shapes::Intersects(aRay, c, d, b, rayT) && rayT >= 0 && rayT <= aMaxT)
+	{
+		aRayT = rayT;
+		isHit = true;
+	}
+	return isHit;
+}
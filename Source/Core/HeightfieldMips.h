@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Shapes.h"
+
+#include <span>
+
+// Min/max height pyramid over a heightfield, for quickly skipping over areas
+// a ray can't hit. Level 0 stores min/max of every heightfield cell (quad
+// between 4 neighbouring vertices), every next level merges 2x2 cells of the
+// previous one, until there's 1 cell covering the whole heightfield.
+// Doesn't own the heights, so they must outlive it and be rebuilt on change
+class HeightfieldMips
+{
+public:
+	// aHeights is aSize.x by aSize.y vertices, row by row, vertices
+	// being aStep apart. Vertex (x, y) is at local (x * aStep, y * aStep)
+	void Build(std::span<const float> aHeights, glm::uvec2 aSize, float aStep);
+
+	// Finds the closest point aRay hits the heightfield at, within [0, aMaxT].
+	// aRay is in local space, with Y being up. Heightfield cells are tested as
+	// 2 triangles, same as they're rendered - only hits from above count
+	bool Raycast(const Shapes::Ray& aRay, float aMaxT, float& aRayT) const;
+
+	uint8_t GetLevelCount() const { return static_cast<uint8_t>(myLevels.size()); }
+	// Returns min/max height of cell at aCoords on anLevel
+	glm::vec2 GetMinMax(uint8_t aLevel, glm::uvec2 aCoords) const
+	{
+		const Level& level = myLevels[aLevel];
+		return level.myMinMax[aCoords.y * level.mySize.x + aCoords.x];
+	}
+
+private:
+	struct Level
+	{
+		std::vector<glm::vec2> myMinMax;
+		glm::uvec2 mySize;
+	};
+
+	bool RaycastCell(const Shapes::Ray& aRay, glm::uvec2 aCell, float aMaxT, float& aRayT) const;
+	float GetHeight(uint32_t aX, uint32_t aY) const { return myHeights[aY * mySize.x + aX]; }
+
+	std::vector<Level> myLevels;
+	std::span<const float> myHeights;
+	glm::uvec2 mySize{ 0 };
+	float myStep = 0;
+};
@@ -0,0 +1,245 @@
+#include "Precomp.h"
+#include "HexFlowField.h"
+
+namespace
+{
+	// by row parity, odd rows are shifted right, so their
+	// neighbours above and below are shifted right as well
+	constexpr glm::ivec2 kNeighborOffsets[2][HexFlowField::kDirectionCount]{
+		{ { 1, 0 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 } },
+		{ { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, -1 } }
+	};
+}
+
+HexFlowField::HexFlowField(glm::ivec2 aSize)
+{
+	Resize(aSize);
+}
+
+void HexFlowField::Resize(glm::ivec2 aSize)
+{
+	ASSERT_STR(aSize.x >= 0 && aSize.y >= 0, "Invalid size!");
+	if (aSize == mySize)
+	{
+		return;
+	}
+
+	mySize = aSize;
+	const size_t count = static_cast<size_t>(aSize.x) * aSize.y;
+	myCosts.assign(count, 1);
+	myIntegration.assign(count, kUnreachable);
+	myDirections.assign(count, kNoDirection);
+}
+
+void HexFlowField::SetCost(glm::ivec2 aHex, uint8_t aCost)
+{
+	ASSERT_STR(aCost > 0, "Costs must be positive, otherwise wavefronts can't be expanded in parallel!");
+	myCosts[GetIndex(aHex)] = aCost;
+}
+
+void HexFlowField::Compute(std::span<const glm::ivec2> aTargets)
+{
+	ComputeImpl<false>(aTargets);
+	BuildDirections<false>();
+}
+
+void HexFlowField::ParallelCompute(std::span<const glm::ivec2> aTargets)
+{
+	ComputeImpl<true>(aTargets);
+	BuildDirections<true>();
+}
+
+glm::ivec2 HexFlowField::GetNextHex(glm::ivec2 aHex) const
+{
+	const uint8_t direction = GetDirection(aHex);
+	return direction != kNoDirection ? GetNeighbor(aHex, direction) : aHex;
+}
+
+glm::ivec2 HexFlowField::GetNeighbor(glm::ivec2 aHex, uint8_t aDirection)
+{
+	ASSERT(aDirection < kDirectionCount);
+	return aHex + kNeighborOffsets[aHex.y & 1][aDirection];
+}
+
+template<bool IsParallel>
+void HexFlowField::ComputeImpl(std::span<const glm::ivec2> aTargets)
+{
+	std::fill(myIntegration.begin(), myIntegration.end(), kUnreachable);
+	for (std::vector<uint32_t>& bucket : myBuckets)
+	{
+		bucket.clear();
+	}
+
+	size_t pendingCount = 0;
+	for (glm::ivec2 target : aTargets)
+	{
+		const uint32_t index = GetIndex(target);
+		if (myCosts[index] != kWall && myIntegration[index] != 0)
+		{
+			myIntegration[index] = 0;
+			myBuckets[0].push_back(index);
+			pendingCount++;
+		}
+	}
+
+	// Dial's variant of Dijkstra - with integer costs, hexes get expanded
+	// in buckets of the same integration instead of from a priority queue.
+	// Every step costs at least 1, so expanding a bucket only adds to the
+	// later ones, and all hexes of a bucket can be expanded at once.
+	// Hexes get added again whenever a cheaper way to them is found, so
+	// the older entries get skipped by checking against the integration
+	struct Push
+	{
+		uint32_t myIndex;
+		uint32_t myIntegration;
+	};
+	tbb::enumerable_thread_specific<std::vector<Push>> threadPushes;
+	for (uint32_t integration = 0; pendingCount > 0; integration++)
+	{
+		std::vector<uint32_t>& wavefront = myBuckets[integration % kBucketCount];
+		pendingCount -= wavefront.size();
+
+		auto ExpandHex = [&](uint32_t anIndex, auto& aPushFunc)
+		{
+			// nothing lowers the integration of the hexes being expanded,
+			// steps from this wavefront only reach the later ones
+			if (myIntegration[anIndex] != integration)
+			{
+				return;
+			}
+
+			const glm::ivec2 hex{ static_cast<int>(anIndex) % mySize.x, static_cast<int>(anIndex) / mySize.x };
+			for (const glm::ivec2 offset : kNeighborOffsets[hex.y & 1])
+			{
+				const glm::ivec2 neighbor = hex + offset;
+				if (!IsValid(neighbor))
+				{
+					continue;
+				}
+
+				const uint32_t neighborIndex = neighbor.y * mySize.x + neighbor.x;
+				const uint8_t cost = myCosts[neighborIndex];
+				if (cost == kWall)
+				{
+					continue;
+				}
+
+				const uint32_t newIntegration = integration + cost;
+				if constexpr (IsParallel)
+				{
+					std::atomic_ref<uint32_t> neighborIntegration(myIntegration[neighborIndex]);
+					uint32_t current = neighborIntegration.load(std::memory_order_relaxed);
+					while (newIntegration < current)
+					{
+						if (neighborIntegration.compare_exchange_weak(current, newIntegration, std::memory_order_relaxed))
+						{
+							aPushFunc(neighborIndex, newIntegration);
+							break;
+						}
+					}
+				}
+				else if (newIntegration < myIntegration[neighborIndex])
+				{
+					myIntegration[neighborIndex] = newIntegration;
+					aPushFunc(neighborIndex, newIntegration);
+				}
+			}
+		};
+
+		if constexpr (IsParallel)
+		{
+			// small wavefronts near the targets aren't worth splitting up
+			constexpr size_t kMinHexesPerTask = 512;
+			tbb::parallel_for(tbb::blocked_range<size_t>(0, wavefront.size(), kMinHexesPerTask),
+				[&](const tbb::blocked_range<size_t>& aRange)
+				{
+					std::vector<Push>& pushes = threadPushes.local();
+					auto PushFunc = [&pushes](uint32_t anIndex, uint32_t anIntegration)
+					{
+						pushes.push_back({ anIndex, anIntegration });
+					};
+					for (size_t i = aRange.begin(); i < aRange.end(); i++)
+					{
+						ExpandHex(wavefront[i], PushFunc);
+					}
+				}
+			);
+			wavefront.clear();
+
+			for (std::vector<Push>& pushes : threadPushes)
+			{
+				for (const Push& push : pushes)
+				{
+					myBuckets[push.myIntegration % kBucketCount].push_back(push.myIndex);
+				}
+				pendingCount += pushes.size();
+				pushes.clear();
+			}
+		}
+		else
+		{
+			auto PushFunc = [&](uint32_t anIndex, uint32_t anIntegration)
+			{
+				myBuckets[anIntegration % kBucketCount].push_back(anIndex);
+				pendingCount++;
+			};
+			// the wavefront itself doesn't grow, as every step costs at least 1
+			for (size_t i = 0; i < wavefront.size(); i++)
+			{
+				ExpandHex(wavefront[i], PushFunc);
+			}
+			wavefront.clear();
+		}
+	}
+}
+
+template<bool IsParallel>
+void HexFlowField::BuildDirections()
+{
+	auto BuildRow = [this](int aY)
+	{
+		for (int x = 0; x < mySize.x; x++)
+		{
+			const glm::ivec2 hex{ x, aY };
+			const uint32_t index = aY * mySize.x + x;
+			if (myCosts[index] == kWall)
+			{
+				myDirections[index] = kNoDirection;
+				continue;
+			}
+
+			// ties go to the first of the neighbours, so
+			// serial and parallel results are the same
+			uint32_t lowest = myIntegration[index];
+			uint8_t direction = kNoDirection;
+			for (uint8_t i = 0; i < kDirectionCount; i++)
+			{
+				const glm::ivec2 neighbor = GetNeighbor(hex, i);
+				if (!IsValid(neighbor))
+				{
+					continue;
+				}
+
+				const uint32_t integration = myIntegration[neighbor.y * mySize.x + neighbor.x];
+				if (integration < lowest)
+				{
+					lowest = integration;
+					direction = i;
+				}
+			}
+			myDirections[index] = direction;
+		}
+	};
+
+	if constexpr (IsParallel)
+	{
+		tbb::parallel_for(0, mySize.y, BuildRow);
+	}
+	else
+	{
+		for (int y = 0; y < mySize.y; y++)
+		{
+			BuildRow(y);
+		}
+	}
+}
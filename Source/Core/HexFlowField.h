@@ -0,0 +1,74 @@
+#pragma once
+
+#include <span>
+
+// Flow field over a hex grid, for many units heading to the same targets.
+// Hexes are laid out in rows, with every odd row shifted right by half a
+// hex (same as HexSolver's). Every hex has a cost of stepping out of it,
+// and the integration field holds the total cost of getting from a hex to
+// the closest of the targets. The direction field then points every hex
+// at its neighbour that's closest to a target, so units only have to look
+// up their next hex instead of searching for a path each.
+class HexFlowField
+{
+public:
+	constexpr static uint8_t kWall = 255;
+	constexpr static uint32_t kUnreachable = std::numeric_limits<uint32_t>::max();
+	constexpr static uint8_t kNoDirection = 255;
+	constexpr static uint8_t kDirectionCount = 6;
+
+	// Hexes start out with cost of 1 and no targets to flow to
+	HexFlowField(glm::ivec2 aSize = glm::ivec2{ 0 });
+
+	// Keeps the costs if the size doesn't change, resets them otherwise
+	void Resize(glm::ivec2 aSize);
+	// from 1 to 254, or kWall to make it impassable
+	void SetCost(glm::ivec2 aHex, uint8_t aCost);
+	uint8_t GetCost(glm::ivec2 aHex) const { return myCosts[GetIndex(aHex)]; }
+
+	// Recomputes the integration and direction fields with a Dijkstra
+	// search from all of aTargets at once. Targets on walls are ignored
+	void Compute(std::span<const glm::ivec2> aTargets);
+	// Same as Compute, but the search expands a whole wavefront of hexes
+	// with the same integration at a time in parallel. Results are the same
+	void ParallelCompute(std::span<const glm::ivec2> aTargets);
+
+	// kUnreachable for walls and hexes walled off from all targets
+	uint32_t GetIntegration(glm::ivec2 aHex) const { return myIntegration[GetIndex(aHex)]; }
+	// kNoDirection for targets, walls and unreachable hexes
+	uint8_t GetDirection(glm::ivec2 aHex) const { return myDirections[GetIndex(aHex)]; }
+	// Returns the neighbour to step to, or aHex if there's none
+	glm::ivec2 GetNextHex(glm::ivec2 aHex) const;
+
+	// Neighbours go counter-clockwise (Y being up), starting with +X.
+	// Doesn't check whether the neighbour is within the grid
+	static glm::ivec2 GetNeighbor(glm::ivec2 aHex, uint8_t aDirection);
+	bool IsValid(glm::ivec2 aHex) const
+	{
+		return aHex.x >= 0 && aHex.y >= 0 && aHex.x < mySize.x && aHex.y < mySize.y;
+	}
+	glm::ivec2 GetSize() const { return mySize; }
+
+private:
+	// Costs are at most 254, so hexes waiting to be expanded are never
+	// more than that ahead of the current wavefront, and can be bucketed
+	// by their integration in a ring of buckets
+	constexpr static uint32_t kBucketCount = 256;
+
+	template<bool IsParallel>
+	void ComputeImpl(std::span<const glm::ivec2> aTargets);
+	template<bool IsParallel>
+	void BuildDirections();
+
+	uint32_t GetIndex(glm::ivec2 aHex) const
+	{
+		ASSERT(IsValid(aHex));
+		return aHex.y * mySize.x + aHex.x;
+	}
+
+	std::vector<uint8_t> myCosts;
+	std::vector<uint32_t> myIntegration; // accessed via atomic_ref
+	std::vector<uint8_t> myDirections;
+	std::vector<uint32_t> myBuckets[kBucketCount];
+	glm::ivec2 mySize{ 0 };
+};
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <span>
+#include <xmmintrin.h>
+#include <tbb/parallel_reduce.h>
+
 // This define controls whether QuadTreeBF has support for sparse quads.
 // The benefit is that we save memory, but it comes with a drawback - upredictable
 // quad filling pattern (root quad might be filler 3rd), which can cause cache thrashing.
@@ -28,10 +32,37 @@ class QuadTreeBF
 {
     using Quad = uint32_t;
     static constexpr Quad kInvalidInd = static_cast<Quad>(-1);
+    static constexpr size_t kRayPacketSize = 4;
 
 public:
     using Info = uint32_t;
 
+    struct Entry
+    {
+        glm::vec2 myMin;
+        glm::vec2 myMax;
+        TItem myItem;
+    };
+
+    struct Nearest
+    {
+        TItem myItem;
+        float myDistanceSq;
+    };
+
+    struct Ray
+    {
+        glm::vec2 myOrigin;
+        glm::vec2 myDir;
+        float myMaxT = std::numeric_limits<float>::max();
+    };
+
+    struct RayHit
+    {
+        TItem myItem;
+        float myT;
+    };
+
     QuadTreeBF(glm::vec2 aMin, glm::vec2 aMax, uint8_t aMaxDepth)
         : myRootMin(aMin)
         , myRootMax(aMax)
@@ -44,6 +75,7 @@ public:
     template<bool CanGrow = true>
     [[nodiscard]] Info Add(glm::vec2 aMin, glm::vec2 aMax, TItem anItem)
     {
+        ASSERT_STR(!myIsReadOnly, "Modifying a read-only QuadTree!");
         if constexpr (CanGrow)
         {
             const glm::vec2 size = aMax - aMin;
@@ -73,6 +105,7 @@ public:
 
     void Remove(Info anInfo, TItem anItem)
     {
+        ASSERT_STR(!myIsReadOnly, "Modifying a read-only QuadTree!");
         std::vector<TItem>& cache = myItems[anInfo];
         auto cacheIter = std::ranges::find(cache, anItem);
         ASSERT(cacheIter != cache.end());
@@ -105,6 +138,7 @@ public:
 
     void Clear()
     {
+        ASSERT_STR(!myIsReadOnly, "Modifying a read-only QuadTree!");
 #ifdef QT_SPARSE
         myQuads.clear();
 #endif
@@ -113,8 +147,33 @@ public:
         myDepth = 0;
     }
 
+    // Replaces contents with anEntries in 1 go, which is cheaper than Adding
+    // them one by one. Items get sorted by their quad index - quads of a level
+    // are laid out in Morton order - and then each quad gets filled at once,
+    // reusing quad buffers from the previous contents.
+    // Queries return the same as after Adding anEntries in order. If anInfos
+    // isn't empty it must match anEntries in size, and receives item Infos
+    void Build(std::span<const Entry> anEntries, std::span<Info> anInfos = {})
+    {
+        BuildInternal<false>(anEntries, anInfos);
+    }
+
+    // Same as Build, but computes quad indices and fills quads in parallel
+    void ParallelBuild(std::span<const Entry> anEntries, std::span<Info> anInfos = {})
+    {
+        BuildInternal<true>(anEntries, anInfos);
+    }
+
+    // Read-only mode: Test doesn't modify the tree, so it's safe to call it from
+    // multiple threads at once, as long as nothing modifies the tree in the
+    // meantime. Wrap such concurrent queries with SetReadOnly(true/false) to 
+    // have any modification assert. Note: QT_TELEMETRY counters aren't atomic,
+    // so they'll be off when querying concurrently
+    void SetReadOnly(bool aIsReadOnly) { myIsReadOnly = aIsReadOnly; }
+    bool IsReadOnly() const { return myIsReadOnly; }
+
     template<class TFunc>
-    void Test(glm::vec2 aMin, glm::vec2 aMax, TFunc&& aFunc)
+    void Test(glm::vec2 aMin, glm::vec2 aMax, TFunc&& aFunc) const
     {
         // Processes from deepest to shallowest
         // In theory, this could lead to worse performance if the tree contains
@@ -236,8 +295,129 @@ public:
         }
     }
 
+    // Finds up to anOut.size() items closest to aPos, that are closer than aMaxDistance.
+    // aGetPos(item) must return a point within the bounds the item was added with.
+    // Results are sorted from closest, returns how many were found
+    template<class TGetPos>
+    uint32_t FindNearest(glm::vec2 aPos, std::span<Nearest> anOut, TGetPos&& aGetPos,
+        float aMaxDistance = std::numeric_limits<float>::max()) const
+    {
+        if (anOut.empty())
+        {
+            return 0;
+        }
+
+        // anOut is kept as a max-heap, so that the furthest found is on top
+        auto IsCloser = [](const Nearest& aLeft, const Nearest& aRight)
+        {
+            return aLeft.myDistanceSq < aRight.myDistanceSq;
+        };
+        const uint32_t maxCount = static_cast<uint32_t>(anOut.size());
+        uint32_t count = 0;
+        float maxDistSq = aMaxDistance < std::numeric_limits<float>::max()
+            ? aMaxDistance * aMaxDistance : aMaxDistance;
+        VisitQuadsByDistance(aPos, maxDistSq, [&](const std::vector<TItem>& anItems, float& aMaxDistSq)
+        {
+            for (TItem item : anItems)
+            {
+                QT_TELEM(myTelem.myItemsAccesses++);
+                const glm::vec2 delta = aGetPos(item) - aPos;
+                const float distSq = glm::dot(delta, delta);
+                if (distSq >= aMaxDistSq)
+                {
+                    continue;
+                }
+
+                if (count == maxCount)
+                {
+                    std::pop_heap(anOut.begin(), anOut.end(), IsCloser);
+                    count--;
+                }
+                anOut[count++] = { item, distSq };
+                std::push_heap(anOut.begin(), anOut.begin() + count, IsCloser);
+                if (count == maxCount)
+                {
+                    aMaxDistSq = anOut[0].myDistanceSq;
+                }
+            }
+            return true;
+        });
+        std::sort_heap(anOut.begin(), anOut.begin() + count, IsCloser);
+        return count;
+    }
+
+    // Finds items within aRadius of aCenter, up to anOut.size() of them.
+    // aGetPos(item) must return a point within the bounds the item was added with.
+    // Returns how many were found, in no particular order
+    template<class TGetPos>
+    uint32_t FindInRadius(glm::vec2 aCenter, float aRadius, std::span<TItem> anOut, TGetPos&& aGetPos) const
+    {
+        if (anOut.empty())
+        {
+            return 0;
+        }
+
+        const uint32_t maxCount = static_cast<uint32_t>(anOut.size());
+        uint32_t count = 0;
+        float radiusSq = aRadius * aRadius;
+        VisitQuadsByDistance(aCenter, radiusSq, [&](const std::vector<TItem>& anItems, float aRadiusSq)
+        {
+            for (TItem item : anItems)
+            {
+                QT_TELEM(myTelem.myItemsAccesses++);
+                const glm::vec2 delta = aGetPos(item) - aCenter;
+                if (glm::dot(delta, delta) > aRadiusSq)
+                {
+                    continue;
+                }
+
+                anOut[count++] = item;
+                if (count == maxCount)
+                {
+                    return false;
+                }
+            }
+            return true;
+        });
+        return count;
+    }
+
+    // Casts aRay against the tree, see RaycastBatch
+    template<class TFunc>
+    RayHit Raycast(const Ray& aRay, const TFunc& aFunc) const
+    {
+        RayHit hit;
+        RaycastPacket(std::span<const Ray>(&aRay, 1), std::span<RayHit>(&hit, 1), aFunc);
+        return hit;
+    }
+
+    // Casts aRays against the tree, in packets of 4 rays that walk the quads together,
+    // testing each quad against the whole packet at once. Coherent rays (sharing
+    // an origin or direction) benefit most. aFunc(aRay, anItem, float& aRayT) tests
+    // the item itself, returning true with aRayT >= 0 on hit. aHits receives the
+    // closest hit of each ray before it's myMaxT, or myT of infinity if nothing was hit.
+    // Packets are processed in parallel, so aFunc must be safe to call concurrently
+    template<class TFunc>
+    void RaycastBatch(std::span<const Ray> aRays, std::span<RayHit> aHits, const TFunc& aFunc) const
+    {
+        ASSERT_STR(aRays.size() == aHits.size(), "Hits don't match the rays!");
+        const size_t packetCount = (aRays.size() + kRayPacketSize - 1) / kRayPacketSize;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, packetCount),
+            [&](const tbb::blocked_range<size_t>& aRange)
+            {
+                for (size_t packet = aRange.begin(); packet < aRange.end(); packet++)
+                {
+                    const size_t start = packet * kRayPacketSize;
+                    const size_t count = std::min(kRayPacketSize, aRays.size() - start);
+                    RaycastPacket(aRays.subspan(start, count), aHits.subspan(start, count), aFunc);
+                }
+            }
+        );
+    }
+
     void ResizeForMinSize(float aSize)
     {
+        ASSERT_STR(!myIsReadOnly, "Modifying a read-only QuadTree!");
         // we need to create a Quad that will not be able to
         // fit something of aSize size into one of it's 4 Quads
         uint8_t depth = glm::min(myMaxDepth, GetDepthForSize(aSize, myRootMax.x - myRootMin.x));
@@ -297,6 +477,352 @@ public:
     }
 
 private:
+    template<bool IsParallel>
+    void BuildInternal(std::span<const Entry> anEntries, std::span<Info> anInfos)
+    {
+        ASSERT_STR(!myIsReadOnly, "Modifying a read-only QuadTree!");
+        ASSERT_STR(anInfos.empty() || anInfos.size() == anEntries.size(), "Infos don't match entries!");
+        ASSERT(anEntries.size() < std::numeric_limits<uint32_t>::max());
+        // Not using Clear, to keep item buffers of quads around for reuse
+#ifdef QT_SPARSE
+        myQuads.clear();
+#else
+        myItems.clear();
+#endif
+        myMinSize = std::numeric_limits<float>::max();
+        myDepth = 0;
+        if (anEntries.empty())
+        {
+            myItems.clear();
+            return;
+        }
+
+        myBuildQuads.resize(anEntries.size());
+        auto CalcQuads = [&](size_t aBegin, size_t anEnd)
+        {
+            float minSize = std::numeric_limits<float>::max();
+            for (size_t i = aBegin; i < anEnd; i++)
+            {
+                const Entry& entry = anEntries[i];
+                myBuildQuads[i] = GetIndexForQuad(entry.myMin, entry.myMax, myRootMin, myRootMax, myMaxDepth);
+                const glm::vec2 size = entry.myMax - entry.myMin;
+                minSize = glm::min(minSize, glm::max(size.x, size.y));
+            }
+            return minSize;
+        };
+        float minSize;
+        if constexpr (IsParallel)
+        {
+            minSize = tbb::parallel_reduce(tbb::blocked_range<size_t>(0, anEntries.size()),
+                std::numeric_limits<float>::max(),
+                [&](const tbb::blocked_range<size_t>& aRange, float aMinSize)
+                {
+                    return glm::min(aMinSize, CalcQuads(aRange.begin(), aRange.end()));
+                },
+                [](float aLeft, float aRight) { return glm::min(aLeft, aRight); }
+            );
+        }
+        else
+        {
+            minSize = CalcQuads(0, anEntries.size());
+        }
+        // quad indices don't depend on current depth, so growing
+        // once for the smallest item is the same as growing per Add
+        ResizeForMinSize(minSize);
+
+        // Counting sort by quad index, which is level offset + Morton code, so
+        // quads end up stored level by level in Z-order. It's stable, so items
+        // of a quad keep the order they were passed in
+        const uint32_t quadCount = GetQuadCount(myDepth + 1);
+        myBuildCursors.assign(quadCount, 0);
+        for (uint32_t quad : myBuildQuads)
+        {
+            myBuildCursors[quad]++;
+        }
+        myBuildRuns.clear();
+        uint32_t runStart = 0;
+        for (uint32_t quad = 0; quad < quadCount; quad++)
+        {
+            const uint32_t count = myBuildCursors[quad];
+            if (count)
+            {
+                myBuildRuns.push_back({ quad, runStart });
+                myBuildCursors[quad] = runStart;
+                runStart += count;
+            }
+        }
+        const uint32_t runCount = static_cast<uint32_t>(myBuildRuns.size());
+        myBuildRuns.push_back({ kInvalidInd, runStart });
+
+        myBuildOrder.resize(anEntries.size());
+        for (uint32_t i = 0; i < myBuildQuads.size(); i++)
+        {
+            myBuildOrder[myBuildCursors[myBuildQuads[i]]++] = i;
+        }
+
+#ifdef QT_SPARSE
+        myItems.resize(runCount);
+#endif
+        // quads are independent of each other, so can be filled in any order
+        auto FillQuad = [&](uint32_t aRun)
+        {
+            const BuildRun& run = myBuildRuns[aRun];
+            const uint32_t runEnd = myBuildRuns[aRun + 1].myStart;
+#ifdef QT_SPARSE
+            myQuads[run.myQuad] = aRun;
+            const uint32_t itemsIndex = aRun;
+#else
+            const uint32_t itemsIndex = run.myQuad;
+#endif
+            std::vector<TItem>& items = myItems[itemsIndex];
+            items.clear();
+            items.reserve(runEnd - run.myStart);
+            for (uint32_t i = run.myStart; i < runEnd; i++)
+            {
+                const uint32_t entryIndex = myBuildOrder[i];
+                items.push_back(anEntries[entryIndex].myItem);
+                if (!anInfos.empty())
+                {
+                    anInfos[entryIndex] = itemsIndex;
+                }
+            }
+        };
+        if constexpr (IsParallel)
+        {
+            tbb::parallel_for(uint32_t(0), runCount, FillQuad);
+        }
+        else
+        {
+            for (uint32_t run = 0; run < runCount; run++)
+            {
+                FillQuad(run);
+            }
+        }
+    }
+
+    // Walks quads depth first, visiting closer children first and skipping quads
+    // further from aPos than aMaxDistSq. aFunc(items, aMaxDistSq) gets called for
+    // every visited quad's items, and can tighten aMaxDistSq as it goes. Returning
+    // false from aFunc stops the walk
+    template<class TFunc>
+    void VisitQuadsByDistance(glm::vec2 aPos, float& aMaxDistSq, TFunc&& aFunc) const
+    {
+#ifdef QT_SPARSE
+        if (myQuads.empty())
+#else
+        if (myItems.empty())
+#endif
+        {
+            return;
+        }
+
+        struct QuadRef
+        {
+            glm::u16vec2 myCoords;
+            uint32_t myIndex;
+            float myDistSq;
+            uint8_t myDepth;
+        };
+        // quad coords are 16 bit, so there can't be more than 16 levels.
+        // Every level replaces a quad with it's 4 children on the stack
+        constexpr uint8_t kMaxLevels = 16;
+        std::array<QuadRef, 3 * kMaxLevels + 1> stack;
+        ASSERT(myDepth <= kMaxLevels);
+        uint32_t stackSize = 0;
+        // root quad also stores items outside of the tree's bounds,
+        // so can't have a distance
+        stack[stackSize++] = { { 0, 0 }, 0, 0.f, 0 };
+
+        const float rootSize = myRootMax.x - myRootMin.x;
+        while (stackSize)
+        {
+            const QuadRef quad = stack[--stackSize];
+            if (quad.myDistSq > aMaxDistSq)
+            {
+                continue;
+            }
+
+            QT_TELEM(myTelem.myDepthAccesses++);
+#ifdef QT_SPARSE
+            const uint32_t itemsIndex = myQuads[quad.myIndex];
+            if (itemsIndex != kInvalidInd)
+#else
+            const uint32_t itemsIndex = quad.myIndex;
+#endif
+            {
+                if (!aFunc(myItems[itemsIndex], aMaxDistSq))
+                {
+                    return;
+                }
+            }
+
+            if (quad.myDepth == myDepth)
+            {
+                continue;
+            }
+
+            const uint8_t childDepth = quad.myDepth + 1;
+            const float childSize = rootSize / (1 << childDepth);
+            const uint32_t firstChild = GetQuadCount(childDepth) + (quad.myIndex - GetQuadCount(quad.myDepth)) * 4;
+            const glm::u16vec2 firstCoords(quad.myCoords.x * 2, quad.myCoords.y * 2);
+            const glm::vec2 center = myRootMin + glm::vec2{ (firstCoords.x + 1) * childSize, (firstCoords.y + 1) * childSize };
+            // Z-order, so x is the lower bit. Closest child is the one on aPos's side
+            // of the center, the opposite child is the furthest
+            const uint8_t closest = (aPos.x >= center.x ? 1 : 0) | (aPos.y >= center.y ? 2 : 0);
+            uint8_t order[4]{ closest ^ 3u, closest ^ 1u, closest ^ 2u, closest };
+            QuadRef children[4];
+            for (uint8_t child = 0; child < 4; child++)
+            {
+                const glm::u16vec2 coords(firstCoords.x + (child & 1), firstCoords.y + (child >> 1));
+                const glm::vec2 min = myRootMin + glm::vec2{ coords.x * childSize, coords.y * childSize };
+                const glm::vec2 max = min + glm::vec2{ childSize };
+                const glm::vec2 delta{
+                    glm::max(glm::max(min.x - aPos.x, aPos.x - max.x), 0.f),
+                    glm::max(glm::max(min.y - aPos.y, aPos.y - max.y), 0.f)
+                };
+                children[child] = { coords, firstChild + child, glm::dot(delta, delta), childDepth };
+            }
+            if (children[order[1]].myDistSq < children[order[2]].myDistSq)
+            {
+                std::swap(order[1], order[2]);
+            }
+            // push furthest first, so that closest gets visited next
+            for (uint8_t child : order)
+            {
+                if (children[child].myDistSq <= aMaxDistSq)
+                {
+                    stack[stackSize++] = children[child];
+                }
+            }
+        }
+    }
+
+    // Up to 4 rays, all walking the quads together
+    template<class TFunc>
+    void RaycastPacket(std::span<const Ray> aRays, std::span<RayHit> aHits, const TFunc& aFunc) const
+    {
+        ASSERT(!aRays.empty() && aRays.size() <= kRayPacketSize);
+        // avoiding NaNs from 0 * inf in slab tests of axis-aligned rays
+        constexpr auto SafeInverse = [](float aValue)
+        {
+            constexpr float kMinAbs = 1e-20f;
+            return 1.f / (glm::abs(aValue) < kMinAbs ? std::copysign(kMinAbs, aValue) : aValue);
+        };
+        alignas(16) float originX[kRayPacketSize];
+        alignas(16) float originY[kRayPacketSize];
+        alignas(16) float invDirX[kRayPacketSize];
+        alignas(16) float invDirY[kRayPacketSize];
+        alignas(16) float maxT[kRayPacketSize];
+        for (uint8_t lane = 0; lane < kRayPacketSize; lane++)
+        {
+            // unused lanes repeat the last ray, but get masked out
+            const Ray& ray = aRays[glm::min<size_t>(lane, aRays.size() - 1)];
+            originX[lane] = ray.myOrigin.x;
+            originY[lane] = ray.myOrigin.y;
+            invDirX[lane] = SafeInverse(ray.myDir.x);
+            invDirY[lane] = SafeInverse(ray.myDir.y);
+            maxT[lane] = ray.myMaxT;
+        }
+        for (RayHit& hit : aHits)
+        {
+            hit.myT = std::numeric_limits<float>::infinity();
+        }
+
+#ifdef QT_SPARSE
+        if (myQuads.empty())
+#else
+        if (myItems.empty())
+#endif
+        {
+            return;
+        }
+
+        const int validMask = (1 << aRays.size()) - 1;
+        const __m128 oX = _mm_load_ps(originX);
+        const __m128 oY = _mm_load_ps(originY);
+        const __m128 iDirX = _mm_load_ps(invDirX);
+        const __m128 iDirY = _mm_load_ps(invDirY);
+
+        struct QuadRef
+        {
+            glm::u16vec2 myCoords;
+            uint32_t myIndex;
+            uint8_t myDepth;
+        };
+        // same bounds as in VisitQuadsByDistance
+        constexpr uint8_t kMaxLevels = 16;
+        std::array<QuadRef, 3 * kMaxLevels + 1> stack;
+        ASSERT(myDepth <= kMaxLevels);
+        uint32_t stackSize = 0;
+        stack[stackSize++] = { { 0, 0 }, 0, 0 };
+
+        // walking front to back for the first ray, so that we find close
+        // hits early and can skip quads behind them
+        const uint8_t closestChild = (aRays[0].myDir.x < 0 ? 1 : 0) | (aRays[0].myDir.y < 0 ? 2 : 0);
+        const float rootSize = myRootMax.x - myRootMin.x;
+        while (stackSize)
+        {
+            const QuadRef quad = stack[--stackSize];
+            int mask = validMask;
+            // root quad also stores items outside of the tree's bounds, so always gets visited
+            if (quad.myDepth > 0)
+            {
+                const float size = rootSize / (1 << quad.myDepth);
+                const glm::vec2 min = myRootMin + glm::vec2{ quad.myCoords.x * size, quad.myCoords.y * size };
+                const __m128 t1X = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.x), oX), iDirX);
+                const __m128 t2X = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.x + size), oX), iDirX);
+                const __m128 t1Y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.y), oY), iDirY);
+                const __m128 t2Y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.y + size), oY), iDirY);
+                __m128 tNear = _mm_max_ps(_mm_min_ps(t1X, t2X), _mm_min_ps(t1Y, t2Y));
+                tNear = _mm_max_ps(tNear, _mm_setzero_ps());
+                __m128 tFar = _mm_min_ps(_mm_max_ps(t1X, t2X), _mm_max_ps(t1Y, t2Y));
+                tFar = _mm_min_ps(tFar, _mm_load_ps(maxT));
+                mask &= _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+                if (!mask)
+                {
+                    continue;
+                }
+            }
+
+#ifdef QT_SPARSE
+            const uint32_t itemsIndex = myQuads[quad.myIndex];
+            if (itemsIndex != kInvalidInd)
+#else
+            const uint32_t itemsIndex = quad.myIndex;
+#endif
+            {
+                for (TItem item : myItems[itemsIndex])
+                {
+                    for (uint8_t lane = 0; lane < aRays.size(); lane++)
+                    {
+                        float rayT;
+                        if ((mask & (1 << lane)) && aFunc(aRays[lane], item, rayT) && rayT < maxT[lane])
+                        {
+                            maxT[lane] = rayT;
+                            aHits[lane] = { item, rayT };
+                        }
+                    }
+                }
+            }
+
+            if (quad.myDepth == myDepth)
+            {
+                continue;
+            }
+
+            const uint8_t childDepth = quad.myDepth + 1;
+            const uint32_t firstChild = GetQuadCount(childDepth) + (quad.myIndex - GetQuadCount(quad.myDepth)) * 4;
+            // pushing furthest first, so that closest gets visited next
+            for (int8_t i = 3; i >= 0; i--)
+            {
+                // Z-order, so x is the lower bit
+                const uint8_t child = closestChild ^ i;
+                const glm::u16vec2 coords(quad.myCoords.x * 2 + (child & 1), quad.myCoords.y * 2 + (child >> 1));
+                stack[stackSize++] = { coords, firstChild + child, childDepth };
+            }
+        }
+    }
+
     static std::pair<uint32_t, uint8_t> GetIndexAndDepthForQuad(glm::vec2 aMin, glm::vec2 aMax, glm::vec2 aRootMin, glm::vec2 aRootMax, uint8_t aMaxDepth)
     {
         // bounds check
@@ -433,6 +959,17 @@ private:
     float myMinSize = std::numeric_limits<float>::max();
     uint8_t myDepth = 0;
     uint8_t myMaxDepth;
+    bool myIsReadOnly = false;
+    // Build scratch, kept around to avoid reallocating on every rebuild
+    struct BuildRun
+    {
+        uint32_t myQuad;
+        uint32_t myStart;
+    };
+    std::vector<uint32_t> myBuildQuads;
+    std::vector<uint32_t> myBuildCursors;
+    std::vector<uint32_t> myBuildOrder;
+    std::vector<BuildRun> myBuildRuns;
 #ifdef QT_TELEMETRY
 public:
     struct Telemetry
@@ -440,7 +977,7 @@ public:
         uint32_t myItemsAccesses = 0;
         uint32_t myDepthAccesses = 0;
     };
-    Telemetry myTelem;
+    mutable Telemetry myTelem;
 private:
 #endif
 
@@ -552,19 +1089,46 @@ public:
         {
             infos[i] = tree.Add(items[i].myMin, items[i].myMax, i);
         }
+
+        // bulk built tree should give out same results, in same order
+        QuadTreeBF<uint8_t>::Entry entries[std::size(items)];
+        for (uint8_t i = 0; i < std::size(items); i++)
+        {
+            entries[i] = { items[i].myMin, items[i].myMax, i };
+        }
+        QuadTreeBF<uint8_t> builtTree({ -5, -5 }, { 5, 5 }, kMaxDepth);
+        QuadTreeBF<uint8_t>::Info builtInfos[std::size(items)];
+        builtTree.ParallelBuild(entries, builtInfos);
+        builtTree.SetReadOnly(true);
+
+        std::vector<uint8_t> found;
+        std::vector<uint8_t> builtFound;
         for (float y = -6; y <= 6; y += 0.5f)
         {
             for (float x = -6; x <= 6; x += 0.5f)
             {
-                uint8_t found = 0;
+                found.clear();
                 tree.Test({ x, y }, { x + 0.05f, y + 0.05f }, [&](uint8_t anIndex) 
                 {
-                    found++;
+                    found.push_back(anIndex);
                     return true;
                 });
-                ASSERT(found);
+                ASSERT(!found.empty());
+
+                builtFound.clear();
+                builtTree.Test({ x, y }, { x + 0.05f, y + 0.05f }, [&](uint8_t anIndex)
+                {
+                    builtFound.push_back(anIndex);
+                    return true;
+                });
+                ASSERT(found == builtFound);
             }
         }
+        builtTree.SetReadOnly(false);
+        for (uint8_t i = 0; i < std::size(items); i++)
+        {
+            builtTree.Remove(builtInfos[i], i);
+        }
     }
 };
 
@@ -1,16 +1,33 @@
 #include "Precomp.h"
 #include "RefCounted.h"
 
-RefCounted::RefCounted()
+RefCounted::RefCounted(RefPolicy aPolicy /* = RefPolicy::Atomic */)
 	: myCounter(0)
+	, myPolicy(aPolicy)
+#ifdef ENABLE_ASSERTS
+	, myOwnerThread(std::this_thread::get_id())
+#endif
 {
 }
 
 void RefCounted::RemoveRef()
 {
-	if (myCounter.fetch_sub(1) == 1)
+	uint32_t prevCount;
+	if (myPolicy == RefPolicy::ThreadConfined)
+	{
+		ASSERT_STR(myOwnerThread == std::this_thread::get_id(), "Thread confined object shared with another thread!");
+		prevCount = myCounter.load(std::memory_order_relaxed);
+		myCounter.store(prevCount - 1, std::memory_order_relaxed);
+	}
+	else
+	{
+		prevCount = myCounter.fetch_sub(1);
+	}
+
+	if (prevCount == 1)
 	{
 		// we just got rid of the last reference, so time to self-destruct
+		ASSERT_STR(myBorrowCount == 0, "Destroying an object that is still borrowed!");
 		Cleanup();
 	}
 }
\ No newline at end of file
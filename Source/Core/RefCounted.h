@@ -16,7 +16,16 @@
 class RefCounted
 {
 public:
-	RefCounted();
+	// Atomic is safe to share between threads. ThreadConfined skips
+	// the locked instructions, but all Handles of the object must be
+	// created and destroyed on the thread that constructed it
+	enum class RefPolicy : uint8_t
+	{
+		Atomic,
+		ThreadConfined
+	};
+
+	RefCounted(RefPolicy aPolicy = RefPolicy::Atomic);
 	virtual ~RefCounted() {}
 
 private:
@@ -24,7 +33,21 @@ private:
 	// Handle<T> support
 	template<typename T>
 	friend class Handle;
-	void AddRef() {	myCounter++; }
+	template<typename T>
+	friend class BorrowedHandle;
+
+	void AddRef() 
+	{
+		if (myPolicy == RefPolicy::ThreadConfined)
+		{
+			ASSERT_STR(myOwnerThread == std::this_thread::get_id(), "Thread confined object shared with another thread!");
+			myCounter.store(myCounter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+		else
+		{
+			myCounter++;
+		}
+	}
 	void RemoveRef();
 	uint32_t GetRefCount() const { return myCounter; }
 	// ==========================
@@ -32,6 +55,12 @@ private:
 private:
 	virtual void Cleanup() { delete this; }
 	std::atomic<uint32_t> myCounter;
+	RefPolicy myPolicy;
+#ifdef ENABLE_ASSERTS
+	std::thread::id myOwnerThread;
+	// tracks live BorrowedHandles, to catch destruction while borrowed
+	std::atomic<uint32_t> myBorrowCount = 0;
+#endif
 };
 
 // =======================================================
@@ -101,6 +130,26 @@ public:
 		return *this;
 	}
 
+	Handle& operator=(Handle&& aHandle) noexcept
+	{
+		if (this == &aHandle)
+		{
+			return *this;
+		}
+
+#ifdef HANDLE_HEAVY_DEBUG
+		AssertWriteLock ourLock(myDebugMutex);
+		AssertWriteLock theirLock(aHandle.myDebugMutex);
+#endif
+		if (myObject)
+		{
+			myObject->RemoveRef();
+		}
+		myObject = aHandle.myObject;
+		aHandle.myObject = nullptr;
+		return *this;
+	}
+
 	// Accessor of internal object casted to type of handle
 	T* Get() 
 	{
@@ -193,6 +242,9 @@ private:
 	template<class TOther>
 	friend class Handle;
 
+	template<class TOther>
+	friend class BorrowedHandle;
+
 	RefCounted* myObject;
 #ifdef HANDLE_HEAVY_DEBUG
 	mutable AssertRWMutex myDebugMutex;
@@ -204,4 +256,78 @@ bool operator==(const Handle<T1>& aLeft, const Handle<T2>& aRight)
 {
 	static_assert(std::is_base_of_v<T2, T1>, "Invalid comparison - unrelated types!");
 	return aLeft.myObject == aRight.myObject;
-}
\ No newline at end of file
+}
+
+// =======================================================
+
+// A non-owning view of a Handle-managed object, for frame-scoped access
+// (render passes, systems) where something else is known to keep the
+// object alive. Copying it doesn't touch the ref count, so it costs the
+// same as a raw pointer. In assert-enabled builds it registers itself with
+// the object, so destroying a still borrowed object asserts
+template<class T>
+class BorrowedHandle
+{
+public:
+	BorrowedHandle() = default;
+
+	template<class TOther> requires std::is_base_of_v<T, TOther>
+	BorrowedHandle(const Handle<TOther>& aHandle)
+		: myObject(aHandle.myObject)
+	{
+		Borrow();
+	}
+
+	BorrowedHandle(const BorrowedHandle& aHandle)
+		: myObject(aHandle.myObject)
+	{
+		Borrow();
+	}
+
+	BorrowedHandle& operator=(const BorrowedHandle& aHandle)
+	{
+		Release();
+		myObject = aHandle.myObject;
+		Borrow();
+		return *this;
+	}
+
+	~BorrowedHandle()
+	{
+		Release();
+	}
+
+	T* Get() { return static_cast<T*>(myObject); }
+	const T* Get() const { return static_cast<const T*>(myObject); }
+	bool IsValid() const { return myObject != nullptr; }
+
+	T* operator->() { return Get(); }
+	const T* operator->() const { return Get(); }
+
+	// Promotes back to a shared-ownership Handle
+	Handle<T> Lock() const { return Handle<T>(myObject); }
+
+private:
+	void Borrow()
+	{
+#ifdef ENABLE_ASSERTS
+		if (myObject)
+		{
+			ASSERT_STR(myObject->GetRefCount() > 0, "Borrowing an object that isn't owned by anything!");
+			myObject->myBorrowCount++;
+		}
+#endif
+	}
+
+	void Release()
+	{
+#ifdef ENABLE_ASSERTS
+		if (myObject)
+		{
+			myObject->myBorrowCount--;
+		}
+#endif
+	}
+
+	RefCounted* myObject = nullptr;
+};
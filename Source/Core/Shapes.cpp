@@ -161,100 +161,51 @@ namespace Shapes
 		return sqrDist <= aRadius * aRadius;
 	}
 
-	// TODO: implement "Fast 3D Triangle-Box Overlap Testing" version and test it
-	// https://fileadmin.cs.lth.se/cs/Personal/Tomas_Akenine-Moller/code/tribox_tam.pdf
+	// Based on "Fast 3D Triangle-Box Overlap Testing", Tomas Akenine-Moller, 2001
+	// Same separating axes as a generic SAT, but with the box moved to the origin
+	// its projection on an axis is just the radius of its half-size along it
 	bool Intersects(glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3, const AABB& aBox)
 	{
-		auto ProjectTriangle = [=](glm::vec3 anAxis) {
-			const float proj[]{
-				glm::dot(anAxis, aV1),
-				glm::dot(anAxis, aV2),
-				glm::dot(anAxis, aV3)
-			};
-
-			glm::vec2 result; // min, max
-			result.x = proj[0];
-			result.y = result.x;
-
-			for (uint8_t i = 1; i < 3; i++)
-			{
-				result.x = glm::min(result.x, proj[i]);
-				result.y = glm::max(result.y, proj[i]);
-			}
-			return result;
-		};
-
-		auto ProjectAABB = [=](glm::vec3 anAxis) {
-			const glm::vec3 size = aBox.myMax - aBox.myMin;
-			const glm::vec3 vertices[]{
-				// bottom
-				aBox.myMin,
-				aBox.myMin + glm::vec3{size.x, 0, 0},
-				aBox.myMin + glm::vec3{0, 0, size.z},
-				aBox.myMin + glm::vec3{size.x, 0, size.z},
-
-				// top
-				aBox.myMin + glm::vec3{0, size.y, 0},
-				aBox.myMin + glm::vec3{size.x, size.y, 0},
-				aBox.myMin + glm::vec3{0, size.y, size.z},
-				aBox.myMax
-			};
-
-			const float proj[]{
-				glm::dot(anAxis, vertices[0]),
-				glm::dot(anAxis, vertices[1]),
-				glm::dot(anAxis, vertices[2]),
-				glm::dot(anAxis, vertices[3]),
-				glm::dot(anAxis, vertices[4]),
-				glm::dot(anAxis, vertices[5]),
-				glm::dot(anAxis, vertices[6]),
-				glm::dot(anAxis, vertices[7])
-			};
-
-			glm::vec2 result; // min, max
-			result.x = proj[0];
-			result.y = result.x;
-
-			for (uint8_t i = 1; i < 8; i++)
-			{
-				result.x = glm::min(result.x, proj[i]);
-				result.y = glm::max(result.y, proj[i]);
-			}
-			return result;
+		const glm::vec3 center = (aBox.myMin + aBox.myMax) * 0.5f;
+		const glm::vec3 halfSize = (aBox.myMax - aBox.myMin) * 0.5f;
+		const glm::vec3 v1 = aV1 - center;
+		const glm::vec3 v2 = aV2 - center;
+		const glm::vec3 v3 = aV3 - center;
+
+		auto IsSeparating = [&](glm::vec3 anAxis) {
+			const float p1 = glm::dot(anAxis, v1);
+			const float p2 = glm::dot(anAxis, v2);
+			const float p3 = glm::dot(anAxis, v3);
+			const float radius = glm::dot(halfSize, glm::abs(anAxis));
+			return glm::min(p1, glm::min(p2, p3)) > radius
+				|| glm::max(p1, glm::max(p2, p3)) < -radius;
 		};
 
-		const glm::vec3 right{ 1, 0, 0 };
-		const glm::vec3 up{ 0, 1, 0 };
-		const glm::vec3 forward{ 0, 0, 1 };
-
-		const glm::vec3 f1 = aV2 - aV1;
-		const glm::vec3 f2 = aV3 - aV2;
-		const glm::vec3 f3 = aV1 - aV3;
-
-		const glm::vec3 axes[]{
-			{1, 0, 0},
-			{0, 1, 0},
-			{0, 0, 1},
-			glm::cross(f1, f2),
-			glm::cross(right, f1),
-			glm::cross(right, f2),
-			glm::cross(right, f3),
-			glm::cross(up, f1),
-			glm::cross(up, f2),
-			glm::cross(up, f3),
-			glm::cross(forward, f1),
-			glm::cross(forward, f2),
-			glm::cross(forward, f3)
-		};
+		// box's normals, same as testing triangle's bounds against the box
+		const glm::vec3 triMin = glm::min(v1, glm::min(v2, v3));
+		const glm::vec3 triMax = glm::max(v1, glm::max(v2, v3));
+		if (glm::any(glm::greaterThan(triMin, halfSize))
+			|| glm::any(glm::lessThan(triMax, -halfSize)))
+		{
+			return false;
+		}
 
-		for (glm::vec3 axis : axes)
+		// triangle's normal
+		const glm::vec3 f1 = v2 - v1;
+		const glm::vec3 f2 = v3 - v2;
+		const glm::vec3 f3 = v1 - v3;
+		const glm::vec3 normal = glm::cross(f1, f2);
+		if (glm::abs(glm::dot(normal, v1)) > glm::dot(halfSize, glm::abs(normal)))
 		{
-			const glm::vec2 aabbProj = ProjectAABB(axis);
-			const glm::vec2 triangleProj = ProjectTriangle(axis);
+			return false;
+		}
 
-			const bool overlaps = triangleProj.x <= aabbProj.y
-				&& aabbProj.x <= triangleProj.y;
-			if (!overlaps)
+		// cross products of box's normals and triangle's edges
+		for (glm::vec3 edge : { f1, f2, f3 })
+		{
+			if (IsSeparating({ 0, -edge.z, edge.y })
+				|| IsSeparating({ edge.z, 0, -edge.x })
+				|| IsSeparating({ -edge.y, edge.x, 0 }))
 			{
 				return false;
 			}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <span>
+
+// An append-only buffer where every thread writes into its own slot, so
+// producers never contend with each other. Consume swaps out contents of
+// every slot, so threads can keep pushing while it's consuming - those
+// items will get picked up by the next Consume.
+// Slot locks are only ever contended by Consume. Consume itself must not
+// be called from multiple threads at the same time.
+template<class T>
+class PerThreadBuffer
+{
+public:
+	void Push(const T& anItem)
+	{
+		Slot& slot = mySlots.local();
+		tbb::spin_mutex::scoped_lock lock(slot.myLock);
+		slot.myWriteItems.push_back(anItem);
+	}
+
+	void Push(std::span<const T> anItems)
+	{
+		Slot& slot = mySlots.local();
+		tbb::spin_mutex::scoped_lock lock(slot.myLock);
+		slot.myWriteItems.insert(slot.myWriteItems.end(), anItems.begin(), anItems.end());
+	}
+
+	// Appends everything pushed so far to anItems, in per-thread push order
+	void Consume(std::vector<T>& anItems)
+	{
+		for (Slot& slot : mySlots)
+		{
+			{
+				tbb::spin_mutex::scoped_lock lock(slot.myLock);
+				std::swap(slot.myWriteItems, slot.myReadItems);
+			}
+			anItems.insert(anItems.end(),
+				std::make_move_iterator(slot.myReadItems.begin()),
+				std::make_move_iterator(slot.myReadItems.end())
+			);
+			// keeping the capacity for next time
+			slot.myReadItems.clear();
+		}
+	}
+
+	void Clear()
+	{
+		for (Slot& slot : mySlots)
+		{
+			tbb::spin_mutex::scoped_lock lock(slot.myLock);
+			slot.myWriteItems.clear();
+		}
+	}
+
+private:
+	struct Slot
+	{
+		tbb::spin_mutex myLock;
+		std::vector<T> myWriteItems;
+		std::vector<T> myReadItems;
+	};
+	tbb::enumerable_thread_specific<Slot> mySlots;
+};
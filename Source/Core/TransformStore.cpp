@@ -0,0 +1,525 @@
+#include "Precomp.h"
+#include "TransformStore.h"
+
+#include "Profiler.h"
+
+TransformStore::Id TransformStore::Add(const Transform& aLocal, Id aParent /* = kInvalidId */,
+	void* anOwner /* = nullptr */)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	Slot slot;
+	if (!myFreeSlots.empty())
+	{
+		slot = myFreeSlots.back();
+		myFreeSlots.pop_back();
+	}
+	else
+	{
+		slot = static_cast<Slot>(myParents.size());
+		myLocalPos.emplace_back();
+		myLocalRot.emplace_back();
+		myLocalScale.emplace_back();
+		myWorldPos.emplace_back();
+		myWorldRot.emplace_back();
+		myWorldScale.emplace_back();
+		myParents.emplace_back();
+		mySlotIds.emplace_back();
+	}
+
+	Id id;
+	if (!myFreeIds.empty())
+	{
+		id = myFreeIds.back();
+		myFreeIds.pop_back();
+	}
+	else
+	{
+		id = static_cast<Id>(myIdSlots.size());
+		myIdSlots.emplace_back();
+		myOwners.emplace_back();
+		myDirtyFlags.emplace_back();
+	}
+
+	myLocalPos[slot] = aLocal.GetPos();
+	myLocalRot[slot] = aLocal.GetRotation();
+	myLocalScale[slot] = aLocal.GetScale();
+	myParents[slot] = aParent != kInvalidId ? GetSlot(aParent) : kInvalidSlot;
+	mySlotIds[slot] = id;
+	myIdSlots[id] = slot;
+	myOwners[id] = anOwner;
+	myDirtyFlags[id] = 0;
+	CalcWorld(slot);
+
+	myCount++;
+	myNeedsSort = true;
+	// let the owner know about the initial state as well
+	AddDirty(id);
+	return id;
+}
+
+void TransformStore::Remove(Id anId)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	const Slot slot = GetSlot(anId);
+	mySlotIds[slot] = kInvalidId;
+	myParents[slot] = kInvalidSlot;
+	myFreeSlots.push_back(slot);
+
+	// might still be in the dirty lists, but these will
+	// get skipped since the flag is cleared
+	myIdSlots[anId] = kInvalidSlot;
+	myOwners[anId] = nullptr;
+	myDirtyFlags[anId] = 0;
+	myFreeIds.push_back(anId);
+
+	myCount--;
+	myNeedsSort = true;
+}
+
+void TransformStore::Reserve(size_t aCount)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	myLocalPos.reserve(aCount);
+	myLocalRot.reserve(aCount);
+	myLocalScale.reserve(aCount);
+	myWorldPos.reserve(aCount);
+	myWorldRot.reserve(aCount);
+	myWorldScale.reserve(aCount);
+	myParents.reserve(aCount);
+	mySlotIds.reserve(aCount);
+	myIdSlots.reserve(aCount);
+	myOwners.reserve(aCount);
+	myDirtyFlags.reserve(aCount);
+}
+
+TransformStore::Id TransformStore::GetParent(Id anId) const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	const Slot parent = myParents[GetSlot(anId)];
+	return parent != kInvalidSlot ? mySlotIds[parent] : kInvalidId;
+}
+
+void TransformStore::SetParent(Id anId, Id aParent)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	ASSERT_STR(anId != aParent, "Transform can't be its own parent!");
+	myParents[GetSlot(anId)] = aParent != kInvalidId ? GetSlot(aParent) : kInvalidSlot;
+	myNeedsSort = true;
+	AddDirty(anId);
+}
+
+void* TransformStore::GetOwner(Id anId) const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	ASSERT_STR(anId < myOwners.size(), "Invalid transform id: {}!", anId);
+	return myOwners[anId];
+}
+
+Transform TransformStore::GetLocal(Id anId) const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	const Slot slot = GetSlot(anId);
+	return { myLocalPos[slot], myLocalRot[slot], myLocalScale[slot] };
+}
+
+void TransformStore::SetLocal(Id anId, const Transform& aLocal)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	const Slot slot = GetSlot(anId);
+	myLocalPos[slot] = aLocal.GetPos();
+	myLocalRot[slot] = aLocal.GetRotation();
+	myLocalScale[slot] = aLocal.GetScale();
+	AddDirty(anId);
+}
+
+Transform TransformStore::GetWorld(Id anId) const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	const Slot slot = GetSlot(anId);
+	return { myWorldPos[slot], myWorldRot[slot], myWorldScale[slot] };
+}
+
+void TransformStore::SetWorld(Id anId, const Transform& aWorld)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	const Slot slot = GetSlot(anId);
+	myWorldPos[slot] = aWorld.GetPos();
+	myWorldRot[slot] = aWorld.GetRotation();
+	myWorldScale[slot] = aWorld.GetScale();
+
+	const Slot parent = myParents[slot];
+	if (parent == kInvalidSlot)
+	{
+		myLocalPos[slot] = myWorldPos[slot];
+		myLocalRot[slot] = myWorldRot[slot];
+		myLocalScale[slot] = myWorldScale[slot];
+	}
+	else
+	{
+		// reverse of CalcWorld
+		const glm::quat invParentRot = glm::inverse(myWorldRot[parent]);
+		const glm::vec3 parentScale = myWorldScale[parent];
+		myLocalPos[slot] = invParentRot * ((myWorldPos[slot] - myWorldPos[parent]) / parentScale);
+		myLocalRot[slot] = invParentRot * myWorldRot[slot];
+		myLocalScale[slot] = myWorldScale[slot] / parentScale;
+	}
+	AddDirty(anId);
+}
+
+glm::mat4 TransformStore::GetWorldMatrix(Id anId) const
+{
+	return GetWorld(anId).GetMatrix();
+}
+
+void TransformStore::UpdateWorld(Id anId)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+
+	CalcWorld(GetSlot(anId));
+}
+
+void TransformStore::MarkDirty(Id anId)
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+	AddDirty(anId);
+}
+
+void TransformStore::AddDirty(Id anId)
+{
+	// Note: expects either a shared or an exclusive lock to be held by
+	// the caller. The flag guarantees an id gets added only once
+	ASSERT_STR(anId < myDirtyFlags.size(), "Invalid transform id: {}!", anId);
+	if (std::atomic_ref<uint8_t>(myDirtyFlags[anId]).exchange(1, std::memory_order_relaxed) == 0)
+	{
+		myDirtyIds.local().push_back(anId);
+	}
+}
+
+void TransformStore::Propagate()
+{
+	Profiler::ScopedMark scope("TransformStore::Propagate");
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	if (myNeedsSort)
+	{
+		SortByDepth();
+	}
+	PropagateAll();
+}
+
+void TransformStore::PropagateDirty(std::vector<Id>& anUpdated)
+{
+	Profiler::ScopedMark scope("TransformStore::PropagateDirty");
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, true);
+
+	if (myNeedsSort)
+	{
+		SortByDepth();
+	}
+
+	anUpdated.clear();
+	std::vector<Slot> dirtySlots;
+	for (std::vector<Id>& dirtyIds : myDirtyIds)
+	{
+		for (Id id : dirtyIds)
+		{
+			if (myDirtyFlags[id])
+			{
+				myDirtyFlags[id] = 0;
+				dirtySlots.push_back(myIdSlots[id]);
+			}
+		}
+		dirtyIds.clear();
+	}
+
+	if (dirtySlots.empty())
+	{
+		return;
+	}
+
+	if (dirtySlots.size() * kFullPropagateRatio >= myCount)
+	{
+		PropagateAll();
+		anUpdated.assign(mySlotIds.begin(), mySlotIds.end());
+		return;
+	}
+
+	// Since slots are sorted by depth, and children of a range form a range,
+	// we can go level by level, only keeping track of ranges to update
+	std::sort(dirtySlots.begin(), dirtySlots.end());
+	using Range = std::pair<Slot, Slot>;
+	std::vector<Range> ranges;
+	std::vector<Range> childRanges;
+	size_t dirtyInd = 0;
+	for (size_t level = 0; level + 1 < myLevelStarts.size(); level++)
+	{
+		const Slot levelEnd = myLevelStarts[level + 1];
+		for (; dirtyInd < dirtySlots.size() && dirtySlots[dirtyInd] < levelEnd; dirtyInd++)
+		{
+			ranges.emplace_back(dirtySlots[dirtyInd], dirtySlots[dirtyInd] + 1);
+		}
+
+		if (ranges.empty())
+		{
+			if (dirtyInd == dirtySlots.size())
+			{
+				break;
+			}
+			continue;
+		}
+
+		// dirty slots can be inside of descendant ranges, so merge them together
+		std::sort(ranges.begin(), ranges.end());
+		size_t lastMerged = 0;
+		size_t levelCount = 0;
+		for (size_t rangeInd = 1; rangeInd < ranges.size(); rangeInd++)
+		{
+			Range& merged = ranges[lastMerged];
+			if (ranges[rangeInd].first <= merged.second)
+			{
+				merged.second = std::max(merged.second, ranges[rangeInd].second);
+			}
+			else
+			{
+				levelCount += merged.second - merged.first;
+				ranges[++lastMerged] = ranges[rangeInd];
+			}
+		}
+		levelCount += ranges[lastMerged].second - ranges[lastMerged].first;
+		ranges.resize(lastMerged + 1);
+
+		constexpr Slot kGrainSize = 4096;
+		auto calcRange = [this](Range aRange) {
+			for (Slot slot = aRange.first; slot < aRange.second; slot++)
+			{
+				CalcWorld(slot);
+			}
+		};
+		if (levelCount < kGrainSize)
+		{
+			std::for_each(ranges.begin(), ranges.end(), calcRange);
+		}
+		else
+		{
+			// isolated for the same reason as in PropagateAll
+			tbb::this_task_arena::isolate([&] {
+				tbb::parallel_for(tbb::blocked_range<size_t>(0, ranges.size()),
+					[&](const tbb::blocked_range<size_t>& aRangeInds) {
+					for (size_t rangeInd = aRangeInds.begin(); rangeInd < aRangeInds.end(); rangeInd++)
+					{
+						const Range range = ranges[rangeInd];
+						if (range.second - range.first < kGrainSize)
+						{
+							calcRange(range);
+							continue;
+						}
+
+						tbb::parallel_for(tbb::blocked_range<Slot>(range.first, range.second, kGrainSize),
+							[&](const tbb::blocked_range<Slot>& aSlots) {
+							calcRange({ aSlots.begin(), aSlots.end() });
+						});
+					}
+				});
+			});
+		}
+
+		childRanges.clear();
+		for (const Range& range : ranges)
+		{
+			anUpdated.insert(anUpdated.end(), mySlotIds.begin() + range.first, mySlotIds.begin() + range.second);
+
+			const Range children{ myChildStarts[range.first], myChildStarts[range.second] };
+			if (children.first != children.second)
+			{
+				childRanges.push_back(children);
+			}
+		}
+		ranges.swap(childRanges);
+	}
+}
+
+size_t TransformStore::GetCount() const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+	return myCount;
+}
+
+size_t TransformStore::GetDepthCount() const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+	return myLevelStarts.empty() ? 0 : myLevelStarts.size() - 1;
+}
+
+TransformStore::Slot TransformStore::GetSlot(Id anId) const
+{
+	ASSERT_STR(anId < myIdSlots.size() && myIdSlots[anId] != kInvalidSlot,
+		"Invalid transform id: {}!", anId);
+	return myIdSlots[anId];
+}
+
+void TransformStore::CalcWorld(Slot aSlot)
+{
+	// Same as Transform::operator*, but reading straight from the arrays
+	const Slot parent = myParents[aSlot];
+	if (parent == kInvalidSlot)
+	{
+		myWorldPos[aSlot] = myLocalPos[aSlot];
+		myWorldRot[aSlot] = myLocalRot[aSlot];
+		myWorldScale[aSlot] = myLocalScale[aSlot];
+		return;
+	}
+
+	const glm::quat parentRot = myWorldRot[parent];
+	const glm::vec3 parentScale = myWorldScale[parent];
+	myWorldPos[aSlot] = myWorldPos[parent] + (parentRot * myLocalPos[aSlot]) * parentScale;
+	myWorldRot[aSlot] = parentRot * myLocalRot[aSlot];
+	myWorldScale[aSlot] = parentScale * myLocalScale[aSlot];
+}
+
+void TransformStore::PropagateAll()
+{
+	if (myLevelStarts.size() < 2)
+	{
+		return;
+	}
+
+	// roots have nothing to inherit from
+	const Slot rootsEnd = myLevelStarts[1];
+	std::copy(myLocalPos.begin(), myLocalPos.begin() + rootsEnd, myWorldPos.begin());
+	std::copy(myLocalRot.begin(), myLocalRot.begin() + rootsEnd, myWorldRot.begin());
+	std::copy(myLocalScale.begin(), myLocalScale.begin() + rootsEnd, myWorldScale.begin());
+
+	// every level only reads from the previous one, so it can be split freely.
+	// Isolated, as the exclusive lock is held - a waiting thread that picked
+	// up an unrelated task reading transforms would spin on it forever
+	constexpr Slot kGrainSize = 4096;
+	tbb::this_task_arena::isolate([&] {
+		for (size_t level = 1; level + 1 < myLevelStarts.size(); level++)
+		{
+			const Slot levelStart = myLevelStarts[level];
+			const Slot levelEnd = myLevelStarts[level + 1];
+			tbb::parallel_for(tbb::blocked_range<Slot>(levelStart, levelEnd, kGrainSize),
+				[this](const tbb::blocked_range<Slot>& aRange) {
+				const Slot* parents = myParents.data();
+				for (Slot slot = aRange.begin(); slot < aRange.end(); slot++)
+				{
+					const Slot parent = parents[slot];
+					const glm::quat parentRot = myWorldRot[parent];
+					const glm::vec3 parentScale = myWorldScale[parent];
+					myWorldPos[slot] = myWorldPos[parent] + (parentRot * myLocalPos[slot]) * parentScale;
+					myWorldRot[slot] = parentRot * myLocalRot[slot];
+					myWorldScale[slot] = parentScale * myLocalScale[slot];
+				}
+			});
+		}
+	});
+}
+
+void TransformStore::SortByDepth()
+{
+	Profiler::ScopedMark scope("TransformStore::SortByDepth");
+
+	const Slot slotCount = static_cast<Slot>(myParents.size());
+	auto isAlive = [this](Slot aSlot) { return mySlotIds[aSlot] != kInvalidId; };
+
+	// gather children of every slot into a single array
+	std::vector<Slot> childOffsets(slotCount + 1, 0);
+	for (Slot slot = 0; slot < slotCount; slot++)
+	{
+		if (isAlive(slot) && myParents[slot] != kInvalidSlot)
+		{
+			childOffsets[myParents[slot] + 1]++;
+		}
+	}
+	for (Slot slot = 0; slot < slotCount; slot++)
+	{
+		childOffsets[slot + 1] += childOffsets[slot];
+	}
+	std::vector<Slot> children(childOffsets.back());
+	std::vector<Slot> childCursors(childOffsets.begin(), childOffsets.end() - 1);
+	for (Slot slot = 0; slot < slotCount; slot++)
+	{
+		if (isAlive(slot) && myParents[slot] != kInvalidSlot)
+		{
+			children[childCursors[myParents[slot]]++] = slot;
+		}
+	}
+
+	// breadth first walk orders by depth, and keeps children of
+	// a parent next to each other
+	std::vector<Slot> order;
+	order.reserve(myCount);
+	for (Slot slot = 0; slot < slotCount; slot++)
+	{
+		if (isAlive(slot) && myParents[slot] == kInvalidSlot)
+		{
+			order.push_back(slot);
+		}
+	}
+
+	myChildStarts.resize(myCount + 1);
+	myLevelStarts.assign(1, 0);
+	for (Slot levelStart = 0; levelStart < order.size();)
+	{
+		const Slot levelEnd = static_cast<Slot>(order.size());
+		myLevelStarts.push_back(levelEnd);
+		for (Slot newSlot = levelStart; newSlot < levelEnd; newSlot++)
+		{
+			myChildStarts[newSlot] = static_cast<Slot>(order.size());
+			const Slot oldSlot = order[newSlot];
+			order.insert(order.end(),
+				children.begin() + childOffsets[oldSlot],
+				children.begin() + childOffsets[oldSlot + 1]
+			);
+		}
+		levelStart = levelEnd;
+	}
+	ASSERT_STR(order.size() == myCount, "Removed transform still had children!");
+	myChildStarts[myCount] = static_cast<Slot>(myCount);
+
+	std::vector<Slot> newSlots(slotCount, kInvalidSlot);
+	for (Slot newSlot = 0; newSlot < order.size(); newSlot++)
+	{
+		newSlots[order[newSlot]] = newSlot;
+	}
+
+	auto permute = [&]<class T>(std::vector<T>& aData) {
+		std::vector<T> sorted(order.size());
+		for (Slot newSlot = 0; newSlot < order.size(); newSlot++)
+		{
+			sorted[newSlot] = aData[order[newSlot]];
+		}
+		aData.swap(sorted);
+	};
+	permute(myLocalPos);
+	permute(myLocalRot);
+	permute(myLocalScale);
+	permute(myWorldPos);
+	permute(myWorldRot);
+	permute(myWorldScale);
+	permute(mySlotIds);
+	permute(myParents);
+
+	for (Slot slot = 0; slot < order.size(); slot++)
+	{
+		Slot& parent = myParents[slot];
+		if (parent != kInvalidSlot)
+		{
+			parent = newSlots[parent];
+		}
+		myIdSlots[mySlotIds[slot]] = slot;
+	}
+
+	myFreeSlots.clear();
+	myNeedsSort = false;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <tbb/spin_rw_mutex.h>
+
+#include <span>
+
+#include "Transform.h"
+
+// Central storage of hierarchical transforms. Local and world transforms are kept
+// as separate position, rotation and scale arrays (SoA), sorted by hierarchy depth
+// with parents referenced by slot index. Because a parent always sits in an earlier
+// depth level, world propagation is a linear pass over each level, with every
+// level being processed in parallel.
+// Within a level slots are grouped by parent, so children of any range of slots
+// form a single range in the next level - this lets PropagateDirty walk only
+// the subtrees of changed entries.
+// Users hold a stable Id, which gets remapped to a slot when the store re-sorts.
+// Per-entry accessors take a shared lock, while structural changes (Add, Remove,
+// SetParent) and propagation take an exclusive one, so entries can be created
+// from loading threads. Writing the same entry from multiple threads is not safe.
+class TransformStore
+{
+public:
+	using Id = uint32_t;
+	constexpr static Id kInvalidId = std::numeric_limits<Id>::max();
+
+	// Creates a new entry, world transform is immediately valid if the parent's is.
+	// anOwner is an optional user pointer, to map updated entries back to objects
+	Id Add(const Transform& aLocal, Id aParent = kInvalidId, void* anOwner = nullptr);
+	// Entry must not be a parent of any other entry
+	void Remove(Id anId);
+	void Reserve(size_t aCount);
+
+	Id GetParent(Id anId) const;
+	// Changes the parent without updating either of the transforms
+	void SetParent(Id anId, Id aParent);
+	void* GetOwner(Id anId) const;
+
+	Transform GetLocal(Id anId) const;
+	// Only updates the local transform and marks the entry as dirty - use
+	// PropagateDirty to get the world transforms updated
+	void SetLocal(Id anId, const Transform& aLocal);
+	Transform GetWorld(Id anId) const;
+	// Updates the world transform right away, and derives the local one from
+	// current world transform of the parent. Marks the entry as dirty,
+	// so that the descendants get updated by PropagateDirty
+	void SetWorld(Id anId, const Transform& aWorld);
+	glm::mat4 GetWorldMatrix(Id anId) const;
+
+	// Recalculates the world transform of a single entry from its parent's
+	// world transform. Descendants are left untouched
+	void UpdateWorld(Id anId);
+
+	// Schedules the entry and its descendants for next PropagateDirty.
+	// Thread safe, marking the same entry multiple times is fine
+	void MarkDirty(Id anId);
+
+	// Recalculates world transforms of every entry, re-sorting by depth if
+	// the hierarchy has changed since last call. Doesn't consume dirty entries
+	void Propagate();
+	// Recalculates world transforms of dirty entries and their descendants,
+	// writing Ids of every recalculated entry to anUpdated
+	void PropagateDirty(std::vector<Id>& anUpdated);
+
+	// Calls aFunc(owner, world transform) for every entry of anIds, in parallel,
+	// taking the lock once for the whole batch instead of once per access.
+	// aFunc must not access the store itself
+	template<class TFunc>
+	void ParallelForEachWorld(std::span<const Id> anIds, size_t aGrainSize, TFunc&& aFunc) const;
+
+	size_t GetCount() const;
+	size_t GetDepthCount() const;
+
+private:
+	using Slot = uint32_t;
+	constexpr static Slot kInvalidSlot = std::numeric_limits<Slot>::max();
+	// Past this ratio of dirty entries it's cheaper to just go over everything
+	constexpr static size_t kFullPropagateRatio = 8;
+
+	Slot GetSlot(Id anId) const;
+	void AddDirty(Id anId);
+	void CalcWorld(Slot aSlot);
+	void PropagateAll();
+	void SortByDepth();
+
+	// Per slot data
+	std::vector<glm::vec3> myLocalPos;
+	std::vector<glm::quat> myLocalRot;
+	std::vector<glm::vec3> myLocalScale;
+	std::vector<glm::vec3> myWorldPos;
+	std::vector<glm::quat> myWorldRot;
+	std::vector<glm::vec3> myWorldScale;
+	std::vector<Slot> myParents;
+	std::vector<Id> mySlotIds;
+	// First child of every slot, with one extra entry at the end. Children
+	// of a slot end where children of the next slot begin
+	std::vector<Slot> myChildStarts;
+
+	// Per id data
+	std::vector<Slot> myIdSlots;
+	std::vector<void*> myOwners;
+	std::vector<uint8_t> myDirtyFlags; // accessed via atomic_ref
+
+	std::vector<Id> myFreeIds;
+	std::vector<Slot> myFreeSlots;
+	// First slot of every depth level, with the last entry marking the end
+	std::vector<Slot> myLevelStarts;
+	tbb::enumerable_thread_specific<std::vector<Id>> myDirtyIds;
+	size_t myCount = 0;
+	// Set when slots are no longer ordered by depth, or have holes in them
+	bool myNeedsSort = false;
+
+	mutable tbb::spin_rw_mutex myMutex;
+};
+
+template<class TFunc>
+void TransformStore::ParallelForEachWorld(std::span<const Id> anIds, size_t aGrainSize, TFunc&& aFunc) const
+{
+	tbb::spin_rw_mutex::scoped_lock lock(myMutex, false);
+	// isolated, so that waiting threads don't pick up unrelated tasks
+	// that could try to lock again behind a pending writer
+	tbb::this_task_arena::isolate([&] {
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, anIds.size(), aGrainSize),
+			[&](const tbb::blocked_range<size_t>& aRange) {
+			for (size_t i = aRange.begin(); i < aRange.end(); i++)
+			{
+				const Id id = anIds[i];
+				const Slot slot = GetSlot(id);
+				aFunc(myOwners[id], Transform(myWorldPos[slot], myWorldRot[slot], myWorldScale[slot]));
+			}
+		});
+	});
+}
@@ -0,0 +1,138 @@
+#include "../Precomp.h"
+#include "CPUSkinning.h"
+
+#include <Graphics/Resources/Model.h>
+
+#include "Animation/Skeleton.h"
+#include "Animation/SkinnedVerts.h"
+
+#include <xmmintrin.h>
+
+namespace
+{
+	// Transforms aVert's position by Sum(weight[i] * matrix[i]), reading only
+	// first InfluenceCount weights
+	template<uint8_t InfluenceCount>
+	__m128 SkinVertex(const SkinnedVertex& aVert, const glm::mat4* aMatrices)
+	{
+		static_assert(InfluenceCount > 0 && InfluenceCount <= CPUSkinning::kMaxInfluences);
+
+		const __m128 x = _mm_set1_ps(aVert.myPos.x);
+		const __m128 y = _mm_set1_ps(aVert.myPos.y);
+		const __m128 z = _mm_set1_ps(aVert.myPos.z);
+
+		__m128 result = _mm_setzero_ps();
+		for (uint8_t i = 0; i < InfluenceCount; i++)
+		{
+			// glm::mat4 is column major, so columns are contiguous
+			const float* mat = glm::value_ptr(aMatrices[aVert.myBoneIndices[i]]);
+			__m128 transformed = _mm_add_ps(
+				_mm_add_ps(
+					_mm_mul_ps(_mm_loadu_ps(mat), x),
+					_mm_mul_ps(_mm_loadu_ps(mat + 4), y)
+				),
+				_mm_add_ps(
+					_mm_mul_ps(_mm_loadu_ps(mat + 8), z),
+					_mm_loadu_ps(mat + 12)
+				)
+			);
+			const __m128 weight = _mm_set1_ps(aVert.myBoneWeights[i]);
+			result = _mm_add_ps(result, _mm_mul_ps(transformed, weight));
+		}
+		return result;
+	}
+
+	template<uint8_t InfluenceCount>
+	void SkinPositionsImpl(std::span<const SkinnedVertex> aVerts, const glm::mat4* aMatrices, glm::vec3* aPositions)
+	{
+		alignas(16) float stored[4];
+		for (const SkinnedVertex& vert : aVerts)
+		{
+			_mm_store_ps(stored, SkinVertex<InfluenceCount>(vert, aMatrices));
+			*aPositions++ = glm::vec3(stored[0], stored[1], stored[2]);
+		}
+	}
+
+	template<uint8_t InfluenceCount>
+	Shapes::AABB CalcAABBImpl(std::span<const SkinnedVertex> aVerts, const glm::mat4* aMatrices)
+	{
+		__m128 min = _mm_set1_ps(std::numeric_limits<float>::max());
+		__m128 max = _mm_set1_ps(std::numeric_limits<float>::lowest());
+		for (const SkinnedVertex& vert : aVerts)
+		{
+			const __m128 pos = SkinVertex<InfluenceCount>(vert, aMatrices);
+			min = _mm_min_ps(min, pos);
+			max = _mm_max_ps(max, pos);
+		}
+
+		alignas(16) float storedMin[4];
+		alignas(16) float storedMax[4];
+		_mm_store_ps(storedMin, min);
+		_mm_store_ps(storedMax, max);
+		return {
+			{ storedMin[0], storedMin[1], storedMin[2] },
+			{ storedMax[0], storedMax[1], storedMax[2] }
+		};
+	}
+
+	template<class TFunc>
+	auto DispatchInfluence(uint8_t anInfluenceCount, TFunc&& aFunc)
+	{
+		switch (anInfluenceCount)
+		{
+		case 1: return aFunc(std::integral_constant<uint8_t, 1>{});
+		case 2: return aFunc(std::integral_constant<uint8_t, 2>{});
+		case 3: return aFunc(std::integral_constant<uint8_t, 3>{});
+		case 4: return aFunc(std::integral_constant<uint8_t, 4>{});
+		default:
+			ASSERT_STR(false, "Unsupported influence count: {}", anInfluenceCount);
+			return aFunc(std::integral_constant<uint8_t, 4>{});
+		}
+	}
+}
+
+namespace CPUSkinning
+{
+	void CalcSkinningMatrices(const Skeleton& aSkeleton, std::span<glm::mat4> aMatrices)
+	{
+		const Skeleton::BoneIndex boneCount = aSkeleton.GetBoneCount();
+		ASSERT_STR(aMatrices.size() >= boneCount, "Not enough space for skinning matrices!");
+		for (Skeleton::BoneIndex index = 0; index < boneCount; index++)
+		{
+			// same as SkeletonAdapter
+			const glm::mat4 worldBoneTransf = aSkeleton.GetBoneWorldTransform(index).GetMatrix();
+			aMatrices[index] = worldBoneTransf * aSkeleton.GetBoneIverseBindTransform(index);
+		}
+	}
+
+	void SkinPositions(std::span<const SkinnedVertex> aVerts, std::span<const glm::mat4> aMatrices,
+		std::span<glm::vec3> aPositions, uint8_t anInfluenceCount /* = kMaxInfluences */)
+	{
+		ASSERT_STR(aPositions.size() >= aVerts.size(), "Not enough space for skinned positions!");
+		DispatchInfluence(anInfluenceCount, [&]<uint8_t Count>(std::integral_constant<uint8_t, Count>) {
+			SkinPositionsImpl<Count>(aVerts, aMatrices.data(), aPositions.data());
+		});
+	}
+
+	Shapes::AABB CalcAABB(std::span<const SkinnedVertex> aVerts, std::span<const glm::mat4> aMatrices,
+		uint8_t anInfluenceCount /* = kMaxInfluences */)
+	{
+		return DispatchInfluence(anInfluenceCount, [&]<uint8_t Count>(std::integral_constant<uint8_t, Count>) {
+			return CalcAABBImpl<Count>(aVerts, aMatrices.data());
+		});
+	}
+
+	Shapes::AABB CalcAABB(const Model& aModel, const Skeleton& aSkeleton)
+	{
+		constexpr size_t kMaxBones = 256;
+		const Skeleton::BoneIndex boneCount = aSkeleton.GetBoneCount();
+		ASSERT_STR(boneCount <= kMaxBones, "Too many bones!");
+
+		glm::mat4 matrices[kMaxBones];
+		CalcSkinningMatrices(aSkeleton, std::span{ matrices, boneCount });
+
+		const Model::VertStorage<SkinnedVertex>* storage = aModel.GetVertexStorage<SkinnedVertex>();
+		const std::span<const SkinnedVertex> verts{ storage->GetData(), storage->GetCount() };
+		return CalcAABB(verts, std::span{ matrices, boneCount });
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Core/Shapes.h>
+
+class Skeleton;
+class Model;
+struct SkinnedVertex;
+
+// CPU implementation of linear blend skinning, matching what skinned shaders
+// do via SkeletonAdapter. Primary use is to get deformed positions or tight
+// bounds without a GPU (culling, headless servers).
+// Kernels are SSE-vectorized per vertex and don't allocate, so they can be
+// invoked on subranges of vertices from multiple threads.
+namespace CPUSkinning
+{
+	constexpr static uint8_t kMaxInfluences = 4;
+
+	// Fills aMatrices with skeleton-space skinning matrices (world * inverse bind)
+	// aMatrices must be able to fit every bone of the skeleton
+	void CalcSkinningMatrices(const Skeleton& aSkeleton, std::span<glm::mat4> aMatrices);
+
+	// Writes skinned positions of aVerts to aPositions. anInfluenceCount controls
+	// how many bone influences to read per vertex (from 1 to kMaxInfluences) -
+	// use lower counts when the asset is known to have fewer influences
+	void SkinPositions(std::span<const SkinnedVertex> aVerts, std::span<const glm::mat4> aMatrices,
+		std::span<glm::vec3> aPositions, uint8_t anInfluenceCount = kMaxInfluences);
+
+	// Same as SkinPositions, but only accumulates an AABB of skinned positions
+	Shapes::AABB CalcAABB(std::span<const SkinnedVertex> aVerts, std::span<const glm::mat4> aMatrices,
+		uint8_t anInfluenceCount = kMaxInfluences);
+
+	// Convenience overload - model-space AABB of a skinned model posed by aSkeleton
+	// Model must be using SkinnedVertex storage
+	Shapes::AABB CalcAABB(const Model& aModel, const Skeleton& aSkeleton);
+}
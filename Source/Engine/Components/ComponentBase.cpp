@@ -1,2 +1,42 @@
 #include "Precomp.h"
-#include "ComponentBase.h"
\ No newline at end of file
+#include "ComponentBase.h"
+
+ComponentPoolBase* ComponentPools::ourPools[ComponentTypes::kMaxTypes] = {};
+
+void ComponentPools::Free(ComponentBase& aComp)
+{
+	ComponentPoolBase* pool = ourPools[aComp.GetTypeId()];
+	ASSERT_STR(pool, "Component wasn't allocated from a pool!");
+	pool->Free(aComp);
+}
+
+void ComponentSet::Add(ComponentBase& aComp)
+{
+	const ComponentTypeId typeId = aComp.GetTypeId();
+	ASSERT_STR(typeId < ComponentTypes::kMaxTypes, "Component type isn't registered!");
+	const uint32_t typeBit = 1u << typeId;
+	ASSERT_STR(!(myMask & typeBit), "Already have a component of this type!");
+
+	const size_t index = std::popcount(myMask & (typeBit - 1));
+	myComponents.insert(myComponents.begin() + index, &aComp);
+	myMask |= typeBit;
+}
+
+ComponentBase* ComponentSet::Remove(ComponentTypeId aTypeId)
+{
+	if (aTypeId >= ComponentTypes::kMaxTypes)
+	{
+		return nullptr;
+	}
+	const uint32_t typeBit = 1u << aTypeId;
+	if (!(myMask & typeBit))
+	{
+		return nullptr;
+	}
+
+	const size_t index = std::popcount(myMask & (typeBit - 1));
+	ComponentBase* comp = myComponents[index];
+	myComponents.erase(myComponents.begin() + index);
+	myMask &= ~typeBit;
+	return comp;
+}
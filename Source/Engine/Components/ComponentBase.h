@@ -1,27 +1,212 @@
 #pragma once
 
 #include <Core/Utils.h>
+#include <Core/StableVector.h>
+
+#include <bit>
 
 class GameObject;
 class Serializer;
 
+using ComponentTypeId = uint8_t;
+
 class ComponentBase
 {
 public:
+	constexpr static ComponentTypeId kInvalidTypeId = std::numeric_limits<ComponentTypeId>::max();
+
 	ComponentBase() : myOwner(nullptr) {}
 	virtual ~ComponentBase() {};
 
 	virtual void Init(GameObject* anOwner) { myOwner = anOwner; };
 
 	GameObject* GetOwner() { return myOwner; }
+	// Only valid for components allocated via ComponentPools
+	ComponentTypeId GetTypeId() const { return myTypeId; }
 
 	virtual std::string_view GetName() const = 0;
 	virtual void Serialize(Serializer&) { ASSERT_STR(false, "NYI"); };
 
 protected:
 	GameObject* myOwner;
+
+private:
+	template<class TComp>
+	friend class ComponentPool;
+	ComponentTypeId myTypeId = kInvalidTypeId;
+};
+
+template<class... TComps>
+struct ComponentTypeList
+{
+	constexpr static size_t kCount = sizeof...(TComps);
+
+	// Returns kCount if TComp isn't in the list
+	template<class TComp>
+	constexpr static size_t IndexOf()
+	{
+		constexpr bool matches[] = { std::is_same_v<TComp, TComps>... };
+		for (size_t i = 0; i < kCount; i++)
+		{
+			if (matches[i])
+			{
+				return i;
+			}
+		}
+		return kCount;
+	}
+
+	// Returns true if every type is listed only once
+	constexpr static bool IsUnique()
+	{
+		size_t index = 0;
+		return ((IndexOf<TComps>() == index++) && ...);
+	}
 };
 
+class VisualComponent;
+class PhysicsComponent;
+class HexComponent;
+template<uint8_t Index> class TestComponent;
+
+// Ids of component types are their indices in List, so they're known at
+// compile time and are dense - they can directly index per-type tables and
+// bitmasks. Every component type has to be added to List
+class ComponentTypes
+{
+public:
+	using List = ComponentTypeList<
+		VisualComponent,
+		PhysicsComponent,
+		HexComponent,
+		TestComponent<0>,
+		TestComponent<1>,
+		TestComponent<2>
+	>;
+	constexpr static ComponentTypeId kMaxTypes = 32;
+
+	template<class TComp>
+	constexpr static ComponentTypeId GetId()
+	{
+		static_assert(std::is_base_of_v<ComponentBase, TComp>);
+		constexpr size_t index = List::IndexOf<TComp>();
+		static_assert(index < List::kCount, "Component type is missing from ComponentTypes::List!");
+		return static_cast<ComponentTypeId>(index);
+	}
+};
+static_assert(ComponentTypes::List::IsUnique(), "Component type is listed more than once!");
+static_assert(ComponentTypes::List::kCount <= ComponentTypes::kMaxTypes, "Too many component types, bump kMaxTypes!");
+
+class ComponentPoolBase
+{
+public:
+	virtual ~ComponentPoolBase() = default;
+	virtual void Free(ComponentBase& aComp) = 0;
+};
+
+// Storage for all components of a single type. Components are kept
+// in pages of contiguous memory, with stable addresses. Allocation
+// and freeing are thread safe, but iteration must not overlap with them
+template<class TComp>
+class ComponentPool final : public ComponentPoolBase
+{
+public:
+	template<class... TArgs>
+	TComp& Allocate(TArgs&&... anArgs)
+	{
+		std::lock_guard lock(myMutex);
+		TComp& comp = myComponents.Allocate(std::forward<TArgs>(anArgs)...);
+		comp.myTypeId = ComponentTypes::GetId<TComp>();
+		return comp;
+	}
+
+	void Free(ComponentBase& aComp) final
+	{
+		ASSERT_STR(aComp.GetTypeId() == ComponentTypes::GetId<TComp>(), "Freeing component of a different type!");
+		std::lock_guard lock(myMutex);
+		myComponents.Free(static_cast<TComp&>(aComp));
+	}
+
+	template<class TFunc>
+	void ForEach(this auto& aSelf, const TFunc& aFunc) { aSelf.myComponents.ForEach(aFunc); }
+
+	template<class TFunc>
+	void ParallelForEach(this auto& aSelf, const TFunc& aFunc) { aSelf.myComponents.ParallelForEach(aFunc); }
+
+	size_t GetCount() const { return myComponents.GetCount(); }
+
+private:
+	StableVector<TComp> myComponents;
+	std::mutex myMutex;
+};
+
+// Global registry of per-type component pools. Systems should iterate
+// the pool of the type they care about, instead of going over GameObjects
+class ComponentPools
+{
+public:
+	template<class TComp>
+	static ComponentPool<TComp>& Get()
+	{
+		static ComponentPool<TComp>& ourPool = Register<TComp>();
+		return ourPool;
+	}
+
+	// Returns the component back to the pool of its type
+	static void Free(ComponentBase& aComp);
+
+private:
+	template<class TComp>
+	static ComponentPool<TComp>& Register()
+	{
+		static ComponentPool<TComp> pool;
+		ourPools[ComponentTypes::GetId<TComp>()] = &pool;
+		return pool;
+	}
+
+	static ComponentPoolBase* ourPools[ComponentTypes::kMaxTypes];
+};
+
+// Per-object set of components, at most one of each type. Components
+// are sorted by type id, with a bitmask of present types, so a lookup
+// is a bit test and a popcount to find the index
+class ComponentSet
+{
+public:
+	template<class TComp>
+	TComp* Get() const
+	{
+		return static_cast<TComp*>(Get(ComponentTypes::GetId<TComp>()));
+	}
+
+	ComponentBase* Get(ComponentTypeId aTypeId) const
+	{
+		// unregistered components have no bit to test
+		if (aTypeId >= ComponentTypes::kMaxTypes)
+		{
+			return nullptr;
+		}
+		const uint32_t typeBit = 1u << aTypeId;
+		if (!(myMask & typeBit))
+		{
+			return nullptr;
+		}
+		return myComponents[std::popcount(myMask & (typeBit - 1))];
+	}
+
+	void Add(ComponentBase& aComp);
+	// Returns the removed component, if there was one
+	ComponentBase* Remove(ComponentTypeId aTypeId);
+
+	size_t GetCount() const { return myComponents.size(); }
+	ComponentBase& GetAt(size_t anIndex) const { return *myComponents[anIndex]; }
+
+private:
+	std::vector<ComponentBase*> myComponents;
+	uint32_t myMask = 0;
+};
+static_assert(ComponentTypes::kMaxTypes <= 32, "ComponentSet mask must fit all types!");
+
 class ComponentRegister
 {
 	using CreateFunc = ComponentBase*(*)();
@@ -32,30 +217,43 @@ public:
 		return registrator;
 	}
 
-	void Register(std::string_view aName, CreateFunc aFunc)
+	void Register(std::string_view aName, ComponentTypeId aTypeId, CreateFunc aFunc)
 	{
-		ASSERT_STR(myCreateFuncs.find(aName) == myCreateFuncs.end(), "{} already registered!", aName);
-		myCreateFuncs.insert({ aName, aFunc });
+		ASSERT_STR(myEntries.find(aName) == myEntries.end(), "{} already registered!", aName);
+		myEntries.insert({ aName, { aFunc, aTypeId } });
 	}
 
 	bool Contains(std::string_view aName) const
 	{
-		return myCreateFuncs.contains(aName);
+		return myEntries.contains(aName);
 	}
 
+	ComponentTypeId GetTypeId(std::string_view aName) const
+	{
+		auto entryIter = myEntries.find(aName);
+		ASSERT_STR(entryIter != myEntries.end(), "Missing registration for {}!", aName);
+		return entryIter->second.myTypeId;
+	}
+
+	// Allocates from the component's pool, must be freed via ComponentPools
 	ComponentBase* Create(std::string_view aName) const
 	{
-		auto funcIter = myCreateFuncs.find(aName);
-		ASSERT_STR(funcIter != myCreateFuncs.end(), "Missing Creation callback for {}!", aName);
-		return funcIter->second();
+		auto entryIter = myEntries.find(aName);
+		ASSERT_STR(entryIter != myEntries.end(), "Missing Creation callback for {}!", aName);
+		return entryIter->second.myCreateFunc();
 	}
 
 private:
-	std::unordered_map<std::string_view, CreateFunc> myCreateFuncs;
+	struct Entry
+	{
+		CreateFunc myCreateFunc;
+		ComponentTypeId myTypeId;
+	};
+	std::unordered_map<std::string_view, Entry> myEntries;
 };
 
-// Optional helper to cause component to implement 
-// auto-registration with ComponentRegister for serialization. 
+// Optional helper to cause component to implement
+// auto-registration with ComponentRegister for serialization.
 // Requires:
 // * TComp must override Serialize(Serialzier&)
 template<class TComp, class TBase = ComponentBase>
@@ -63,16 +261,16 @@ class SerializableComponent : public TBase
 {
 public:
 	// this is needed to get past ODR and cause implicit template instantiation
-	~SerializableComponent() { ourRegistrar; } 
+	~SerializableComponent() { ourRegistrar; }
 	std::string_view GetName() const override { return Utils::NameOf<TComp>; }
 
 private:
 	static bool Register()
 	{
 		auto newT = [] {
-			return static_cast<ComponentBase*>(new TComp());
+			return static_cast<ComponentBase*>(&ComponentPools::Get<TComp>().Allocate());
 		};
-		ComponentRegister::Get().Register(Utils::NameOf<TComp>, newT);
+		ComponentRegister::Get().Register(Utils::NameOf<TComp>, ComponentTypes::GetId<TComp>(), newT);
 		return true;
 	}
 	static bool ourRegistrar;
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ComponentBase.h"
+
+// Plain component for Tests and BenchTable. Every component type needs
+// a slot in ComponentTypes::List, so they share these instead of
+// declaring their own
+template<uint8_t Index>
+class TestComponent : public ComponentBase
+{
+public:
+	std::string_view GetName() const final { return Utils::NameOf<TestComponent>; }
+
+	glm::vec3 myPos = glm::vec3(Index);
+	glm::vec3 myVelocity = glm::vec3(1);
+	int myValue = Index + 1;
+};
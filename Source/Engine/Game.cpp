@@ -87,6 +87,16 @@ namespace UIWidgets
 			ImGui::Checkbox("Is Paused (B)", &settings.myIsPaused);
 			ImGui::Checkbox("Draw Wireframe (K)", &settings.myUseWireframe);
 			ImGui::Checkbox("Draw Physics Debug", &settings.myDrawPhysicsDebug);
+
+			constexpr uint32_t kTraceFrames = 120;
+			if (aGame.GetTaskManager().IsTracing())
+			{
+				ImGui::Text("Tracing tasks...");
+			}
+			else if (ImGui::Button("Trace Tasks"))
+			{
+				aGame.RequestTaskTrace(kTraceFrames, "TaskTrace.json");
+			}
 		}
 		ImGui::End();
 	}
@@ -227,13 +237,27 @@ void Game::Init(bool aUseDefaultCompositePass)
 		task.SetName("RemoveGameObjects");
 		myTaskManager->AddTask(task);
 
-		task = GameTask(Tasks::UpdateEnd, [this] { UpdateEnd(); });
+		task = GameTask(Tasks::TransformUpdate, [this] { TransformUpdate(); });
 		task.AddDependency(Tasks::RemoveGameObjects);
+		task.AddDependency(Tasks::PhysicsUpdate);
+		task.AddDependency(Tasks::AnimationUpdate);
+		task.SetName("TransformUpdate");
+		myTaskManager->AddTask(task);
+
+		task = GameTask(Tasks::UpdateEnd, [this] { UpdateEnd(); });
+		task.AddDependency(Tasks::TransformUpdate);
 		task.SetName("UpdateEnd");
 		myTaskManager->AddTask(task);
 
+		// Only the pipelining infrastructure is in place - Game stays at depth 1.
+		// Going deeper needs render passes to read per-frame copies instead of
+		// live state: camera (recalculated here), renderables and skeletons
+		// (added/removed/moved by Simulation), terrains, lights and debug
+		// drawers. Gather also has to keep waiting on the previous frame's
+		// SubmitRenderables, which is an external dependency only allowed at 1
 		task = GameTask(Tasks::Render, [this] { Render(); });
 		task.AddDependency(Tasks::UpdateEnd);
+		task.SetStage(GameTask::Stage::Render);
 		task.SetName("Render");
 		myTaskManager->AddTask(task);
 
@@ -311,7 +335,7 @@ void Game::Run()
 void Game::CleanUp()
 {
 	// First, wait until last frame is done
-	myTaskManager->Wait();
+	myTaskManager->WaitAll();
 	while (myRenderThread->HasWork())
 	{
 		myRenderThread->SubmitRenderables();
@@ -326,14 +350,8 @@ void Game::CleanUp()
 	
 	// get rid of pending objects
 	ourGODeleteEnabled = true;
-	while (!myAddQueue.empty())
-	{
-		myAddQueue.pop();
-	}
-	while (!myRemoveQueue.empty())
-	{
-		myRemoveQueue.pop();
-	}
+	myAddBuffer.Clear();
+	myRemoveBuffer.Clear();
 	myWorld.Clear();
 	ourGODeleteEnabled = false;
 
@@ -343,7 +361,7 @@ void Game::CleanUp()
 		delete terrain.myVisualObject;
 		if (terrain.myPhysComponent)
 		{
-			delete terrain.myPhysComponent;
+			ComponentPools::Free(*terrain.myPhysComponent);
 		}
 	}
 	myTerrains.clear();
@@ -410,6 +428,12 @@ void Game::RunMainThread()
 			}
 		}
 
+		if (myTraceFrameCount > 0)
+		{
+			myTaskManager->StartTrace(myTraceFrameCount, myTraceReportPath);
+			myTraceFrameCount = 0;
+		}
+
 		{
 			GameTaskManager::ExternalDependencyScope dependency = myTaskManager->AddExternalDependency(Tasks::Render);
 			myTaskManager->Run();
@@ -421,14 +445,18 @@ void Game::RunMainThread()
 	}
 }
 
+void Game::RequestTaskTrace(uint32_t aFrameCount, std::string_view aReportPath)
+{
+	ASSERT_STR(aFrameCount > 0, "Need at least 1 frame to trace!");
+	myTraceFrameCount = aFrameCount;
+	myTraceReportPath = aReportPath;
+}
+
 void Game::AddGameObject(Handle<GameObject> aGOHandle)
 {
 	ASSERT_STR(aGOHandle.IsValid(), "Invalid object passed in!");
 
-	{
-		tbb::spin_mutex::scoped_lock spinLock(myAddLock);
-		myAddQueue.push(aGOHandle);
-	}
+	myAddBuffer.Push(aGOHandle);
 
 	GameObject* go = aGOHandle.Get();
 	const size_t childCount = go->GetChildCount();
@@ -452,10 +480,7 @@ void Game::AddGameObject(Handle<GameObject> aGOHandle)
 		GameObject* dirtyGO = dirtyGOs.back();
 		dirtyGOs.pop_back();
 
-		{
-			tbb::spin_mutex::scoped_lock spinLock(myAddLock);
-			myAddQueue.push(dirtyGO);
-		}
+		myAddBuffer.Push(dirtyGO);
 
 		const size_t dirtyCount = dirtyGO->GetChildCount();
 		for (size_t childInd = 0; childInd < dirtyCount; childInd++)
@@ -469,10 +494,7 @@ void Game::RemoveGameObject(Handle<GameObject> aGOHandle)
 {
 	ASSERT_STR(aGOHandle.IsValid(), "Invalid object passed in!");
 
-	{
-		tbb::spin_mutex::scoped_lock spinLock(myRemoveLock);
-		myRemoveQueue.push(aGOHandle);
-	}
+	myRemoveBuffer.Push(aGOHandle);
 
 	// if there's a parent - let it stay in the world
 	GameObject* go = aGOHandle.Get();
@@ -502,10 +524,7 @@ void Game::RemoveGameObject(Handle<GameObject> aGOHandle)
 		GameObject* dirtyGO = dirtyGOs.back();
 		dirtyGOs.pop_back();
 
-		{
-			tbb::spin_mutex::scoped_lock spinLock(myRemoveLock);
-			myRemoveQueue.push(dirtyGO);
-		}
+		myRemoveBuffer.Push(dirtyGO);
 
 		// We need to detach from parent to break the circular dependency
 		// between Parent <=> Child (because both of them are Handles)
@@ -556,7 +575,7 @@ void Game::AddTerrain(Terrain* aTerrain, Handle<Pipeline> aPipeline)
 
 		if (physWorld)
 		{
-			PhysicsComponent* physComp = new PhysicsComponent();
+			PhysicsComponent* physComp = &ComponentPools::Get<PhysicsComponent>().Allocate();
 			physComp->CreateOwnerlessPhysicsEntity(0,
 				terrain->GetPhysShape(),
 				transf.GetMatrix()
@@ -580,7 +599,10 @@ void Game::RemoveTerrain(size_t anIndex)
 
 	delete myTerrains[anIndex].myTerrain;
 	delete myTerrains[anIndex].myVisualObject;
-	delete myTerrains[anIndex].myPhysComponent;
+	if (myTerrains[anIndex].myPhysComponent)
+	{
+		ComponentPools::Free(*myTerrains[anIndex].myPhysComponent);
+	}
 	myTerrains.erase(myTerrains.begin() + anIndex);
 }
 
@@ -589,12 +611,11 @@ void Game::AddGameObjects()
 #ifdef ASSERT_MUTEX
 	AssertLock assertLock(myGOMutex);
 #endif
-	tbb::spin_mutex::scoped_lock spinlock(myAddLock);
-	while (myAddQueue.size())
+	myAddBuffer.Consume(myGOBatch);
+	if (!myGOBatch.empty())
 	{
-		Handle<GameObject> go = myAddQueue.front();
-		myAddQueue.pop();
-		myWorld.Add(go);
+		myWorld.Add(myGOBatch);
+		myGOBatch.clear();
 	}
 }
 
@@ -697,13 +718,32 @@ void Game::RemoveGameObjects()
 	AssertLock assertLock(myGOMutex);
 #endif
 
-	tbb::spin_mutex::scoped_lock spinlock(myRemoveLock);
-	ourGODeleteEnabled = true;
-	while (myRemoveQueue.size())
+	myRemoveBuffer.Consume(myGOBatch);
+	if (!myGOBatch.empty())
 	{
-		Handle<GameObject> go = myRemoveQueue.front();
-		myWorld.Remove(go);
-		myRemoveQueue.pop();
+		myWorld.Remove(myGOBatch);
+		// dropping the last handles deletes the objects
+		ourGODeleteEnabled = true;
+		myGOBatch.clear();
+		ourGODeleteEnabled = false;
 	}
-	ourGODeleteEnabled = false;
-}
\ No newline at end of file
+}
+
+void Game::TransformUpdate()
+{
+	Profiler::ScopedMark profile(__func__);
+
+	// only objects that moved this frame, or whose parents moved, get touched
+	TransformStore& transforms = GameObject::GetTransformStore();
+	transforms.PropagateDirty(myUpdatedTransforms);
+
+	constexpr size_t kGrainSize = 1024;
+	transforms.ParallelForEachWorld(myUpdatedTransforms, kGrainSize,
+		[](void* anOwner, const Transform& aWorld) {
+		GameObject* go = static_cast<GameObject*>(anOwner);
+		if (Renderable* renderable = go->GetRenderable())
+		{
+			renderable->myVO.SetTransform(aWorld);
+		}
+	});
+}
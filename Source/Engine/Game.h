@@ -4,6 +4,7 @@
 #include <Core/Debug/DebugDrawer.h>
 #include <Core/Utils.h>
 #include <Core/StableVector.h>
+#include <Core/Threading/PerThreadBuffer.h>
 
 #include "GameTaskManager.h"
 #include "GameObject.h"
@@ -38,6 +39,7 @@ public:
 			AnimationUpdate,
 			GameUpdate,
 			RemoveGameObjects,
+			TransformUpdate,
 			UpdateEnd,
 			Render,
 			UpdateAudio,
@@ -52,7 +54,7 @@ public:
 	{
 		Terrain* myTerrain; // owning
 		VisualObject* myVisualObject; // owning
-		PhysicsComponent* myPhysComponent; // owning
+		PhysicsComponent* myPhysComponent; // owning, from ComponentPools
 	};
 
 public:
@@ -105,6 +107,11 @@ public:
 	EngineSettings& GetEngineSettings() { return mySettings; }
 	const EngineSettings& GetEngineSettings() const { return mySettings; }
 
+	// Traces GameTasks of aFrameCount frames, starting with the next one,
+	// and writes the critical path report to aReportPath
+	// (see GameTaskManager::StartTrace)
+	void RequestTaskTrace(uint32_t aFrameCount, std::string_view aReportPath);
+
 	// Adds GameObject and it's children to the world
 	// Does not add the parent of the GameObject to the world -
 	// it is assumed it's already been added
@@ -140,6 +147,7 @@ private:
 	void UpdateAudio();
 	void UpdateEnd();
 	void RemoveGameObjects();
+	void TransformUpdate();
 
 	static Game* ourInstance;
 	RenderThread* myRenderThread;
@@ -151,13 +159,17 @@ private:
 
 	Utils::AffinitySetter myAffinitySetter{ Utils::AffinitySetter::Priority::Medium };
 	Camera* myCamera;
-	tbb::spin_mutex myAddLock, myRemoveLock;
 	World myWorld;
-	std::queue<Handle<GameObject>> myAddQueue;
-	std::queue<Handle<GameObject>> myRemoveQueue;
+	// GameObjects get queued from any thread, and are added/removed
+	// from the world in bulk once per frame
+	PerThreadBuffer<Handle<GameObject>> myAddBuffer;
+	PerThreadBuffer<Handle<GameObject>> myRemoveBuffer;
+	// shared, since Add and Remove stages never overlap
+	std::vector<Handle<GameObject>> myGOBatch;
 	
 	StableVector<Renderable> myRenderables;
 	std::mutex myRenderablesMutex;
+	std::vector<TransformStore::Id> myUpdatedTransforms;
 	
 	std::vector<TerrainEntity> myTerrains;
 	AssetTracker* myAssetTracker;
@@ -169,6 +181,9 @@ private:
 	EngineSettings mySettings;
 	TopBar myTopBar;
 	FileWatcher* myFileWatcher;
+	// pending trace request, started between frames
+	std::string myTraceReportPath;
+	uint32_t myTraceFrameCount = 0;
 
 	bool myIsRunning;
 	bool myShouldEnd;
@@ -40,10 +40,11 @@ public:
 	}
 };
 
+TransformStore GameObject::ourTransforms;
+
 GameObject::GameObject(const Transform& aTransform)
 	: myUID(UID::Create())
-	, myWorldTransf(aTransform)
-	, myLocalTransf(aTransform)
+	, myTransfId(ourTransforms.Add(aTransform, TransformStore::kInvalidId, this))
 	, myIsDead(false)
 	, myCenter(0)
 {
@@ -52,8 +53,7 @@ GameObject::GameObject(const Transform& aTransform)
 GameObject::GameObject(Id anId, std::string_view aPath)
 	: Resource(anId, aPath)
 	, myUID(UID::Create())
-	, myWorldTransf(Transform())
-	, myLocalTransf(Transform())
+	, myTransfId(ourTransforms.Add(Transform(), TransformStore::kInvalidId, this))
 	, myIsDead(false)
 	, myCenter(0)
 {
@@ -63,73 +63,38 @@ GameObject::~GameObject()
 {
 	ASSERT_STR(Game::ourGODeleteEnabled, "GameObject got deleted outside cleanup stage!");
 
-	for (ComponentBase* comp : myComponents)
+	for (size_t i = 0; i < myComponents.GetCount(); i++)
 	{
-		delete comp;
+		ComponentPools::Free(myComponents.GetAt(i));
 	}
 
 	if (myRenderable)
 	{
 		Game::GetInstance()->DeleteRenderable(*myRenderable);
 	}
+
+	ourTransforms.Remove(myTransfId);
 }
 
-void GameObject::SetLocalTransform(const Transform& aTransf, bool aMoveChildren /* = true */)
+void GameObject::SetLocalTransform(const Transform& aTransf)
 {
 #ifdef ASSERT_MUTEX
 	AssertLock lock(myPhysMutex);
 #endif
-	if (aTransf != myLocalTransf)
+	if (aTransf != GetLocalTransform())
 	{
-		myLocalTransf = aTransf;
-
-		Transform parentTransf;
-		if (myParent.IsValid())
-		{
-			parentTransf = myParent->GetWorldTransform();
-		}
-		myWorldTransf = parentTransf * myLocalTransf;
-
-		if (aMoveChildren)
-		{
-			UpdateHierarchyTransform();
-		}
-
-		if (myRenderable)
-		{
-			myRenderable->myVO.SetTransform(myWorldTransf);
-		}
+		ourTransforms.SetLocal(myTransfId, aTransf);
 	}
 }
 
-void GameObject::SetWorldTransform(const Transform& aTransf, bool aMoveChildren /* = true */)
+void GameObject::SetWorldTransform(const Transform& aTransf)
 {
 #ifdef ASSERT_MUTEX
 	AssertLock lock(myPhysMutex);
 #endif
-	if (aTransf != myWorldTransf)
+	if (aTransf != GetWorldTransform())
 	{
-		myWorldTransf = aTransf;
-
-		if (myParent.IsValid())
-		{
-			myLocalTransf = myParent->GetWorldTransform() * myWorldTransf.GetInverted();
-		}
-		else
-		{
-			myLocalTransf = myWorldTransf;
-		}
-		
-
-		if (aMoveChildren)
-		{
-			UpdateHierarchyTransform();
-		}
-
-		if (myRenderable)
-		{
-			myRenderable->myVO.SetTransform(myWorldTransf);
-		}
+		ourTransforms.SetWorld(myTransfId, aTransf);
 	}
 }
 
@@ -139,7 +104,7 @@ void GameObject::CreateRenderable()
 
 	// TODO: store a reference to Game instead of grabbing the global instance
 	myRenderable = &Game::GetInstance()->CreateRenderable(*this);
-	myRenderable->myVO.SetTransform(myWorldTransf);
+	myRenderable->myVO.SetTransform(GetWorldTransform());
 }
 
 void GameObject::Die()
@@ -152,17 +117,16 @@ void GameObject::SetParent(Handle<GameObject>& aParent, bool aKeepWorldTransf /*
 {
 	ASSERT_STR(aParent.IsValid(), "Trying to use invalid game object!");
 	myParent = aParent;
+	ourTransforms.SetParent(myTransfId, aParent->myTransfId);
+	const Transform worldTransf = GetWorldTransform();
 	if (aKeepWorldTransf)
 	{
-		// force recalculation of world transf
-		myWorldTransf = {};
-		SetWorldTransform(myWorldTransf);
+		// recalculates local transf relative to new parent
+		ourTransforms.SetWorld(myTransfId, worldTransf);
 	}
 	else
 	{
-		// force recalculation of local transf
-		myLocalTransf = {};
-		SetLocalTransform(myWorldTransf);
+		ourTransforms.SetLocal(myTransfId, worldTransf);
 	}
 }
 
@@ -185,6 +149,7 @@ void GameObject::DetachChild(size_t aInd)
 {
 	ASSERT_STR(aInd < myChildren.size(), "No child with index {}!", aInd);
 	myChildren[aInd]->myParent = Handle<GameObject>();
+	ourTransforms.SetParent(myChildren[aInd]->myTransfId, TransformStore::kInvalidId);
 	myChildren[aInd]->SetLocalTransform(myChildren[aInd]->GetWorldTransform());
 	myChildren.erase(myChildren.begin() + aInd);
 }
@@ -197,9 +162,10 @@ void GameObject::DetachChild(const Handle<GameObject>& aGO)
 	DetachChild(index);
 }
 
-void GameObject::SetWorld(World* aWorld)
+void GameObject::SetWorld(World* aWorld, World::ObjectId anId)
 {
 	myWorld = aWorld;
+	myWorldId = anId;
 	HierarchyAccess::RunOnChildren(*this, [aWorld](GameObject& aGO) {
 		aGO.myWorld = aWorld;
 	});
@@ -214,7 +180,7 @@ void GameObject::SetPhysTransform(const glm::mat4& aTransf)
 	newTransf.SetRotation(glm::quat_cast(aTransf));
 	// But we must reapply our scale, as we drop it when
 	// we send it to Bullet 
-	newTransf.SetScale(myWorldTransf.GetScale());
+	newTransf.SetScale(GetWorldTransform().GetScale());
 	SetWorldTransform(newTransf);
 }
 
@@ -222,19 +188,11 @@ void GameObject::GetPhysTransform(glm::mat4& aTransf) const
 {
 	// Bullet doesn't support scale, so we have to rely on the user
 	// to scale the shape themselves
-	Transform transf = myWorldTransf;
+	Transform transf = GetWorldTransform();
 	transf.SetScale({ 1, 1, 1 });
 	aTransf = transf.GetMatrix();
 }
 
-void GameObject::UpdateHierarchyTransform()
-{
-	// Expectation that local transform is up to date!
-	HierarchyAccess::RunOnChildren(*this, [](GameObject& aGO) {
-		aGO.myWorldTransf = aGO.GetParent()->GetWorldTransform() * aGO.myLocalTransf;
-	});
-}
-
 void GameObject::Serialize(Serializer& aSerializer)
 {
 	// Checking if we're deserializing a child GameObject
@@ -247,89 +205,77 @@ void GameObject::Serialize(Serializer& aSerializer)
 		// this will avoid zombie objects,
 		// save time and prevent further hierarchy deserialization
 		myParent = Handle<GameObject>();
+		ourTransforms.SetParent(myTransfId, TransformStore::kInvalidId);
 		return;
 	}
 
 	aSerializer.Serialize("myUID", myUID);
 	
 	// we can reconstruct world from local, so only serializing local
-	aSerializer.Serialize("myLocalTransf", myLocalTransf);
+	Transform localTransf = GetLocalTransform();
+	aSerializer.Serialize("myLocalTransf", localTransf);
 	if (isReading)
 	{
 		// because we're serializing hierarchy top to bottom,
 		// parent GO can set the myParent early
-		if(myParent.IsValid())
-		{
-			myWorldTransf = myParent->GetWorldTransform() * myLocalTransf;
-		}
-		else
-		{
-			myWorldTransf = myLocalTransf;
-		}
+		ourTransforms.SetLocal(myTransfId, localTransf);
+		ourTransforms.UpdateWorld(myTransfId);
 	}
 
 	aSerializer.Serialize("myCenter", myCenter);
 
-	size_t compsCount = myComponents.size();
+	size_t compsCount = myComponents.GetCount();
 	if (Serializer::ArrayScope compsScope{ aSerializer, "myComponents", compsCount })
 	{
-		if (isReading)
-		{
-			myComponents.resize(compsCount);
-		}
-
+		// components of matching types get reused, the rest get replaced
+		ComponentSet readComponents;
 		for (size_t i = 0; i < compsCount; i++)
 		{
 			if (Serializer::ObjectScope compTypeScope{ aSerializer, Serializer::kArrayElem })
 			{
+				ComponentBase* comp = nullptr;
 				if (isReading)
 				{
 					std::string compType;
-					std::string_view oldCompName;
-					if (myComponents[i])
-					{
-						compType = myComponents[i]->GetName();
-						oldCompName = myComponents[i]->GetName();
-					}
 					aSerializer.Serialize("myCompType", compType);
-					if (!compType.empty())
-					{
-						if (compType != oldCompName
-							&& ComponentRegister::Get().Contains(compType))
-						{
-							if (myComponents[i])
-							{
-								delete myComponents[i];
-							}
-							myComponents[i] = ComponentRegister::Get().Create(compType);
-							myComponents[i]->Init(this);
-						}
-					}
-					else
+					const ComponentRegister& compRegister = ComponentRegister::Get();
+					if (!compType.empty() && compRegister.Contains(compType))
 					{
-						if (myComponents[i])
+						comp = myComponents.Remove(compRegister.GetTypeId(compType));
+						if (!comp)
 						{
-							delete myComponents[i];
+							comp = compRegister.Create(compType);
+							comp->Init(this);
 						}
-						myComponents[i] = nullptr;
+						readComponents.Add(*comp);
 					}
 				}
 				else
 				{
-					std::string_view compTypeView = myComponents[i]->GetName();
+					comp = &myComponents.GetAt(i);
+					std::string_view compTypeView = comp->GetName();
 					std::string compType(compTypeView.data(), compTypeView.size());
 					aSerializer.Serialize("myCompType", compType);
 				}
 
-				if (myComponents[i])
+				if (comp)
 				{
 					if (Serializer::ObjectScope compScope{ aSerializer, "myCompData" })
 					{
-						myComponents[i]->Serialize(aSerializer);
+						comp->Serialize(aSerializer);
 					}
 				}
 			}
 		}
+
+		if (isReading)
+		{
+			for (size_t i = 0; i < myComponents.GetCount(); i++)
+			{
+				ComponentPools::Free(myComponents.GetAt(i));
+			}
+			myComponents = std::move(readComponents);
+		}
 	}
 
 	// We're skipping parent serialization as it doesn't make much sense in
@@ -343,6 +289,7 @@ void GameObject::Serialize(Serializer& aSerializer)
 			// To mitigate, children's serialization starts with a check if they own
 			// the last handle
 			child->myParent = this;
+			ourTransforms.SetParent(child->myTransfId, myTransfId);
 		}
 	}
 }
\ No newline at end of file
@@ -2,17 +2,18 @@
 
 #include <Graphics/Graphics.h>
 #include <Core/Transform.h>
+#include <Core/TransformStore.h>
 #include <Core/UID.h>
 #include <Physics/PhysicsEntity.h>
 #include <Core/Pool.h>
 #include <Core/Resources/Resource.h>
 
 #include "Animation/AnimationController.h"
+#include "Components/ComponentBase.h"
 #include "VisualObject.h"
+#include "World.h"
 
-class ComponentBase;
 class GameObject;
-class World;
 
 struct Renderable
 {
@@ -29,18 +30,28 @@ public:
 	GameObject(Id anId, std::string_view aPath);
 	~GameObject();
 
-	const Transform& GetLocalTransform() const { return myLocalTransf; }
-	const Transform& GetWorldTransform() const { return myWorldTransf; }
-	void SetLocalTransform(const Transform& aTransf, bool aMoveChildren = true);
-	void SetWorldTransform(const Transform& aTransf, bool aMoveChildren = true);
+	Transform GetLocalTransform() const { return ourTransforms.GetLocal(myTransfId); }
+	Transform GetWorldTransform() const { return ourTransforms.GetWorld(myTransfId); }
+	// Deferred: this object's world transform, its children's world transforms
+	// and the renderables only get updated by Game's TransformUpdate step.
+	// Until then GetWorldTransform of this object and its children returns
+	// the values from before the call
+	void SetLocalTransform(const Transform& aTransf);
+	// World transform of this object is updated right away, but world
+	// transforms of its children and the renderable are deferred until
+	// Game's TransformUpdate step, same as with SetLocalTransform
+	void SetWorldTransform(const Transform& aTransf);
 
 	const UID& GetUID() const { return myUID; }
 	
+	// Components are allocated from per-type ComponentPools,
+	// only one component of each type is supported
 	template<class TComp, class... TArgs>
 	TComp* AddComponent(TArgs&&... anArgs);
 
+	// Matches the exact type only, TComp has to be in ComponentTypes::List
 	template<class TComp>
-	TComp* GetComponent() const;
+	TComp* GetComponent() const { return myComponents.Get<TComp>(); }
 
 	void CreateRenderable();
 	const Renderable* GetRenderable() const { return myRenderable; }
@@ -66,13 +77,18 @@ public:
 	void DetachChild(size_t aInd);
 	void DetachChild(const Handle<GameObject>& aGO);
 
-	void SetWorld(World* aWorld);
+	// Children inherit the world, but only get an id once they're added to it
+	void SetWorld(World* aWorld, World::ObjectId anId);
 	World* GetWorld() { return myWorld; }
 	const World* GetWorld() const { return myWorld; }
+	World::ObjectId GetWorldId() const { return myWorldId; }
 
 	void Serialize(Serializer& aSerializer) final;
 	std::string_view GetTypeName() const override { return "GameObject"; }
 
+	// Shared storage of all GameObject transforms
+	static TransformStore& GetTransformStore() { return ourTransforms; }
+
 	// IPhysControllable impl
 private:
 	void SetPhysTransform(const glm::mat4& aTransf) final;
@@ -80,15 +96,15 @@ private:
 
 private:
 	friend class HierarchyAccess;
-	void UpdateHierarchyTransform();
+
+	static TransformStore ourTransforms;
 
 	UID myUID;
 	
-	Transform myWorldTransf;
-	Transform myLocalTransf;
+	TransformStore::Id myTransfId;
 	glm::vec3 myCenter;
 
-	std::vector<ComponentBase*> myComponents;
+	ComponentSet myComponents;
 	Renderable* myRenderable = nullptr; // owning
 	PoolPtr<Skeleton> mySkeleton;
 	PoolPtr<AnimationController> myAnimController;
@@ -98,6 +114,7 @@ private:
 	bool myIsDead;
 
 	World* myWorld = nullptr;
+	World::ObjectId myWorldId;
 
 #ifdef ASSERT_MUTEX
 	AssertMutex myPhysMutex;
@@ -107,22 +124,8 @@ private:
 template<class TComp, class... TArgs>
 TComp* GameObject::AddComponent(TArgs&&... anArgs)
 {
-	// TODO: get rid of this, replace with Component Pool use
-	TComp* newComp = new TComp(std::forward<TArgs>(anArgs)...);
-	newComp->Init(this);
-	myComponents.push_back(newComp);
-	return newComp;
-}
-
-template<class TComp>
-TComp* GameObject::GetComponent() const
-{
-	for (ComponentBase* comp : myComponents)
-	{
-		if (TComp* dynComp = dynamic_cast<TComp*>(comp))
-		{
-			return dynComp;
-		}
-	}
-	return nullptr;
+	TComp& newComp = ComponentPools::Get<TComp>().Allocate(std::forward<TArgs>(anArgs)...);
+	newComp.Init(this);
+	myComponents.Add(newComp);
+	return &newComp;
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "Precomp.h"
 #include "GameTaskManager.h"
 
+#include "GameTaskTracer.h"
+
 #include <Core/Profiler.h>
 
+#include <tbb/global_control.h>
+
 GameTask::GameTask(Type aType, std::function<void()> aCallback)
 	: myType(aType)
 	, myCallback(aCallback)
@@ -24,11 +28,17 @@ GameTaskManager::ExternalDependencyScope::~ExternalDependencyScope()
 }
 
 GameTaskManager::GameTaskManager()
-	: myTaskGraph(std::make_unique<tbb::flow::graph>())
+	: myTracer(std::make_unique<GameTaskTracer>())
 	, myIsRunning(false)
 {
+	for (std::unique_ptr<tbb::flow::graph>& graph : myTaskGraphs)
+	{
+		graph = std::make_unique<tbb::flow::graph>();
+	}
 }
 
+GameTaskManager::~GameTaskManager() = default;
+
 void GameTaskManager::AddTask(const GameTask& aTask)
 {
 	ASSERT_STR(!myTasks.contains(aTask.GetType()), "Task id {} is already in use!", aTask.GetType());
@@ -55,28 +65,113 @@ GameTaskManager::ExternalDependencyScope GameTaskManager::AddExternalDependency(
 	ASSERT_STR(iter != myTaskNodes.end(), "Failed to find a task!");
 	TaskNodeType& task = static_cast<TaskNodeType&>(*iter->second);
 
-	std::shared_ptr<StartNodeType> startNode = std::make_shared<StartNodeType>(*myTaskGraph.get());
+	const Stage stage = GetTask(aType).GetStage();
+	ASSERT_STR(stage == Stage::Simulation || myPipelineDepth == 1,
+		"Render stage can still be running, can't safely relink it!");
+	tbb::flow::graph& graph = *myTaskGraphs[static_cast<size_t>(stage)];
+
+	std::shared_ptr<StartNodeType> startNode = std::make_shared<StartNodeType>(graph);
 	myExternalDepsResetQueue.push({ startNode, aType });
 	return { startNode, task };
 }
 
+void GameTaskManager::SetPipelineDepth(size_t aDepth)
+{
+	ASSERT_STR(aDepth > 0 && aDepth <= kMaxPipelineDepth, "Unsupported pipeline depth: {}!", aDepth);
+	WaitAll();
+	myPipelineDepth = aDepth;
+}
+
+void GameTaskManager::StartTrace(uint32_t aFrameCount, std::string_view aReportPath)
+{
+	ASSERT_STR(!myIsRunning, "Trace must be started between frames!");
+	if (myNeedsResolve)
+	{
+		// tracer needs to know the tasks
+		WaitAll();
+		ResolveDependencies();
+		myNeedsResolve = false;
+	}
+	myTracer->Start(mySimFrame, aFrameCount, aReportPath);
+}
+
+bool GameTaskManager::IsTracing() const
+{
+	return myTracer->IsRecording();
+}
+
 void GameTaskManager::Run()
 {
 	if (myNeedsResolve)
 	{
+		// we're about to rebuild the graphs, so nothing can be in flight
+		WaitAll();
 		ResolveDependencies();
 		myNeedsResolve = false;
 	}
 	myIsRunning = true;
-	constexpr GameTask::Type startType = static_cast<GameTask::Type>(GameTask::ReservedTypes::GraphBroadcast);
-	StartNodeType* from = static_cast<StartNodeType*>(myTaskNodes[startType].get());
+	StartNodeType* from = myStartNodes[static_cast<size_t>(Stage::Simulation)].get();
 	from->try_put(tbb::flow::continue_msg());
 }
 
 void GameTaskManager::Wait()
 {
 	Profiler::ScopedMark mark("GameTaskManager::Wait");
-	myTaskGraph->wait_for_all();
+	if (myIsRunning)
+	{
+		myTaskGraphs[static_cast<size_t>(Stage::Simulation)]->wait_for_all();
+		if (myPipelineDepth > 1)
+		{
+			// next Run will write snapshots of the frame after this one, so
+			// renders of up to depth-2 frames can be left in flight
+			WaitForRenders(static_cast<uint32_t>(myPipelineDepth - 2));
+		}
+		ScheduleRender();
+		mySimFrame++;
+		myIsRunning = false;
+	}
+
+	if (myPipelineDepth == 1)
+	{
+		WaitForRenders(0);
+	}
+
+	ResetExternalDependencies();
+
+	if (myTracer->IsRecording())
+	{
+		myTracer->TryFinish(myRenderedFrames);
+	}
+}
+
+void GameTaskManager::WaitAll()
+{
+	Wait();
+	WaitForRenders(0);
+}
+
+void GameTaskManager::WaitForRenders(uint32_t aMaxQueued)
+{
+	const bool hasWorkers = tbb::this_task_arena::max_concurrency() > 1
+		&& tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism) > 1;
+	if (aMaxQueued == 0 || !hasWorkers)
+	{
+		// helps out with the renders instead of just blocking - without
+		// worker threads there would be no one else to run them
+		myTaskGraphs[static_cast<size_t>(Stage::Render)]->wait_for_all();
+		return;
+	}
+
+	uint32_t queuedRenders = myQueuedRenders;
+	while (queuedRenders > aMaxQueued)
+	{
+		myQueuedRenders.wait(queuedRenders);
+		queuedRenders = myQueuedRenders;
+	}
+}
+
+void GameTaskManager::ResetExternalDependencies()
+{
 	while (!myExternalDepsResetQueue.empty())
 	{
 		auto& [externDep, taskType] = myExternalDepsResetQueue.front();
@@ -85,7 +180,26 @@ void GameTaskManager::Wait()
 		externDep->remove_successor(task);
 		myExternalDepsResetQueue.pop();
 	}
-	myIsRunning = false;
+}
+
+void GameTaskManager::ScheduleRender()
+{
+	// Render stages run one at a time in frame order - if there's one
+	// already going, OnRenderDone will kick this one off
+	if (myQueuedRenders.fetch_add(1) == 0)
+	{
+		myStartNodes[static_cast<size_t>(Stage::Render)]->try_put(tbb::flow::continue_msg());
+	}
+}
+
+void GameTaskManager::OnRenderDone()
+{
+	myRenderedFrames++;
+	if (myQueuedRenders.fetch_sub(1) > 1)
+	{
+		myStartNodes[static_cast<size_t>(Stage::Render)]->try_put(tbb::flow::continue_msg());
+	}
+	myQueuedRenders.notify_all();
 }
 
 void GameTaskManager::ResolveDependencies()
@@ -109,36 +223,97 @@ void GameTaskManager::ResolveDependencies()
 
 	// throw away all current nodes from the graph
 	myTaskNodes.clear();
+	myRenderDoneNode.reset();
 
 	// construct all the graph nodes
-	constexpr GameTask::Type kStartType = static_cast<GameTask::Type>(GameTask::ReservedTypes::GraphBroadcast);
-	myTaskNodes[kStartType] = std::make_shared<StartNodeType>(*myTaskGraph);
-	for (const auto [taskType, gameTask] : myTasks)
+	for (size_t stage = 0; stage < kStageCount; stage++)
+	{
+		myStartNodes[stage] = std::make_shared<StartNodeType>(*myTaskGraphs[stage]);
+	}
+	std::unordered_map<GameTask::Type, GameTaskTracer::Index> traceIndices;
+	for (const auto& [taskType, gameTask] : myTasks)
+	{
+		const GameTaskTracer::Index traceIndex = static_cast<GameTaskTracer::Index>(traceIndices.size());
+		traceIndices[taskType] = traceIndex;
+
+		const Stage stage = gameTask.GetStage();
+		auto taskBody = [this, stage, traceIndex, callback = gameTask.myCallback](tbb::flow::continue_msg) {
+			if (!myTracer->IsRecording()) [[likely]]
+			{
+				callback();
+				return;
+			}
+
+			const uint64_t frame = stage == Stage::Render ? GetRenderFrame() : GetSimFrame();
+			const int64_t start = GameTaskTracer::Now();
+			callback();
+			myTracer->Record(frame, traceIndex, start, GameTaskTracer::Now());
+		};
+		tbb::flow::graph& graph = *myTaskGraphs[static_cast<size_t>(stage)];
+		myTaskNodes[taskType] = std::make_shared<TaskNodeType>(graph, taskBody);
+	}
+
+	std::vector<GameTaskTracer::TaskInfo> traceInfos(myTasks.size());
+	for (const auto& [taskType, gameTask] : myTasks)
 	{
-		myTaskNodes[taskType] = std::make_shared<TaskNodeType>(*myTaskGraph, gameTask);
+		GameTaskTracer::TaskInfo& info = traceInfos[traceIndices[taskType]];
+		info.myName = gameTask.GetName();
+		info.myStage = gameTask.GetStage();
+		for (GameTask::Type dependency : gameTask.GetDependencies())
+		{
+			if (GetTask(dependency).GetStage() == info.myStage)
+			{
+				info.myDependencies.push_back(traceIndices[dependency]);
+			}
+		}
 	}
+	myTracer->SetTasks(std::move(traceInfos), mySimFrame);
+	myRenderDoneNode = std::make_shared<TaskNodeType>(*myTaskGraphs[static_cast<size_t>(Stage::Render)],
+		[this](tbb::flow::continue_msg) { OnRenderDone(); }
+	);
 
 	// then we can make the graph edges
+	bool hasRenderTasks = false;
 	for (const auto [taskType, gameTask] : myTasks)
 	{
-		const std::vector<GameTask::Type>& dependencies = gameTask.GetDependencies();
-		if (size_t count = dependencies.size())
+		const Stage stage = gameTask.GetStage();
+		TaskNodeType* to = static_cast<TaskNodeType*>(myTaskNodes[taskType].get());
+
+		bool hasStageDeps = false;
+		for (GameTask::Type dependency : gameTask.GetDependencies())
 		{
-			for (size_t i = 0; i < count; i++)
+			const Stage depStage = GetTask(dependency).GetStage();
+			ASSERT_STR(depStage <= stage, "{} depends on a task from a later stage!", gameTask.GetName());
+			if (depStage != stage)
 			{
-				// edge from dependent on to depending
-				TaskNodeType* from = static_cast<TaskNodeType*>(myTaskNodes[dependencies[i]].get());
-				TaskNodeType* to = static_cast<TaskNodeType*>(myTaskNodes[taskType].get());
-				tbb::flow::make_edge(*from, *to);
+				// earlier stages are always fully done by the time this one starts
+				continue;
 			}
+
+			// edge from dependent on to depending
+			TaskNodeType* from = static_cast<TaskNodeType*>(myTaskNodes[dependency].get());
+			tbb::flow::make_edge(*from, *to);
+			hasStageDeps = true;
 		}
-		else
+
+		if (!hasStageDeps)
 		{
 			// with no dependencies we can kick it off at the start
-			StartNodeType* from = static_cast<StartNodeType*>(myTaskNodes[kStartType].get());
-			TaskNodeType* to = static_cast<TaskNodeType*>(myTaskNodes[taskType].get());
+			StartNodeType* from = myStartNodes[static_cast<size_t>(stage)].get();
 			tbb::flow::make_edge(*from, *to);
 		}
+
+		if (stage == Stage::Render)
+		{
+			tbb::flow::make_edge(*to, *myRenderDoneNode);
+			hasRenderTasks = true;
+		}
+	}
+
+	if (!hasRenderTasks)
+	{
+		// still need to track frame completion
+		tbb::flow::make_edge(*myStartNodes[static_cast<size_t>(Stage::Render)], *myRenderDoneNode);
 	}
 
 	// lastly, we might've had external dependencies scheduled
@@ -157,4 +332,4 @@ void GameTaskManager::ResolveDependencies()
 			myExternalDepsResetQueue.push(std::move(pair));
 		}
 	}
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 
 #include <Core/Utils.h>
 
+class GameTaskTracer;
+
 class GameTask
 {
 public:
@@ -12,6 +14,16 @@ public:
 
 	using Type = uint16_t;
 
+	// Render tasks of a frame start once every Simulation task of that frame
+	// is done, and can overlap with Simulation of the following frames
+	// (see GameTaskManager::SetPipelineDepth)
+	enum class Stage : uint8_t
+	{
+		Simulation,
+		Render,
+		Count
+	};
+
 public:
 	GameTask(Type aType, std::function<void()> aCallback);
 	void operator()(tbb::flow::continue_msg) const { myCallback(); }
@@ -22,6 +34,10 @@ public:
 	void SetName(std::string_view aName) { myName = aName; }
 	std::string_view GetName() const { return myName; }
 
+	// Dependencies on tasks of an earlier stage are implicitly satisfied
+	void SetStage(Stage aStage) { myStage = aStage; }
+	Stage GetStage() const { return myStage; }
+
 private:
 	friend class GameTaskManager;
 	Type GetType() const { return myType; }
@@ -30,6 +46,7 @@ private:
 	std::vector<Type> myDependencies;
 	std::string_view myName;
 	Type myType;
+	Stage myStage = Stage::Simulation;
 };
 
 // thanks https://software.intel.com/en-us/node/506218
@@ -53,23 +70,62 @@ public:
 		std::weak_ptr<StartNodeType> myStartNode;
 	};
 
+	constexpr static size_t kMaxPipelineDepth = 4;
+
 	GameTaskManager();
+	~GameTaskManager();
 
 	void AddTask(const GameTask& aTask);
 	GameTask& GetTask(GameTask::Type anId);
+	// Only supported for Render stage tasks when pipeline depth is 1
 	ExternalDependencyScope AddExternalDependency(GameTask::Type aType);
 
 	const std::unordered_map<GameTask::Type, GameTask>& GetTasks() const { return myTasks; }
 
+	// How many frames can be in flight at once. At 1 every frame is fully
+	// done by the time Wait returns. At 2+ Render stage of a frame keeps
+	// running while the next frames get simulated, with Render stages
+	// executing in frame order. Waits for all in-flight frames to finish
+	void SetPipelineDepth(size_t aDepth);
+	size_t GetPipelineDepth() const { return myPipelineDepth; }
+
+	// Frame that Simulation tasks are working on
+	uint64_t GetSimFrame() const { return mySimFrame; }
+	// Frame that Render tasks are working on
+	uint64_t GetRenderFrame() const { return myRenderedFrames; }
+
+	// Kicks off Simulation stage of the next frame
 	void Run();
+	// Waits for Simulation stage of the current frame, then schedules its
+	// Render stage. Returns once there are fewer frames in flight than
+	// pipeline depth, so it's safe to Run the next one
 	void Wait();
+	// Waits until every scheduled frame is completely done
+	void WaitAll();
+
+	// Records task timings of the next aFrameCount frames, and writes out
+	// a critical path report to aReportPath once they're done
+	void StartTrace(uint32_t aFrameCount, std::string_view aReportPath);
+	bool IsTracing() const;
 
 private:
+	using Stage = GameTask::Stage;
+	constexpr static size_t kStageCount = static_cast<size_t>(Stage::Count);
+
 	void ResolveDependencies();
+	void ResetExternalDependencies();
+	void ScheduleRender();
+	void OnRenderDone();
+	// Returns once at most aMaxQueued Render stages are left in flight
+	void WaitForRenders(uint32_t aMaxQueued);
 
 	tbb::task_arena myTaskArena;
 	Utils::AffinitySetter myAffinitySetter{ myTaskArena, Utils::AffinitySetter::Priority::High };
-	std::unique_ptr<tbb::flow::graph> myTaskGraph;
+	// Every stage gets its own graph, so that we can wait on them separately
+	std::unique_ptr<tbb::flow::graph> myTaskGraphs[kStageCount];
+	std::shared_ptr<StartNodeType> myStartNodes[kStageCount];
+	// Runs after all Render tasks, to chain the next queued frame
+	std::shared_ptr<TaskNodeType> myRenderDoneNode;
 	std::unordered_map<GameTask::Type, GameTask> myTasks;
 	std::unordered_map<GameTask::Type, std::shared_ptr<BaseTaskNodeType>> myTaskNodes;
 	struct ExternalDepPair
@@ -78,6 +134,12 @@ private:
 		const GameTask::Type myTaskType;
 	};
 	std::queue<ExternalDepPair> myExternalDepsResetQueue;
+	std::unique_ptr<GameTaskTracer> myTracer;
+	size_t myPipelineDepth = 1;
+	uint64_t mySimFrame = 0;
+	std::atomic<uint64_t> myRenderedFrames = 0;
+	// Render stages that are scheduled, but not yet done
+	std::atomic<uint32_t> myQueuedRenders = 0;
 	std::atomic<bool> myIsRunning;
 	std::atomic<bool> myNeedsResolve = true;
-};
\ No newline at end of file
+};
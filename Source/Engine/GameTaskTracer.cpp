@@ -0,0 +1,268 @@
+#include "Precomp.h"
+#include "GameTaskTracer.h"
+
+#include <Core/File.h>
+
+#include <map>
+#include <numeric>
+#include <nlohmann/json.hpp>
+
+void GameTaskTracer::SetTasks(std::vector<TaskInfo>&& aTasks, uint64_t aNextFrame)
+{
+	myTasks = std::move(aTasks);
+	if (IsRecording())
+	{
+		std::println("[Info] GameTaskTracer: tasks changed, restarting the trace");
+		Start(aNextFrame, myFrameCount, myReportPath);
+	}
+}
+
+void GameTaskTracer::Start(uint64_t aFirstFrame, uint32_t aFrameCount, std::string_view aReportPath)
+{
+	ASSERT_STR(aFrameCount > 0, "Need at least 1 frame to trace!");
+	myFirstFrame = aFirstFrame;
+	myFrameCount = aFrameCount;
+	myReportPath = aReportPath;
+	myTimings.clear();
+	myTimings.resize(myTasks.size() * aFrameCount);
+	myIsRecording.store(true, std::memory_order_relaxed);
+}
+
+int64_t GameTaskTracer::Now()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void GameTaskTracer::Record(uint64_t aFrame, Index aTask, int64_t aStart, int64_t anEnd)
+{
+	if (aFrame < myFirstFrame || aFrame >= myFirstFrame + myFrameCount)
+	{
+		return;
+	}
+
+	Timing& timing = myTimings[(aFrame - myFirstFrame) * myTasks.size() + aTask];
+	timing.myStart = aStart;
+	timing.myEnd = anEnd;
+}
+
+bool GameTaskTracer::TryFinish(uint64_t aFinishedFrames)
+{
+	if (!IsRecording() || aFinishedFrames < myFirstFrame + myFrameCount)
+	{
+		return false;
+	}
+	myIsRecording.store(false, std::memory_order_relaxed);
+
+	const std::string report = GenerateReport();
+	File file(myReportPath);
+	if (!file.Write(report.data(), report.size()))
+	{
+		std::println("[Error] GameTaskTracer: failed to write report to {}", myReportPath);
+		return false;
+	}
+	std::println("[Info] GameTaskTracer: wrote report of {} frames to {}", myFrameCount, myReportPath);
+	return true;
+}
+
+GameTaskTracer::Index GameTaskTracer::FindGatingDependency(std::span<const Timing> aFrame, Index aTask) const
+{
+	Index gating = kNoTask;
+	int64_t latestEnd = std::numeric_limits<int64_t>::min();
+	auto CheckDependency = [&](Index aDependency) {
+		if (aFrame[aDependency].myEnd > latestEnd)
+		{
+			latestEnd = aFrame[aDependency].myEnd;
+			gating = aDependency;
+		}
+	};
+
+	const TaskInfo& task = myTasks[aTask];
+	if (!task.myDependencies.empty())
+	{
+		for (Index dependency : task.myDependencies)
+		{
+			CheckDependency(dependency);
+		}
+		return gating;
+	}
+
+	// roots of a stage wait for every task of previous stages
+	for (Index other = 0; other < myTasks.size(); other++)
+	{
+		if (myTasks[other].myStage < task.myStage)
+		{
+			CheckDependency(other);
+		}
+	}
+	return gating;
+}
+
+std::string GameTaskTracer::GenerateReport() const
+{
+	const size_t taskCount = myTasks.size();
+	if (taskCount == 0)
+	{
+		return "{}";
+	}
+
+	struct TaskStats
+	{
+		int64_t myTotal = 0;
+		int64_t myMax = 0;
+		uint32_t myCriticalCount = 0;
+	};
+	struct EdgeStats
+	{
+		int64_t myTotalIdle = 0;
+		uint32_t myCount = 0;
+		uint32_t myGatingCount = 0;
+	};
+	struct PathStats
+	{
+		int64_t myTotal = 0;
+		uint32_t myCount = 0;
+	};
+	std::vector<TaskStats> taskStats(taskCount);
+	std::map<std::pair<Index, Index>, EdgeStats> edgeStats;
+	std::map<std::vector<Index>, PathStats> pathStats;
+	int64_t totalSpan = 0;
+	int64_t minSpan = std::numeric_limits<int64_t>::max();
+	int64_t maxSpan = 0;
+	double totalParallelism = 0;
+
+	std::vector<Index> path;
+	for (uint32_t frame = 0; frame < myFrameCount; frame++)
+	{
+		std::span<const Timing> timings(myTimings.data() + frame * taskCount, taskCount);
+
+		int64_t frameStart = std::numeric_limits<int64_t>::max();
+		Index lastTask = 0;
+		int64_t busyTime = 0;
+		for (Index task = 0; task < taskCount; task++)
+		{
+			const Timing& timing = timings[task];
+			const int64_t duration = timing.myEnd - timing.myStart;
+			taskStats[task].myTotal += duration;
+			taskStats[task].myMax = std::max(taskStats[task].myMax, duration);
+			busyTime += duration;
+
+			frameStart = std::min(frameStart, timing.myStart);
+			if (timing.myEnd > timings[lastTask].myEnd)
+			{
+				lastTask = task;
+			}
+
+			const Index gating = FindGatingDependency(timings, task);
+			if (gating == kNoTask)
+			{
+				continue;
+			}
+			for (Index dependency : myTasks[task].myDependencies)
+			{
+				EdgeStats& edge = edgeStats[{ dependency, task }];
+				edge.myTotalIdle += timing.myStart - timings[dependency].myEnd;
+				edge.myCount++;
+				edge.myGatingCount += dependency == gating;
+			}
+			if (myTasks[task].myDependencies.empty())
+			{
+				// implicit edge from previous stage, only tracking the one that gated
+				EdgeStats& edge = edgeStats[{ gating, task }];
+				edge.myTotalIdle += timing.myStart - timings[gating].myEnd;
+				edge.myCount++;
+				edge.myGatingCount++;
+			}
+		}
+
+		const int64_t span = timings[lastTask].myEnd - frameStart;
+		totalSpan += span;
+		minSpan = std::min(minSpan, span);
+		maxSpan = std::max(maxSpan, span);
+		totalParallelism += span > 0 ? static_cast<double>(busyTime) / span : 0.0;
+
+		// walk back from the last task, always through the dependency
+		// that finished last - that's the one that held the task back
+		path.clear();
+		for (Index task = lastTask; task != kNoTask; task = FindGatingDependency(timings, task))
+		{
+			path.push_back(task);
+			taskStats[task].myCriticalCount++;
+		}
+		std::reverse(path.begin(), path.end());
+		PathStats& stats = pathStats[path];
+		stats.myTotal += timings[lastTask].myEnd - timings[path.front()].myStart;
+		stats.myCount++;
+	}
+
+	constexpr auto ToMs = [](double aNanoSec) { return aNanoSec / 1'000'000.0; };
+	const double frameCount = static_cast<double>(myFrameCount);
+
+	nlohmann::json report;
+	report["frames"] = myFrameCount;
+	report["frameSpanMs"] = {
+		{ "avg", ToMs(totalSpan / frameCount) },
+		{ "min", ToMs(static_cast<double>(minSpan)) },
+		{ "max", ToMs(static_cast<double>(maxSpan)) }
+	};
+	report["avgParallelism"] = totalParallelism / frameCount;
+
+	std::vector<Index> taskOrder(taskCount);
+	std::iota(taskOrder.begin(), taskOrder.end(), Index(0));
+	std::sort(taskOrder.begin(), taskOrder.end(), [&](Index aLeft, Index aRight) {
+		return taskStats[aLeft].myCriticalCount * taskStats[aLeft].myTotal
+			> taskStats[aRight].myCriticalCount * taskStats[aRight].myTotal;
+	});
+	nlohmann::json& tasksJson = report["tasks"];
+	for (Index task : taskOrder)
+	{
+		tasksJson.push_back({
+			{ "name", std::string(myTasks[task].myName) },
+			{ "stage", myTasks[task].myStage == GameTask::Stage::Render ? "Render" : "Simulation" },
+			{ "avgMs", ToMs(taskStats[task].myTotal / frameCount) },
+			{ "maxMs", ToMs(static_cast<double>(taskStats[task].myMax)) },
+			{ "criticalRatio", taskStats[task].myCriticalCount / frameCount }
+		});
+	}
+
+	std::vector<std::pair<const std::vector<Index>*, const PathStats*>> paths;
+	for (const auto& [pathTasks, stats] : pathStats)
+	{
+		paths.emplace_back(&pathTasks, &stats);
+	}
+	std::sort(paths.begin(), paths.end(), [](const auto& aLeft, const auto& aRight) {
+		return aLeft.second->myCount > aRight.second->myCount;
+	});
+	nlohmann::json& pathsJson = report["criticalPaths"];
+	for (const auto& [pathTasks, stats] : paths)
+	{
+		nlohmann::json names = nlohmann::json::array();
+		for (Index task : *pathTasks)
+		{
+			names.push_back(std::string(myTasks[task].myName));
+		}
+		pathsJson.push_back({
+			{ "tasks", std::move(names) },
+			{ "frames", stats->myCount },
+			{ "avgMs", ToMs(static_cast<double>(stats->myTotal) / stats->myCount) }
+		});
+	}
+
+	std::vector<std::pair<std::pair<Index, Index>, EdgeStats>> edges(edgeStats.begin(), edgeStats.end());
+	std::sort(edges.begin(), edges.end(), [](const auto& aLeft, const auto& aRight) {
+		return aLeft.second.myTotalIdle > aRight.second.myTotalIdle;
+	});
+	nlohmann::json& edgesJson = report["edges"];
+	for (const auto& [edge, stats] : edges)
+	{
+		edgesJson.push_back({
+			{ "from", std::string(myTasks[edge.first].myName) },
+			{ "to", std::string(myTasks[edge.second].myName) },
+			{ "avgIdleMs", ToMs(static_cast<double>(stats.myTotalIdle) / stats.myCount) },
+			{ "gatingRatio", static_cast<double>(stats.myGatingCount) / stats.myCount }
+		});
+	}
+
+	constexpr int kIndent = 1;
+	return report.dump(kIndent, '\t');
+}
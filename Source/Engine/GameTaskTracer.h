@@ -0,0 +1,62 @@
+#pragma once
+
+#include "GameTaskManager.h"
+
+// Records start and end of every GameTask over a number of frames, and then
+// writes out a JSON report: per task timings, how often each task was on
+// the critical path of the frame, which chains of tasks formed it, and how
+// long each dependency edge sat idle - time between the dependency finishing
+// and the dependent task getting started.
+// Recording is driven by GameTaskManager. When not recording, the only cost
+// is a relaxed atomic load per executed task
+class GameTaskTracer
+{
+public:
+	using Index = uint16_t;
+	struct TaskInfo
+	{
+		std::string_view myName;
+		GameTask::Stage myStage;
+		// Only dependencies from the same stage, previous stages are implicit
+		std::vector<Index> myDependencies;
+	};
+
+	// Replaces task descriptions. If a trace is in progress, it's restarted
+	// from aNextFrame, since old records no longer match the tasks
+	void SetTasks(std::vector<TaskInfo>&& aTasks, uint64_t aNextFrame);
+
+	// Starts recording aFrameCount frames, beginning from aFirstFrame.
+	// Report gets written to aReportPath once all of them are done
+	void Start(uint64_t aFirstFrame, uint32_t aFrameCount, std::string_view aReportPath);
+	bool IsRecording() const { return myIsRecording.load(std::memory_order_relaxed); }
+
+	static int64_t Now();
+	// Thread safe, as long as each task records once per frame
+	void Record(uint64_t aFrame, Index aTask, int64_t aStart, int64_t anEnd);
+
+	// Writes out the report if all traced frames have finished.
+	// Returns true if the report was written
+	bool TryFinish(uint64_t aFinishedFrames);
+	// Builds the JSON report out of recorded frames
+	std::string GenerateReport() const;
+
+private:
+	struct Timing
+	{
+		int64_t myStart = 0;
+		int64_t myEnd = 0;
+	};
+
+	// Returns the dependency that finished last, or kNoTask for graph roots
+	Index FindGatingDependency(std::span<const Timing> aFrame, Index aTask) const;
+
+	constexpr static Index kNoTask = std::numeric_limits<Index>::max();
+
+	std::vector<TaskInfo> myTasks;
+	// myFrameCount x task count, indexed by frame first
+	std::vector<Timing> myTimings;
+	std::string myReportPath;
+	uint64_t myFirstFrame = 0;
+	uint32_t myFrameCount = 0;
+	std::atomic<bool> myIsRecording = false;
+};
@@ -34,7 +34,7 @@ void DefaultRenderPass::Execute(Graphics& aGraphics)
 
 	constexpr auto IsUsable = [](const VisualObject& aVO) 
 	{
-		constexpr auto CheckResource = [](const Handle<GPUResource>& aRes) 
+		constexpr auto CheckResource = [](BorrowedHandle<GPUResource> aRes) 
 		{
 			return aRes.IsValid() && aRes->GetState() == GPUResource::State::Valid;
 		};
@@ -177,7 +177,7 @@ void TerrainRenderPass::Execute(Graphics& aGraphics)
 	const Camera& camera = *game.GetCamera();
 
 	constexpr auto IsUsable = [](const VisualObject& aVO) {
-		constexpr auto CheckResource = [](const Handle<GPUResource>& aRes) {
+		constexpr auto CheckResource = [](BorrowedHandle<GPUResource> aRes) {
 			return aRes.IsValid() && aRes->GetState() == GPUResource::State::Valid;
 		};
 		return CheckResource(aVO.GetPipeline())
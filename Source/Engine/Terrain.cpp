@@ -41,6 +41,7 @@ void Terrain::Load(Handle<Texture> aTexture, float aStep, float anYScale)
 
 		myHeightfield = std::make_shared<PhysicsShapeHeightfield>
 			(myWidth, myHeight, std::move(heights), myMinHeight, myMaxHeight);
+		myHeightMips.Build(myHeightfield->GetHeights(), { myWidth, myHeight }, myStep);
 	});
 }
 
@@ -106,6 +107,7 @@ void Terrain::Generate(glm::uvec2 aSize, float aStep, float anYScale)
 
 	myHeightfield = std::make_shared<PhysicsShapeHeightfield>
 		(myWidth, myHeight, std::move(heights), myMinHeight, myMaxHeight);
+	myHeightMips.Build(myHeightfield->GetHeights(), { myWidth, myHeight }, myStep);
 }
 
 void Terrain::GenerateNormals()
@@ -219,6 +221,30 @@ glm::vec3 Terrain::GetNormal(glm::vec2 aLocalPos) const
 	return glm::mix(botNorm, topNorm, z);
 }
 
+bool Terrain::Raycast(const Shapes::Ray& aLocalRay, float aMaxT, float& aRayT) const
+{
+	ASSERT_STR(myHeightfield, "Terrain hasn't finished initalizing!");
+	return myHeightMips.Raycast(aLocalRay, aMaxT, aRayT);
+}
+
+void Terrain::RaycastBatch(std::span<const Shapes::Ray> aLocalRays, float aMaxT, std::span<float> aRayTs) const
+{
+	ASSERT_STR(myHeightfield, "Terrain hasn't finished initalizing!");
+	ASSERT_STR(aLocalRays.size() == aRayTs.size(), "Results don't match the rays!");
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aLocalRays.size()),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			for (size_t i = aRange.begin(); i < aRange.end(); i++)
+			{
+				if (!myHeightMips.Raycast(aLocalRays[i], aMaxT, aRayTs[i]))
+				{
+					aRayTs[i] = std::numeric_limits<float>::infinity();
+				}
+			}
+		}
+	);
+}
+
 void Terrain::PushHeightLevelColor(float aHeightLevel, glm::vec3 aColor)
 {
 	ASSERT_STR(myLevelsCount < kMaxHeightLevels, 
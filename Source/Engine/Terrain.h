@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/RefCounted.h>
+#include <Core/HeightfieldMips.h>
 
 class PhysicsShapeHeightfield;
 class Texture;
@@ -25,6 +26,13 @@ public:
 	float GetHeight(glm::vec2 aLocalPos) const;
 	glm::vec3 GetNormal(glm::vec2 aLocalPos) const;
 
+	// Finds where aLocalRay first hits the terrain, within [0, aMaxT] along it.
+	// Uses a min/max height pyramid to skip over areas the ray passes above
+	bool Raycast(const Shapes::Ray& aLocalRay, float aMaxT, float& aRayT) const;
+	// Casts aLocalRays in parallel, writing hit distances into aRayTs,
+	// or infinity for misses
+	void RaycastBatch(std::span<const Shapes::Ray> aLocalRays, float aMaxT, std::span<float> aRayTs) const;
+
 	Handle<Texture> GetTextureHandle() const { return myTexture; }
 
 	float GetWidth() const { return (myWidth - 1) * myStep; }
@@ -44,6 +52,8 @@ private:
 
 	Handle<Texture> myTexture;
 	std::vector<glm::vec3> myNormals;
+	// refers to heights of myHeightfield
+	HeightfieldMips myHeightMips;
 
 	// dimensions of the heightmap texture used
 	uint32_t myWidth = 0, myHeight = 0;
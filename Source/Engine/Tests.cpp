@@ -1,15 +1,36 @@
 #include "Precomp.h"
 #include "Tests.h"
 
+#include <Core/HexFlowField.h>
 #include <Core/Profiler.h>
 #include <Core/Resources/AssetTracker.h>
 #include <Core/Resources/BinarySerializer.h>
 #include <Core/Resources/JsonSerializer.h>
+#include <Core/FlatGrid.h>
+#include <Core/Grid.h>
 #include <Core/Pool.h>
+#include <Core/QuadTree.h>
 #include <Core/StableVector.h>
 #include <Core/StaticVector.h>
+#include <Core/TransformStore.h>
 #include <Core/Shapes.h>
 #include <Core/Utils.h>
+#include <Core/Vertex.h>
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/PhysicsEntity.h>
+#include <Physics/PhysicsShapes.h>
+#include <Physics/PhysicsSnapshot.h>
+
+#include "Animation/CPUSkinning.h"
+#include "Animation/SkinnedVerts.h"
+#include "Components/ComponentBase.h"
+#include "Components/TestComponent.h"
+#include "Game.h"
+#include "GameObject.h"
+#include "GameTaskManager.h"
+#include "GameTaskTracer.h"
+#include "World.h"
 
 void Tests::RunTests()
 {
@@ -21,6 +42,19 @@ void Tests::RunTests()
 	TestStableVector();
 	TestStaticVector();
 	TestIntersects();
+	TestCPUSkinning();
+	TestPhysicsInterpolation();
+	TestPhysicsSnapshot();
+	TestTransformStore();
+	TestTransformDirtyPropagation();
+	TestComponentPools();
+	TestRefCountPolicies();
+	TestGameTaskPipeline();
+	TestGameTaskTracer();
+	TestHexFlowField();
+	TestSpatialQueries();
+	TestFlatGrid();
+	TestWorldStorage();
 }
 
 void Tests::TestBase64()
@@ -451,4 +485,1019 @@ void Tests::TestIntersects()
 		};
 		ASSERT(Shapes::Intersects(v1, v2, v3, aabbNew));
 	}
-}
\ No newline at end of file
+}
+
+void Tests::TestCPUSkinning()
+{
+	const glm::mat4 matrices[2]{
+		glm::mat4(1.f),
+		glm::translate(glm::mat4(1.f), glm::vec3(0, 2, 0))
+	};
+	const SkinnedVertex verts[3]{
+		{ { 1, 0, 0 }, {}, {}, { 0, 0, 0, 0 }, { 1, 0, 0, 0 } },
+		{ { 0, 0, 1 }, {}, {}, { 1, 0, 0, 0 }, { 1, 0, 0, 0 } },
+		{ { -1, 0, 0 }, {}, {}, { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0, 0 } }
+	};
+
+	glm::vec3 positions[3];
+	CPUSkinning::SkinPositions(verts, matrices, positions);
+	ASSERT(positions[0] == glm::vec3(1, 0, 0));
+	ASSERT(positions[1] == glm::vec3(0, 2, 1));
+	ASSERT(positions[2] == glm::vec3(-1, 1, 0));
+
+	// only first influence is read, so last vertex is fully bound to bone 0
+	CPUSkinning::SkinPositions(verts, matrices, positions, 1);
+	ASSERT(positions[2] == glm::vec3(-0.5f, 0, 0));
+
+	const Shapes::AABB aabb = CPUSkinning::CalcAABB(verts, matrices);
+	ASSERT(aabb.myMin == glm::vec3(-1, 0, 0));
+	ASSERT(aabb.myMax == glm::vec3(1, 2, 1));
+}
+
+void Tests::TestPhysicsInterpolation()
+{
+	constexpr float kStep = PhysicsWorld::kFixedStepLength;
+	constexpr float kEpsilon = 0.0001f;
+	auto CreateEntity = [] {
+		PhysicsEntity::InitParams params;
+		params.myType = PhysicsEntity::Type::Dynamic;
+		params.myShape = std::make_shared<PhysicsShapeSphere>(0.5f);
+		params.myTranfs = glm::translate(glm::vec3(0, 10, 0));
+		params.myMass = 1.f;
+		return new PhysicsEntity(params);
+	};
+	auto GetHeight = [](const glm::mat4& aTransf) {
+		return aTransf[3].y;
+	};
+
+	// interpolation
+	{
+		PhysicsWorld* world = new PhysicsWorld();
+		PhysicsEntity* entity = CreateEntity();
+		world->AddEntity(entity);
+		world->Simulate(0);
+
+		// not enough for a step
+		world->Simulate(kStep / 2.f);
+		ASSERT(glm::abs(world->GetInterpolationAlpha() - 0.5f) < kEpsilon);
+		ASSERT(GetHeight(entity->GetTransform()) == 10.f);
+		ASSERT(GetHeight(entity->GetTransformInterp()) == 10.f);
+
+		// a single step, with nothing left over - interp is at previous state
+		world->Simulate(kStep / 2.f);
+		const float steppedHeight = GetHeight(entity->GetTransform());
+		ASSERT(steppedHeight < 10.f);
+		ASSERT(world->GetInterpolationAlpha() < kEpsilon);
+		ASSERT(glm::abs(GetHeight(entity->GetTransformInterp()) - 10.f) < kEpsilon);
+
+		// halfway between previous and current states
+		world->Simulate(kStep / 2.f);
+		const float expectedHeight = (10.f + steppedHeight) / 2.f;
+		ASSERT(glm::abs(GetHeight(entity->GetTransformInterp()) - expectedHeight) < kEpsilon);
+
+		// too much time - only kMaxSteps are done, rest gets dropped
+		world->Simulate(1.f);
+		ASSERT(glm::abs(world->GetDroppedTime() - (1.f - PhysicsWorld::kMaxSteps * kStep)) < kEpsilon);
+		ASSERT(glm::abs(world->GetInterpolationAlpha() - 0.5f) < kEpsilon);
+
+		delete world;
+		delete entity;
+	}
+
+	// pending additions and teleports - nothing to interpolate from
+	{
+		PhysicsWorld* world = new PhysicsWorld();
+		PhysicsEntity* entity = CreateEntity();
+		world->AddEntity(entity);
+		ASSERT(GetHeight(entity->GetTransformInterp()) == 10.f);
+		world->Simulate(0);
+
+		world->Simulate(kStep * 1.5f);
+		ASSERT(glm::abs(world->GetInterpolationAlpha() - 0.5f) < kEpsilon);
+		const glm::mat4 teleported = glm::translate(glm::vec3(5, 20, 0));
+		entity->SetTransform(teleported);
+		ASSERT(glm::distance(entity->GetTransformInterp()[3], teleported[3]) < kEpsilon);
+
+		delete world;
+		delete entity;
+	}
+
+	// step budget
+	{
+		PhysicsWorld* world = new PhysicsWorld();
+		PhysicsEntity* entity = CreateEntity();
+		world->AddEntity(entity);
+		world->Simulate(0);
+
+		// nothing fits in the budget, so it should degrade to a single step per frame
+		world->SetStepTimeBudget(std::numeric_limits<float>::min());
+		world->Simulate(2.5f * kStep);
+		ASSERT(world->GetStepBudget() == 1);
+		ASSERT(world->GetDroppedTime() == 0.f);
+		world->Simulate(2 * kStep);
+		ASSERT(glm::abs(world->GetDroppedTime() - kStep) < kEpsilon);
+
+		// everything fits, so it should recover
+		world->SetStepTimeBudget(std::numeric_limits<float>::max());
+		world->Simulate(kStep);
+		ASSERT(world->GetStepBudget() == PhysicsWorld::kMaxSteps);
+
+		delete world;
+		delete entity;
+	}
+
+	// determinism - same time input results in same state
+	{
+		PhysicsWorld* worlds[2]{ new PhysicsWorld(), new PhysicsWorld() };
+		PhysicsEntity* entities[2]{ CreateEntity(), CreateEntity() };
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			worlds[i]->AddEntity(entities[i]);
+			worlds[i]->Simulate(0);
+		}
+
+		constexpr float kDeltas[]{ 0.016f, 0.033f, 0.008f, 0.1f, 0.016f, 0.05f };
+		for (float delta : kDeltas)
+		{
+			worlds[0]->Simulate(delta);
+			worlds[1]->Simulate(delta);
+		}
+		ASSERT(entities[0]->GetTransform() == entities[1]->GetTransform());
+		ASSERT(entities[0]->GetTransformInterp() == entities[1]->GetTransformInterp());
+
+		for (uint8_t i = 0; i < 2; i++)
+		{
+			delete worlds[i];
+			delete entities[i];
+		}
+	}
+}
+
+void Tests::TestPhysicsSnapshot()
+{
+	constexpr float kStep = PhysicsWorld::kFixedStepLength;
+	PhysicsWorld* world = new PhysicsWorld();
+	PhysicsEntity::InitParams groundParams;
+	groundParams.myShape = std::make_shared<PhysicsShapeBox>(glm::vec3(5, 0.5f, 5));
+	groundParams.myTranfs = glm::translate(glm::vec3(0, -0.5f, 0));
+	PhysicsEntity* ground = new PhysicsEntity(groundParams);
+	world->AddEntity(ground);
+
+	constexpr uint8_t kEntityCount = 3;
+	PhysicsEntity* entities[kEntityCount];
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		PhysicsEntity::InitParams params;
+		params.myType = PhysicsEntity::Type::Dynamic;
+		params.myShape = std::make_shared<PhysicsShapeBox>(glm::vec3(0.5f));
+		params.myTranfs = glm::translate(glm::vec3(0, 1 + i * 1.1f, 0));
+		params.myMass = 1.f;
+		entities[i] = new PhysicsEntity(params);
+		world->AddEntity(entities[i]);
+	}
+
+	// a rotated slab, spinning on the ground - its world inertia changes
+	// every step, so restoring has to update it along with the rotation
+	{
+		PhysicsEntity::InitParams params;
+		params.myType = PhysicsEntity::Type::Dynamic;
+		params.myShape = std::make_shared<PhysicsShapeBox>(glm::vec3(1, 0.2f, 0.4f));
+		params.myTranfs = glm::translate(glm::vec3(3, 0.2f, 0))
+			* glm::rotate(glm::radians(30.f), glm::vec3(0, 1, 0));
+		params.myMass = 1.f;
+		entities[2] = new PhysicsEntity(params);
+		world->AddEntity(entities[2]);
+	}
+	world->Simulate(0);
+	entities[1]->SetVelocity({ 1, 0, 0 });
+	entities[2]->SetAngularVelocity({ 0.5f, 8, 0 });
+
+	PhysicsSnapshot snapshot;
+	world->TakeSnapshot(snapshot);
+	ASSERT(snapshot.GetBodyCount() == kEntityCount);
+	std::array<glm::mat4, kEntityCount> initialTransfs;
+	for (uint8_t i = 0; i < kEntityCount; i++)
+	{
+		initialTransfs[i] = entities[i]->GetTransform();
+	}
+
+	// bodies will land on each other and ground, so contact caches come into play
+	auto Run = [&] {
+		for (uint8_t i = 0; i < 30; i++)
+		{
+			world->Simulate(kStep);
+		}
+		std::array<glm::mat4, kEntityCount> transfs;
+		for (uint8_t i = 0; i < kEntityCount; i++)
+		{
+			transfs[i] = entities[i]->GetTransform();
+		}
+		return transfs;
+	};
+
+	world->RestoreSnapshot(snapshot);
+	const std::array<glm::mat4, kEntityCount> firstRun = Run();
+	ASSERT(firstRun[1] != initialTransfs[1]);
+	ASSERT(firstRun[2] != initialTransfs[2]);
+
+	// rotations are restored exactly, not through quaternions
+	world->RestoreSnapshot(snapshot);
+	for (uint8_t i = 0; i < kEntityCount; i++)
+	{
+		ASSERT(entities[i]->GetTransform() == initialTransfs[i]);
+	}
+	const std::array<glm::mat4, kEntityCount> secondRun = Run();
+	ASSERT(firstRun == secondRun);
+
+	// restoring from a copied buffer, as if it was loaded from disk
+	const PhysicsSnapshot copy(snapshot.GetBuffer());
+	world->RestoreSnapshot(copy);
+	ASSERT(Run() == firstRun);
+
+	delete world;
+	delete ground;
+	for (PhysicsEntity* entity : entities)
+	{
+		delete entity;
+	}
+}
+
+void Tests::TestTransformStore()
+{
+	auto isClose = [](const Transform& aA, const Transform& aB) {
+		constexpr float kEpsilon = 0.0001f;
+		return glm::all(glm::epsilonEqual(aA.GetPos(), aB.GetPos(), kEpsilon))
+			&& glm::all(glm::epsilonEqual(aA.GetScale(), aB.GetScale(), kEpsilon))
+			&& glm::abs(glm::dot(aA.GetRotation(), aB.GetRotation())) > 1.f - kEpsilon;
+	};
+
+	const Transform rootLocal({ 1, 0, 0 }, glm::quat(glm::vec3(0, glm::half_pi<float>(), 0)), glm::vec3(2));
+	const Transform childLocal({ 0, 1, 2 }, glm::quat(glm::vec3(0.3f, 0, 0)), glm::vec3(1));
+	const Transform grandChildLocal({ 3, 0, 0 }, glm::quat(1, 0, 0, 0), glm::vec3(0.5f));
+
+	TransformStore store;
+	// adding in reverse order, so that depth sorting has to reorder them
+	const TransformStore::Id grandChild = store.Add(grandChildLocal);
+	const TransformStore::Id child = store.Add(childLocal);
+	const TransformStore::Id root = store.Add(rootLocal);
+	store.SetParent(grandChild, child);
+	store.SetParent(child, root);
+	ASSERT(store.GetParent(grandChild) == child);
+	ASSERT(store.GetParent(root) == TransformStore::kInvalidId);
+
+	store.Propagate();
+	ASSERT(store.GetCount() == 3);
+	ASSERT(store.GetDepthCount() == 3);
+	ASSERT(isClose(store.GetWorld(root), rootLocal));
+	ASSERT(isClose(store.GetWorld(child), rootLocal * childLocal));
+	ASSERT(isClose(store.GetWorld(grandChild), rootLocal * childLocal * grandChildLocal));
+	// ids must survive the sort
+	ASSERT(isClose(store.GetLocal(grandChild), grandChildLocal));
+
+	// single entry update only touches the entry itself
+	const Transform movedRoot({ 0, 5, 0 }, glm::quat(1, 0, 0, 0), glm::vec3(1));
+	store.SetLocal(root, movedRoot);
+	store.UpdateWorld(root);
+	ASSERT(isClose(store.GetWorld(root), movedRoot));
+	ASSERT(isClose(store.GetWorld(child), rootLocal * childLocal));
+	store.Propagate();
+	ASSERT(isClose(store.GetWorld(grandChild), movedRoot * childLocal * grandChildLocal));
+
+	// removing leaves a hole, which must get reused and compacted
+	store.Remove(grandChild);
+	const TransformStore::Id sibling = store.Add(grandChildLocal, root);
+	ASSERT(isClose(store.GetWorld(sibling), movedRoot * grandChildLocal));
+	store.Propagate();
+	ASSERT(store.GetCount() == 3);
+	ASSERT(store.GetDepthCount() == 2);
+	ASSERT(isClose(store.GetWorld(child), movedRoot * childLocal));
+	ASSERT(isClose(store.GetWorld(sibling), movedRoot * grandChildLocal));
+}
+
+void Tests::TestTransformDirtyPropagation()
+{
+	auto isClose = [](const Transform& aA, const Transform& aB) {
+		constexpr float kEpsilon = 0.0001f;
+		return glm::all(glm::epsilonEqual(aA.GetPos(), aB.GetPos(), kEpsilon))
+			&& glm::all(glm::epsilonEqual(aA.GetScale(), aB.GetScale(), kEpsilon))
+			&& glm::abs(glm::dot(aA.GetRotation(), aB.GetRotation())) > 1.f - kEpsilon;
+	};
+	auto contains = [](const std::vector<TransformStore::Id>& anIds, TransformStore::Id anId) {
+		return std::find(anIds.begin(), anIds.end(), anId) != anIds.end();
+	};
+
+	const Transform rootLocal({ 1, 0, 0 }, glm::quat(glm::vec3(0, glm::half_pi<float>(), 0)), glm::vec3(2));
+	const Transform childLocal({ 0, 1, 2 }, glm::quat(glm::vec3(0.3f, 0, 0)), glm::vec3(1));
+
+	// enough static entries to stay under the full-propagation threshold
+	constexpr uint32_t kStaticCount = 64;
+	TransformStore store;
+	const TransformStore::Id root = store.Add(rootLocal);
+	const TransformStore::Id child = store.Add(childLocal, root);
+	const TransformStore::Id grandChild = store.Add(childLocal, child);
+	TransformStore::Id statics[kStaticCount];
+	for (uint32_t i = 0; i < kStaticCount; i++)
+	{
+		statics[i] = store.Add(childLocal, i > 0 ? statics[i - 1] : TransformStore::kInvalidId);
+	}
+
+	// freshly added entries get reported
+	std::vector<TransformStore::Id> updated;
+	store.PropagateDirty(updated);
+	ASSERT(updated.size() == kStaticCount + 3);
+	store.PropagateDirty(updated);
+	ASSERT(updated.empty());
+
+	// moving a child only touches its subtree
+	const Transform movedChild({ 0, 3, 0 }, glm::quat(1, 0, 0, 0), glm::vec3(1));
+	store.SetLocal(child, movedChild);
+	ASSERT(isClose(store.GetWorld(grandChild), rootLocal * childLocal * childLocal));
+	store.PropagateDirty(updated);
+	ASSERT(updated.size() == 2);
+	ASSERT(contains(updated, child) && contains(updated, grandChild));
+	ASSERT(isClose(store.GetWorld(child), rootLocal * movedChild));
+	ASSERT(isClose(store.GetWorld(grandChild), rootLocal * movedChild * childLocal));
+
+	// marking both an entry and its ancestor doesn't report it twice
+	store.MarkDirty(grandChild);
+	store.MarkDirty(root);
+	store.MarkDirty(root);
+	store.PropagateDirty(updated);
+	ASSERT(updated.size() == 3);
+
+	// setting world transform of a child keeps it after propagation
+	const Transform worldTarget({ 5, 5, 5 }, glm::quat(glm::vec3(0, 0, 1)), glm::vec3(3));
+	store.SetWorld(child, worldTarget);
+	store.PropagateDirty(updated);
+	ASSERT(isClose(store.GetWorld(child), worldTarget));
+	ASSERT(isClose(store.GetWorld(grandChild), worldTarget * childLocal));
+	ASSERT(!contains(updated, statics[0]));
+
+	// removed entries are skipped, even if they were dirty
+	store.MarkDirty(grandChild);
+	store.Remove(grandChild);
+	store.PropagateDirty(updated);
+	ASSERT(updated.empty());
+
+	// batched reads see the same owners and world transforms
+	int owner = 0;
+	const TransformStore::Id owned = store.Add(childLocal, child, &owner);
+	store.PropagateDirty(updated);
+	ASSERT(updated.size() == 1);
+	const Transform ownedWorld = store.GetWorld(owned);
+	std::atomic<uint32_t> visitCount = 0;
+	store.ParallelForEachWorld(updated, 1, [&](void* anOwner, const Transform& aWorld) {
+		ASSERT(anOwner == &owner);
+		ASSERT(isClose(aWorld, ownedWorld));
+		visitCount++;
+	});
+	ASSERT(visitCount == 1);
+}
+
+void Tests::TestComponentPools()
+{
+	using CompA = TestComponent<0>;
+	using CompB = TestComponent<1>;
+	using CompC = TestComponent<2>;
+	static_assert(ComponentTypes::GetId<CompA>() < ComponentTypes::GetId<CompC>());
+
+	// adding out of type order still keeps lookups correct
+	ComponentSet set;
+	CompC& compC = ComponentPools::Get<CompC>().Allocate();
+	set.Add(compC);
+	CompA& compA = ComponentPools::Get<CompA>().Allocate();
+	set.Add(compA);
+	ASSERT(set.GetCount() == 2);
+	ASSERT(set.Get<CompA>() == &compA);
+	ASSERT(set.Get<CompB>() == nullptr);
+	ASSERT(set.Get<CompC>() == &compC);
+
+	CompB& compB = ComponentPools::Get<CompB>().Allocate();
+	set.Add(compB);
+	ASSERT(set.Get<CompB>()->myValue == 2);
+	ASSERT(set.Get<CompC>()->myValue == 3);
+
+	int sum = 0;
+	ComponentPools::Get<CompA>().ForEach([&](const CompA& aComp) {
+		sum += aComp.myValue;
+	});
+	ASSERT(sum == 1);
+
+	ComponentBase* removed = set.Remove(ComponentTypes::GetId<CompA>());
+	ASSERT(removed == &compA);
+	ASSERT(set.Get<CompA>() == nullptr);
+	ASSERT(set.Get<CompC>() == &compC);
+	ASSERT(set.Remove(ComponentTypes::GetId<CompA>()) == nullptr);
+
+	// ids of unregistered components fall outside of the mask
+	ASSERT(set.Get(ComponentBase::kInvalidTypeId) == nullptr);
+	ASSERT(set.Get(ComponentTypes::kMaxTypes) == nullptr);
+	ASSERT(set.Remove(ComponentBase::kInvalidTypeId) == nullptr);
+
+	ComponentPools::Free(*removed);
+	ASSERT(ComponentPools::Get<CompA>().GetCount() == 0);
+	for (size_t i = 0; i < set.GetCount(); i++)
+	{
+		ComponentPools::Free(set.GetAt(i));
+	}
+	ASSERT(ComponentPools::Get<CompB>().GetCount() == 0);
+	ASSERT(ComponentPools::Get<CompC>().GetCount() == 0);
+}
+
+void Tests::TestRefCountPolicies()
+{
+	struct Tracked : RefCounted
+	{
+		Tracked(RefPolicy aPolicy, bool& aDestroyed)
+			: RefCounted(aPolicy)
+			, myDestroyed(aDestroyed)
+		{
+		}
+		~Tracked() { myDestroyed = true; }
+		bool& myDestroyed;
+	};
+
+	for (RefCounted::RefPolicy policy : { RefCounted::RefPolicy::Atomic, RefCounted::RefPolicy::ThreadConfined })
+	{
+		bool destroyed = false;
+		Handle<Tracked> handle = new Tracked(policy, destroyed);
+		{
+			Handle<Tracked> copy = handle;
+			ASSERT(!handle.IsLastHandle());
+			Handle<RefCounted> baseCopy = copy;
+			ASSERT(handle == baseCopy);
+		}
+		ASSERT(handle.IsLastHandle());
+
+		{
+			// borrowing doesn't extend the lifetime...
+			BorrowedHandle<Tracked> borrowed = handle;
+			BorrowedHandle<RefCounted> baseBorrowed = handle;
+			BorrowedHandle<Tracked> borrowedCopy = borrowed;
+			ASSERT(borrowedCopy.Get() == handle.Get());
+			ASSERT(baseBorrowed.Get() == handle.Get());
+			ASSERT(handle.IsLastHandle());
+
+			// ... unless promoted back
+			Handle<Tracked> locked = borrowed.Lock();
+			ASSERT(!handle.IsLastHandle());
+		}
+		ASSERT(handle.IsLastHandle());
+		ASSERT(!destroyed);
+
+		handle = Handle<Tracked>();
+		ASSERT(destroyed);
+	}
+
+	BorrowedHandle<RefCounted> empty;
+	ASSERT(!empty.IsValid());
+}
+
+void Tests::TestGameTaskPipeline()
+{
+	constexpr GameTask::Type kSimTask = 1;
+	constexpr GameTask::Type kRenderTask = 2;
+	constexpr GameTask::Type kPresentTask = 3;
+	constexpr uint64_t kFrameCount = 16;
+
+	for (size_t depth = 1; depth <= GameTaskManager::kMaxPipelineDepth; depth++)
+	{
+		GameTaskManager taskManager;
+		taskManager.SetPipelineDepth(depth);
+		// a copy per frame in flight, so simulation never overwrites what's being rendered
+		std::array<uint64_t, GameTaskManager::kMaxPipelineDepth> snapshots{};
+		std::vector<uint64_t> renderedSnapshots;
+		std::atomic<uint64_t> presentedCount = 0;
+
+		GameTask task(kSimTask, [&] {
+			const uint64_t frame = taskManager.GetSimFrame();
+			// only up to depth frames can be in flight
+			ASSERT(presentedCount + depth >= frame + 1);
+			snapshots[frame % depth] = frame;
+		});
+		taskManager.AddTask(task);
+
+		task = GameTask(kRenderTask, [&] {
+			// gives the next frame's simulation a chance to catch up
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+			renderedSnapshots.push_back(snapshots[taskManager.GetRenderFrame() % depth]);
+		});
+		task.AddDependency(kSimTask);
+		task.SetStage(GameTask::Stage::Render);
+		taskManager.AddTask(task);
+
+		task = GameTask(kPresentTask, [&] {
+			ASSERT(renderedSnapshots.back() == taskManager.GetRenderFrame());
+			presentedCount++;
+		});
+		task.AddDependency(kRenderTask);
+		task.SetStage(GameTask::Stage::Render);
+		taskManager.AddTask(task);
+
+		for (uint64_t frame = 0; frame < kFrameCount; frame++)
+		{
+			taskManager.Run();
+			taskManager.Wait();
+			ASSERT(presentedCount + depth >= frame + 2);
+		}
+		taskManager.WaitAll();
+
+		// every frame got rendered once, in order, seeing its own snapshot
+		ASSERT(presentedCount == kFrameCount);
+		ASSERT(renderedSnapshots.size() == kFrameCount);
+		for (uint64_t frame = 0; frame < kFrameCount; frame++)
+		{
+			ASSERT(renderedSnapshots[frame] == frame);
+		}
+	}
+}
+
+void Tests::TestGameTaskTracer()
+{
+	using Stage = GameTask::Stage;
+	enum Tasks : GameTaskTracer::Index { A, B, C, R };
+	std::vector<GameTaskTracer::TaskInfo> tasks{
+		{ "A", Stage::Simulation, {} },
+		{ "B", Stage::Simulation, { A } },
+		{ "C", Stage::Simulation, {} },
+		{ "R", Stage::Render, {} }
+	};
+	GameTaskTracer tracer;
+	tracer.SetTasks(std::move(tasks), 0);
+
+	constexpr uint32_t kFrameCount = 2;
+	constexpr int64_t kFrameLength = 100;
+	tracer.Start(0, kFrameCount, "");
+	for (uint32_t frame = 0; frame < kFrameCount; frame++)
+	{
+		const int64_t offset = frame * kFrameLength;
+		tracer.Record(frame, A, offset + 0, offset + 10);
+		tracer.Record(frame, B, offset + 12, offset + 30);
+		tracer.Record(frame, C, offset + 0, offset + 25);
+		// render root is held back by the last simulation task, B
+		tracer.Record(frame, R, offset + 31, offset + 40);
+	}
+	// outside of traced range, must be ignored
+	tracer.Record(kFrameCount, A, 0, 1000);
+
+	const nlohmann::json report = nlohmann::json::parse(tracer.GenerateReport());
+	ASSERT(report["frames"] == kFrameCount);
+
+	const nlohmann::json& paths = report["criticalPaths"];
+	ASSERT(paths.size() == 1);
+	ASSERT(paths[0]["frames"] == kFrameCount);
+	ASSERT((paths[0]["tasks"] == nlohmann::json{ "A", "B", "R" }));
+
+	for (const nlohmann::json& task : report["tasks"])
+	{
+		const bool isCritical = task["name"] != "C";
+		ASSERT(task["criticalRatio"] == (isCritical ? 1.0 : 0.0));
+	}
+
+	const nlohmann::json& edges = report["edges"];
+	ASSERT(edges.size() == 2);
+	for (const nlohmann::json& edge : edges)
+	{
+		ASSERT(edge["gatingRatio"] == 1.0);
+		if (edge["to"] == "B")
+		{
+			ASSERT(edge["from"] == "A");
+			ASSERT(edge["avgIdleMs"] == 2 / 1'000'000.0);
+		}
+		else
+		{
+			ASSERT(edge["from"] == "B" && edge["to"] == "R");
+			ASSERT(edge["avgIdleMs"] == 1 / 1'000'000.0);
+		}
+	}
+}
+
+void Tests::TestHexFlowField()
+{
+	// plain BFS over unit costs to compare against
+	auto GetDistances = [](const HexFlowField& aField, std::span<const glm::ivec2> aTargets)
+	{
+		const glm::ivec2 size = aField.GetSize();
+		std::vector<uint32_t> distances(size.x * size.y, HexFlowField::kUnreachable);
+		std::vector<glm::ivec2> toVisit;
+		for (glm::ivec2 target : aTargets)
+		{
+			distances[target.y * size.x + target.x] = 0;
+			toVisit.push_back(target);
+		}
+		for (size_t i = 0; i < toVisit.size(); i++)
+		{
+			const glm::ivec2 hex = toVisit[i];
+			for (uint8_t dir = 0; dir < HexFlowField::kDirectionCount; dir++)
+			{
+				const glm::ivec2 neighbor = HexFlowField::GetNeighbor(hex, dir);
+				if (!aField.IsValid(neighbor) || aField.GetCost(neighbor) == HexFlowField::kWall)
+				{
+					continue;
+				}
+
+				uint32_t& distance = distances[neighbor.y * size.x + neighbor.x];
+				if (distance == HexFlowField::kUnreachable)
+				{
+					distance = distances[hex.y * size.x + hex.x] + 1;
+					toVisit.push_back(neighbor);
+				}
+			}
+		}
+		return distances;
+	};
+
+	// every hex has to step to a neighbour that's exactly its own cost
+	// closer, and following the steps must end up on a target
+	auto CheckDirections = [](const HexFlowField& aField, std::span<const glm::ivec2> aTargets)
+	{
+		const glm::ivec2 size = aField.GetSize();
+		for (int y = 0; y < size.y; y++)
+		{
+			for (int x = 0; x < size.x; x++)
+			{
+				const glm::ivec2 hex{ x, y };
+				const uint32_t integration = aField.GetIntegration(hex);
+				if (integration == HexFlowField::kUnreachable || integration == 0)
+				{
+					ASSERT(aField.GetDirection(hex) == HexFlowField::kNoDirection);
+					continue;
+				}
+
+				const glm::ivec2 next = aField.GetNextHex(hex);
+				ASSERT(aField.IsValid(next));
+				ASSERT(integration == aField.GetIntegration(next) + aField.GetCost(hex));
+			}
+		}
+
+		glm::ivec2 hex = size - 1;
+		if (aField.GetIntegration(hex) != HexFlowField::kUnreachable)
+		{
+			for (glm::ivec2 next = aField.GetNextHex(hex); next != hex; next = aField.GetNextHex(hex))
+			{
+				hex = next;
+			}
+			ASSERT(std::ranges::find(aTargets, hex) != aTargets.end());
+		}
+	};
+
+	{
+		// a wall splitting the grid, with a single gap at the top
+		HexFlowField field({ 8, 6 });
+		for (int y = 0; y < 5; y++)
+		{
+			field.SetCost({ 4, y }, HexFlowField::kWall);
+		}
+		// walled off corner
+		field.SetCost({ 0, 4 }, HexFlowField::kWall);
+		field.SetCost({ 1, 4 }, HexFlowField::kWall);
+		field.SetCost({ 1, 5 }, HexFlowField::kWall);
+
+		const glm::ivec2 targets[]{ { 1, 1 } };
+		field.Compute(targets);
+		const std::vector<uint32_t> distances = GetDistances(field, targets);
+		for (int y = 0; y < 6; y++)
+		{
+			for (int x = 0; x < 8; x++)
+			{
+				ASSERT(field.GetIntegration({ x, y }) == distances[y * 8 + x]);
+			}
+		}
+		ASSERT(field.GetIntegration({ 4, 0 }) == HexFlowField::kUnreachable);
+		ASSERT(field.GetIntegration({ 0, 5 }) == HexFlowField::kUnreachable);
+		ASSERT(field.GetNextHex({ 0, 5 }) == glm::ivec2(0, 5));
+		ASSERT(field.GetNextHex({ 1, 1 }) == glm::ivec2(1, 1));
+		// right side has to go through the gap
+		ASSERT(field.GetIntegration({ 5, 0 }) > field.GetIntegration({ 3, 0 }) + 5);
+		CheckDirections(field, targets);
+	}
+
+	{
+		// bigger grid with random costs and several targets,
+		// serial and parallel searches must produce the same fields
+		constexpr int kSize = 256;
+		HexFlowField serial({ kSize, kSize });
+		uint32_t seed = 1;
+		auto Random = [&seed]
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return seed >> 16;
+		};
+		for (int y = 0; y < kSize; y++)
+		{
+			for (int x = 0; x < kSize; x++)
+			{
+				const uint32_t value = Random() % 20;
+				serial.SetCost({ x, y }, value < 3 ? HexFlowField::kWall : static_cast<uint8_t>(1 + value * 12));
+			}
+		}
+		const glm::ivec2 targets[]{ { 3, 5 }, { 200, 20 }, { 40, 230 }, { 128, 128 } };
+		for (glm::ivec2 target : targets)
+		{
+			serial.SetCost(target, 1);
+		}
+		HexFlowField parallel = serial;
+
+		serial.Compute(targets);
+		parallel.ParallelCompute(targets);
+		for (int y = 0; y < kSize; y++)
+		{
+			for (int x = 0; x < kSize; x++)
+			{
+				ASSERT(serial.GetIntegration({ x, y }) == parallel.GetIntegration({ x, y }));
+				ASSERT(serial.GetDirection({ x, y }) == parallel.GetDirection({ x, y }));
+			}
+		}
+		CheckDirections(serial, targets);
+
+		// with unit costs, integration is the hex count to the closest target
+		for (int y = 0; y < kSize; y++)
+		{
+			for (int x = 0; x < kSize; x++)
+			{
+				if (serial.GetCost({ x, y }) != HexFlowField::kWall)
+				{
+					serial.SetCost({ x, y }, 1);
+				}
+			}
+		}
+		serial.ParallelCompute(targets);
+		const std::vector<uint32_t> distances = GetDistances(serial, targets);
+		for (int y = 0; y < kSize; y++)
+		{
+			for (int x = 0; x < kSize; x++)
+			{
+				ASSERT(serial.GetIntegration({ x, y }) == distances[y * kSize + x]);
+			}
+		}
+	}
+}
+
+void Tests::TestSpatialQueries()
+{
+	// items are boxes, reported by a point inside of them
+	struct Item
+	{
+		glm::vec2 myMin;
+		glm::vec2 myMax;
+		glm::vec2 myPos;
+	};
+	auto GetDistanceSq = [](glm::vec2 aLeft, glm::vec2 aRight)
+	{
+		const glm::vec2 delta = aLeft - aRight;
+		return glm::dot(delta, delta);
+	};
+
+	// compares against brute force over all items. Distances get computed the
+	// same way, so must match exactly - but items at the same distance can
+	// come in any order. Items spanning several cells or quads must still
+	// only be reported once
+	auto CheckQueries = [&](const auto& aStructure, std::span<const Item> anItems, glm::vec2 aQuery,
+		uint32_t aNearestCount, float aMaxDistance, float aRadius)
+	{
+		using Structure = std::remove_cvref_t<decltype(aStructure)>;
+		auto GetPos = [&](uint32_t anItem) { return anItems[anItem].myPos; };
+
+		const float maxDistSq = aMaxDistance < std::numeric_limits<float>::max()
+			? aMaxDistance * aMaxDistance : aMaxDistance;
+		std::vector<float> expectedDists;
+		std::vector<uint32_t> expectedInRadius;
+		for (uint32_t i = 0; i < anItems.size(); i++)
+		{
+			const float distSq = GetDistanceSq(anItems[i].myPos, aQuery);
+			if (distSq < maxDistSq)
+			{
+				expectedDists.push_back(distSq);
+			}
+			if (distSq <= aRadius * aRadius)
+			{
+				expectedInRadius.push_back(i);
+			}
+		}
+		std::sort(expectedDists.begin(), expectedDists.end());
+
+		std::vector<typename Structure::Nearest> nearest(aNearestCount);
+		const uint32_t nearestCount = aStructure.FindNearest(aQuery, nearest, GetPos, aMaxDistance);
+		ASSERT(nearestCount == std::min<size_t>(aNearestCount, expectedDists.size()));
+		std::vector<uint32_t> found;
+		for (uint32_t i = 0; i < nearestCount; i++)
+		{
+			ASSERT(nearest[i].myDistanceSq == expectedDists[i]);
+			ASSERT(nearest[i].myDistanceSq == GetDistanceSq(GetPos(nearest[i].myItem), aQuery));
+			found.push_back(nearest[i].myItem);
+		}
+		std::sort(found.begin(), found.end());
+		ASSERT(std::adjacent_find(found.begin(), found.end()) == found.end());
+
+		found.resize(anItems.size());
+		found.resize(aStructure.FindInRadius(aQuery, aRadius, std::span<uint32_t>(found), GetPos));
+		std::sort(found.begin(), found.end());
+		ASSERT(found == expectedInRadius);
+	};
+
+	constexpr float kSize = 128;
+	const glm::vec2 kMin{ -kSize / 2 };
+	// 16 units per cell
+	constexpr uint16_t kCellCount = 8;
+	constexpr uint8_t kMaxDepth = 4;
+	auto CheckItems = [&](std::span<const Item> anItems, std::span<const glm::vec2> aQueries)
+	{
+		Grid<uint32_t> grid(kMin, kSize, kCellCount);
+		std::vector<QuadTreeBF<uint32_t>::Entry> entries;
+		for (uint32_t i = 0; i < anItems.size(); i++)
+		{
+			grid.Add(anItems[i].myMin, anItems[i].myMax, i);
+			entries.push_back({ anItems[i].myMin, anItems[i].myMax, i });
+		}
+		QuadTreeBF<uint32_t> tree(kMin, kMin + kSize, kMaxDepth);
+		tree.Build(entries);
+
+		constexpr uint32_t kNearestCounts[]{ 1, 4, 32 };
+		for (uint32_t i = 0; i < aQueries.size(); i++)
+		{
+			const uint32_t nearestCount = kNearestCounts[i % std::size(kNearestCounts)];
+			// limited reach, so that rings and quads get cut off by it rather than by the count
+			const float maxDistance = i % 2 ? 20.f : std::numeric_limits<float>::max();
+			const float radius = 4.f + i % 48;
+			CheckQueries(grid, anItems, aQueries[i], nearestCount, maxDistance, radius);
+			CheckQueries(tree, anItems, aQueries[i], nearestCount, maxDistance, radius);
+		}
+		// reaching the whole structure, from outside of it
+		CheckQueries(grid, anItems, { -1000, -1000 }, 8, std::numeric_limits<float>::max(), 2000.f);
+		CheckQueries(tree, anItems, { -1000, -1000 }, 8, std::numeric_limits<float>::max(), 2000.f);
+	};
+
+	std::mt19937 engine(7);
+	std::uniform_real_distribution<float> posDistrib(-kSize * 0.75f, kSize * 0.75f);
+	std::uniform_real_distribution<float> sizeDistrib(0.5f, 40.f);
+	std::uniform_real_distribution<float> unitDistrib(0.f, 1.f);
+
+	// queries from both inside and outside of the grid
+	std::vector<glm::vec2> queries(256);
+	for (glm::vec2& query : queries)
+	{
+		query = { posDistrib(engine) * 2.f, posDistrib(engine) * 2.f };
+	}
+
+	// dense, with items spanning several cells, and some outside of the grid
+	// that only the border cells hold
+	std::vector<Item> items(512);
+	for (Item& item : items)
+	{
+		item.myMin = { posDistrib(engine), posDistrib(engine) };
+		item.myMax = item.myMin + glm::vec2{ sizeDistrib(engine), sizeDistrib(engine) };
+		item.myPos = item.myMin + (item.myMax - item.myMin) * glm::vec2{ unitDistrib(engine), unitDistrib(engine) };
+	}
+	items.push_back({ { 1000, 20 }, { 1001, 21 }, { 1000.5f, 20.5f } });
+	CheckItems(items, queries);
+
+	// sparse - most queries have to search through many empty rings/quads,
+	// including the unbounded border cells, before finding anything
+	const Item sparseItems[]{
+		{ kMin, kMin + 1.f, kMin + 0.5f },
+		{ { 1000, 20 }, { 1001, 21 }, { 1000.5f, 20.5f } }
+	};
+	CheckItems(sparseItems, queries);
+}
+
+void Tests::TestFlatGrid()
+{
+	// odd cell size and offset, so that cell edges don't land on round numbers
+	const glm::vec2 gridMin{ -37.5f, 12.25f };
+	constexpr float kGridSize = 100.f;
+	constexpr uint16_t kCellCount = 13;
+	const GridLayout layout(gridMin, kGridSize, kCellCount);
+
+	// GetCellRange has to match the scalar conversion it replaced
+	auto GetCellIndices = [&](glm::vec2 aPos)
+	{
+		const glm::vec2 offset = aPos - gridMin;
+		glm::i32vec2 coords = static_cast<glm::i32vec2>(offset / layout.GetCellSize());
+		coords = glm::clamp(coords, glm::i32vec2{ 0 }, glm::i32vec2{ kCellCount - 1 });
+		return static_cast<glm::u16vec2>(coords);
+	};
+	std::vector<float> coords;
+	for (float coord = -200.f; coord <= 200.f; coord += 0.37f)
+	{
+		coords.push_back(coord);
+	}
+	// right on, and next to, the cell edges
+	for (uint16_t i = 0; i <= kCellCount; i++)
+	{
+		for (float origin : { gridMin.x, gridMin.y })
+		{
+			const float edge = origin + i * layout.GetCellSize();
+			coords.push_back(edge);
+			coords.push_back(std::nextafter(edge, -std::numeric_limits<float>::max()));
+			coords.push_back(std::nextafter(edge, std::numeric_limits<float>::max()));
+		}
+	}
+	coords.push_back(-1e6f);
+	coords.push_back(1e6f);
+	for (size_t i = 0; i < coords.size(); i++)
+	{
+		for (size_t j = 0; j < coords.size(); j++)
+		{
+			const glm::vec2 min{ coords[i], coords[j] };
+			const glm::vec2 max{ coords[j], coords[coords.size() - 1 - i] };
+			const GridLayout::CellRange range = layout.GetCellRange(min, max);
+			ASSERT(range.myMin == GetCellIndices(min));
+			ASSERT(range.myMax == GetCellIndices(max));
+		}
+	}
+
+	// enough entries for ParallelRebuild to split them up, with some
+	// spanning several cells and some outside of the grid
+	std::mt19937 engine(42);
+	std::uniform_real_distribution<float> posDistrib(-kGridSize * 0.5f, kGridSize * 1.5f);
+	std::uniform_real_distribution<float> sizeDistrib(0.f, 20.f);
+	std::vector<FlatGrid<uint32_t>::Entry> entries(20'000);
+	Grid<uint32_t> grid(gridMin, kGridSize, kCellCount);
+	for (uint32_t i = 0; i < entries.size(); i++)
+	{
+		const glm::vec2 min = gridMin + glm::vec2{ posDistrib(engine), posDistrib(engine) };
+		entries[i] = { min, min + glm::vec2{ sizeDistrib(engine), sizeDistrib(engine) }, i };
+		grid.Add(entries[i].myMin, entries[i].myMax, i);
+	}
+
+	FlatGrid<uint32_t> flatGrid(gridMin, kGridSize, kCellCount);
+	flatGrid.Rebuild(entries);
+	FlatGrid<uint32_t> parallelFlatGrid(gridMin, kGridSize, kCellCount);
+	parallelFlatGrid.ParallelRebuild(entries);
+	ASSERT(flatGrid.GetItemCount() == parallelFlatGrid.GetItemCount());
+	for (uint32_t i = 0; i < flatGrid.GetCellCount(); i++)
+	{
+		ASSERT(std::ranges::equal(flatGrid.GetCell(i), parallelFlatGrid.GetCell(i)));
+	}
+
+	// and both keep the same cells, in the same order, as adding to a Grid
+	uint32_t cellIndex = 0;
+	grid.ForEachCell([&](const std::vector<uint32_t>& aCell)
+	{
+		ASSERT(std::ranges::equal(aCell, flatGrid.GetCell(cellIndex)));
+		cellIndex++;
+	});
+}
+
+void Tests::TestWorldStorage()
+{
+	// handles get released at the end, outside of Game's cleanup stage
+	Game::ourGODeleteEnabled = true;
+	{
+		std::vector<Handle<GameObject>> objects;
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			objects.emplace_back(new GameObject(Transform()));
+		}
+
+		World world;
+		world.Add(objects);
+		ASSERT(world.GetCount() == objects.size());
+		std::vector<World::ObjectId> ids;
+		for (const Handle<GameObject>& object : objects)
+		{
+			ASSERT(object->GetWorld() == &world);
+			ASSERT(world.Get(object->GetWorldId()) == object.Get());
+			ids.push_back(object->GetWorldId());
+		}
+
+		// removing from the middle moves the last one in its place
+		world.Remove(objects[1]);
+		ASSERT(world.GetCount() == 3);
+		ASSERT(objects[1]->GetWorld() == nullptr);
+		ASSERT(world.Get(ids[1]) == nullptr);
+		for (uint32_t i : { 0, 2, 3 })
+		{
+			ASSERT(world.Get(ids[i]) == objects[i].Get());
+		}
+
+		// freed slot gets reused, but the old id stays stale
+		world.Add(objects[1]);
+		const World::ObjectId reusedId = objects[1]->GetWorldId();
+		ASSERT(reusedId.myIndex == ids[1].myIndex);
+		ASSERT(!(reusedId == ids[1]));
+		ASSERT(world.Get(ids[1]) == nullptr);
+		ASSERT(world.Get(reusedId) == objects[1].Get());
+
+		// generations wrap around - stale ids of free slots must not resolve
+		// even once their generation matches again
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			world.Remove(objects[3]);
+			ASSERT(world.Get(ids[3]) == nullptr);
+			world.Add(objects[3]);
+		}
+		world.Remove(objects[3]);
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			ASSERT(world.Get({ ids[3].myIndex, static_cast<uint8_t>(i) }) == nullptr);
+		}
+		ASSERT(world.Get({ 1000, 0 }) == nullptr);
+
+		world.Remove(objects[0]);
+		world.Remove(objects[1]);
+		world.Remove(objects[2]);
+		ASSERT(world.GetCount() == 0);
+	}
+	Game::ourGODeleteEnabled = false;
+}
@@ -14,4 +14,17 @@ private:
 	static void TestStableVector();
 	static void TestStaticVector();
 	static void TestIntersects();
+	static void TestCPUSkinning();
+	static void TestPhysicsInterpolation();
+	static void TestPhysicsSnapshot();
+	static void TestTransformStore();
+	static void TestTransformDirtyPropagation();
+	static void TestComponentPools();
+	static void TestRefCountPolicies();
+	static void TestGameTaskPipeline();
+	static void TestGameTaskTracer();
+	static void TestHexFlowField();
+	static void TestSpatialQueries();
+	static void TestFlatGrid();
+	static void TestWorldStorage();
 };
\ No newline at end of file
@@ -11,15 +11,15 @@
 void EntitiesWidget::Draw(Game& aGame)
 {
 	World& world = aGame.GetWorld();
-	world.Access([&](std::vector<Handle<GameObject>>& aGameObjects) {
+	world.Access([&](std::span<GameObject* const> aGameObjects) {
 		ImGui::LabelText("Entities Count", "%llu", aGameObjects.size());
 		if (!aGameObjects.empty())
 		{
 			ImGui::Text("Entities:");
 		}
-		for (Handle<GameObject>& gameObjectHandle : aGameObjects)
+		for (GameObject* gameObjectPtr : aGameObjects)
 		{
-			GameObject& gameObject = *gameObjectHandle.Get();
+			GameObject& gameObject = *gameObjectPtr;
 			if (gameObject.GetParent().IsValid())
 			{
 				// skip children objects - they'll be displayed as part of hierarchy
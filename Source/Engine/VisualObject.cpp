@@ -30,11 +30,18 @@ void VisualObject::SetTexture(Handle<Texture> aTexture)
 	myAllValid &= myTexture.IsValid() && myTexture->GetState() == GPUResource::State::Valid;
 }
 
+void VisualObject::SetLocalBounds(const Shapes::AABB& aBounds)
+{
+	myLocalCenter = (aBounds.myMin + aBounds.myMax) / 2.f;
+	myLocalRadius = glm::length(aBounds.myMax - aBounds.myMin) / 2.f;
+	myHasLocalBounds = true;
+}
+
 glm::vec3 VisualObject::GetCenter() const
 {
 	const glm::vec3 pos = myTransf.GetPos();
 	const glm::vec3 scale = myTransf.GetScale();
-	const glm::vec3 localCenter = myModel->GetCenter();
+	const glm::vec3 localCenter = myHasLocalBounds ? myLocalCenter : myModel->GetCenter();
 	return pos + scale * localCenter;
 }
 
@@ -42,6 +49,6 @@ float VisualObject::GetRadius() const
 {
 	const glm::vec3 scale = myTransf.GetScale();
 	const float maxScale = std::max({ scale.x, scale.y, scale.z });
-	const float radius = myModel->GetSphereRadius();
+	const float radius = myHasLocalBounds ? myLocalRadius : myModel->GetSphereRadius();
 	return maxScale * radius;
 }
\ No newline at end of file
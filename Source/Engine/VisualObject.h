@@ -2,6 +2,7 @@
 
 #include <Core/Transform.h>
 #include <Core/RefCounted.h>
+#include <Core/Shapes.h>
 
 class Model;
 class Texture;
@@ -28,6 +29,11 @@ public:
 	glm::vec3 GetCenter() const;
 	float GetRadius() const;
 
+	// Overrides model's bounds with model-space AABB, used for culling
+	// of deformed models (i.e. skinned - see CPUSkinning::CalcAABB)
+	void SetLocalBounds(const Shapes::AABB& aBounds);
+	void ResetLocalBounds() { myHasLocalBounds = false; }
+
 	void SetTransform(const Transform& aTransf) { myTransf = aTransf; }
 	const Transform& GetTransform() const { return myTransf; }
 
@@ -39,5 +45,8 @@ private:
 	Handle<GPUModel> myModel;
 	Handle<GPUPipeline> myPipeline;
 	Handle<GPUTexture> myTexture;
+	glm::vec3 myLocalCenter = glm::vec3(0);
+	float myLocalRadius = 0;
+	bool myHasLocalBounds = false;
 	bool myAllValid = false;
 };
\ No newline at end of file
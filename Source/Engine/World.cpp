@@ -13,20 +13,10 @@ World::World(Id anId, std::string_view aPath)
 
 void World::Add(Handle<GameObject>& aGameObject)
 {
-	ASSERT_STR(aGameObject.IsValid(), "Invalid object passed in!");
-
 #ifdef ASSERT_MUTEX
 	AssertWriteLock lock(myObjectsMutex);
 #endif
-
-	GameObject* objPtr = aGameObject.Get();
-	ASSERT(!myGameObjIndices.contains(objPtr));
-
-	const size_t newIndex = myGameObjects.size();
-	myGameObjects.push_back(aGameObject);
-	myGameObjIndices.insert({ objPtr, newIndex });
-
-	aGameObject->SetWorld(this);
+	AddImpl(aGameObject);
 }
 
 void World::Remove(Handle<GameObject>& aGameObject)
@@ -36,24 +26,37 @@ void World::Remove(Handle<GameObject>& aGameObject)
 #ifdef ASSERT_MUTEX
 	AssertWriteLock lock(myObjectsMutex);
 #endif
+	RemoveImpl(*aGameObject.Get());
+}
 
-	GameObject* objPtr = aGameObject.Get();
-	const auto objIndIter = myGameObjIndices.find(objPtr);
-	ASSERT_STR(objIndIter != myGameObjIndices.end(), "Game Object didn't belong to world!");
-	const size_t toDeleteInd = objIndIter->second;
+void World::Add(std::span<Handle<GameObject>> aGameObjects)
+{
+#ifdef ASSERT_MUTEX
+	AssertWriteLock lock(myObjectsMutex);
+#endif
 
-	const auto lastIter = myGameObjects.end() - 1;
-	if (toDeleteInd != myGameObjects.size() - 1)
+	const size_t newSize = myObjects.size() + aGameObjects.size();
+	myObjects.reserve(newSize);
+	myHandles.reserve(newSize);
+	mySparseIndices.reserve(newSize);
+	mySparse.reserve(newSize);
+	for (Handle<GameObject>& gameObject : aGameObjects)
 	{
-		const auto toDeleteIter = myGameObjects.begin() + toDeleteInd;
-		std::swap(*toDeleteIter, *lastIter);
-		// Update the index of what used to be last, since we just swapped
-		myGameObjIndices[toDeleteIter->Get()] = toDeleteInd;
+		AddImpl(gameObject);
 	}
-	myGameObjects.erase(lastIter);
-	myGameObjIndices.erase(objIndIter);
+}
+
+void World::Remove(std::span<Handle<GameObject>> aGameObjects)
+{
+#ifdef ASSERT_MUTEX
+	AssertWriteLock lock(myObjectsMutex);
+#endif
 
-	objPtr->SetWorld(nullptr);
+	for (Handle<GameObject>& gameObject : aGameObjects)
+	{
+		ASSERT_STR(gameObject.IsValid(), "Invalid object passed in!");
+		RemoveImpl(*gameObject.Get());
+	}
 }
 
 void World::Clear()
@@ -61,8 +64,11 @@ void World::Clear()
 #ifdef ASSERT_MUTEX
 	AssertWriteLock lock(myObjectsMutex);
 #endif
-	myGameObjects.clear();
-	myGameObjIndices.clear();
+	myObjects.clear();
+	myHandles.clear();
+	mySparseIndices.clear();
+	mySparse.clear();
+	myFirstFree = kInvalidIndex;
 
 	if (myPhysWorld)
 	{
@@ -75,14 +81,43 @@ void World::Reserve(size_t aSize)
 #ifdef ASSERT_MUTEX
 	AssertWriteLock lock(myObjectsMutex);
 #endif
-	myGameObjects.reserve(aSize);
-	myGameObjIndices.reserve(aSize);
+	myObjects.reserve(aSize);
+	myHandles.reserve(aSize);
+	mySparseIndices.reserve(aSize);
+	mySparse.reserve(aSize);
+}
+
+GameObject* World::Get(ObjectId anId)
+{
+	if (anId.myIndex >= mySparse.size())
+	{
+		return nullptr;
+	}
+
+	// generations wrap around, so a stale id can match a free entry again -
+	// then myDenseIndex is a free list link, and won't point back to it
+	const SparseEntry& entry = mySparse[anId.myIndex];
+	if (entry.myGeneration != anId.myGeneration
+		|| entry.myDenseIndex >= myObjects.size()
+		|| mySparseIndices[entry.myDenseIndex] != anId.myIndex)
+	{
+		return nullptr;
+	}
+	return myObjects[entry.myDenseIndex];
+}
+
+const GameObject* World::Get(ObjectId anId) const
+{
+	return const_cast<World*>(this)->Get(anId);
 }
 
 void World::CreatePhysWorld()
 {
 	ASSERT(!myPhysWorld);
 	myPhysWorld = new PhysicsWorld();
+	// leave the rest of the frame for game and render work
+	constexpr float kPhysicsStepTimeBudget = 1.f / 120.f;
+	myPhysWorld->SetStepTimeBudget(kPhysicsStepTimeBudget);
 }
 
 void World::Serialize(Serializer& aSerializer)
@@ -98,7 +133,7 @@ void World::Serialize(Serializer& aSerializer)
 		const std::string pathStr(pathWithoutExt.data(), pathWithoutExt.size());
 		char path[256]{};
 		size_t i = 0;
-		for (Handle<GameObject>& go : myGameObjects)
+		for (Handle<GameObject>& go : myHandles)
 		{
 			if (go->GetPath().empty())
 			{
@@ -108,5 +143,69 @@ void World::Serialize(Serializer& aSerializer)
 			}
 		}
 	}
-	aSerializer.Serialize("myGameObjects", myGameObjects);
+	if (aSerializer.IsReading())
+	{
+		std::vector<Handle<GameObject>> gameObjects;
+		aSerializer.Serialize("myGameObjects", gameObjects);
+		Add(gameObjects);
+	}
+	else
+	{
+		aSerializer.Serialize("myGameObjects", myHandles);
+	}
+}
+
+void World::AddImpl(Handle<GameObject>& aGameObject)
+{
+	ASSERT_STR(aGameObject.IsValid(), "Invalid object passed in!");
+	GameObject* objPtr = aGameObject.Get();
+	ASSERT_STR(Get(objPtr->GetWorldId()) != objPtr, "Game Object already belongs to world!");
+
+	uint32_t sparseIndex = myFirstFree;
+	if (sparseIndex != kInvalidIndex)
+	{
+		myFirstFree = mySparse[sparseIndex].myDenseIndex;
+	}
+	else
+	{
+		sparseIndex = static_cast<uint32_t>(mySparse.size());
+		mySparse.push_back({ kInvalidIndex, 0 });
+	}
+
+	SparseEntry& entry = mySparse[sparseIndex];
+	entry.myDenseIndex = static_cast<uint32_t>(myObjects.size());
+	myObjects.push_back(objPtr);
+	myHandles.push_back(aGameObject);
+	mySparseIndices.push_back(sparseIndex);
+
+	objPtr->SetWorld(this, { sparseIndex, entry.myGeneration });
+}
+
+void World::RemoveImpl(GameObject& aGameObject)
+{
+	const ObjectId id = aGameObject.GetWorldId();
+	ASSERT_STR(Get(id) == &aGameObject, "Game Object didn't belong to world!");
+
+	SparseEntry& entry = mySparse[id.myIndex];
+	const uint32_t toDeleteInd = entry.myDenseIndex;
+	const uint32_t lastInd = static_cast<uint32_t>(myObjects.size() - 1);
+	if (toDeleteInd != lastInd)
+	{
+		myObjects[toDeleteInd] = myObjects[lastInd];
+		myHandles[toDeleteInd] = std::move(myHandles[lastInd]);
+		mySparseIndices[toDeleteInd] = mySparseIndices[lastInd];
+		// Update the index of what used to be last, since we just moved it
+		mySparse[mySparseIndices[toDeleteInd]].myDenseIndex = toDeleteInd;
+	}
+	myObjects.pop_back();
+	// caller still holds a Handle, so this won't destroy the object
+	myHandles.pop_back();
+	mySparseIndices.pop_back();
+
+	// invalidate the id, and put the entry to the free list
+	entry.myGeneration++;
+	entry.myDenseIndex = myFirstFree;
+	myFirstFree = id.myIndex;
+
+	aGameObject.SetWorld(nullptr, {});
 }
\ No newline at end of file
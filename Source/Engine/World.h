@@ -8,59 +8,99 @@
 class GameObject;
 class PhysicsWorld;
 
+// Container of GameObjects that make up the game. Objects are kept in
+// a dense array for iteration, with a sparse array of generational
+// indices on the side, so both lookup by ObjectId and removal are O(1).
+// World owns a Handle of every object, but iteration hands out plain
+// pointers, so walking the world doesn't touch the ref counts.
 class World : public Resource
 {
+	using GenerationType = uint8_t;
+	constexpr static uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
 public:
 	constexpr static StaticString kExtension = ".world";
 
+	// Stays the same while GameObject is in the world. Once it's removed
+	// the ObjectId becomes stale, even if its slot is reused by another object
+	struct ObjectId
+	{
+		uint32_t myIndex = kInvalidIndex;
+		GenerationType myGeneration = 0;
+
+		bool operator==(const ObjectId&) const = default;
+	};
+
 	World() = default;
 	World(Id anId, std::string_view aPath);
 	~World() noexcept = default;
 
 	void Add(Handle<GameObject>& aGameObject);
 	void Remove(Handle<GameObject>& aGameObject);
+	// Bulk versions, reserving the storage up front
+	void Add(std::span<Handle<GameObject>> aGameObjects);
+	void Remove(std::span<Handle<GameObject>> aGameObjects);
 	void Clear();
 	void Reserve(size_t aSize);
 
+	// Returns nullptr if the object is no longer in the world
+	GameObject* Get(ObjectId anId);
+	const GameObject* Get(ObjectId anId) const;
+	size_t GetCount() const { return myObjects.size(); }
+
 	void CreatePhysWorld();
 	PhysicsWorld* GetPhysicsWorld() { return myPhysWorld; }
 	const PhysicsWorld* GetPhysicsWorld() const { return myPhysWorld; }
 
 	template<class TFunc> 
 		requires std::is_invocable_v<
-			TFunc, std::vector<Handle<GameObject>>&
+			TFunc, std::span<GameObject* const>
 		>
 	void Access(TFunc aFunc)
 	{
 #ifdef ASSERT_MUTEX
 		AssertWriteLock lock(myObjectsMutex);
 #endif
-		aFunc(myGameObjects);
+		aFunc(std::span<GameObject* const>{ myObjects });
 	}
 
 	template<class TFunc> 
 		requires std::is_invocable_v<
-			TFunc, const std::vector<Handle<GameObject>>&
+			TFunc, std::span<const GameObject* const>
 		>
 	void Access(TFunc aFunc) const
 	{
 #ifdef ASSERT_MUTEX
 		AssertReadLock lock(myObjectsMutex);
 #endif
-		aFunc(myGameObjects);
+		const GameObject* const* objects = myObjects.data();
+		aFunc(std::span<const GameObject* const>{ objects, myObjects.size() });
 	}
 
 	std::string_view GetTypeName() const override { return "World"; }
 
 private:
 	void Serialize(Serializer& aSerializer) final;
+	void AddImpl(Handle<GameObject>& aGameObject);
+	void RemoveImpl(GameObject& aGameObject);
+
+	// Dense arrays, swap-removed
+	std::vector<GameObject*> myObjects;
+	std::vector<Handle<GameObject>> myHandles;
+	std::vector<uint32_t> mySparseIndices;
+
+	// Sparse array, indexed by ObjectId::myIndex. Free entries form
+	// a linked list through myDenseIndex
+	struct SparseEntry
+	{
+		uint32_t myDenseIndex;
+		GenerationType myGeneration;
+	};
+	std::vector<SparseEntry> mySparse;
+	uint32_t myFirstFree = kInvalidIndex;
 
-	// TODO: Merge into flat_map from C++23
-	std::vector<Handle<GameObject>> myGameObjects;
-	std::unordered_map<const GameObject*, size_t> myGameObjIndices;
 	PhysicsWorld* myPhysWorld = nullptr;
 #ifdef ASSERT_MUTEX
 	AssertRWMutex myObjectsMutex;
 #endif
-};
-
+};
\ No newline at end of file
@@ -3,75 +3,33 @@
 class PhysicsEntity;
 class btCollisionObject;
 
-// TODO: investigate to template it on a lambda, to reduce the 
-// amount of manual code writing
+// Commands are written into per-thread CmdBuffers, so they must
+// satisfy CmdType (trivial, with a unique kId)
+// Make sure to add handlers of the types to the PhysicsWorld!
+template<uint8_t Id>
 struct PhysicsCommand
 {
-	// make sure to add handlers of the types to the PhysicsWorld!
-	enum Type
-	{
-		AddBody,
-		RemoveBody,
-		DeleteBody,
-		ChangeBody,
-		Count
-	};
-
-	explicit PhysicsCommand(Type aType)
-		: myType(aType)
-	{
-	}
-
-	virtual ~PhysicsCommand() = default;
-
-	Type myType;
+	static constexpr uint8_t kId = Id;
 };
 
-struct PhysicsCommandAddBody : PhysicsCommand
+struct PhysicsCommandAddBody : PhysicsCommand<0>
 {
-	explicit PhysicsCommandAddBody(PhysicsEntity* anEntity)
-		: PhysicsCommand(Type::AddBody)
-		, myEntity(anEntity)
-	{
-	}
-
 	PhysicsEntity* myEntity;
 };
 
-struct PhysicsCommandRemoveBody : PhysicsCommand
+struct PhysicsCommandRemoveBody : PhysicsCommand<1>
 {
-	explicit PhysicsCommandRemoveBody(PhysicsEntity* anEntity)
-		: PhysicsCommand(PhysicsCommand::RemoveBody)
-		, myEntity(anEntity)
-	{
-	}
-
 	PhysicsEntity* myEntity;
 };
 
-struct PhysicsCommandDeleteBody : PhysicsCommand
+struct PhysicsCommandDeleteBody : PhysicsCommand<2>
 {
-	explicit PhysicsCommandDeleteBody(PhysicsEntity* anEntity)
-		: PhysicsCommand(PhysicsCommand::DeleteBody)
-		, myEntity(anEntity)
-	{
-	}
-
 	PhysicsEntity* myEntity;
 };
 
-struct PhysicsCommandChangeBody : PhysicsCommand
+struct PhysicsCommandChangeBody : PhysicsCommand<3>
 {
-	explicit PhysicsCommandChangeBody(PhysicsEntity* anEntity, 
-		btCollisionObject* anOldBody, char anOldType)
-		: PhysicsCommand(PhysicsCommand::ChangeBody)
-		, myEntity(anEntity)
-		, myOldBody(anOldBody)
-		, myOldType(anOldType)
-	{
-	}
-
 	PhysicsEntity* myEntity;
 	btCollisionObject* myOldBody;
 	char myOldType;
-};
\ No newline at end of file
+};
@@ -76,16 +76,8 @@ glm::mat4 PhysicsEntity::GetTransformInterp() const
 	ASSERT(myBody);
 	ASSERT_STR(myType == Type::Dynamic, "Only Dynamic objects can move!");
 
-	const btRigidBody* rigidBody = static_cast<const btRigidBody*>(myBody);
-
-	ASSERT_STR(rigidBody->getMotionState(), "Motion state was not set-up");
-
-	// according to http://www.bulletphysics.org/mediawiki-1.5.8/index.php/Stepping_The_World
-	// Bullet interpolates stuff if world max step count is > 1, which we do have
-	const btDefaultMotionState* motionState;
-	motionState = static_cast<const btDefaultMotionState*>(rigidBody->getMotionState());
-
-	return Utils::ConvertToGLM(motionState->m_graphicsWorldTrans);
+	const float alpha = myWorld ? myWorld->GetInterpolationAlpha() : 1.f;
+	return Utils::ConvertToGLM(GetInterpolatedTransform(alpha));
 }
 
 // TODO: add a command version of this
@@ -99,6 +91,10 @@ void PhysicsEntity::SetTransform(const glm::mat4& aTransf)
 
 	// convert to bullet and cache it
 	myBody->setWorldTransform(Utils::ConvertToBullet(aTransf));
+
+	// it's a teleport, so there's nothing to interpolate from
+	SaveInterpolationState();
+	myHasStaleMotionState = true;
 }
 
 float PhysicsEntity::GetMass() const
@@ -132,6 +128,17 @@ void PhysicsEntity::SetVelocity(glm::vec3 aVelocity)
 	rigidBody->setLinearVelocity(velocity);
 }
 
+void PhysicsEntity::SetAngularVelocity(glm::vec3 aVelocity)
+{
+	ASSERT(myBody);
+	ASSERT_STR(myType == Type::Dynamic, "Only Dynamic objects can have velocity!");
+	ASSERT(!Utils::IsNan(aVelocity));
+
+	const btVector3 velocity = Utils::ConvertToBullet(aVelocity);
+	btRigidBody* rigidBody = static_cast<btRigidBody*>(myBody);
+	rigidBody->setAngularVelocity(velocity);
+}
+
 void PhysicsEntity::SetCollisionFlags(int aFlagSet)
 {
 	myBody->setCollisionFlags(aFlagSet); 
@@ -403,6 +410,23 @@ void PhysicsEntity::UpdateTransform()
 	}
 }
 
+void PhysicsEntity::SaveInterpolationState()
+{
+	const btTransform& transf = myBody->getWorldTransform();
+	myPrevPos = Utils::ConvertToGLM(transf.getOrigin());
+	const btQuaternion rot = transf.getRotation();
+	myPrevRot = glm::quat(rot.w(), rot.x(), rot.y(), rot.z());
+}
+
+btTransform PhysicsEntity::GetInterpolatedTransform(float anAlpha) const
+{
+	const btTransform& transf = myBody->getWorldTransform();
+	const btVector3 pos = Utils::ConvertToBullet(myPrevPos).lerp(transf.getOrigin(), anAlpha);
+	const btQuaternion prevRot(myPrevRot.x, myPrevRot.y, myPrevRot.z, myPrevRot.w);
+	const btQuaternion rot = prevRot.slerp(transf.getRotation(), anAlpha);
+	return btTransform(rot, pos);
+}
+
 void PhysicsEntity::CreateBody(const InitParams& aParams)
 {
 	// input validation
@@ -468,6 +492,8 @@ void PhysicsEntity::CreateBody(const InitParams& aParams)
 		break;
 	}
 	myBody->setUserPointer(this);
+	// so that bodies pending addition don't interpolate from the origin
+	SaveInterpolationState();
 }
 
 void PhysicsEntity::UpdateType(Type aType, float aMass)
@@ -503,7 +529,10 @@ void PhysicsEntity::UpdateType(Type aType, float aMass)
 
 	if (myWorld)
 	{
-		const PhysicsCommandChangeBody* cmd = new PhysicsCommandChangeBody(this, oldBody, oldType);
+		PhysicsCommandChangeBody cmd;
+		cmd.myEntity = this;
+		cmd.myOldBody = oldBody;
+		cmd.myOldType = oldType;
 		myWorld->EnqueueCommand(cmd);
 	}
 	else
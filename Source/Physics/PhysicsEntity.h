@@ -17,6 +17,7 @@ class PhysicsShapeBase;
 class btRigidBody;
 class btCollisionObject;
 class btMotionState;
+class btTransform;
 class Serializer;
 
 class IPhysControllable
@@ -79,7 +80,7 @@ public:
 
 	// Returns un-interpolated transform
 	glm::mat4 GetTransform() const;
-	// Returns interpolated transform
+	// Returns transform interpolated between last 2 world steps
 	glm::mat4 GetTransformInterp() const;
 	// Updates the position of rigidbody. Does not take effect until stepped,
 	// so if it needs to be fetched, use GetTransformInterp()
@@ -92,6 +93,8 @@ public:
 
 	// Not thread-safe: updates velocity immediatelly
 	void SetVelocity(glm::vec3 aVelocity);
+	// Not thread-safe: updates angular velocity immediatelly
+	void SetAngularVelocity(glm::vec3 aVelocity);
 
 	// TODO: expose flags as an enum set
 	void SetCollisionFlags(int aFlagSet);
@@ -115,6 +118,8 @@ private:
 	void ApplyForces();
 	void SetMass(float aMass);
 	void UpdateTransform();
+	void SaveInterpolationState();
+	btTransform GetInterpolatedTransform(float anAlpha) const;
 
 	void CreateBody(const InitParams& aParams);
 	void UpdateType(Type aType, float aMass);
@@ -138,6 +143,12 @@ private:
 	glm::vec3 myAccumForces{0};
 	glm::vec3 myAccumTorque{0};
 	glm::vec3 myOffset{0};
+	// state before last step, used for interpolation
+	glm::vec3 myPrevPos{0};
+	glm::quat myPrevRot{1, 0, 0, 0};
+	// set while the motion state doesn't match the body, so that it
+	// gets the final transform once the body falls asleep
+	bool myHasStaleMotionState = false;
 
 	Type myType = Type::Static;
 
@@ -0,0 +1,30 @@
+#include "Precomp.h"
+#include "PhysicsSnapshot.h"
+
+PhysicsSnapshot::PhysicsSnapshot(std::span<const std::byte> aBuffer)
+	: myBuffer(aBuffer.begin(), aBuffer.end())
+{
+	ASSERT_STR(myBuffer.size() >= sizeof(Header), "Invalid snapshot buffer!");
+
+	Header header;
+	std::memcpy(&header, myBuffer.data(), sizeof(Header));
+	ASSERT_STR(header.myMagic == kMagic, "Buffer isn't a physics snapshot!");
+	ASSERT_STR(header.myVersion == kVersion, "Snapshot version {} isn't supported, expected {}!",
+		header.myVersion, kVersion);
+	ASSERT_STR(myBuffer.size() == sizeof(Header)
+		+ header.myBodyCount * sizeof(BodyState)
+		+ header.myConstraintCount * sizeof(float),
+		"Snapshot buffer is truncated!");
+}
+
+uint32_t PhysicsSnapshot::GetBodyCount() const
+{
+	if (myBuffer.empty())
+	{
+		return 0;
+	}
+
+	Header header;
+	std::memcpy(&header, myBuffer.data(), sizeof(Header));
+	return header.myBodyCount;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// A binary copy of the simulation state of a PhysicsWorld, stored in
+// a single contiguous buffer. Take via PhysicsWorld::TakeSnapshot and
+// restore via PhysicsWorld::RestoreSnapshot. Buffer is reused between
+// snapshots, so it's cheap to take one every frame
+// Note: bodies are matched by their order in the world, so snapshot is only
+// valid for a world with the same entities, added in the same order (no
+// additions/removals in between). Buffers can be saved and loaded back by
+// the same build, but aren't portable between platforms
+class PhysicsSnapshot
+{
+public:
+	PhysicsSnapshot() = default;
+	// Creates a snapshot from a previously captured buffer (i.e. loaded from disk)
+	explicit PhysicsSnapshot(std::span<const std::byte> aBuffer);
+
+	std::span<const std::byte> GetBuffer() const { return myBuffer; }
+	bool IsEmpty() const { return myBuffer.empty(); }
+	uint32_t GetBodyCount() const;
+
+private:
+	friend class PhysicsWorld;
+
+	// "PHSN", to catch buffers that aren't snapshots
+	constexpr static uint32_t kMagic = 0x4E534850;
+	// bump whenever the layout changes
+	constexpr static uint32_t kVersion = 1;
+
+	struct Header
+	{
+		uint32_t myMagic;
+		uint32_t myVersion;
+		uint32_t myBodyCount;
+		uint32_t myConstraintCount;
+		float myAccumulatedTime;
+	};
+
+	struct BodyState
+	{
+		// used for validation only, unlike pointers these
+		// stay the same between runs
+		int myShapeType;
+		float myInvMass;
+		glm::vec3 myPos;
+		// basis rows as Bullet has them - going through a quaternion
+		// isn't exact, and replays would diverge
+		float myBasis[3][3];
+		glm::vec3 myLinearVelocity;
+		glm::vec3 myAngularVelocity;
+		glm::vec3 myPrevPos;
+		glm::quat myPrevRot;
+		float myDeactivationTime;
+		int myActivationState;
+	};
+	static_assert(std::is_trivially_copyable_v<BodyState>);
+
+	// Layout: Header, BodyState[myBodyCount], float[myConstraintCount]
+	std::vector<std::byte> myBuffer;
+};
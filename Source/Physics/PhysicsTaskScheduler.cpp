@@ -0,0 +1,53 @@
+#include "Precomp.h"
+#include "PhysicsTaskScheduler.h"
+
+PhysicsTaskScheduler& PhysicsTaskScheduler::Activate()
+{
+	static PhysicsTaskScheduler ourScheduler;
+	if (btGetTaskScheduler() != &ourScheduler)
+	{
+		btSetTaskScheduler(&ourScheduler);
+	}
+	return ourScheduler;
+}
+
+PhysicsTaskScheduler::PhysicsTaskScheduler()
+	: btITaskScheduler("PhysicsTaskScheduler")
+	, myNumThreads(getMaxNumThreads())
+{
+}
+
+int PhysicsTaskScheduler::getMaxNumThreads() const
+{
+	// Bullet tracks per-thread data in fixed arrays, so we can't go over it
+	return std::min(tbb::this_task_arena::max_concurrency(), BT_MAX_THREAD_COUNT);
+}
+
+void PhysicsTaskScheduler::setNumThreads(int aNumThreads)
+{
+	// Actual concurrency is controlled by the arena we're called in,
+	// this only affects how Bullet sizes it's per-thread pools
+	myNumThreads = std::clamp(aNumThreads, 1, getMaxNumThreads());
+}
+
+void PhysicsTaskScheduler::parallelFor(int aBegin, int anEnd, int aGrainSize, const btIParallelForBody& aBody)
+{
+	tbb::parallel_for(tbb::blocked_range<int>(aBegin, anEnd, aGrainSize),
+		[&aBody](const tbb::blocked_range<int>& aRange) {
+			aBody.forLoop(aRange.begin(), aRange.end());
+		}, 
+		tbb::simple_partitioner()
+	);
+}
+
+btScalar PhysicsTaskScheduler::parallelSum(int aBegin, int anEnd, int aGrainSize, const btIParallelSumBody& aBody)
+{
+	return tbb::parallel_reduce(tbb::blocked_range<int>(aBegin, anEnd, aGrainSize),
+		btScalar(0),
+		[&aBody](const tbb::blocked_range<int>& aRange, btScalar aSum) {
+			return aSum + aBody.sumLoop(aRange.begin(), aRange.end());
+		},
+		std::plus<btScalar>(),
+		tbb::simple_partitioner()
+	);
+}
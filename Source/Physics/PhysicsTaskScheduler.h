@@ -0,0 +1,26 @@
+#pragma once
+
+#include <LinearMath/btThreads.h>
+
+// Bridges Bullet's multithreading with TBB. Parallel work is spawned
+// in the task_arena of the caller, so stepping the world from within
+// Game's task graph keeps Bullet in the engine's arena instead of
+// it spinning up it's own thread pool
+class PhysicsTaskScheduler final : public btITaskScheduler
+{
+public:
+	// Bullet supports a single global scheduler, so this lazily
+	// creates it and sets it as active. Must be called from main thread
+	static PhysicsTaskScheduler& Activate();
+
+	PhysicsTaskScheduler();
+
+	int getMaxNumThreads() const override;
+	int getNumThreads() const override { return myNumThreads; }
+	void setNumThreads(int aNumThreads) override;
+	void parallelFor(int aBegin, int anEnd, int aGrainSize, const btIParallelForBody& aBody) override;
+	btScalar parallelSum(int aBegin, int anEnd, int aGrainSize, const btIParallelSumBody& aBody) override;
+
+private:
+	int myNumThreads;
+};
@@ -4,6 +4,8 @@
 #include "PhysicsCommands.h"
 #include "PhysicsDebugDrawer.h"
 #include "PhysicsEntity.h"
+#include "PhysicsSnapshot.h"
+#include "PhysicsTaskScheduler.h"
 
 #include <Core/Utils.h>
 #include <Core/Profiler.h>
@@ -11,18 +13,29 @@
 #include <BulletCollision/CollisionShapes/btTriangleShape.h>
 #include <BulletCollision/NarrowPhaseCollision/btRaycastCallback.h>
 
-PhysicsWorld::PhysicsWorld()
-	: myIsBeingStepped(false)
+PhysicsWorld::PhysicsWorld(Threading aThreading /* = Threading::Single */)
+	: myThreading(aThreading)
+	, myIsBeingStepped(false)
 {
 	myBroadphase = new btDbvtBroadphase();
 	myGhostCallback = new btGhostPairCallback();
 	myBroadphase->getOverlappingPairCache()->setInternalGhostPairCallback(myGhostCallback);
 	myConfiguration = new btDefaultCollisionConfiguration();
-	myDispatcher = new btCollisionDispatcher(myConfiguration);
-	// TODO: Bullet has a multithread solver with TBB support! Need to investigate
-	// how to set it up (see BT_THREADSAFE)
-	mySolver = new btSequentialImpulseConstraintSolver();
-	myWorld = new btDiscreteDynamicsWorld(myDispatcher, myBroadphase, mySolver, myConfiguration);
+	if (myThreading == Threading::Multi)
+	{
+		const PhysicsTaskScheduler& scheduler = PhysicsTaskScheduler::Activate();
+		myDispatcher = new btCollisionDispatcherMt(myConfiguration);
+		// islands get solved in parallel, with each thread grabbing a free solver from the pool
+		btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(scheduler.getNumThreads());
+		mySolver = solverPool;
+		myWorld = new btDiscreteDynamicsWorldMt(myDispatcher, myBroadphase, solverPool, nullptr, myConfiguration);
+	}
+	else
+	{
+		myDispatcher = new btCollisionDispatcher(myConfiguration);
+		mySolver = new btSequentialImpulseConstraintSolver();
+		myWorld = new btDiscreteDynamicsWorld(myDispatcher, myBroadphase, mySolver, myConfiguration);
+	}
 	
 	// Setting up pre physics step callback
 	myWorld->setInternalTickCallback([](btDynamicsWorld* aWorld, float aDeltaTime) {
@@ -37,7 +50,6 @@ PhysicsWorld::PhysicsWorld()
 
 	myWorld->setDebugDrawer(new PhysicsDebugDrawer());
 
-	myCommands.reserve(200);
 	myTriggers.reserve(100);
 }
 
@@ -73,8 +85,8 @@ void PhysicsWorld::AddEntity(PhysicsEntity* anEntity)
 	ASSERT(!anEntity->myWorld);
 	anEntity->myState = PhysicsEntity::State::PendingAddition;
 	anEntity->myWorld = this;
-	// TODO: get rid of allocs/deallocs by using an internal recycler
-	const PhysicsCommandAddBody* cmd = new PhysicsCommandAddBody(anEntity);
+	PhysicsCommandAddBody cmd;
+	cmd.myEntity = anEntity;
 	EnqueueCommand(cmd);
 }
 
@@ -83,8 +95,8 @@ void PhysicsWorld::RemoveEntity(PhysicsEntity* anEntity)
 	ASSERT(anEntity->GetState() == PhysicsEntity::State::InWorld);
 	ASSERT(anEntity->myWorld == this);
 	anEntity->myState = PhysicsEntity::State::PendingRemoval;
-	// TODO: get rid of allocs/deallocs by using an internal recycler
-	const PhysicsCommandRemoveBody* cmd = new PhysicsCommandRemoveBody(anEntity);
+	PhysicsCommandRemoveBody cmd;
+	cmd.myEntity = anEntity;
 	EnqueueCommand(cmd);
 }
 
@@ -94,8 +106,8 @@ void PhysicsWorld::DeleteEntity(PhysicsEntity* anEntity)
 		|| anEntity->GetState() == PhysicsEntity::State::PendingAddition);
 	ASSERT(anEntity->myWorld == this);
 	anEntity->myState = PhysicsEntity::State::PendingRemoval;
-	// TODO: get rid of allocs/deallocs by using an internal recycler
-	const PhysicsCommandDeleteBody* cmd = new PhysicsCommandDeleteBody(anEntity);
+	PhysicsCommandDeleteBody cmd;
+	cmd.myEntity = anEntity;
 	EnqueueCommand(cmd);
 }
 
@@ -111,12 +123,45 @@ void PhysicsWorld::Simulate(float aDeltaTime)
 		{
 			Profiler::ScopedMark scope("PhysicsWorld::StepSimulation");
 			myIsBeingStepped = true;
-			// even if we don't have enough deltaTime this frame, Bullet will avoid stepping
-			// the simulation, but it will update the motion states, thus achieving interpolation
-			myWorld->stepSimulation(aDeltaTime, kMaxSteps, kFixedStepLength);
+			myAccumulatedTime += aDeltaTime;
+			int stepCount = static_cast<int>(myAccumulatedTime / kFixedStepLength);
+			if (stepCount > myStepBudget)
+			{
+				// can't afford to catch up, so drop the extra time instead
+				const float droppedTime = (stepCount - myStepBudget) * kFixedStepLength;
+				myAccumulatedTime -= droppedTime;
+				myDroppedTime += droppedTime;
+				stepCount = myStepBudget;
+			}
+
+			const auto stepStart = std::chrono::steady_clock::now();
+			for (int step = 0; step < stepCount; step++)
+			{
+				if (step == stepCount - 1)
+				{
+					SaveInterpolationStates();
+				}
+				// Without max sub steps Bullet does exactly 1 step of the passed length.
+				// We keep track of leftover time ourselves, to be able to interpolate
+				// between the last 2 states, as Bullet only extrapolates
+				myWorld->stepSimulation(kFixedStepLength, 0, kFixedStepLength);
+				myAccumulatedTime -= kFixedStepLength;
+			}
+			myAccumulatedTime = std::max(myAccumulatedTime, 0.f);
+
+			if (stepCount > 0)
+			{
+				const std::chrono::duration<float> stepTime = std::chrono::steady_clock::now() - stepStart;
+				UpdateStepBudget(stepTime.count() / stepCount);
+			}
 			myIsBeingStepped = false;
 		}
 
+		{
+			Profiler::ScopedMark scope("PhysicsWorld::Interpolate");
+			ApplyInterpolation();
+		}
+
 		{
 			Profiler::ScopedMark scope("PhysicsWorld::DebugDraw");
 			myWorld->debugDrawWorld();
@@ -124,6 +169,159 @@ void PhysicsWorld::Simulate(float aDeltaTime)
 	}
 }
 
+float PhysicsWorld::GetInterpolationAlpha() const
+{
+	return std::min(myAccumulatedTime / kFixedStepLength, 1.f);
+}
+
+void PhysicsWorld::TakeSnapshot(PhysicsSnapshot& aSnapshot) const
+{
+	Profiler::ScopedMark scope("PhysicsWorld::TakeSnapshot");
+#ifdef ASSERT_MUTEX
+	AssertReadLock readLock(mySimulationMutex);
+#endif
+
+	using Header = PhysicsSnapshot::Header;
+	using BodyState = PhysicsSnapshot::BodyState;
+
+	const btAlignedObjectArray<btRigidBody*>& rigidbodies = myWorld->getNonStaticRigidBodies();
+	const Header header{
+		PhysicsSnapshot::kMagic,
+		PhysicsSnapshot::kVersion,
+		static_cast<uint32_t>(rigidbodies.size()),
+		static_cast<uint32_t>(myWorld->getNumConstraints()),
+		myAccumulatedTime
+	};
+	std::vector<std::byte>& buffer = aSnapshot.myBuffer;
+	// resize keeps the capacity, so repeated snapshots don't allocate
+	buffer.resize(sizeof(Header) 
+		+ header.myBodyCount * sizeof(BodyState)
+		+ header.myConstraintCount * sizeof(float));
+	std::byte* writePtr = buffer.data();
+	std::memcpy(writePtr, &header, sizeof(Header));
+	writePtr += sizeof(Header);
+
+	for (int i = 0; i < rigidbodies.size(); i++)
+	{
+		const btRigidBody* rigidbody = rigidbodies[i];
+		const PhysicsEntity* physEntity = static_cast<const PhysicsEntity*>(rigidbody->getUserPointer());
+		const btTransform& transf = rigidbody->getWorldTransform();
+		BodyState state{
+			rigidbody->getCollisionShape()->getShapeType(),
+			rigidbody->getInvMass(),
+			Utils::ConvertToGLM(transf.getOrigin()),
+			{},
+			Utils::ConvertToGLM(rigidbody->getLinearVelocity()),
+			Utils::ConvertToGLM(rigidbody->getAngularVelocity()),
+			physEntity->myPrevPos,
+			physEntity->myPrevRot,
+			rigidbody->getDeactivationTime(),
+			rigidbody->getActivationState()
+		};
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				state.myBasis[row][column] = transf.getBasis()[row][column];
+			}
+		}
+		std::memcpy(writePtr, &state, sizeof(BodyState));
+		writePtr += sizeof(BodyState);
+	}
+
+	for (int i = 0; i < myWorld->getNumConstraints(); i++)
+	{
+		const float impulse = myWorld->getConstraint(i)->getAppliedImpulse();
+		std::memcpy(writePtr, &impulse, sizeof(float));
+		writePtr += sizeof(float);
+	}
+}
+
+void PhysicsWorld::RestoreSnapshot(const PhysicsSnapshot& aSnapshot)
+{
+	Profiler::ScopedMark scope("PhysicsWorld::RestoreSnapshot");
+	ASSERT_STR(!IsStepping(), "Can't restore while stepping!");
+#ifdef ASSERT_MUTEX
+	AssertWriteLock writeLock(mySimulationMutex);
+#endif
+
+	using Header = PhysicsSnapshot::Header;
+	using BodyState = PhysicsSnapshot::BodyState;
+
+	ASSERT_STR(!aSnapshot.IsEmpty(), "Snapshot wasn't taken!");
+	const std::byte* readPtr = aSnapshot.myBuffer.data();
+	Header header;
+	std::memcpy(&header, readPtr, sizeof(Header));
+	readPtr += sizeof(Header);
+
+	btAlignedObjectArray<btRigidBody*>& rigidbodies = myWorld->getNonStaticRigidBodies();
+	ASSERT_STR(header.myBodyCount == static_cast<uint32_t>(rigidbodies.size()), 
+		"Snapshot doesn't match the world - {} vs {} bodies!", header.myBodyCount, rigidbodies.size());
+	ASSERT_STR(header.myConstraintCount == static_cast<uint32_t>(myWorld->getNumConstraints()),
+		"Snapshot doesn't match the world's constraints!");
+	myAccumulatedTime = header.myAccumulatedTime;
+
+	for (int i = 0; i < rigidbodies.size(); i++)
+	{
+		BodyState state;
+		std::memcpy(&state, readPtr, sizeof(BodyState));
+		readPtr += sizeof(BodyState);
+
+		btRigidBody* rigidbody = rigidbodies[i];
+		PhysicsEntity* physEntity = static_cast<PhysicsEntity*>(rigidbody->getUserPointer());
+		ASSERT_STR(state.myShapeType == rigidbody->getCollisionShape()->getShapeType()
+			&& state.myInvMass == rigidbody->getInvMass(),
+			"Snapshot doesn't match the world's bodies!");
+
+		const btMatrix3x3 basis(
+			state.myBasis[0][0], state.myBasis[0][1], state.myBasis[0][2],
+			state.myBasis[1][0], state.myBasis[1][1], state.myBasis[1][2],
+			state.myBasis[2][0], state.myBasis[2][1], state.myBasis[2][2]
+		);
+		const btTransform transf(basis, Utils::ConvertToBullet(state.myPos));
+		const btVector3 linearVelocity = Utils::ConvertToBullet(state.myLinearVelocity);
+		const btVector3 angularVelocity = Utils::ConvertToBullet(state.myAngularVelocity);
+		rigidbody->setWorldTransform(transf);
+		// world-space inertia is cached, and would otherwise
+		// stay rotated as it was before the restore
+		rigidbody->updateInertiaTensor();
+		rigidbody->setInterpolationWorldTransform(transf);
+		rigidbody->setLinearVelocity(linearVelocity);
+		rigidbody->setAngularVelocity(angularVelocity);
+		rigidbody->setInterpolationLinearVelocity(linearVelocity);
+		rigidbody->setInterpolationAngularVelocity(angularVelocity);
+		rigidbody->forceActivationState(state.myActivationState);
+		rigidbody->setDeactivationTime(state.myDeactivationTime);
+		rigidbody->clearForces();
+
+		physEntity->myPrevPos = state.myPrevPos;
+		physEntity->myPrevRot = state.myPrevRot;
+		// restored sleeping bodies still need their motion states updated
+		physEntity->myHasStaleMotionState = true;
+	}
+
+	for (int i = 0; i < myWorld->getNumConstraints(); i++)
+	{
+		float impulse;
+		std::memcpy(&impulse, readPtr, sizeof(float));
+		readPtr += sizeof(float);
+		myWorld->getConstraint(i)->internalSetAppliedImpulse(impulse);
+	}
+
+	// drop cached contacts and collision algorithms, so that stepping after 
+	// a restore doesn't depend on what happened before it
+	btOverlappingPairCache* pairCache = myBroadphase->getOverlappingPairCache();
+	btBroadphasePairArray& pairs = pairCache->getOverlappingPairArray();
+	for (int i = 0; i < pairs.size(); i++)
+	{
+		pairCache->cleanOverlappingPair(pairs[i], myDispatcher);
+	}
+	mySolver->reset();
+	myWorld->updateAabbs();
+
+	ApplyInterpolation();
+}
+
 bool PhysicsWorld::RaycastClosest(glm::vec3 aFrom, glm::vec3 aDir, float aDist, PhysicsEntity*& aHitEntity) const
 {
 	glm::vec3 to = aFrom + aDir * aDist;
@@ -187,6 +385,81 @@ bool PhysicsWorld::Raycast(glm::vec3 aFrom, glm::vec3 aTo, std::vector<PhysicsEn
 	return false;
 }
 
+namespace
+{
+	// Grain size for batched queries, large enough to amortize
+	// task overhead since each query is fairly cheap
+	constexpr size_t kQueryGrainSize = 64;
+
+	void FillHit(PhysicsWorld::QueryHit& aHit, const btCollisionObject* anObject,
+		const btVector3& aPoint, const btVector3& aNormal, btScalar aFraction)
+	{
+		aHit.myEntity = anObject ? static_cast<PhysicsEntity*>(anObject->getUserPointer()) : nullptr;
+		aHit.myPoint = Utils::ConvertToGLM(aPoint);
+		aHit.myNormal = Utils::ConvertToGLM(aNormal);
+		aHit.myFraction = anObject ? aFraction : 1.f;
+	}
+}
+
+void PhysicsWorld::RaycastClosest(std::span<const RayQuery> aRays, std::span<QueryHit> aHits) const
+{
+	Profiler::ScopedMark scope("PhysicsWorld::RaycastClosestBatch");
+	ASSERT_STR(aHits.size() >= aRays.size(), "Not enough space for hits!");
+
+	// Note: broadphase uses per-thread stacks for ray tests (BT_THREADSAFE),
+	// so concurrent queries are safe as long as nothing modifies the world
+#ifdef ASSERT_MUTEX
+	AssertReadLock readLock(mySimulationMutex);
+#endif
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aRays.size(), kQueryGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange) {
+		for (size_t i = aRange.begin(); i < aRange.end(); i++)
+		{
+			const btVector3 from = Utils::ConvertToBullet(aRays[i].myFrom);
+			const btVector3 to = Utils::ConvertToBullet(aRays[i].myTo);
+
+			btCollisionWorld::ClosestRayResultCallback closestCollector(from, to);
+			// by defalt we don't want hits with backface triangles
+			closestCollector.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+			myWorld->rayTest(from, to, closestCollector);
+
+			FillHit(aHits[i], closestCollector.m_collisionObject, closestCollector.m_hitPointWorld,
+				closestCollector.m_hitNormalWorld, closestCollector.m_closestHitFraction);
+		}
+	});
+}
+
+void PhysicsWorld::SweepClosest(std::span<const SweepQuery> aSweeps, std::span<QueryHit> aHits) const
+{
+	Profiler::ScopedMark scope("PhysicsWorld::SweepClosestBatch");
+	ASSERT_STR(aHits.size() >= aSweeps.size(), "Not enough space for hits!");
+
+#ifdef ASSERT_MUTEX
+	AssertReadLock readLock(mySimulationMutex);
+#endif
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aSweeps.size(), kQueryGrainSize),
+		[&](const tbb::blocked_range<size_t>& aRange) {
+		for (size_t i = aRange.begin(); i < aRange.end(); i++)
+		{
+			const SweepQuery& sweep = aSweeps[i];
+			btTransform from;
+			from.setIdentity();
+			from.setOrigin(Utils::ConvertToBullet(sweep.myFrom));
+			btTransform to;
+			to.setIdentity();
+			to.setOrigin(Utils::ConvertToBullet(sweep.myTo));
+
+			// stack allocated to avoid needing a shape cache
+			btSphereShape sphere(sweep.myRadius);
+			btCollisionWorld::ClosestConvexResultCallback closestCollector(from.getOrigin(), to.getOrigin());
+			myWorld->convexSweepTest(&sphere, from, to, closestCollector);
+
+			FillHit(aHits[i], closestCollector.m_hitCollisionObject, closestCollector.m_hitPointWorld,
+				closestCollector.m_hitNormalWorld, closestCollector.m_closestHitFraction);
+		}
+	});
+}
+
 const DebugDrawer& PhysicsWorld::GetDebugDrawer() const
 {
 	return static_cast<PhysicsDebugDrawer*>(myWorld->getDebugDrawer())->GetDebugDrawer();
@@ -303,43 +576,150 @@ void PhysicsWorld::PostPhysicsStep(float aDeltaTime)
 	}
 }
 
-// little macro helper for switch cases to reduce the length
+void PhysicsWorld::SaveInterpolationStates()
+{
+	btAlignedObjectArray<btRigidBody*>& rigidbodies = myWorld->getNonStaticRigidBodies();
+	for (int i = 0; i < rigidbodies.size(); i++)
+	{
+		PhysicsEntity* physEntity = static_cast<PhysicsEntity*>(rigidbodies[i]->getUserPointer());
+		physEntity->SaveInterpolationState();
+	}
+}
+
+void PhysicsWorld::ApplyInterpolation()
+{
+	const float alpha = GetInterpolationAlpha();
+	btAlignedObjectArray<btRigidBody*>& rigidbodies = myWorld->getNonStaticRigidBodies();
+	for (int i = 0; i < rigidbodies.size(); i++)
+	{
+		btRigidBody* rigidbody = rigidbodies[i];
+		if (!rigidbody->getMotionState())
+		{
+			continue;
+		}
+
+		PhysicsEntity* physEntity = static_cast<PhysicsEntity*>(rigidbody->getUserPointer());
+		// sleeping bodies have settled, so there's nothing to interpolate -
+		// they only need to catch up to where they fell asleep, once
+		if (!rigidbody->isActive())
+		{
+			if (physEntity->myHasStaleMotionState)
+			{
+				rigidbody->getMotionState()->setWorldTransform(rigidbody->getWorldTransform());
+				physEntity->myHasStaleMotionState = false;
+			}
+			continue;
+		}
+
+		rigidbody->getMotionState()->setWorldTransform(physEntity->GetInterpolatedTransform(alpha));
+		physEntity->myHasStaleMotionState = true;
+	}
+}
+
+void PhysicsWorld::UpdateStepBudget(float aStepCost)
+{
+	if (myStepTimeBudget <= 0.f)
+	{
+		myStepBudget = kMaxSteps;
+		return;
+	}
+
+	// smoothing out to avoid reacting to single spikes
+	constexpr float kCostSmoothing = 0.1f;
+	myAvgStepCost = myAvgStepCost > 0.f
+		? glm::mix(myAvgStepCost, aStepCost, kCostSmoothing)
+		: aStepCost;
+	// clamping as float, since budget can be arbitrary large
+	const float affordableSteps = myStepTimeBudget / myAvgStepCost;
+	myStepBudget = static_cast<int>(std::clamp(affordableSteps, 1.f, static_cast<float>(kMaxSteps)));
+}
+
+namespace
+{
+	template<class T>
+	T GetCommand(std::span<const std::byte> aBytes, uint32_t& anIndex)
+	{
+		T cmd;
+		std::memcpy(&cmd, &aBytes[anIndex], sizeof(T));
+		anIndex += sizeof(T);
+		return cmd;
+	}
+}
+
 void PhysicsWorld::ResolveCommands()
 {
 	Profiler::ScopedMark scope("PhysicsWorld::ResolveCommands");
-	tbb::spin_mutex::scoped_lock lock(myCommandsLock);
+
+	struct Cursor
+	{
+		std::span<const std::byte> myBytes;
+		std::span<const uint32_t> mySequences;
+		uint32_t myIndex = 0;
+		uint32_t myReadCount = 0;
+	};
+	std::vector<Cursor> cursors;
+	for (CommandSlot& slot : myCommands)
+	{
+		{
+			tbb::spin_mutex::scoped_lock lock(slot.myLock);
+			std::swap(slot.myWriteBuffer, slot.myReadBuffer);
+			std::swap(slot.myWriteSequences, slot.myReadSequences);
+		}
+		if (!slot.myReadSequences.empty())
+		{
+			cursors.push_back({ slot.myReadBuffer.GetBuffer(), slot.myReadSequences });
+		}
+	}
+
+	// Commands get resolved in the order they were enqueued, regardless of
+	// which thread enqueued them, so add->remove and add->change sequences
+	// of an entity stay valid. There's a cursor per thread with commands,
+	// so picking the next one is just a linear search
 	std::unordered_set<PhysicsEntity*> skippedPhysEntities;
-	for (const PhysicsCommand* cmd : myCommands)
+	while (!cursors.empty())
 	{
-		const PhysicsCommand& cmdRef = *cmd;
-		switch (cmdRef.myType)
+		auto cursorIter = std::ranges::min_element(cursors, [](const Cursor& aLeft, const Cursor& aRight) {
+			// sequences wrap around, so compare by their distance
+			const uint32_t left = aLeft.mySequences[aLeft.myReadCount];
+			const uint32_t right = aRight.mySequences[aRight.myReadCount];
+			return static_cast<int32_t>(left - right) < 0;
+		});
+		Cursor& cursor = *cursorIter;
+
+		const uint8_t cmdId = static_cast<uint8_t>(cursor.myBytes[cursor.myIndex++]);
+		switch (cmdId)
 		{
-		case PhysicsCommand::AddBody:
-			AddBodyHandler(static_cast<const PhysicsCommandAddBody&>(cmdRef), skippedPhysEntities);
+		case PhysicsCommandAddBody::kId:
+			AddBodyHandler(GetCommand<PhysicsCommandAddBody>(cursor.myBytes, cursor.myIndex), skippedPhysEntities);
 			break;
-		case PhysicsCommand::RemoveBody:
-			RemoveBodyHandler(static_cast<const PhysicsCommandRemoveBody&>(cmdRef), skippedPhysEntities);
+		case PhysicsCommandChangeBody::kId:
+			ChangeBodyHandler(GetCommand<PhysicsCommandChangeBody>(cursor.myBytes, cursor.myIndex));
 			break;
-		case PhysicsCommand::DeleteBody:
-			DeleteBodyHandler(static_cast<const PhysicsCommandDeleteBody&>(cmdRef), skippedPhysEntities);
+		case PhysicsCommandRemoveBody::kId:
+			RemoveBodyHandler(GetCommand<PhysicsCommandRemoveBody>(cursor.myBytes, cursor.myIndex), skippedPhysEntities);
 			break;
-		case PhysicsCommand::ChangeBody:
-			ChangeBodyHandler(static_cast<const PhysicsCommandChangeBody&>(cmdRef));
+		case PhysicsCommandDeleteBody::kId:
+			DeleteBodyHandler(GetCommand<PhysicsCommandDeleteBody>(cursor.myBytes, cursor.myIndex), skippedPhysEntities);
 			break;
 		default:
 			ASSERT(false);
 			break;
 		}
-		// TODO: get rid of allocs/deallocs by using an internal recycler
-		delete cmd;
+
+		cursor.myReadCount++;
+		if (cursor.myReadCount == cursor.mySequences.size())
+		{
+			ASSERT_STR(cursor.myIndex == cursor.myBytes.size(), "Commands and sequences are out of sync!");
+			*cursorIter = cursors.back();
+			cursors.pop_back();
+		}
 	}
-	myCommands.clear();
-}
 
-void PhysicsWorld::EnqueueCommand(const PhysicsCommand* aCmd)
-{
-	tbb::spin_mutex::scoped_lock lock(myCommandsLock);
-	myCommands.push_back(aCmd);
+	for (CommandSlot& slot : myCommands)
+	{
+		slot.myReadBuffer.Clear();
+		slot.myReadSequences.clear();
+	}
 }
 
 void PhysicsWorld::AddBodyHandler(const PhysicsCommandAddBody& aCmd, std::unordered_set<PhysicsEntity*>& aSkippedSet)
@@ -367,6 +747,7 @@ void PhysicsWorld::AddBodyHandler(const PhysicsCommandAddBody& aCmd, std::unorde
 		break;
 	case PhysicsEntity::Type::Dynamic:
 		myWorld->addRigidBody(static_cast<btRigidBody*>(entity->myBody));
+		entity->SaveInterpolationState();
 		break;
 	default:
 		ASSERT(false);
@@ -411,7 +792,8 @@ void PhysicsWorld::RemoveBodyHandler(const PhysicsCommandRemoveBody& aCmd, const
 void PhysicsWorld::DeleteBodyHandler(const PhysicsCommandDeleteBody& aCmd, const std::unordered_set<PhysicsEntity*>& aSkippedSet)
 {
 	// remove it from the world first
-	PhysicsCommandRemoveBody remCmd(aCmd.myEntity);
+	PhysicsCommandRemoveBody remCmd;
+	remCmd.myEntity = aCmd.myEntity;
 	RemoveBodyHandler(remCmd, aSkippedSet);
 
 	// now it's safe to delete it
@@ -449,6 +831,7 @@ void PhysicsWorld::ChangeBodyHandler(const PhysicsCommandChangeBody& aCmd)
 		break;
 	case PhysicsEntity::Type::Dynamic:
 		myWorld->addRigidBody(static_cast<btRigidBody*>(entity->myBody));
+		entity->SaveInterpolationState();
 		break;
 	default:
 		ASSERT(false);
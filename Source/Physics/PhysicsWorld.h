@@ -1,17 +1,18 @@
 #pragma once
 
 #include <Core/Threading/AssertRWMutex.h>
+#include <Core/CmdBuffer.h>
 
 class PhysicsEntity;
 class btBroadphaseInterface;
 class btDefaultCollisionConfiguration;
 class btCollisionDispatcher;
-class btSequentialImpulseConstraintSolver;
+class btConstraintSolver;
 class btDiscreteDynamicsWorld;
 class btGhostPairCallback;
 class btCollisionObject;
 class DebugDrawer;
-struct PhysicsCommand;
+class PhysicsSnapshot;
 struct PhysicsCommandAddBody;
 struct PhysicsCommandRemoveBody;
 struct PhysicsCommandDeleteBody;
@@ -31,10 +32,24 @@ public:
 		virtual void OnTriggerCallback(const PhysicsEntity& aLeft, const PhysicsEntity& aRight) = 0;
 	};
 
+	enum class Threading : uint8_t
+	{
+		// Everything is simulated on the calling thread
+		Single,
+		// Uses btDiscreteDynamicsWorldMt - narrowphase, island solving
+		// and integration get split across the caller's TBB arena
+		Multi
+	};
+
+	constexpr static int kMaxSteps = 4;
+	constexpr static float kFixedStepLength = 1.f / 30.f;
+
 public:
-	PhysicsWorld();
+	PhysicsWorld(Threading aThreading = Threading::Single);
 	~PhysicsWorld();
 
+	Threading GetThreading() const { return myThreading; }
+
 	// Adds entity to the world - threadsafe
 	void AddEntity(PhysicsEntity* anEntity);
 	// Removes entity from the world - threadsafe
@@ -42,8 +57,34 @@ public:
 	// Deletes entity and cleans up references - threadsafe
 	void DeleteEntity(PhysicsEntity* anEntity);
 
+	// Advances the world in fixed steps of kFixedStepLength, carrying leftover
+	// time over to the next call. Dynamic entities with a controller get
+	// their transforms interpolated between the last 2 steps, so rendering
+	// stays smooth even if the world isn't stepped every frame
 	void Simulate(float aDeltaTime);
 
+	// How far the world is, in [0, 1], between the last 2 steps
+	float GetInterpolationAlpha() const;
+
+	// Limits how much time stepping can take per Simulate call. Under load
+	// the allowed step count goes down, and the time that couldn't be
+	// simulated gets dropped - simulation slows down instead of causing
+	// follow-up spikes. 0 disables the budget, allowing up to kMaxSteps
+	void SetStepTimeBudget(float aSeconds) { myStepTimeBudget = aSeconds; }
+	// How many steps next Simulate call is allowed to make
+	int GetStepBudget() const { return myStepBudget; }
+	// Total simulation time that was dropped due to step budget
+	float GetDroppedTime() const { return myDroppedTime; }
+
+	// Captures transforms, velocities, sleeping states and constraint impulses
+	// of all dynamic entities. Pending commands are not captured
+	void TakeSnapshot(PhysicsSnapshot& aSnapshot) const;
+	// Restores the state captured by TakeSnapshot in place, without recreating
+	// any bodies. Contact caches get flushed, so that stepping after a restore
+	// doesn't depend on state from before it - replays from the same snapshot
+	// are deterministic
+	void RestoreSnapshot(const PhysicsSnapshot& aSnapshot);
+
 	// Makes a raycast and returns the closest hit, if there is one
 	bool RaycastClosest(glm::vec3 aFrom, glm::vec3 aDir, float aDist, PhysicsEntity*& aHitEntity) const;
 	// Makes a raycast and returns the closest hit, if there is one
@@ -55,6 +96,34 @@ public:
 	// Makes a raycast and returns all the hits
 	bool Raycast(glm::vec3 aFrom, glm::vec3 aTo, std::vector<PhysicsEntity*>& anAllHits) const;
 
+	struct RayQuery
+	{
+		glm::vec3 myFrom;
+		glm::vec3 myTo;
+	};
+
+	struct SweepQuery
+	{
+		glm::vec3 myFrom;
+		glm::vec3 myTo;
+		float myRadius;
+	};
+
+	struct QueryHit
+	{
+		PhysicsEntity* myEntity; // null if nothing was hit
+		glm::vec3 myPoint;
+		glm::vec3 myNormal;
+		float myFraction; // [0, 1] along the query, 1 if nothing was hit
+	};
+
+	// Batched versions of RaycastClosest - processes queries in parallel 
+	// and writes the closest hit for each query at the same index in aHits.
+	// Doesn't allocate, but world must not be stepped during the call
+	void RaycastClosest(std::span<const RayQuery> aRays, std::span<QueryHit> aHits) const;
+	// Same as batched RaycastClosest, but sweeps a sphere of myRadius
+	void SweepClosest(std::span<const SweepQuery> aSweeps, std::span<QueryHit> aHits) const;
+
 	// TODO: refactor this away
 	const DebugDrawer& GetDebugDrawer() const;
 
@@ -68,34 +137,62 @@ public:
 	static void EnablePhysicsProfiling();
 
 private:
-	constexpr static int kMaxSteps = 4;
-	constexpr static float kFixedStepLength = 1.f / 30.f;
-
 	std::vector<btCollisionObject*> myTriggers;
 	std::vector<ISymCallbackListener*> myPhysSystems;
 
 	void PrePhysicsStep(float aDeltaTime);
 	void PostPhysicsStep(float aDeltaTime);
+	void SaveInterpolationStates();
+	void ApplyInterpolation();
+	void UpdateStepBudget(float aStepCost);
 
 	btBroadphaseInterface* myBroadphase;
 	btDefaultCollisionConfiguration* myConfiguration;
 	btCollisionDispatcher* myDispatcher;
-	btSequentialImpulseConstraintSolver* mySolver; // for now using default one, should try ODE quickstep solver later 
+	btConstraintSolver* mySolver; // for now using default one, should try ODE quickstep solver later 
 	btDiscreteDynamicsWorld* myWorld;
 	btGhostPairCallback* myGhostCallback;
+	Threading myThreading;
+
+	float myAccumulatedTime = 0;
+	float myDroppedTime = 0;
+	float myStepTimeBudget = 0;
+	float myAvgStepCost = 0;
+	int myStepBudget = kMaxSteps;
 	
-	tbb::spin_mutex myCommandsLock;
 	std::atomic<bool> myIsBeingStepped;
-	// TODO: should probably have per-type reusable command caches, 
-	// so that even it points to heap, it'll be layed out continuously
-	// - should make more cache friendly
-	std::vector<const PhysicsCommand*> myCommands;
+
+	// Commands are written to a thread-local buffer, so enqueueing only
+	// takes an uncontended lock. ResolveCommands swaps out the write
+	// buffers, so threads can keep enqueueing while it's resolving.
+	// Every command is stamped with a global sequence number, so that
+	// ResolveCommands can merge them back in the order they were enqueued
+	struct CommandSlot
+	{
+		constexpr static uint32_t kInitialSize = 4 * 1024;
+
+		tbb::spin_mutex myLock;
+		CmdBuffer myWriteBuffer{ kInitialSize };
+		CmdBuffer myReadBuffer{ kInitialSize };
+		// sequence number of every command in the matching buffer
+		std::vector<uint32_t> myWriteSequences;
+		std::vector<uint32_t> myReadSequences;
+	};
+	tbb::enumerable_thread_specific<CommandSlot> myCommands;
+	std::atomic<uint32_t> myNextCommandSequence = 0;
 
 	void ResolveCommands();
 
 private:
 	friend class PhysicsEntity;
-	void EnqueueCommand(const PhysicsCommand* aCmd);
+	template<CmdType T>
+	void EnqueueCommand(const T& aCmd)
+	{
+		CommandSlot& slot = myCommands.local();
+		tbb::spin_mutex::scoped_lock lock(slot.myLock);
+		slot.myWriteBuffer.Write<T>() = aCmd;
+		slot.myWriteSequences.push_back(myNextCommandSequence.fetch_add(1, std::memory_order_relaxed));
+	}
 	bool IsStepping() const { return myIsBeingStepped; }
 
 #ifdef ASSERT_MUTEX
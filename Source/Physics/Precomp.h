@@ -7,19 +7,29 @@
 #include <unordered_set>
 #include <format>
 #include <chrono>
+#include <span>
+#include <algorithm>
+#include <functional>
 
 #include <btBulletDynamicsCommon.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 #include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <LinearMath/btThreads.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include <tbb/spin_mutex.h>
 #include <tbb/task_scheduler_observer.h>
 #include <tbb/queuing_mutex.h>
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/task_group.h>
+#include <tbb/task_arena.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
 #include <Core/Debug/Assert.h>
 
@@ -0,0 +1,219 @@
+#include "Precomp.h"
+#include "HeadlessRunner.h"
+
+#include <Core/File.h>
+#include <Core/Profiler.h>
+
+#include <charconv>
+#include <format>
+#include <numeric>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+	template<class T>
+	bool ParseValue(std::string_view aText, T& aValue, int aBase = 10)
+	{
+		const char* end = aText.data() + aText.size();
+		std::from_chars_result result;
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			result = std::from_chars(aText.data(), end, aValue);
+		}
+		else
+		{
+			result = std::from_chars(aText.data(), end, aValue, aBase);
+		}
+		return result.ec == std::errc() && result.ptr == end;
+	}
+}
+
+bool HeadlessRunner::IsRequested(std::span<char* const> anArgs)
+{
+	return std::ranges::find(anArgs, std::string_view("--headless")) != anArgs.end();
+}
+
+bool HeadlessRunner::ParseArgs(std::span<char* const> anArgs, Settings& aSettings)
+{
+	for (size_t i = 0; i < anArgs.size(); i++)
+	{
+		const std::string_view arg = anArgs[i];
+		if (arg == "--headless")
+		{
+			continue;
+		}
+		if (arg == "--verify")
+		{
+			aSettings.myVerifyDeterminism = true;
+			continue;
+		}
+
+		if (i + 1 == anArgs.size())
+		{
+			std::println("Missing value for {}", arg);
+			return false;
+		}
+		const std::string_view value = anArgs[++i];
+
+		bool parsed = true;
+		if (arg == "--frames")
+		{
+			parsed = ParseValue(value, aSettings.myFrameCount) && aSettings.myFrameCount > 0;
+		}
+		else if (arg == "--tanks")
+		{
+			parsed = ParseValue(value, aSettings.myTest.myTankCount) && aSettings.myTest.myTankCount > 0;
+		}
+		else if (arg == "--side")
+		{
+			parsed = ParseValue(value, aSettings.myTest.mySpawnSquareSide);
+		}
+		else if (arg == "--seed")
+		{
+			parsed = ParseValue(value, aSettings.myTest.mySeed);
+		}
+		else if (arg == "--dt")
+		{
+			parsed = ParseValue(value, aSettings.myDeltaTime) && aSettings.myDeltaTime > 0;
+		}
+		else if (arg == "--out")
+		{
+			aSettings.myReportPath = value;
+		}
+		else if (arg == "--expect")
+		{
+			uint32_t checksum = 0;
+			const std::string_view hexDigits = value.starts_with("0x") ? value.substr(2) : value;
+			parsed = ParseValue(hexDigits, checksum, 16);
+			aSettings.myExpectedChecksum = checksum;
+		}
+		else
+		{
+			std::println("Unrecognized argument: {}", arg);
+			return false;
+		}
+
+		if (!parsed)
+		{
+			std::println("Invalid value for {}: {}", arg, value);
+			return false;
+		}
+	}
+	return true;
+}
+
+HeadlessRunner::HeadlessRunner(const Settings& aSettings)
+	: mySettings(aSettings)
+{
+	for (std::vector<int64_t>& timings : myTimings)
+	{
+		timings.reserve(mySettings.myFrameCount);
+	}
+}
+
+int HeadlessRunner::Run()
+{
+	StressTest test(mySettings.myTest);
+
+	using Clock = std::chrono::steady_clock;
+	for (uint32_t frame = 0; frame < mySettings.myFrameCount; frame++)
+	{
+		Profiler::GetInstance().NewFrame();
+
+		const Clock::time_point frameStart = Clock::now();
+		test.Simulate(mySettings.myDeltaTime);
+		const Clock::duration frameDuration = Clock::now() - frameStart;
+
+		const StressTest::SystemTimings& timings = test.GetLastTimings();
+		myTimings[System::UpdateTanks].push_back(timings.myUpdateTanks);
+		myTimings[System::UpdateBalls].push_back(timings.myUpdateBalls);
+		myTimings[System::CheckCollisions].push_back(timings.myCheckCollisions);
+		myTimings[System::Frame].push_back(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(frameDuration).count()
+		);
+	}
+
+	const uint32_t checksum = test.CalcChecksum();
+	std::println("StressTest: {} frames, {} tanks and {} balls left, checksum {:#010x}",
+		mySettings.myFrameCount, test.GetTankCount(), test.GetBallCount(), checksum);
+
+	const std::string report = GenerateReport(checksum, test);
+	File file(mySettings.myReportPath);
+	if (!file.Write(report.data(), report.size()))
+	{
+		std::println("StressTest: failed to write report to {}", mySettings.myReportPath);
+		return 1;
+	}
+
+	if (mySettings.myExpectedChecksum && *mySettings.myExpectedChecksum != checksum)
+	{
+		std::println("StressTest: checksum mismatch, expected {:#010x}", *mySettings.myExpectedChecksum);
+		return 1;
+	}
+
+	if (mySettings.myVerifyDeterminism)
+	{
+		const uint32_t rerunChecksum = RerunForChecksum();
+		if (rerunChecksum != checksum)
+		{
+			std::println("StressTest: not deterministic, rerun ended with checksum {:#010x}", rerunChecksum);
+			return 1;
+		}
+		std::println("StressTest: rerun matched the checksum");
+	}
+	return 0;
+}
+
+uint32_t HeadlessRunner::RerunForChecksum() const
+{
+	StressTest test(mySettings.myTest);
+	for (uint32_t frame = 0; frame < mySettings.myFrameCount; frame++)
+	{
+		test.Simulate(mySettings.myDeltaTime);
+	}
+	return test.CalcChecksum();
+}
+
+std::string HeadlessRunner::GenerateReport(uint32_t aChecksum, const StressTest& aTest) const
+{
+	constexpr auto ToMs = [](double aNanoSec) { return aNanoSec / 1'000'000.0; };
+
+	nlohmann::json report;
+	report["settings"] = {
+		{ "frames", mySettings.myFrameCount },
+		{ "dt", mySettings.myDeltaTime },
+		{ "seed", mySettings.myTest.mySeed },
+		{ "tanks", mySettings.myTest.myTankCount },
+		{ "side", mySettings.myTest.mySpawnSquareSide }
+	};
+	report["checksum"] = std::format("{:#010x}", aChecksum);
+	report["finalState"] = {
+		{ "tanks", aTest.GetTankCount() },
+		{ "balls", aTest.GetBallCount() }
+	};
+
+	nlohmann::json& systemsJson = report["systems"];
+	std::vector<int64_t> sorted;
+	for (uint8_t system = 0; system < System::Count; system++)
+	{
+		sorted = myTimings[system];
+		std::sort(sorted.begin(), sorted.end());
+		// nearest-rank percentile
+		auto Percentile = [&sorted, &ToMs](double aRank) {
+			const size_t index = static_cast<size_t>(std::ceil(aRank * sorted.size()));
+			return ToMs(static_cast<double>(sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1]));
+		};
+		const int64_t total = std::accumulate(sorted.begin(), sorted.end(), int64_t(0));
+
+		systemsJson[std::string(kSystemNames[system])] = {
+			{ "avgMs", ToMs(static_cast<double>(total) / sorted.size()) },
+			{ "p50Ms", Percentile(0.5) },
+			{ "p90Ms", Percentile(0.9) },
+			{ "p99Ms", Percentile(0.99) },
+			{ "maxMs", ToMs(static_cast<double>(sorted.back())) }
+		};
+	}
+
+	constexpr int kIndent = 1;
+	return report.dump(kIndent, '\t');
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "StressTest.h"
+
+#include <optional>
+
+// Runs the StressTest without a window, with a fixed timestep and seed,
+// for a fixed amount of frames. Writes out a JSON report with timing
+// percentiles of every system and a checksum of the final state - runs
+// with the same settings must end up with the same checksum.
+// Usage: StressTest --headless [--frames N] [--tanks N] [--side N]
+//	[--seed N] [--dt seconds] [--out report.json] [--expect checksum] [--verify]
+class HeadlessRunner
+{
+public:
+	struct Settings
+	{
+		StressTest::HeadlessSettings myTest;
+		std::string myReportPath = "StressTestReport.json";
+		uint32_t myFrameCount = 1000;
+		float myDeltaTime = 1.f / 60.f;
+		// if set, the run fails when the final checksum doesn't match it
+		std::optional<uint32_t> myExpectedChecksum;
+		// if set, the run gets repeated and fails when the checksums differ
+		bool myVerifyDeterminism = false;
+	};
+
+	// Returns true if aArgs request a headless run
+	static bool IsRequested(std::span<char* const> anArgs);
+	// Returns false if any of the arguments is unrecognized or malformed
+	static bool ParseArgs(std::span<char* const> anArgs, Settings& aSettings);
+
+	HeadlessRunner(const Settings& aSettings);
+
+	// Returns the process exit code
+	int Run();
+
+private:
+	enum System : uint8_t
+	{
+		UpdateTanks,
+		UpdateBalls,
+		CheckCollisions,
+		Frame,
+		Count
+	};
+	constexpr static std::string_view kSystemNames[System::Count] = {
+		"UpdateTanks",
+		"UpdateBalls",
+		"CheckCollisions",
+		"Frame"
+	};
+
+	// Runs the simulation again without collecting timings
+	uint32_t RerunForChecksum() const;
+	std::string GenerateReport(uint32_t aChecksum, const StressTest& aTest) const;
+
+	Settings mySettings;
+	// per-frame durations in nanoseconds, for every system
+	std::vector<int64_t> myTimings[System::Count];
+};
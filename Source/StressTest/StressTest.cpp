@@ -21,8 +21,12 @@
 #include <Core/Resources/AssetTracker.h>
 #include <Core/Debug/DebugDrawer.h>
 #include <Core/Shapes.h>
+#include <Core/CRC32.h>
+
+#include <bit>
 
 StressTest::StressTest(Game& aGame)
+	: myGame(&aGame)
 {
 	std::random_device randDevice;
 	myRandEngine = std::default_random_engine(randDevice());
@@ -31,36 +35,7 @@ StressTest::StressTest(Game& aGame)
 
 	CreateTerrain(aGame, mySpawnSquareSide);
 	CreateGrid(mySpawnSquareSide);
-
-	{
-		OBJImporter importer;
-		constexpr StaticString path = Resource::kAssetsFolder + "Tank/Tank.obj";
-		[[maybe_unused]] bool loadRes = importer.Load(path);
-		ASSERT_STR(loadRes, "Failed to load {}", path);
-		myTankModel = importer.GetModel(0);
-
-		const glm::vec3 aabbMin = myTankModel->GetAABBMin();
-		const glm::vec3 aabbMax = myTankModel->GetAABBMax();
-		const glm::vec3 halfExtents = (aabbMax - aabbMin) / 2.f * kTankScale;
-		myTankShape = std::make_shared<PhysicsShapeBox>(
-			halfExtents
-		);
-	}
-
-	{
-		OBJImporter importer;
-		constexpr StaticString path = Resource::kAssetsFolder + "sphere.obj";
-		[[maybe_unused]] bool loadRes = importer.Load(path);
-		ASSERT_STR(loadRes, "Failed to load {}", path);
-		mySphereModel = importer.GetModel(0);
-
-		const glm::vec3 aabbMin = mySphereModel->GetAABBMin();
-		const glm::vec3 aabbMax = mySphereModel->GetAABBMax();
-		const glm::vec3 halfExtents = (aabbMax - aabbMin) / 2.f * kBallScale;
-		myBallShape = std::make_shared<PhysicsShapeSphere>(
-			halfExtents.x
-		);
-	}
+	LoadShapes();
 
 	{
 		myGreyTexture = new Texture();
@@ -84,6 +59,19 @@ StressTest::StressTest(Game& aGame)
 	light.myTransform.LookAt({ 0, -10, 0 });
 }
 
+StressTest::StressTest(const HeadlessSettings& aSettings)
+	: myRandEngine(aSettings.mySeed)
+{
+	mySpawnSquareSide = std::bit_ceil(glm::max(aSettings.mySpawnSquareSide, 4u));
+	myTankLimit = aSettings.myTankCount;
+	// replenish the whole army within a second
+	mySpawnRate = static_cast<float>(aSettings.myTankCount);
+
+	myHeadlessTerrain.reset(GenerateTerrain(mySpawnSquareSide));
+	CreateGrid(mySpawnSquareSide);
+	LoadShapes();
+}
+
 StressTest::~StressTest()
 {
 	delete myGrid;
@@ -116,9 +104,57 @@ void StressTest::Update(Game& aGame, float aDeltaTime)
 	}
 
 	UpdateCamera(*aGame.GetCamera(), aDeltaTime);
-	UpdateTanks(aGame, aDeltaTime);
-	UpdateBalls(aGame, aDeltaTime);
-	CheckCollisions(aGame);
+	Simulate(aDeltaTime);
+}
+
+void StressTest::Simulate(float aDeltaTime)
+{
+	using Clock = std::chrono::steady_clock;
+	auto ElapsedSince = [](Clock::time_point aStart) {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - aStart).count();
+	};
+
+	Clock::time_point start = Clock::now();
+	UpdateTanks(aDeltaTime);
+	myLastTimings.myUpdateTanks = ElapsedSince(start);
+
+	start = Clock::now();
+	UpdateBalls(aDeltaTime);
+	myLastTimings.myUpdateBalls = ElapsedSince(start);
+
+	start = Clock::now();
+	CheckCollisions();
+	myLastTimings.myCheckCollisions = ElapsedSince(start);
+}
+
+uint32_t StressTest::CalcChecksum() const
+{
+	std::vector<char> state;
+	auto Append = [&state](const auto& aValue) {
+		const char* bytes = reinterpret_cast<const char*>(&aValue);
+		state.insert(state.end(), bytes, bytes + sizeof(aValue));
+	};
+
+	Append(myTanks.GetCount());
+	myTanks.ForEach([&](const Tank& aTank) {
+		Append(aTank.myTransf.GetPos());
+		Append(aTank.myDest);
+		Append(aTank.myCooldown);
+		Append(aTank.myTeam);
+	});
+	Append(myBalls.GetCount());
+	myBalls.ForEach([&](const Ball& aBall) {
+		Append(aBall.myTransf.GetPos());
+		Append(aBall.myVel);
+		Append(aBall.myLife);
+		Append(aBall.myTeam);
+	});
+	return Utils::CRC32(state.data(), state.size());
+}
+
+const Terrain& StressTest::GetTerrain() const
+{
+	return myGame ? *myGame->GetTerrain(0) : *myHeadlessTerrain;
 }
 
 void StressTest::DrawUI(Game& aGame, float aDeltaTime)
@@ -130,6 +166,7 @@ void StressTest::DrawUI(Game& aGame, float aDeltaTime)
 		myWipeEverything = ImGui::InputScalar("Spawn Square Side", ImGuiDataType_U32, &mySpawnSquareSide);
 		mySpawnSquareSide = glm::max(mySpawnSquareSide, 3u);
 		ImGui::InputFloat("Tank Speed", &myTankSpeed);
+		ImGui::InputScalar("Tank Limit", ImGuiDataType_U32, &myTankLimit);
 		ImGui::Text("Tanks alive: %llu", myTanks.GetCount());
 		ImGui::Checkbox("Draw Shapes", &myDrawShapes);
 		ImGui::Checkbox("Control Camera", &myControlCamera);
@@ -153,13 +190,17 @@ void StressTest::DrawUI(Game& aGame, float aDeltaTime)
 	ImGui::End();
 }
 
-void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
+void StressTest::UpdateTanks(float aDeltaTime)
 {
 	const float halfHeight = myTankShape->GetHalfExtents().y;
-	const Terrain& terrain = *aGame.GetTerrain(0);
+	const Terrain& terrain = GetTerrain();
 	const glm::vec2 halfTerrainSize{ terrain.GetWidth() / 2.f };
 
 	myTankAccum += mySpawnRate * aDeltaTime;
+	if (myTankLimit > 0)
+	{
+		myTankAccum = glm::min(myTankAccum, static_cast<float>(myTankLimit));
+	}
 	if (myTankAccum >= myTanks.GetCount() + 1)
 	{
 		Profiler::ScopedMark scope("SpawnTanks");
@@ -178,6 +219,7 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 
 			tank.myTeam = myTankSwitch;
 			tank.myCooldown = myShootCD;
+			tank.myIsAlive = true;
 
 			const float xSpawn = (mySpawnSquareSide - 1) / 2.f * (tank.myTeam ? 1 : -1);
 			const float zSpawn = filter(myRandEngine);
@@ -196,13 +238,18 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 			tankTransf.LookAt(tank.myDest);
 			const glm::quat rot(tankTransf.GetUp(), terrain.GetNormal(terrainPos));
 			tankTransf.SetRotation(rot * tankTransf.GetRotation());
+			tank.myTransf = tankTransf;
 
-			tank.myGO = new GameObject(tankTransf);
-			VisualComponent* visualComp = tank.myGO->AddComponent<VisualComponent>();
-			visualComp->SetModel(myTankModel);
-			visualComp->SetTextureCount(1);
-			visualComp->SetTexture(0, tank.myTeam ? myGreenTankTexture : myRedTankTexture);
-			visualComp->SetPipeline(myDefaultPipeline);
+			if (myGame)
+			{
+				tank.myGO = new GameObject(tankTransf);
+				VisualComponent* visualComp = tank.myGO->AddComponent<VisualComponent>();
+				visualComp->SetModel(myTankModel);
+				visualComp->SetTextureCount(1);
+				visualComp->SetTexture(0, tank.myTeam ? myGreenTankTexture : myRedTankTexture);
+				visualComp->SetPipeline(myDefaultPipeline);
+				myGame->AddGameObject(tank.myGO);
+			}
 
 			tankTransf.SetScale({ 1, 1, 1 }); // tank has already scaled collider
 			Shapes::AABB bounds = myTankShape->GetAABB(tankTransf.GetMatrix());
@@ -211,8 +258,6 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 				{ bounds.myMax.x, bounds.myMax.z },
 				{ &tank, true }
 			);
-
-			aGame.AddGameObject(tank.myGO);
 		}
 	}
 
@@ -222,7 +267,7 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 		size_t removed = 0;
 		myTanks.ForEach([&](Tank& aTank)
 		{
-			Transform transf = aTank.myGO->GetWorldTransform();
+			Transform transf = aTank.myTransf;
 			Transform unscaled = transf;
 			unscaled.SetScale({ 1, 1, 1 });
 
@@ -234,7 +279,10 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 
 			if (sqrlength <= 1.f)
 			{
-				aGame.RemoveGameObject(aTank.myGO);
+				if (myGame)
+				{
+					myGame->RemoveGameObject(aTank.myGO);
+				}
 
 				myGrid->Remove(
 					{ origTankAABB.myMin.x, origTankAABB.myMin.z },
@@ -258,16 +306,20 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 			const glm::quat rot(transf.GetUp(), terrain.GetNormal(terrainPos));
 			transf.SetRotation(rot * transf.GetRotation());
 			
-			aTank.myGO->SetWorldTransform(transf);
+			aTank.myTransf = transf;
+			if (aTank.myGO.IsValid())
+			{
+				aTank.myGO->SetWorldTransform(transf);
+			}
 
 			transf.SetScale({ 1, 1, 1 });
 			const Shapes::AABB newTankAABB = myTankShape->GetAABB(transf.GetMatrix());
-			if (myDrawShapes)
+			if (myGame && myDrawShapes)
 			{
 				const float halfHeight = myTankShape->GetHalfExtents().y;
 				const glm::vec3 tankMin = newTankAABB.myMin + glm::vec3{ 0, halfHeight, 0 };
 				const glm::vec3 tankMax = newTankAABB.myMax + glm::vec3{ 0, halfHeight, 0 };
-				aGame.GetDebugDrawer().AddAABB(tankMin, tankMax, { 0, 1, 0 });
+				myGame->GetDebugDrawer().AddAABB(tankMin, tankMax, { 0, 1, 0 });
 			}
 			myGrid->Move(
 				{ origTankAABB.myMin.x, origTankAABB.myMin.z },
@@ -292,17 +344,23 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 				Ball& ball = myBalls.Allocate();
 				ball.myLife = myShotLife;
 				ball.myTeam = aTank.myTeam;
+				ball.myIsAlive = true;
+				ball.myTransf = ballTransf;
 
 				glm::vec3 initVelocity = transf.GetForward();
 				initVelocity.y += 0.5f;
 				ball.myVel = glm::normalize(initVelocity) * myShotSpeed;
 
-				ball.myGO = new GameObject(ballTransf);
-				VisualComponent* visualComp = ball.myGO->AddComponent<VisualComponent>();
-				visualComp->SetModel(mySphereModel);
-				visualComp->SetTextureCount(1);
-				visualComp->SetTexture(0, myGreyTexture);
-				visualComp->SetPipeline(myDefaultPipeline);
+				if (myGame)
+				{
+					ball.myGO = new GameObject(ballTransf);
+					VisualComponent* visualComp = ball.myGO->AddComponent<VisualComponent>();
+					visualComp->SetModel(mySphereModel);
+					visualComp->SetTextureCount(1);
+					visualComp->SetTexture(0, myGreyTexture);
+					visualComp->SetPipeline(myDefaultPipeline);
+					myGame->AddGameObject(ball.myGO);
+				}
 
 				ballTransf.SetScale({ 1, 1, 1 });
 				Shapes::AABB ballAABB = myBallShape->GetAABB(ballTransf.GetMatrix());
@@ -311,26 +369,24 @@ void StressTest::UpdateTanks(Game& aGame, float aDeltaTime)
 					{ ballAABB.myMax.x, ballAABB.myMax.z },
 					{ &ball, false }
 				);
-				aGame.AddGameObject(ball.myGO);
-
 			}
 		});
 		myTankAccum -= removed;	
 	}
 }
 
-void StressTest::UpdateBalls(Game& aGame, float aDeltaTime)
+void StressTest::UpdateBalls(float aDeltaTime)
 {
 	const float ballRadius = myBallShape->GetRadius();
-	const Terrain& terrain = *aGame.GetTerrain(0);
+	const Terrain& terrain = GetTerrain();
 	const glm::vec2 halfTerrainSize{ terrain.GetWidth() / 2.f };
 
 	{
 		Profiler::ScopedMark scope("MoveBalls");
 		constexpr static float kGravity = 9.8f;
-		myBalls.ForEach([aDeltaTime, &aGame, halfTerrainSize, &terrain, ballRadius, this](Ball& aBall)
+		myBalls.ForEach([aDeltaTime, halfTerrainSize, &terrain, ballRadius, this](Ball& aBall)
 		{
-			Transform transf = aBall.myGO->GetWorldTransform();
+			Transform transf = aBall.myTransf;
 			Transform unscaled = transf;
 			unscaled.SetScale({ 1, 1, 1 });
 			Shapes::AABB originalAABB = myBallShape->GetAABB(transf.GetMatrix());
@@ -344,7 +400,10 @@ void StressTest::UpdateBalls(Game& aGame, float aDeltaTime)
 					{ &aBall, false }
 				);
 
-				aGame.RemoveGameObject(aBall.myGO);
+				if (myGame)
+				{
+					myGame->RemoveGameObject(aBall.myGO);
+				}
 				aBall.myGO = Handle<GameObject>();
 				myBalls.Free(aBall);
 				return;
@@ -367,19 +426,26 @@ void StressTest::UpdateBalls(Game& aGame, float aDeltaTime)
 					{ &aBall, false }
 				);
 
-				aGame.RemoveGameObject(aBall.myGO);
+				if (myGame)
+				{
+					myGame->RemoveGameObject(aBall.myGO);
+				}
 				aBall.myGO = Handle<GameObject>();
 				myBalls.Free(aBall);
 				return;
 			}
 
-			aBall.myGO->SetWorldTransform(transf);
+			aBall.myTransf = transf;
+			if (aBall.myGO.IsValid())
+			{
+				aBall.myGO->SetWorldTransform(transf);
+			}
 
 			transf.SetScale({ 1, 1, 1 });
 			Shapes::AABB newAABB = myBallShape->GetAABB(transf.GetMatrix());
-			if (myDrawShapes)
+			if (myGame && myDrawShapes)
 			{
-				aGame.GetDebugDrawer().AddAABB(newAABB.myMin, newAABB.myMax, { 1, 0, 0 });
+				myGame->GetDebugDrawer().AddAABB(newAABB.myMin, newAABB.myMax, { 1, 0, 0 });
 			}
 			myGrid->Move(
 				{ originalAABB.myMin.x, originalAABB.myMin.z },
@@ -481,10 +547,55 @@ void StressTest::UpdateCamera(Camera& aCam, float aDeltaTime)
 	}
 }
 
-void StressTest::CheckCollisions(Game& aGame)
+void StressTest::CheckCollisions()
 {
 	Profiler::ScopedMark scope("CheckCollisions");
-	uint16_t tanksRemoved = 0;
+	uint32_t tanksRemoved = 0;
+
+	// freshly spawned GameObjects can only collide once they've been added to the world
+	auto CanCollide = [](const auto& anEntity) {
+		return anEntity.myIsAlive && (!anEntity.myGO.IsValid() || anEntity.myGO->GetWorld());
+	};
+
+	// Cells are independent, so overlapping pairs get gathered in parallel
+	// without modifying anything. Pairs come sorted in cell order and get
+	// resolved serially, which keeps the result the same regardless of
+	// thread count or scheduling
+	using Overlaps = GridOverlaps<TankOrBall>;
+	const float halfHeight = myTankShape->GetHalfExtents().y;
+	auto GetBounds = [&](const TankOrBall& anEntry, Overlaps::Bounds& aBounds)
+	{
+		Shapes::AABB aabb;
+		if (anEntry.myIsTank)
+		{
+			const Tank& tank = *static_cast<const Tank*>(anEntry.myPtr);
+			if (!CanCollide(tank))
+			{
+				return Overlaps::Kind::Skip;
+			}
+			Transform tankTransf = tank.myTransf;
+			tankTransf.SetScale({ 1, 1, 1 });
+			tankTransf.Translate({ 0, halfHeight, 0 });
+			aabb = myTankShape->GetAABB(tankTransf.GetMatrix());
+			aBounds.myGroup = tank.myTeam;
+		}
+		else
+		{
+			const Ball& ball = *static_cast<const Ball*>(anEntry.myPtr);
+			if (!CanCollide(ball))
+			{
+				return Overlaps::Kind::Skip;
+			}
+			Transform ballTransf = ball.myTransf;
+			ballTransf.SetScale({ 1, 1, 1 });
+			aabb = myBallShape->GetAABB(ballTransf.GetMatrix());
+			aBounds.myGroup = ball.myTeam;
+		}
+		aBounds.myMin = aabb.myMin;
+		aBounds.myMax = aabb.myMax;
+		return anEntry.myIsTank ? Overlaps::Kind::Second : Overlaps::Kind::First;
+	};
+	const std::span<const Overlaps::Pair> pairs = myOverlaps.Gather(*myGrid, GetBounds);
 
 	struct ToRemove
 	{
@@ -494,76 +605,40 @@ void StressTest::CheckCollisions(Game& aGame)
 	};
 	std::vector<ToRemove> removeQueue;
 	removeQueue.reserve(512);
-
-	const float halfHeight = myTankShape->GetHalfExtents().y;
-	myGrid->ForEachCell([this, halfHeight, &removeQueue, &aGame](std::vector<TankOrBall>& aCell) 
 	{
-		if (aCell.size() <= 2)
-		{
-			return; // nothing to do
-		}
-		for (uint32_t ballInd = 0; ballInd < aCell.size() - 1; ballInd++)
+		Profiler::ScopedMark scope("ResolveHits");
+		auto GetRect = [](const Overlaps::Bounds& aBounds) {
+			return Shapes::Rect{ { aBounds.myMin.x, aBounds.myMin.z }, { aBounds.myMax.x, aBounds.myMax.z } };
+		};
+
+		// first pair of still alive ball and tank wins,
+		// same as if the cells got walked one by one
+		for (const Overlaps::Pair& pair : pairs)
 		{
-			if (aCell[ballInd].myIsTank)
-			{
-				continue;
-			}
-			Ball* ball = static_cast<Ball*>(aCell[ballInd].myPtr);
-			if (!ball->myGO.IsValid() || !ball->myGO->GetWorld())
+			Ball& ball = *static_cast<Ball*>(pair.myFirst.myItem.myPtr);
+			Tank& tank = *static_cast<Tank*>(pair.mySecond.myItem.myPtr);
+			if (!ball.myIsAlive || !tank.myIsAlive)
 			{
 				continue;
 			}
 
-			Transform ballTransf = ball->myGO->GetWorldTransform();
-			ballTransf.SetScale({ 1, 1, 1 });
-			Shapes::AABB ballAABB = myBallShape->GetAABB(ballTransf.GetMatrix());
-			for (uint32_t tankInd = ballInd + 1; tankInd < aCell.size(); tankInd++)
-			{
-				if (!aCell[tankInd].myIsTank)
-				{
-					continue;
-				}
-				Tank* tank = static_cast<Tank*>(aCell[tankInd].myPtr);
-				if (!tank->myGO.IsValid() || !tank->myGO->GetWorld())
-				{
-					continue;
-				}
+			removeQueue.push_back({ GetRect(pair.mySecond), &tank, true });
+			removeQueue.push_back({ GetRect(pair.myFirst), &ball, false });
 
-				if (ball->myTeam == tank->myTeam)
-				{
-					continue;
-				}
-
-				Transform tankTransf = tank->myGO->GetWorldTransform();
-				tankTransf.SetScale({ 1, 1, 1 });
-				tankTransf.Translate({ 0, halfHeight, 0 });
-				Shapes::AABB tankAABB = myTankShape->GetAABB(tankTransf.GetMatrix());
-
-				// coarse check
-				if (Shapes::Intersects(ballAABB, tankAABB))
-				{
-					// found it - schedule removal
-					const glm::vec2 tankMin{ tankAABB.myMin.x, tankAABB.myMin.z };
-					const glm::vec2 tankMax{ tankAABB.myMax.x, tankAABB.myMax.z };
-					removeQueue.push_back({ { tankMin, tankMax }, tank, true });
-					const glm::vec2 ballMin{ ballAABB.myMin.x, ballAABB.myMin.z };
-					const glm::vec2 ballMax{ ballAABB.myMax.x, ballAABB.myMax.z };
-					removeQueue.push_back({ { ballMin, ballMax }, ball, false });
-
-					// remove from world
-					aGame.RemoveGameObject(tank->myGO);
-					aGame.RemoveGameObject(ball->myGO);
-
-					// also mark they're dead
-					tank->myGO = {};
-					ball->myGO = {};
-
-					// this ball got consumed, so go for next one
-					break;
-				}
+			// remove from world
+			if (myGame)
+			{
+				myGame->RemoveGameObject(tank.myGO);
+				myGame->RemoveGameObject(ball.myGO);
 			}
+
+			// also mark they're dead
+			tank.myGO = {};
+			tank.myIsAlive = false;
+			ball.myGO = {};
+			ball.myIsAlive = false;
 		}
-	});
+	}
 
 	{
 		Profiler::ScopedMark scope("RemoveObjects");
@@ -615,7 +690,48 @@ void StressTest::CreateGrid(uint32_t aSize)
 	myGrid = new Grid<TankOrBall>(glm::vec2{ aSize / -2.f }, static_cast<float>(aSize), cellCount);
 }
 
+void StressTest::LoadShapes()
+{
+	{
+		OBJImporter importer;
+		constexpr StaticString path = Resource::kAssetsFolder + "Tank/Tank.obj";
+		[[maybe_unused]] bool loadRes = importer.Load(path);
+		ASSERT_STR(loadRes, "Failed to load {}", path);
+		myTankModel = importer.GetModel(0);
+
+		const glm::vec3 aabbMin = myTankModel->GetAABBMin();
+		const glm::vec3 aabbMax = myTankModel->GetAABBMax();
+		const glm::vec3 halfExtents = (aabbMax - aabbMin) / 2.f * kTankScale;
+		myTankShape = std::make_shared<PhysicsShapeBox>(
+			halfExtents
+		);
+	}
+
+	{
+		OBJImporter importer;
+		constexpr StaticString path = Resource::kAssetsFolder + "sphere.obj";
+		[[maybe_unused]] bool loadRes = importer.Load(path);
+		ASSERT_STR(loadRes, "Failed to load {}", path);
+		mySphereModel = importer.GetModel(0);
+
+		const glm::vec3 aabbMin = mySphereModel->GetAABBMin();
+		const glm::vec3 aabbMax = mySphereModel->GetAABBMax();
+		const glm::vec3 halfExtents = (aabbMax - aabbMin) / 2.f * kBallScale;
+		myBallShape = std::make_shared<PhysicsShapeSphere>(
+			halfExtents.x
+		);
+	}
+}
+
 void StressTest::CreateTerrain(Game& aGame, uint32_t aSize)
+{
+	Terrain* terrain = GenerateTerrain(aSize);
+	AssetTracker& assetTracker = aGame.GetAssetTracker();
+	Handle<Pipeline> terrainPipeline = assetTracker.GetOrCreate<Pipeline>("TestTerrain/terrain.ppl");
+	aGame.AddTerrain(terrain, terrainPipeline);
+}
+
+Terrain* StressTest::GenerateTerrain(uint32_t aSize)
 {
 	Terrain* terrain = new Terrain();
 	const float power = glm::log2(static_cast<float>(aSize));
@@ -628,8 +744,5 @@ void StressTest::CreateTerrain(Game& aGame, uint32_t aSize)
 	terrain->PushHeightLevelColor(yScale / 3, { 0.125f, 0.5f, 0 });
 	terrain->PushHeightLevelColor(2 * yScale / 3, { 0.3f, 1, 0 });
 	terrain->PushHeightLevelColor(yScale, { 0.5f, 0.5f, 0.5f });
-
-	AssetTracker& assetTracker = aGame.GetAssetTracker();
-	Handle<Pipeline> terrainPipeline = assetTracker.GetOrCreate<Pipeline>("TestTerrain/terrain.ppl");
-	aGame.AddTerrain(terrain, terrainPipeline);
+	return terrain;
 }
\ No newline at end of file
@@ -3,30 +3,71 @@
 #include <Core/RefCounted.h>
 #include <Core/Pool.h>
 #include <Core/StableVector.h>
+#include <Core/Transform.h>
+#include <Core/Shapes.h>
+#include <Core/GridOverlaps.h>
 
 class Game;
 class GameObject;
-template<class T> class Grid;
 class Model;
 class Pipeline;
 class Texture;
 class Camera;
 class PhysicsShapeBox;
 class PhysicsShapeSphere;
+class Terrain;
 struct Light;
 
 // Sets up and runs the Tank stress test:
 // a "wall" of tanks descends towards the middle,
 // shooting each other.
+// Can also run headless - without a Game, GameObjects or any rendering
+// resources - for deterministic benchmarking, see HeadlessRunner
 class StressTest
 {
 public:
+	struct HeadlessSettings
+	{
+		uint32_t mySeed = 0;
+		// how many tanks can be alive at the same time
+		uint32_t myTankCount = 1000;
+		// gets rounded up to power of 2, to match the terrain
+		uint32_t mySpawnSquareSide = 256;
+	};
+
+	// Per-system durations of the last Simulate call, in nanoseconds
+	struct SystemTimings
+	{
+		int64_t myUpdateTanks = 0;
+		int64_t myUpdateBalls = 0;
+		int64_t myCheckCollisions = 0;
+	};
+
 	StressTest(Game& aGame);
+	StressTest(const HeadlessSettings& aSettings);
 	~StressTest();
 
 	void Update(Game& aGame, float aDeltaTime);
+	// Advances tanks and balls by aDeltaTime, without touching UI or camera.
+	// Given the same seed and the same deltas, it's fully deterministic
+	void Simulate(float aDeltaTime);
+
+	const SystemTimings& GetLastTimings() const { return myLastTimings; }
+	size_t GetTankCount() const { return myTanks.GetCount(); }
+	size_t GetBallCount() const { return myBalls.GetCount(); }
+	// CRC of positions and teams of everything alive, for verifying determinism.
+	// Only comparable between runs of the same binary - floats aren't
+	// guaranteed to match bit for bit across compilers and platforms
+	uint32_t CalcChecksum() const;
 
 private:
+	// null when running headless
+	Game* myGame = nullptr;
+	// only used when running headless, otherwise the Game owns the terrain
+	std::unique_ptr<Terrain> myHeadlessTerrain;
+	const Terrain& GetTerrain() const;
+	SystemTimings myLastTimings;
+
 	Handle<Texture> myGreenTankTexture;
 	Handle<Texture> myRedTankTexture;
 	Handle<Texture> myGreyTexture;
@@ -36,6 +77,8 @@ private:
 
 	float mySpawnRate = 10.f;
 	uint32_t mySpawnSquareSide = 64;
+	// 0 means no limit
+	uint32_t myTankLimit = 0;
 	float myTankSpeed = 5.f;
 	float myShootCD = 2.f;
 	float myShotLife = 10.f;
@@ -51,13 +94,15 @@ private:
 
 	constexpr static float kTankScale = 0.01f;
 	float myTankAccum = 0.f;
-	bool myTankSwitch;
+	bool myTankSwitch = false;
 	struct Tank
 	{
-		Handle<GameObject> myGO;
+		Handle<GameObject> myGO; // invalid when running headless
+		Transform myTransf;
 		glm::vec3 myDest;
 		float myCooldown;
 		bool myTeam;
+		bool myIsAlive;
 	};
 	StableVector<Tank, 1024> myTanks;
 	std::shared_ptr<PhysicsShapeBox> myTankShape;
@@ -73,19 +118,21 @@ private:
 	};
 	Grid<TankOrBall>* myGrid = nullptr;
 
-	void UpdateTanks(Game& aGame, float aDeltaTime);
+	void UpdateTanks(float aDeltaTime);
 
 	constexpr static float kBallScale = 0.2f;
 	struct Ball
 	{
-		Handle<GameObject> myGO;
+		Handle<GameObject> myGO; // invalid when running headless
+		Transform myTransf;
 		glm::vec3 myVel;
 		float myLife;
 		bool myTeam;
+		bool myIsAlive;
 	};
 	StableVector<Ball, 1024> myBalls;
 	std::shared_ptr<PhysicsShapeSphere> myBallShape;
-	void UpdateBalls(Game& aGame, float aDeltaTime);
+	void UpdateBalls(float aDeltaTime);
 
 	float myRotationAngle = 0.f;
 	float myFlightSpeed = 16.f;
@@ -94,8 +141,12 @@ private:
 
 	PoolPtr<Light> myLight;
 
-	void CheckCollisions(Game& aGame);
+	// balls are first, tanks are second
+	GridOverlaps<TankOrBall> myOverlaps;
+	void CheckCollisions();
 	void WipeEverything(Game& aGame);
+	void LoadShapes();
 	void CreateGrid(uint32_t aSize);
 	void CreateTerrain(Game& aGame, uint32_t aSize);
+	static Terrain* GenerateTerrain(uint32_t aSize);
 };
\ No newline at end of file
@@ -1,16 +1,53 @@
 #include "Precomp.h"
 
 #include "StressTest.h"
+#include "HeadlessRunner.h"
 
 #include <Engine/Game.h>
 
+#include <charconv>
+
 void glfwErrorReporter(int code, const char* desc)
 {
 	std::println("GLFW error({}): {}", code, desc);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+	const std::span<char* const> args(argv + 1, static_cast<size_t>(argc - 1));
+	if (HeadlessRunner::IsRequested(args))
+	{
+		HeadlessRunner::Settings settings;
+		if (!HeadlessRunner::ParseArgs(args, settings))
+		{
+			return 1;
+		}
+		return HeadlessRunner(settings).Run();
+	}
+
+	// Usage: StressTest [--trace-frames N] [--trace-out report.json]
+	uint32_t traceFrames = 0;
+	std::string_view traceReportPath = "TaskTrace.json";
+	for (size_t i = 0; i + 1 < args.size(); i += 2)
+	{
+		const std::string_view arg = args[i];
+		const std::string_view value = args[i + 1];
+		if (arg == "--trace-frames")
+		{
+			const char* end = value.data() + value.size();
+			const std::from_chars_result result = std::from_chars(value.data(), end, traceFrames);
+			if (result.ec != std::errc() || result.ptr != end || traceFrames == 0)
+			{
+				std::println("Invalid value for {}: {}", arg, value);
+				return 1;
+			}
+		}
+		else if (arg == "--trace-out")
+		{
+			traceReportPath = value;
+		}
+	}
+
 	// TODO: get rid of this and all rand() calls
 	srand(static_cast<uint32_t>(time(0)));
 
@@ -35,6 +72,11 @@ int main()
 	taskManager.GetTask(Game::Tasks::UpdateEnd).AddDependency(kTestUpdateTask);
 	taskManager.GetTask(Game::Tasks::RemoveGameObjects).AddDependency(kTestUpdateTask);
 
+	if (traceFrames > 0)
+	{
+		game->RequestTaskTrace(traceFrames, traceReportPath);
+	}
+
 	game->Run();
 	
 	delete testScenario;
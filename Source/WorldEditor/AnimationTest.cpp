@@ -11,6 +11,7 @@
 #include <Engine/Animation/AnimationClip.h>
 #include <Engine/Resources/GLTFImporter.h>
 #include <Engine/Animation/SkinnedVerts.h>
+#include <Engine/Animation/CPUSkinning.h>
 
 AnimationTest::AnimationTest(Game& aGame)
 	: myGame(aGame)
@@ -50,13 +51,20 @@ AnimationTest::AnimationTest(Game& aGame)
 	VisualObject& vo = go->GetRenderable()->myVO;
 	vo.SetPipeline(skinnedPipeline);
 	vo.SetTexture(wireframeTexture);
-	vo.SetModel(GenerateModel(*skeleton));
+	myModel = GenerateModel(*skeleton);
+	vo.SetModel(myModel);
 }
 
 void AnimationTest::Update(float aDeltaTime)
 {
 	DebugDrawer& drawer = myGame.GetDebugDrawer();
-	myGO->GetSkeleton().Get()->DebugDraw(drawer, { glm::vec3(0), glm::vec3(0), glm::vec3(1) });
+	const Skeleton& skeleton = *myGO->GetSkeleton().Get();
+	skeleton.DebugDraw(drawer, { glm::vec3(0), glm::vec3(0), glm::vec3(1) });
+
+	// keep culling bounds in sync with the animated pose
+	const Shapes::AABB bounds = CPUSkinning::CalcAABB(*myModel.Get(), skeleton);
+	myGO->GetRenderable()->myVO.SetLocalBounds(bounds);
+	drawer.AddAABB(bounds.myMin, bounds.myMax, glm::vec3(1, 1, 0));
 }
 
 Handle<Model> AnimationTest::GenerateModel(const Skeleton& aSkeleton)
@@ -21,4 +21,5 @@ private:
 	Game& myGame;
 	Handle<GameObject> myGO;
 	Handle<AnimationClip> myClip;
+	Handle<Model> myModel;
 };
\ No newline at end of file
@@ -23,6 +23,7 @@
 #include <Core/Resources/AssetTracker.h>
 #include <Core/Utils.h>
 #include <Core/File.h>
+#include <Core/Shapes.h>
 
 #include <Graphics/Camera.h>
 #include <Graphics/Resources/Model.h>
@@ -128,6 +129,9 @@ void EditorMode::Update(Game& aGame, float aDeltaTime)
 
 	if (myNavMesh)
 	{
+		// obstacles changed by the menu last frame are in the World by now
+		myNavMesh->ApplyRebuild();
+		myNavMesh->StartRebuild(&aGame.GetAssetTracker());
 		myNavMesh->DebugDraw(debugDrawer);
 	}
 }
@@ -434,6 +438,7 @@ void EditorMode::DrawMenu(Game& aGame)
 				ImGui::Checkbox("Render Voxel Regions", &myDrawRegions);
 				ImGui::Checkbox("Render Corner Points", &myDrawCornerPoints);
 				ImGui::Checkbox("Render Contours", &myDrawContours);
+				ImGui::Checkbox("Render Nav Graph", &myDrawNavGraph);
 
 				aGame.GetDebugDrawer().AddAABB(
 					myNavMeshOrigin - myNavMeshExtents,
@@ -454,16 +459,38 @@ void EditorMode::DrawMenu(Game& aGame)
 						myNavMeshOrigin + myNavMeshExtents
 					};
 					NavMeshGen::Settings settings{ 
-						glm::degrees(myMaxSlope),
-						0,
-						myDrawGenAABB,
-						myDebugTriangles,
-						myRenderVoxels,
-						myDrawRegions,
-						myDrawCornerPoints,
-						myDrawContours
+						.myMaxSlope = glm::degrees(myMaxSlope),
+						.myMinFreeHeight = 0,
+						.myDrawGenAABB = myDrawGenAABB,
+						.myDrawValidTriangleChecks = myDebugTriangles,
+						.myDrawGeneratedSpans = myRenderVoxels,
+						.myDrawRegions = myDrawRegions,
+						.myDrawCornerPoints = myDrawCornerPoints,
+						.myDrawContours = myDrawContours,
+						.myDrawNavGraph = myDrawNavGraph
 					};
-					myNavMesh->Generate(input, settings, aGame);
+					myNavMesh->Generate(input, settings, &aGame.GetAssetTracker());
+				}
+
+				if (myNavMesh)
+				{
+					ImGui::DragFloat3("Obstacle Pos", glm::value_ptr(myNavObstaclePos));
+					if (ImGui::Button("Add Obstacle"))
+					{
+						Transform transf;
+						transf.SetPos(myNavObstaclePos);
+						Handle<GameObject> go = CreateGOWithMesh(aGame, myDefAssets.GetBox(), transf);
+						MarkNavObstacleDirty(*go.Get());
+						myNavObstacles.push_back(go);
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Remove Obstacle") && !myNavObstacles.empty())
+					{
+						MarkNavObstacleDirty(*myNavObstacles.back().Get());
+						aGame.RemoveGameObject(myNavObstacles.back());
+						myNavObstacles.pop_back();
+					}
+					ImGui::Text("%s", myNavMesh->IsRebuilding() ? "Rebuilding tiles..." : "Up to date");
 				}
 
 				ImGui::EndTabItem();
@@ -496,6 +523,14 @@ Handle<GameObject> EditorMode::CreateGOWithMesh(Game& aGame, Handle<Model> aMode
 	return go;
 }
 
+void EditorMode::MarkNavObstacleDirty(const GameObject& aGO)
+{
+	const Handle<Model> box = myDefAssets.GetBox();
+	const Shapes::AABB boxAABB{ box->GetAABBMin(), box->GetAABBMax() };
+	const Shapes::AABB worldAABB = boxAABB.Transform(aGO.GetWorldTransform());
+	myNavMesh->MarkDirty(worldAABB.myMin, worldAABB.myMax);
+}
+
 void EditorMode::CreateMesh(Game& aGame, const Transform& aTransf)
 {
 	myMenuFunction = [&, this](Game& aGame) {
@@ -67,6 +67,11 @@ private:
 	bool myDrawRegions = false;
 	bool myDrawCornerPoints = false;
 	bool myDrawContours = false;
+	bool myDrawNavGraph = false;
+	// boxes to try out incremental navmesh rebuilds with
+	glm::vec3 myNavObstaclePos{ 0, 0.5f, -2.f };
+	std::vector<Handle<GameObject>> myNavObstacles;
+	void MarkNavObstacleDirty(const GameObject& aGO);
 	
 	// Object Picking
 	void UpdatePickedObject(Game& aGame);
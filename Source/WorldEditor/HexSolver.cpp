@@ -39,6 +39,22 @@ void HexSolver::Update(Game& aGame, float aDeltaTime)
 			{
 				Solve();
 			}
+			ImGui::Separator();
+
+			ImGui::Text("Targets: %zu", myTargets.size());
+			if (ImGui::Button("Add End as Target") && myFlowField.IsValid(myEnd))
+			{
+				myTargets.push_back(myEnd);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Clear Targets"))
+			{
+				myTargets.clear();
+			}
+			if (ImGui::Button("Flow Field"))
+			{
+				SolveFlowField();
+			}
 		}
 		ImGui::End();
 	}
@@ -56,6 +72,13 @@ void HexSolver::InitGrid(Game& aGame)
 		myGrid[i] = sampler(generator) <= myObstChance;
 	}
 
+	myFlowField.Resize({ mySize, mySize });
+	for (int i = 0; i < myGrid.size(); i++)
+	{
+		myFlowField.SetCost({ i % mySize, i / mySize }, myGrid[i] ? HexFlowField::kWall : 1);
+	}
+	myTargets.clear();
+
 	AssetTracker& assetTracker = aGame.GetAssetTracker();
 	Handle<Model> hexModel = assetTracker.GetOrCreate<Model>("Hexagon/HexShape.model");
 	Handle<Texture> hexTexture = assetTracker.GetOrCreate<Texture>("Hexagon/HexTexture.img");
@@ -108,16 +131,21 @@ void HexSolver::InitGrid(Game& aGame)
 	}
 }
 
+void HexSolver::ResetMarks()
+{
+	// every hex belongs to this solver, so going over the pool
+	// directly skips the per-object component lookup
+	ComponentPools::Get<HexComponent>().ForEach([](HexComponent& aComp) {
+		aComp.myIsStart = false;
+		aComp.myIsEnd = false;
+		aComp.myIsPath = false;
+	});
+}
+
 void HexSolver::Solve()
 {
 	// resetting visuals from last attempt
-	for (Handle<GameObject>& go : myGameObjects)
-	{
-		HexComponent* hexComp = go->GetComponent<HexComponent>();
-		hexComp->myIsStart = false;
-		hexComp->myIsEnd = false;
-		hexComp->myIsPath = false;
-	}
+	ResetMarks();
 
 	struct FloodFillStep
 	{
@@ -210,6 +238,36 @@ void HexSolver::Solve()
 	}
 }
 
+void HexSolver::SolveFlowField()
+{
+	ResetMarks();
+
+	if (!myFlowField.IsValid(myStart) || (myTargets.empty() && !myFlowField.IsValid(myEnd)))
+	{
+		return;
+	}
+
+	const std::span<const glm::ivec2> targets = myTargets.empty()
+		? std::span<const glm::ivec2>(&myEnd, 1)
+		: std::span<const glm::ivec2>(myTargets);
+	myFlowField.ParallelCompute(targets);
+
+	for (glm::ivec2 target : targets)
+	{
+		myGameObjects[target.y * mySize + target.x]->GetComponent<HexComponent>()->myIsEnd = true;
+	}
+	myGameObjects[myStart.y * mySize + myStart.x]->GetComponent<HexComponent>()->myIsStart = true;
+
+	// every step is a single look-up, and leads strictly closer
+	// to a target, until there's no step left to take
+	glm::ivec2 hex = myStart;
+	for (glm::ivec2 next = myFlowField.GetNextHex(hex); next != hex; next = myFlowField.GetNextHex(hex))
+	{
+		hex = next;
+		myGameObjects[hex.y * mySize + hex.x]->GetComponent<HexComponent>()->myIsPath = true;
+	}
+}
+
 void TintAdapter::FillUniformBlock(const AdapterSourceData& aData, UniformBlock& aUB)
 {
 	const UniformAdapterSource& data = static_cast<const UniformAdapterSource&>(aData);
@@ -3,6 +3,7 @@
 #include <Graphics/UniformAdapterRegister.h>
 #include <Engine/Components/ComponentBase.h>
 #include <Graphics/Descriptor.h>
+#include <Core/HexFlowField.h>
 
 class Game;
 template<class T> class Handle;
@@ -17,10 +18,17 @@ public:
 
 private:
 	void InitGrid(Game& aGame);
+	// Clears start, end and path marks of every hex
+	void ResetMarks();
 
 	void Solve();
+	// Paths from start to the closest of the targets (or end if there
+	// are none), by following a flow field computed from all of them
+	void SolveFlowField();
 
 	std::vector<bool> myGrid;
+	HexFlowField myFlowField;
+	std::vector<glm::ivec2> myTargets;
 	std::vector<Handle<GameObject>> myGameObjects;
 	glm::ivec2 myStart{};
 	glm::ivec2 myEnd{};
@@ -0,0 +1,439 @@
+#include "Precomp.h"
+#include "NavMeshBench.h"
+
+#include <Engine/Terrain.h>
+#include <Core/File.h>
+
+#include <bit>
+#include <charconv>
+#include <random>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+namespace
+{
+	// raised in the middle of a tile for rebuilds, steep enough to block
+	constexpr float kPillarSize = 4.f;
+	constexpr float kPillarHeight = 4.f;
+
+	template<class T>
+	bool ParseValue(std::string_view aText, T& aValue)
+	{
+		const char* end = aText.data() + aText.size();
+		const std::from_chars_result result = std::from_chars(aText.data(), end, aValue);
+		return result.ec == std::errc() && result.ptr == end;
+	}
+}
+
+bool NavMeshBench::IsRequested(std::span<char* const> anArgs)
+{
+	return std::ranges::find(anArgs, std::string_view("--navmesh-bench")) != anArgs.end();
+}
+
+bool NavMeshBench::ParseArgs(std::span<char* const> anArgs, Settings& aSettings)
+{
+	for (size_t i = 0; i < anArgs.size(); i++)
+	{
+		const std::string_view arg = anArgs[i];
+		if (arg == "--navmesh-bench")
+		{
+			continue;
+		}
+
+		if (i + 1 == anArgs.size())
+		{
+			std::println("Missing value for {}", arg);
+			return false;
+		}
+		const std::string_view value = anArgs[++i];
+
+		bool parsed = true;
+		if (arg == "--verts")
+		{
+			parsed = ParseValue(value, aSettings.myTerrainVerts)
+				&& aSettings.myTerrainVerts > 2
+				&& std::has_single_bit(aSettings.myTerrainVerts);
+		}
+		else if (arg == "--step")
+		{
+			parsed = ParseValue(value, aSettings.myTerrainStep) && aSettings.myTerrainStep > 0;
+		}
+		else if (arg == "--height")
+		{
+			parsed = ParseValue(value, aSettings.myTerrainHeight) && aSettings.myTerrainHeight >= 0;
+		}
+		else if (arg == "--voxel")
+		{
+			parsed = ParseValue(value, aSettings.myGen.myVoxelSize) && aSettings.myGen.myVoxelSize > 0;
+		}
+		else if (arg == "--voxel-height")
+		{
+			parsed = ParseValue(value, aSettings.myGen.myVoxelHeight) && aSettings.myGen.myVoxelHeight > 0;
+		}
+		else if (arg == "--runs")
+		{
+			parsed = ParseValue(value, aSettings.myRunCount) && aSettings.myRunCount > 0;
+		}
+		else if (arg == "--queries")
+		{
+			parsed = ParseValue(value, aSettings.myQueryCount);
+		}
+		else if (arg == "--query-frames")
+		{
+			parsed = ParseValue(value, aSettings.myQueryFrames);
+		}
+		else if (arg == "--query-range")
+		{
+			parsed = ParseValue(value, aSettings.myQueryRange) && aSettings.myQueryRange > 0;
+		}
+		else if (arg == "--rebuilds")
+		{
+			parsed = ParseValue(value, aSettings.myRebuildCount);
+		}
+		else if (arg == "--seed")
+		{
+			parsed = ParseValue(value, aSettings.mySeed);
+		}
+		else if (arg == "--out")
+		{
+			aSettings.myReportPath = value;
+		}
+		else
+		{
+			std::println("Unrecognized argument: {}", arg);
+			return false;
+		}
+
+		if (!parsed)
+		{
+			std::println("Invalid value for {}: {}", arg, value);
+			return false;
+		}
+	}
+	return true;
+}
+
+NavMeshBench::NavMeshBench(const Settings& aSettings)
+	: mySettings(aSettings)
+{
+	for (std::vector<std::chrono::nanoseconds>& timings : myTimings)
+	{
+		timings.reserve(mySettings.myRunCount);
+	}
+	myTotalTimings.reserve(mySettings.myRunCount);
+	myQueryTimings.reserve(mySettings.myQueryFrames);
+	myRebuildTimings.reserve(mySettings.myRebuildCount);
+	myRebuildStartTimings.reserve(mySettings.myRebuildCount);
+	myRebuildApplyTimings.reserve(mySettings.myRebuildCount);
+}
+
+int NavMeshBench::Run()
+{
+	// terrain generation relies on rand()
+	srand(mySettings.mySeed);
+	Terrain terrain;
+	terrain.Generate(glm::uvec2(mySettings.myTerrainVerts), mySettings.myTerrainStep, mySettings.myTerrainHeight);
+
+	// triangulating same as the terrain is rendered, 2 triangles per quad
+	const uint32_t verts = mySettings.myTerrainVerts;
+	const float step = mySettings.myTerrainStep;
+	std::vector<glm::vec3> vertices(verts * verts);
+	for (uint32_t z = 0; z < verts; z++)
+	{
+		for (uint32_t x = 0; x < verts; x++)
+		{
+			const glm::vec2 localPos{ x * step, z * step };
+			vertices[z * verts + x] = { localPos.x, terrain.GetHeight(localPos), localPos.y };
+		}
+	}
+	const auto [minVert, maxVert] = std::ranges::minmax_element(vertices, {},
+		[](glm::vec3 aVertex) { return aVertex.y; });
+	const float minY = minVert->y;
+	const float maxY = maxVert->y;
+
+	std::vector<glm::vec3> triangles;
+	triangles.reserve((verts - 1) * (verts - 1) * 6);
+	for (uint32_t z = 0; z < verts - 1; z++)
+	{
+		for (uint32_t x = 0; x < verts - 1; x++)
+		{
+			const glm::vec3 a = vertices[z * verts + x];
+			const glm::vec3 b = vertices[z * verts + x + 1];
+			const glm::vec3 c = vertices[(z + 1) * verts + x];
+			const glm::vec3 d = vertices[(z + 1) * verts + x + 1];
+			triangles.insert(triangles.end(), { a, c, b, c, d, b });
+		}
+	}
+	const size_t triangleCount = triangles.size() / 3;
+
+	const NavMeshGen::Input input{
+		.myWorld = nullptr,
+		.myMin = { 0, minY - 1, 0 },
+		// room for the pillars of rebuilds
+		.myMax = { terrain.GetWidth(), maxY + 1 + kPillarHeight, terrain.GetDepth() },
+		.myTriangles = triangles
+	};
+
+	NavMeshGen navMesh;
+	for (uint32_t run = 0; run < mySettings.myRunCount; run++)
+	{
+		navMesh.Generate(input, mySettings.myGen, nullptr);
+
+		const NavMeshGen::Stats& stats = navMesh.GetStats();
+		std::chrono::nanoseconds total{ 0 };
+		for (uint8_t stage = 0; stage < NavMeshGen::Stats::Stage::Count; stage++)
+		{
+			myTimings[stage].push_back(stats.myStageTimes[stage]);
+			total += stats.myStageTimes[stage];
+		}
+		myTotalTimings.push_back(total);
+		std::println("NavMeshBench: run {} took {:.1f}ms", run,
+			std::chrono::duration<double, std::milli>(total).count());
+	}
+
+	std::println("NavMeshBench: {:.0f}m x {:.0f}m, {} triangles, {} tiles, {} polys",
+		terrain.GetWidth(), terrain.GetDepth(), triangleCount,
+		navMesh.GetStats().myTileCount, navMesh.GetPolys().size());
+
+	if (mySettings.myQueryCount > 0 && mySettings.myQueryFrames > 0)
+	{
+		RunPathQueries(terrain, navMesh);
+	}
+
+	if (mySettings.myRebuildCount > 0)
+	{
+		RunRebuilds(triangles, navMesh);
+	}
+
+	const std::string report = GenerateReport(navMesh, triangleCount);
+	File file(mySettings.myReportPath);
+	if (!file.Write(report.data(), report.size()))
+	{
+		std::println("NavMeshBench: failed to write report to {}", mySettings.myReportPath);
+		return 1;
+	}
+	return 0;
+}
+
+void NavMeshBench::RunPathQueries(const Terrain& aTerrain, const NavMeshGen& aNavMesh)
+{
+	// every unit walks between 2 random points on the terrain within range
+	std::mt19937 engine(mySettings.mySeed);
+	const glm::vec2 maxPos{ aTerrain.GetWidth(), aTerrain.GetDepth() };
+	std::uniform_real_distribution<float> xDistrib(0, maxPos.x);
+	std::uniform_real_distribution<float> zDistrib(0, maxPos.y);
+	std::uniform_real_distribution<float> rangeDistrib(-mySettings.myQueryRange, mySettings.myQueryRange);
+	auto GetTerrainPos = [&](glm::vec2 aPos)
+	{
+		// GetHeight excludes the far edges
+		const glm::vec2 pos = glm::clamp(aPos, glm::vec2(0), glm::max(maxPos - 0.01f, glm::vec2(0)));
+		return glm::vec3{ pos.x, aTerrain.GetHeight(pos), pos.y };
+	};
+
+	std::vector<NavMeshPathfinder::Request> requests(mySettings.myQueryCount);
+	for (NavMeshPathfinder::Request& request : requests)
+	{
+		const glm::vec2 start{ xDistrib(engine), zDistrib(engine) };
+		const glm::vec2 end = start + glm::vec2{ rangeDistrib(engine), rangeDistrib(engine) };
+		request.myStart = GetTerrainPos(start);
+		request.myEnd = GetTerrainPos(end);
+	}
+
+	NavMeshPathfinder pathfinder(aNavMesh);
+	std::vector<NavMeshPathfinder::Path> paths;
+	size_t pointCount = 0;
+	// units move a bit every frame, so the ones that stay
+	// within the same poly get their paths from the cache
+	std::uniform_real_distribution<float> moveDistrib(-1.f, 1.f);
+	using Clock = std::chrono::steady_clock;
+	for (uint32_t frame = 0; frame < mySettings.myQueryFrames; frame++)
+	{
+		if (frame > 0)
+		{
+			for (NavMeshPathfinder::Request& request : requests)
+			{
+				const glm::vec2 move{ moveDistrib(engine), moveDistrib(engine) };
+				request.myStart = GetTerrainPos(glm::vec2{ request.myStart.x, request.myStart.z } + move);
+			}
+		}
+
+		const Clock::time_point start = Clock::now();
+		pathfinder.FindPaths(requests, paths);
+		myQueryTimings.push_back(Clock::now() - start);
+
+		const NavMeshPathfinder::Stats& stats = pathfinder.GetStats();
+		myQueryStats.myCacheHits += stats.myCacheHits;
+		myQueryStats.mySearches += stats.mySearches;
+		myQueryStats.myFailed += stats.myFailed;
+		for (const NavMeshPathfinder::Path& path : paths)
+		{
+			pointCount += path.myPoints.size();
+		}
+	}
+
+	const size_t foundCount = myQueryStats.myCacheHits + myQueryStats.mySearches;
+	std::println("NavMeshBench: {} frames of {} path queries, {} found ({} from cache), {:.1f} points per path",
+		mySettings.myQueryFrames, mySettings.myQueryCount, foundCount, myQueryStats.myCacheHits,
+		foundCount > 0 ? static_cast<double>(pointCount) / foundCount : 0.0);
+}
+
+void NavMeshBench::RunRebuilds(std::vector<glm::vec3>& aTriangles, NavMeshGen& aNavMesh)
+{
+	// pillars stay clear of tile borders, for every rebuild to be of a single
+	// tile. Triangles reach a terrain step further out than the moved vertices
+	const float tileSize = aNavMesh.GetTileSize();
+	const float halfSize = kPillarSize / 2.f;
+	const float reach = halfSize + mySettings.myTerrainStep;
+	const float margin = reach + mySettings.myGen.myVoxelSize;
+	const float terrainSize = (mySettings.myTerrainVerts - 1) * mySettings.myTerrainStep;
+	if (tileSize < margin * 2 || terrainSize < tileSize)
+	{
+		std::println("NavMeshBench: terrain or tiles are too small for rebuilds");
+		return;
+	}
+
+	// the last tiles on X and Z can be cut short
+	const uint32_t fullTiles = static_cast<uint32_t>(terrainSize / tileSize);
+	std::mt19937 engine(mySettings.mySeed);
+	std::uniform_int_distribution<uint32_t> tileDistrib(0, fullTiles - 1);
+	std::uniform_real_distribution<float> offsetDistrib(margin, tileSize - margin);
+	glm::vec2 center{ 0 };
+	using Clock = std::chrono::steady_clock;
+	for (uint32_t rebuild = 0; rebuild < mySettings.myRebuildCount; rebuild++)
+	{
+		const bool isRaising = rebuild % 2 == 0;
+		if (isRaising)
+		{
+			const glm::vec2 tile{ tileDistrib(engine), tileDistrib(engine) };
+			center = tile * tileSize + glm::vec2{ offsetDistrib(engine), offsetDistrib(engine) };
+		}
+		const float offset = isRaising ? kPillarHeight : -kPillarHeight;
+		for (glm::vec3& vertex : aTriangles)
+		{
+			if (glm::abs(vertex.x - center.x) <= halfSize && glm::abs(vertex.z - center.y) <= halfSize)
+			{
+				vertex.y += offset;
+			}
+		}
+
+		const Clock::time_point start = Clock::now();
+		aNavMesh.MarkDirty(
+			{ center.x - reach, std::numeric_limits<float>::lowest(), center.y - reach },
+			{ center.x + reach, std::numeric_limits<float>::max(), center.y + reach }
+		);
+		const bool started = aNavMesh.StartRebuild(nullptr);
+		ASSERT(started);
+		const Clock::time_point startEnd = Clock::now();
+
+		// polling like a frame would, but without anything else to do
+		Clock::time_point applyStart;
+		do
+		{
+			std::this_thread::yield();
+			applyStart = Clock::now();
+		} while (!aNavMesh.ApplyRebuild());
+		const Clock::time_point end = Clock::now();
+
+		myRebuildTimings.push_back(end - start);
+		myRebuildStartTimings.push_back(startEnd - start);
+		myRebuildApplyTimings.push_back(end - applyStart);
+	}
+
+	std::chrono::nanoseconds total{ 0 };
+	for (std::chrono::nanoseconds timing : myRebuildTimings)
+	{
+		total += timing;
+	}
+	std::println("NavMeshBench: {} single tile rebuilds, {:.1f}ms on average", myRebuildTimings.size(),
+		std::chrono::duration<double, std::milli>(total).count() / myRebuildTimings.size());
+}
+
+std::string NavMeshBench::GenerateReport(const NavMeshGen& aNavMesh, size_t aTriangleCount) const
+{
+	using Ms = std::chrono::duration<double, std::milli>;
+	auto GetTimingsJson = [](const std::vector<std::chrono::nanoseconds>& aTimings)
+	{
+		const auto [min, max] = std::ranges::minmax_element(aTimings);
+		std::chrono::nanoseconds total{ 0 };
+		for (std::chrono::nanoseconds timing : aTimings)
+		{
+			total += timing;
+		}
+		return nlohmann::json{
+			{ "avgMs", Ms(total).count() / aTimings.size() },
+			{ "minMs", Ms(*min).count() },
+			{ "maxMs", Ms(*max).count() }
+		};
+	};
+
+	nlohmann::json report;
+	report["settings"] = {
+		{ "runs", mySettings.myRunCount },
+		{ "seed", mySettings.mySeed },
+		{ "terrainVerts", mySettings.myTerrainVerts },
+		{ "terrainStep", mySettings.myTerrainStep },
+		{ "terrainHeight", mySettings.myTerrainHeight },
+		{ "voxelSize", mySettings.myGen.myVoxelSize },
+		{ "voxelHeight", mySettings.myGen.myVoxelHeight },
+		{ "maxSlope", mySettings.myGen.myMaxSlope },
+		{ "minFreeHeight", mySettings.myGen.myMinFreeHeight },
+		{ "maxStepHeight", mySettings.myGen.myMaxStepHeight }
+	};
+
+	const NavMeshGen::Stats& stats = aNavMesh.GetStats();
+	size_t linkCount = 0;
+	for (const NavMeshGen::NavPoly& poly : aNavMesh.GetPolys())
+	{
+		linkCount += poly.myLinkCount;
+	}
+	report["navMesh"] = {
+		{ "triangles", aTriangleCount },
+		{ "tiles", stats.myTileCount },
+		{ "spans", stats.mySpanCount },
+		{ "contours", stats.myContourCount },
+		{ "polys", aNavMesh.GetPolys().size() },
+		{ "links", linkCount }
+	};
+
+	nlohmann::json& stagesJson = report["stages"];
+	for (uint8_t stage = 0; stage < NavMeshGen::Stats::Stage::Count; stage++)
+	{
+		stagesJson[std::string(NavMeshGen::Stats::kStageNames[stage])] = GetTimingsJson(myTimings[stage]);
+	}
+	report["total"] = GetTimingsJson(myTotalTimings);
+
+	if (!myQueryTimings.empty())
+	{
+		std::chrono::nanoseconds totalTime{ 0 };
+		for (std::chrono::nanoseconds timing : myQueryTimings)
+		{
+			totalTime += timing;
+		}
+		const double queryCount = static_cast<double>(mySettings.myQueryCount) * myQueryTimings.size();
+		report["pathQueries"] = {
+			{ "queriesPerFrame", mySettings.myQueryCount },
+			{ "frames", mySettings.myQueryFrames },
+			{ "range", mySettings.myQueryRange },
+			{ "cacheHits", myQueryStats.myCacheHits },
+			{ "searches", myQueryStats.mySearches },
+			{ "failed", myQueryStats.myFailed },
+			{ "queriesPerSec", queryCount / std::chrono::duration<double>(totalTime).count() },
+			{ "frame", GetTimingsJson(myQueryTimings) }
+		};
+	}
+
+	if (!myRebuildTimings.empty())
+	{
+		report["rebuilds"] = {
+			{ "count", myRebuildTimings.size() },
+			{ "tileSize", aNavMesh.GetTileSize() },
+			{ "pillarSize", kPillarSize },
+			{ "latency", GetTimingsJson(myRebuildTimings) },
+			{ "start", GetTimingsJson(myRebuildStartTimings) },
+			{ "apply", GetTimingsJson(myRebuildApplyTimings) }
+		};
+	}
+
+	constexpr int kIndent = 1;
+	return report.dump(kIndent, '\t');
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "NavMeshPathfinder.h"
+
+class Terrain;
+
+// Generates a navmesh over a large random terrain without a window,
+// several times in a row, then runs frames of batched path queries over
+// it, and then raises and lowers pillars of terrain within single tiles,
+// rebuilding them incrementally. Writes out a JSON report with the time
+// spent in every generation stage, the size of the resulting navmesh,
+// path query throughput and tile rebuild latency.
+// Usage: WorldEditor --navmesh-bench [--verts N] [--step meters]
+//	[--height meters] [--voxel meters] [--voxel-height meters]
+//	[--runs N] [--queries N] [--query-frames N] [--query-range meters]
+//	[--rebuilds N] [--seed N] [--out report.json]
+class NavMeshBench
+{
+public:
+	struct Settings
+	{
+		NavMeshGen::Settings myGen{
+			.myMaxSlope = 45.f,
+			.myMinFreeHeight = 2.f,
+			// fine enough for a terrain, while a 1km^2 voxel grid
+			// still fits in memory
+			.myVoxelSize = 0.5f,
+			.myVoxelHeight = 0.1f
+		};
+		std::string myReportPath = "NavMeshBenchReport.json";
+		// terrain vertices per side, power of 2
+		uint32_t myTerrainVerts = 1024;
+		// 1023m x 1023m with defaults
+		float myTerrainStep = 1.f;
+		float myTerrainHeight = 32.f;
+		uint32_t myRunCount = 3;
+		// path queries per frame, from as many units
+		uint32_t myQueryCount = 10'000;
+		uint32_t myQueryFrames = 10;
+		// how far away from a unit its path's end can be
+		float myQueryRange = 64.f;
+		// every other one restores the terrain of the previous one
+		uint32_t myRebuildCount = 20;
+		uint32_t mySeed = 12345;
+	};
+
+	// Returns true if anArgs request a navmesh benchmark run
+	static bool IsRequested(std::span<char* const> anArgs);
+	// Returns false if any of the arguments is unrecognized or malformed
+	static bool ParseArgs(std::span<char* const> anArgs, Settings& aSettings);
+
+	NavMeshBench(const Settings& aSettings);
+
+	// Returns the process exit code
+	int Run();
+
+private:
+	void RunPathQueries(const Terrain& aTerrain, const NavMeshGen& aNavMesh);
+	void RunRebuilds(std::vector<glm::vec3>& aTriangles, NavMeshGen& aNavMesh);
+	std::string GenerateReport(const NavMeshGen& aNavMesh, size_t aTriangleCount) const;
+
+	Settings mySettings;
+	// per-run durations of every stage
+	std::vector<std::chrono::nanoseconds> myTimings[NavMeshGen::Stats::Stage::Count];
+	std::vector<std::chrono::nanoseconds> myTotalTimings;
+	// per-frame durations of path queries
+	std::vector<std::chrono::nanoseconds> myQueryTimings;
+	// summed up over all of the frames
+	NavMeshPathfinder::Stats myQueryStats;
+	// per-rebuild durations, from marking the tiles dirty to the rebuild
+	// getting applied, and of the parts that block the calling thread
+	std::vector<std::chrono::nanoseconds> myRebuildTimings;
+	std::vector<std::chrono::nanoseconds> myRebuildStartTimings;
+	std::vector<std::chrono::nanoseconds> myRebuildApplyTimings;
+};
@@ -12,90 +12,70 @@
 #include <Core/Profiler.h>
 #include <Core/Shapes.h>
 
-void NavMeshGen::Generate(const Input& anInput, const Settings& aSettings, Game& aGame)
+#include <thread>
+
+struct NavMeshGen::ModelInstance
+{
+	Handle<Model> myModel;
+	glm::mat4 myTransform;
+	Shapes::AABB myAABB; // world space
+};
+
+NavMeshGen::NavMeshGen() = default;
+
+NavMeshGen::~NavMeshGen()
+{
+	WaitForRebuild();
+}
+
+void NavMeshGen::Generate(const Input& anInput, const Settings& aSettings, AssetTracker* anAssetTracker)
 {
 	Profiler::GetInstance().CaptureCurrentFrame();
 	Profiler::ScopedMark scope("NavMesh::Generate");
+	// a running rebuild reads the tiles, and would be outdated anyway
+	WaitForRebuild();
+	myRebuild = {};
+	myIsRebuilding = false;
+	myDirtyTiles.clear();
+
 	myInput = anInput;
 	mySettings = aSettings;
+	myStats = {};
 
-	CreateTiles();
+	// every stage is parallel over tiles internally, stages themselves
+	// run one after another so that they can be timed separately
+	auto RunStage = [this](Stats::Stage aStage, const auto& aFunc)
+	{
+		using Clock = std::chrono::steady_clock;
+		const Clock::time_point start = Clock::now();
+		aFunc();
+		myStats.myStageTimes[aStage] = Clock::now() - start;
+	};
+	RunStage(Stats::CreateTiles, [this] { CreateTiles(); });
+	RunStage(Stats::Voxelize, [&] {
+		const std::vector<ModelInstance> models = GatherModels(anAssetTracker, myInput.myMin, myInput.myMax);
+		std::vector<Tile*> tiles(myTiles.size());
+		for (size_t i = 0; i < myTiles.size(); i++)
+		{
+			tiles[i] = &myTiles[i];
+		}
+		VoxelizeTiles(tiles, models);
+	});
+	RunStage(Stats::SegmentTiles, [this] { SegmentTiles(); });
+	RunStage(Stats::ExtractContours, [this] { ExtractContours(); });
+	RunStage(Stats::MergeTiles, [this] { MergeTiles(); });
+	RunStage(Stats::BuildNavGraph, [this] { BuildNavGraph(); });
 
-	constexpr uint8_t kScenario = 0;
-	Tile& tile = myTiles[2];
-	const uint32_t width = tile.mySize.x;
-	const uint32_t halfHeight = static_cast<uint32_t>(
-		(tile.myMaxHeight - tile.myMinHeight) / kVoxelHeight / 2
-	);
-	switch (kScenario)
-	{
-	case 0:
-		GatherTriangles(aGame.GetAssetTracker());
-		break;
-	case 1:
-		tile.myVoxelGrid[0].AddBoth(halfHeight);
-		tile.myVoxelGrid[1].AddBoth(halfHeight);
-		tile.myVoxelGrid[2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 2].AddBoth(halfHeight);
-		break;
-	case 2:
-		tile.myVoxelGrid[0].AddBoth(halfHeight);
-		tile.myVoxelGrid[1].AddBoth(halfHeight);
-		tile.myVoxelGrid[2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 2].AddBoth(halfHeight);
-		break;
-	case 3:
-		tile.myVoxelGrid[0].AddBoth(halfHeight);
-		tile.myVoxelGrid[1].AddBoth(halfHeight);
-		tile.myVoxelGrid[2].AddBoth(halfHeight);
-		tile.myVoxelGrid[3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3 + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3 + 3].AddBoth(halfHeight);
-		break;
-	case 4:
-		tile.myVoxelGrid[0].AddBoth(halfHeight);
-		tile.myVoxelGrid[1].AddBoth(halfHeight);
-		tile.myVoxelGrid[2].AddBoth(halfHeight);
-		tile.myVoxelGrid[3].AddBoth(halfHeight);
-		tile.myVoxelGrid[4].AddBoth(halfHeight);
-		tile.myVoxelGrid[width].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width + 4].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 2 + 4].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 3 + 4].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 4].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 4 + 1].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 4 + 2].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 4 + 3].AddBoth(halfHeight);
-		tile.myVoxelGrid[width * 4 + 4].AddBoth(halfHeight);
-		break;
+	myStats.myTileCount = myTiles.size();
+	for (const Tile& tile : myTiles)
+	{
+		for (const VoxelColumn& column : tile.myVoxelGrid)
+		{
+			myStats.mySpanCount += column.mySpans.size();
+		}
+		myStats.myContourCount += tile.myContours.size();
 	}
-
-	SegmentTiles();
-	ExtractContours();
+	myIsTileDirty.assign(myTiles.size(), 0);
 }
 
 void NavMeshGen::DebugDraw(DebugDrawer& aDrawer) const
@@ -106,12 +86,7 @@ void NavMeshGen::DebugDraw(DebugDrawer& aDrawer) const
 
 		for (const Tile& tile : myTiles)
 		{
-			const glm::vec3 aabbMax{
-				tile.myAABBMin.x + tile.mySize.x * kVoxelSize,
-				tile.myAABBMin.y + tile.mySize.y * kVoxelHeight,
-				tile.myAABBMin.z + tile.mySize.z * kVoxelSize,
-			};
-			aDrawer.AddAABB(tile.myAABBMin, aabbMax, { 0, 1, 0 });
+			aDrawer.AddAABB(tile.myAABBMin, tile.GetAABBMax(), { 0, 1, 0 });
 		}
 	}
 
@@ -133,27 +108,293 @@ void NavMeshGen::DebugDraw(DebugDrawer& aDrawer) const
 
 	if (mySettings.myDrawRegions)
 	{
-		for (const Region& region : myRegions)
+		for (const Tile& tile : myTiles)
 		{
-			region.Draw(aDrawer);
+			for (const Region& region : tile.myRegions)
+			{
+				region.Draw(aDrawer, tile);
+			}
 		}
 	}
 
 	if (mySettings.myDrawCornerPoints)
 	{
-		for (const Region& region : myRegions)
+		for (const Tile& tile : myTiles)
 		{
-			region.DrawCornerPoints(aDrawer);
+			for (const Region& region : tile.myRegions)
+			{
+				region.DrawCornerPoints(aDrawer, tile);
+			}
 		}
 	}
 
 	if (mySettings.myDrawContours)
 	{
-		for (const Contour& contour : myContours)
+		for (const Tile& tile : myTiles)
+		{
+			for (const Contour& contour : tile.myContours)
+			{
+				contour.Draw(aDrawer);
+			}
+		}
+	}
+
+	if (mySettings.myDrawNavGraph)
+	{
+		for (uint32_t polyIndex = 0; polyIndex < myPolys.size(); polyIndex++)
+		{
+			const NavPoly& poly = myPolys[polyIndex];
+			for (const NavLink& link : GetLinks(poly))
+			{
+				// links go both ways, so drawing each once
+				if (link.myPoly < polyIndex)
+				{
+					continue;
+				}
+
+				const glm::vec3 portalCenter = (link.myPortalStart + link.myPortalEnd) / 2.f;
+				aDrawer.AddLine(poly.myCenter, portalCenter, { 1, 1, 0 });
+				aDrawer.AddLine(portalCenter, myPolys[link.myPoly].myCenter, { 1, 1, 0 });
+				aDrawer.AddLine(link.myPortalStart, link.myPortalEnd, { 1, 0, 1 });
+			}
+		}
+	}
+}
+
+uint32_t NavMeshGen::FindPoly(glm::vec3 aPos) const
+{
+	if (myTiles.empty())
+	{
+		return kInvalidPoly;
+	}
+
+	const glm::vec2 tilePos = glm::floor((glm::vec2{ aPos.x, aPos.z } - myTileOrigin) / myTileSize);
+	if (tilePos.x < 0 || tilePos.y < 0 
+		|| tilePos.x >= myTileCount.x || tilePos.y >= myTileCount.y)
+	{
+		return kInvalidPoly;
+	}
+	const Tile& tile = myTiles[static_cast<uint32_t>(tilePos.y) * myTileCount.x + static_cast<uint32_t>(tilePos.x)];
+
+	const glm::vec3 voxelPos = (aPos - tile.myAABBMin) 
+		/ glm::vec3{ tile.myVoxelSize, tile.myVoxelHeight, tile.myVoxelSize };
+	const glm::u32vec2 column = glm::clamp(
+		glm::vec2{ voxelPos.x, voxelPos.z },
+		glm::vec2{ 0 },
+		glm::vec2{ tile.mySize.x - 1, tile.mySize.z - 1 }
+	);
+	const VoxelColumn& voxelColumn = tile.myVoxelGrid[column.y * tile.mySize.x + column.x];
+	if (voxelColumn.mySpans.empty())
+	{
+		return kInvalidPoly;
+	}
+
+	const VoxelSpan* closest = &voxelColumn.mySpans[0];
+	for (const VoxelSpan& span : voxelColumn.mySpans)
+	{
+		if (glm::abs(span.myMaxY - voxelPos.y) < glm::abs(closest->myMaxY - voxelPos.y))
+		{
+			closest = &span;
+		}
+	}
+	if (closest->myRegionId == VoxelSpan::kInvalidRegion)
+	{
+		return kInvalidPoly; // not walkable, so not part of any poly
+	}
+	return tile.myFirstPoly + closest->myRegionId - 1;
+}
+
+void NavMeshGen::MarkDirty(glm::vec3 aMin, glm::vec3 aMax)
+{
+	// geometry outside of the input bounds doesn't get voxelized
+	if (myTiles.empty() || !Shapes::Intersects(
+		Shapes::AABB{ aMin, aMax }, 
+		Shapes::AABB{ myInput.myMin, myInput.myMax }))
+	{
+		return;
+	}
+
+	// triangles touch voxels they get within rounding distance of
+	const glm::vec3 padding{ mySettings.myVoxelSize };
+	const auto [minTile, maxTile] = GetTileRange(aMin - padding, aMax + padding);
+	for (uint32_t y = minTile.y; y <= maxTile.y; y++)
+	{
+		for (uint32_t x = minTile.x; x <= maxTile.x; x++)
+		{
+			const uint32_t index = y * myTileCount.x + x;
+			if (!myIsTileDirty[index])
+			{
+				myIsTileDirty[index] = 1;
+				myDirtyTiles.push_back(index);
+			}
+		}
+	}
+}
+
+bool NavMeshGen::StartRebuild(AssetTracker* anAssetTracker)
+{
+	if (myIsRebuilding || myDirtyTiles.empty())
+	{
+		return false;
+	}
+
+	Profiler::ScopedMark scope("NavMeshGen::StartRebuild");
+	myRebuild.myTileIndices.swap(myDirtyTiles);
+	myDirtyTiles.clear();
+	std::ranges::sort(myRebuild.myTileIndices);
+
+	glm::vec3 min{ std::numeric_limits<float>::max() };
+	glm::vec3 max{ std::numeric_limits<float>::lowest() };
+	for (uint32_t index : myRebuild.myTileIndices)
+	{
+		myIsTileDirty[index] = 0;
+		min = glm::min(min, myTiles[index].myAABBMin);
+		max = glm::max(max, myTiles[index].GetAABBMax());
+	}
+	// World isn't safe to access from other threads
+	myRebuild.myModels = GatherModels(anAssetTracker, min, max);
+
+	myIsRebuildDone = false;
+	myIsRebuilding = true;
+	myRebuildArena.enqueue([this] {
+		RebuildTiles();
+		myIsRebuildDone.store(true, std::memory_order_release);
+	});
+	return true;
+}
+
+bool NavMeshGen::ApplyRebuild()
+{
+	if (!myIsRebuilding || !myIsRebuildDone.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	Profiler::ScopedMark scope("NavMeshGen::ApplyRebuild");
+	// moving tiles keeps their grids and regions in place,
+	// so pointers into them stay valid
+	for (size_t i = 0; i < myRebuild.myTileIndices.size(); i++)
+	{
+		std::swap(myTiles[myRebuild.myTileIndices[i]], myRebuild.myTiles[i]);
+	}
+	for (size_t i = 0; i < myRebuild.myRelinkedIndices.size(); i++)
+	{
+		myTiles[myRebuild.myRelinkedIndices[i]].myBorderPortals.swap(myRebuild.myRelinkedPortals[i]);
+	}
+	for (size_t i = 0; i < myTiles.size(); i++)
+	{
+		myTiles[i].myFirstPoly = myRebuild.myFirstPolys[i];
+	}
+	myPolys.swap(myRebuild.myPolys);
+	myLinks.swap(myRebuild.myLinks);
+
+	// old tiles go along with the models, whose handles
+	// have to be released on the thread they were taken on
+	myRebuild = {};
+	myIsRebuilding = false;
+	return true;
+}
+
+void NavMeshGen::RebuildTiles()
+{
+	Profiler::ScopedMark scope("NavMeshGen::RebuildTiles");
+	Rebuild& rebuild = myRebuild;
+	const size_t rebuiltCount = rebuild.myTileIndices.size();
+	rebuild.myTiles.resize(rebuiltCount);
+	std::vector<Tile*> rebuiltTiles(rebuiltCount);
+	for (size_t i = 0; i < rebuiltCount; i++)
+	{
+		InitTile(rebuild.myTiles[i], rebuild.myTileIndices[i]);
+		rebuiltTiles[i] = &rebuild.myTiles[i];
+	}
+	VoxelizeTiles(rebuiltTiles, rebuild.myModels);
+
+	const uint32_t maxRegionSize = GetMaxRegionSize();
+	const uint32_t maxStep = GetMaxStep();
+	tbb::parallel_for(size_t(0), rebuiltCount, [&](size_t anIndex)
+	{
+		Tile& tile = rebuild.myTiles[anIndex];
+		tile.Segment(maxRegionSize);
+		tile.ExtractContours();
+		tile.LinkRegions(maxStep);
+	});
+
+	// the rest of the tiles are read as they are, the main
+	// thread doesn't change them until the rebuild is applied
+	std::vector<const Tile*> tiles(myTiles.size());
+	std::vector<const std::vector<PolyEdge>*> borderPortals(myTiles.size());
+	for (size_t i = 0; i < myTiles.size(); i++)
+	{
+		tiles[i] = &myTiles[i];
+		borderPortals[i] = &myTiles[i].myBorderPortals;
+	}
+	for (size_t i = 0; i < rebuiltCount; i++)
+	{
+		tiles[rebuild.myTileIndices[i]] = &rebuild.myTiles[i];
+		borderPortals[rebuild.myTileIndices[i]] = &rebuild.myTiles[i].myBorderPortals;
+	}
+	auto LinkBorders = [&](uint32_t anIndex, std::vector<PolyEdge>& aPortals)
+	{
+		const uint32_t nextOnX = GetNextTile(anIndex, true);
+		const uint32_t nextOnZ = GetNextTile(anIndex, false);
+		tiles[anIndex]->LinkBorders(
+			nextOnX != kInvalidTile ? tiles[nextOnX] : nullptr,
+			nextOnZ != kInvalidTile ? tiles[nextOnZ] : nullptr,
+			maxStep,
+			aPortals
+		);
+	};
+
+	// tiles handle the borders with the next tiles, so the previous
+	// ones need to relink to the rebuilt tiles as well
+	std::vector<uint32_t>& relinked = rebuild.myRelinkedIndices;
+	relinked.clear();
+	for (uint32_t index : rebuild.myTileIndices)
+	{
+		const glm::u32vec2 tilePos{ index % myTileCount.x, index / myTileCount.x };
+		if (tilePos.x > 0)
 		{
-			contour.Draw(aDrawer);
+			relinked.push_back(index - 1);
+		}
+		if (tilePos.y > 0)
+		{
+			relinked.push_back(index - myTileCount.x);
 		}
 	}
+	std::ranges::sort(relinked);
+	relinked.erase(std::unique(relinked.begin(), relinked.end()), relinked.end());
+	std::erase_if(relinked, [&](uint32_t anIndex)
+	{
+		return std::ranges::binary_search(rebuild.myTileIndices, anIndex);
+	});
+	rebuild.myRelinkedPortals.resize(relinked.size());
+
+	tbb::parallel_for(size_t(0), rebuiltCount + relinked.size(), [&](size_t anIndex)
+	{
+		if (anIndex < rebuiltCount)
+		{
+			LinkBorders(rebuild.myTileIndices[anIndex], rebuild.myTiles[anIndex].myBorderPortals);
+		}
+		else
+		{
+			LinkBorders(relinked[anIndex - rebuiltCount], rebuild.myRelinkedPortals[anIndex - rebuiltCount]);
+		}
+	});
+	for (size_t i = 0; i < relinked.size(); i++)
+	{
+		borderPortals[relinked[i]] = &rebuild.myRelinkedPortals[i];
+	}
+
+	AssembleNavGraph(tiles, borderPortals, rebuild.myFirstPolys, rebuild.myPolys, rebuild.myLinks);
+}
+
+void NavMeshGen::WaitForRebuild()
+{
+	// rebuild gets enqueued into the arena, so there's no task to wait on
+	while (myIsRebuilding && !myIsRebuildDone.load(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
 }
 
 bool NavMeshGen::IsVertexCorner(uint8_t aVert, uint8_t aNeighborsSet)
@@ -245,35 +486,47 @@ void NavMeshGen::VoxelColumn::Merge()
 	);
 }
 
+void NavMeshGen::VoxelColumn::Filter(uint32_t aMinFreeHeight)
+{
+	// spans are sorted and don't overlap after Merge,
+	// and top-most span has unlimited space above it
+	for (size_t i = 0; i + 1 < mySpans.size(); i++)
+	{
+		if (mySpans[i + 1].myMinY - mySpans[i].myMaxY < aMinFreeHeight)
+		{
+			mySpans[i].myMinY = mySpans[i].myMaxY; // reset a span
+		}
+	}
+
+	std::erase_if(mySpans,
+		[](const VoxelSpan& aSpan) { return aSpan.myMinY == aSpan.myMaxY; }
+	);
+}
+
 void NavMeshGen::Tile::Insert(glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3)
 {
 	const glm::vec3 minBVWS = glm::min(aV1, glm::min(aV2, aV3));
 	const glm::vec3 maxBVWS = glm::max(aV1, glm::max(aV2, aV3));
 
 	// Entire triangle might lie outside of our tile
-	const glm::vec3 aabbMax{
-		myAABBMin.x + mySize.x * kVoxelSize,
-		myAABBMin.y + mySize.y * kVoxelHeight,
-		myAABBMin.z + mySize.z * kVoxelSize,
-	};
 	if (!Shapes::Intersects(
 		Shapes::AABB{ minBVWS, maxBVWS },
-		Shapes::AABB{ myAABBMin, aabbMax }))
+		Shapes::AABB{ myAABBMin, GetAABBMax() }))
 	{
 		return;
 	}
 
 	// Quantize in voxel grid
 	const glm::vec3 minBV{
-		glm::round((minBVWS.x - myAABBMin.x) / kVoxelSize),
-		glm::round((minBVWS.y - myAABBMin.y) / kVoxelHeight),
-		glm::round((minBVWS.z - myAABBMin.z) / kVoxelSize)
+		glm::round((minBVWS.x - myAABBMin.x) / myVoxelSize),
+		glm::round((minBVWS.y - myAABBMin.y) / myVoxelHeight),
+		glm::round((minBVWS.z - myAABBMin.z) / myVoxelSize)
 	};
 
 	const glm::vec3 maxBV{
-		glm::round((maxBVWS.x - myAABBMin.x) / kVoxelSize),
-		glm::round((maxBVWS.y - myAABBMin.y) / kVoxelHeight),
-		glm::round((maxBVWS.z - myAABBMin.z) / kVoxelSize)
+		glm::round((maxBVWS.x - myAABBMin.x) / myVoxelSize),
+		glm::round((maxBVWS.y - myAABBMin.y) / myVoxelHeight),
+		glm::round((maxBVWS.z - myAABBMin.z) / myVoxelSize)
 	};
 
 	// TODO: optimize as this can cover a lot of empty cells
@@ -307,20 +560,51 @@ void NavMeshGen::Tile::Insert(glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3)
 	const glm::vec3 v2TS = aV2 - myAABBMin;
 	const glm::vec3 v3TS = aV3 - myAABBMin;
 
-	constexpr Shapes::AABB voxelAABB{
+	const Shapes::AABB voxelAABB{
 		{ 0, 0, 0 },
-		{ kVoxelSize, kVoxelHeight, kVoxelSize }
+		{ myVoxelSize, myVoxelHeight, myVoxelSize }
 	};
+
+	// Triangle can only touch voxels of a column within the height range
+	// its plane has over the column, so the rest of triangle's BV can be
+	// skipped. Steep triangles cover their whole BV range anyway
+	const glm::vec3 normal = glm::cross(v2TS - v1TS, v3TS - v1TS);
+	const bool clipsColumns = glm::abs(normal.y) > 0.5f * glm::length(normal);
+	const glm::vec2 planeSlope = clipsColumns
+		? -glm::vec2{ normal.x, normal.z } / normal.y / myVoxelHeight * myVoxelSize
+		: glm::vec2{ 0 };
+	auto GetColumnYRange = [&](uint32_t aX, uint32_t aZ)
+	{
+		if (!clipsColumns)
+		{
+			return glm::uvec2{ minY, maxY };
+		}
+		// in voxels, relative to the first vertex
+		const glm::vec2 corner = glm::vec2{ aX, aZ } - glm::vec2{ v1TS.x, v1TS.z } / myVoxelSize;
+		const float startY = v1TS.y / myVoxelHeight + glm::dot(planeSlope, corner);
+		const float yAlongX = startY + planeSlope.x;
+		const float yAlongZ = startY + planeSlope.y;
+		const float yAlongXZ = yAlongX + planeSlope.y;
+		const float planeMinY = glm::min(glm::min(startY, yAlongX), glm::min(yAlongZ, yAlongXZ));
+		const float planeMaxY = glm::max(glm::max(startY, yAlongX), glm::max(yAlongZ, yAlongXZ));
+		// padded by a voxel to not lose touching ones to rounding
+		return glm::uvec2{
+			static_cast<uint32_t>(glm::max(glm::floor(planeMinY) - 1, static_cast<float>(minY))),
+			static_cast<uint32_t>(glm::clamp(glm::floor(planeMaxY) + 1, 0.f, static_cast<float>(maxY)))
+		};
+	};
+
 	for (uint32_t z = minZ; z < maxZ; z++)
 	{
 		for (uint32_t x = minX; x < maxX; x++)
 		{
-			for (uint32_t y = minY; y <= maxY; y++)
+			const glm::uvec2 yRange = GetColumnYRange(x, z);
+			for (uint32_t y = yRange.x; y <= yRange.y; y++)
 			{
 				const glm::vec3 voxelMin{
-					x * kVoxelSize,
-					y * kVoxelHeight,
-					z * kVoxelSize
+					x * myVoxelSize,
+					y * myVoxelHeight,
+					z * myVoxelSize
 				};
 				// Translate to voxel space to maintain precision
 				const glm::vec3 v1VS = v1TS - voxelMin;
@@ -348,6 +632,21 @@ void NavMeshGen::Tile::MergeColumns()
 	}
 }
 
+void NavMeshGen::Tile::FilterColumns(float aMinFreeHeight)
+{
+	if (aMinFreeHeight <= 0)
+	{
+		return;
+	}
+
+	Profiler::ScopedMark scope("NavMeshGen::Tile::FilterColumns");
+	const uint32_t minFreeHeight = static_cast<uint32_t>(glm::ceil(aMinFreeHeight / myVoxelHeight));
+	for (VoxelColumn& column : myVoxelGrid)
+	{
+		column.Filter(minFreeHeight);
+	}
+}
+
 void NavMeshGen::Tile::DrawValidTriangleChecks(DebugDrawer& aDrawer) const
 {
 	for (const Line& line : myDebugTriangles)
@@ -366,14 +665,14 @@ void NavMeshGen::Tile::DrawVoxelSpans(DebugDrawer& aDrawer) const
 			for (const VoxelSpan& span : column.mySpans)
 			{
 				const glm::vec3 min{
-					x * kVoxelSize,
-					span.myMinY * kVoxelHeight,
-					z * kVoxelSize
+					x * myVoxelSize,
+					span.myMinY * myVoxelHeight,
+					z * myVoxelSize
 				};
 				const glm::vec3 max{
-					(x + 1) * kVoxelSize,
-					span.myMaxY * kVoxelHeight,
-					(z + 1) * kVoxelSize
+					(x + 1) * myVoxelSize,
+					span.myMaxY * myVoxelHeight,
+					(z + 1) * myVoxelSize
 				};
 				aDrawer.AddAABB(
 					myAABBMin + min,
@@ -387,63 +686,108 @@ void NavMeshGen::Tile::DrawVoxelSpans(DebugDrawer& aDrawer) const
 
 void NavMeshGen::CreateTiles()
 {
-	// Round to kTileSize
-	constexpr float kTileSize = kVoxelSize * kVoxelsPerTile;
-	const float minX = glm::floor(myInput.myMin.x / kTileSize) * kTileSize;
-	const float minZ = glm::floor(myInput.myMin.z / kTileSize) * kTileSize;
-	const float maxX = glm::ceil(myInput.myMax.x / kTileSize) * kTileSize;
-	const float maxZ = glm::ceil(myInput.myMax.z / kTileSize) * kTileSize;
-	const float height = glm::ceil(myInput.myMax.y - myInput.myMin.y) / kVoxelHeight;
+	// Round to tile size
+	myTileSize = mySettings.myVoxelSize * kVoxelsPerTile;
+	const float minX = glm::floor(myInput.myMin.x / myTileSize) * myTileSize;
+	const float minZ = glm::floor(myInput.myMin.z / myTileSize) * myTileSize;
+	const float maxX = glm::ceil(myInput.myMax.x / myTileSize) * myTileSize;
+	const float maxZ = glm::ceil(myInput.myMax.z / myTileSize) * myTileSize;
 	
-	const glm::u32vec2 tileCount{
-		glm::ceil((maxX - minX) / kTileSize),
-		glm::ceil((maxZ - minZ) / kTileSize)
+	myTileOrigin = { minX, minZ };
+	myTileCount = glm::u32vec2{
+		glm::ceil((maxX - minX) / myTileSize),
+		glm::ceil((maxZ - minZ) / myTileSize)
 	};
-	myTiles.resize(tileCount.x * tileCount.y);
-
-	for (uint32_t y = 0; y < tileCount.y; y++)
+	myTiles.clear();
+	myTiles.resize(myTileCount.x * myTileCount.y);
+	for (uint32_t i = 0; i < myTiles.size(); i++)
 	{
-		for (uint32_t x = 0; x < tileCount.x; x++)
-		{
-			const glm::vec2 bvMin{ 
-				glm::max(minX + x * kTileSize, myInput.myMin.x),
-				glm::max(minZ + y * kTileSize, myInput.myMin.z)
-			};
-			const glm::vec2 bvMax{
-				glm::min(minX + (x + 1) * kTileSize, myInput.myMax.x),
-				glm::min(minZ + (y + 1) * kTileSize, myInput.myMax.z)
-			};
+		InitTile(myTiles[i], i);
+	}
+}
 
-			Tile& tile = myTiles[y * tileCount.x + x];
-			tile.mySize = glm::u32vec3{
-				glm::ceil((bvMax.x - bvMin.x) / kVoxelSize),
-				height,
-				glm::ceil((bvMax.y - bvMin.y) / kVoxelSize)
-			};
-			tile.myAABBMin = glm::vec3{
-				bvMin.x,
-				myInput.myMin.y,
-				bvMin.y
-			};
-			tile.myMinHeight = myInput.myMin.y;
-			tile.myMaxHeight = myInput.myMax.y;
-			tile.myVoxelGrid.resize(tile.mySize.x * tile.mySize.z);
-		}
+void NavMeshGen::InitTile(Tile& aTile, uint32_t anIndex) const
+{
+	const glm::u32vec2 tilePos{ anIndex % myTileCount.x, anIndex / myTileCount.x };
+	const glm::vec2 bvMin = glm::max(
+		myTileOrigin + glm::vec2(tilePos) * myTileSize,
+		glm::vec2{ myInput.myMin.x, myInput.myMin.z }
+	);
+	const glm::vec2 bvMax = glm::min(
+		myTileOrigin + glm::vec2(tilePos + 1u) * myTileSize,
+		glm::vec2{ myInput.myMax.x, myInput.myMax.z }
+	);
+	const float height = glm::ceil(myInput.myMax.y - myInput.myMin.y) / mySettings.myVoxelHeight;
+
+	aTile.myIndex = anIndex;
+	aTile.mySize = glm::u32vec3{
+		glm::ceil((bvMax.x - bvMin.x) / mySettings.myVoxelSize),
+		height,
+		glm::ceil((bvMax.y - bvMin.y) / mySettings.myVoxelSize)
+	};
+	aTile.myAABBMin = glm::vec3{
+		bvMin.x,
+		myInput.myMin.y,
+		bvMin.y
+	};
+	aTile.myMinHeight = myInput.myMin.y;
+	aTile.myMaxHeight = myInput.myMax.y;
+	aTile.myVoxelSize = mySettings.myVoxelSize;
+	aTile.myVoxelHeight = mySettings.myVoxelHeight;
+	aTile.myVoxelGrid.resize(aTile.mySize.x * aTile.mySize.z);
+}
+
+std::pair<glm::u32vec2, glm::u32vec2> NavMeshGen::GetTileRange(glm::vec3 aMin, glm::vec3 aMax) const
+{
+	const glm::vec2 lastTile = glm::vec2(myTileCount - 1u);
+	const glm::u32vec2 minTile{ glm::clamp(
+		glm::floor((glm::vec2{ aMin.x, aMin.z } - myTileOrigin) / myTileSize),
+		glm::vec2(0), lastTile
+	) };
+	const glm::u32vec2 maxTile{ glm::clamp(
+		glm::floor((glm::vec2{ aMax.x, aMax.z } - myTileOrigin) / myTileSize),
+		glm::vec2(0), lastTile
+	) };
+	return { minTile, maxTile };
+}
+
+uint32_t NavMeshGen::GetNextTile(uint32_t anIndex, bool anIsOnX) const
+{
+	const glm::u32vec2 tilePos{ anIndex % myTileCount.x, anIndex / myTileCount.x };
+	if (anIsOnX)
+	{
+		return tilePos.x + 1 < myTileCount.x ? anIndex + 1 : kInvalidTile;
 	}
+	return tilePos.y + 1 < myTileCount.y ? anIndex + myTileCount.x : kInvalidTile;
 }
 
-void NavMeshGen::GatherTriangles(AssetTracker& anAssetTracker)
+uint32_t NavMeshGen::GetMaxRegionSize() const
 {
-	const float maxSlopeCos = glm::cos(glm::radians(mySettings.myMaxSlope));
-	auto ProcessForTile = [&](Tile& aTile, const std::vector<Handle<GameObject>>& aGOs) {
-		Profiler::ScopedMark scope("NavMeshGen::GatherTriangles::ProcessTile");
+	return glm::clamp(
+		static_cast<uint32_t>(mySettings.myMaxRegionSize / mySettings.myVoxelSize),
+		1u,
+		kVoxelsPerTile
+	);
+}
 
-		const glm::vec3 tileMax{
-			aTile.myAABBMin.x + aTile.mySize.x * kVoxelSize,
-			aTile.myAABBMin.y + aTile.mySize.y * kVoxelHeight,
-			aTile.myAABBMin.z + aTile.mySize.z * kVoxelSize
-		};
-		for (const Handle<GameObject>& go : aGOs)
+uint32_t NavMeshGen::GetMaxStep() const
+{
+	return static_cast<uint32_t>(mySettings.myMaxStepHeight / mySettings.myVoxelHeight);
+}
+
+std::vector<NavMeshGen::ModelInstance> NavMeshGen::GatherModels(AssetTracker* anAssetTracker, 
+	glm::vec3 aMin, glm::vec3 aMax) const
+{
+	std::vector<ModelInstance> models;
+	if (!myInput.myWorld)
+	{
+		return models;
+	}
+
+	ASSERT_STR(anAssetTracker, "Need an AssetTracker to get models of the World!");
+	myInput.myWorld->Access([&](std::span<const GameObject* const> aGOs)
+	{
+		for (const GameObject* go : aGOs)
 		{
 			const VisualComponent* visual = go->GetComponent<VisualComponent>();
 			if (!visual)
@@ -457,26 +801,89 @@ void NavMeshGen::GatherTriangles(AssetTracker& anAssetTracker)
 				continue;
 			}
 
-			Handle<Model> model = anAssetTracker.Get<Model>(modelRes);
+			Handle<Model> model = anAssetTracker->Get<Model>(modelRes);
 			ASSERT_STR(model->GetState() == Resource::State::Ready,
 				"Not ready to generate navmesh!");
 
+			// AABB early model rejection
 			const Transform& transf = go->GetWorldTransform();
-			const glm::mat4& transfMat = transf.GetMatrix();
+			const Shapes::AABB modelAABB{
+				model->GetAABBMin(),
+				model->GetAABBMax()
+			};
+			const Shapes::AABB transfAABB = modelAABB.Transform(transf);
+			if (!Shapes::Intersects(transfAABB, { aMin, aMax }))
+			{
+				continue;
+			}
+			models.push_back({ std::move(model), transf.GetMatrix(), transfAABB });
+		}
+	});
+	return models;
+}
 
-			// AABB early model rejection
+void NavMeshGen::VoxelizeTiles(std::span<Tile* const> aTiles, std::span<const ModelInstance> aModels) const
+{
+	const float maxSlopeCos = glm::cos(glm::radians(mySettings.myMaxSlope));
+	auto InsertTriangle = [&](Tile& aTile, glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3) {
+		// angle against horizontal plane
+		const glm::vec3 normal = glm::normalize(glm::cross(aV2 - aV1, aV3 - aV1));
+		const float slopeCos = glm::dot(normal, { 0, 1, 0 });
+		const bool validTriangle = slopeCos >= maxSlopeCos;
+
+		if (mySettings.myDrawValidTriangleChecks)
+		{
+			const glm::vec3 center = (aV1 + aV2 + aV3) / 3.f;
+			const glm::vec3 color = validTriangle ? glm::vec3{ 0, 1, 0 } : glm::vec3{ 1, 0, 0 };
+			aTile.myDebugTriangles.push_back({ center, center + normal / 4.f, color });
+		}
+
+		if (validTriangle)
+		{
+			aTile.Insert(aV1, aV2, aV3);
+		}
+	};
+
+	// Input triangles get binned by tiles they overlap,
+	// so that every tile doesn't have to go through all of them
+	const std::span<const glm::vec3> triangles = myInput.myTriangles;
+	ASSERT_STR(triangles.size() % 3 == 0, "Triangles must have 3 vertices each!");
+	std::vector<uint32_t> tileSlots(myTiles.size(), kInvalidTile);
+	for (uint32_t i = 0; i < aTiles.size(); i++)
+	{
+		tileSlots[aTiles[i]->myIndex] = i;
+	}
+	std::vector<std::vector<uint32_t>> tileTriangles(aTiles.size());
+	for (uint32_t i = 0; i < triangles.size(); i += 3)
+	{
+		const glm::vec3 min = glm::min(triangles[i], glm::min(triangles[i + 1], triangles[i + 2]));
+		const glm::vec3 max = glm::max(triangles[i], glm::max(triangles[i + 1], triangles[i + 2]));
+		const auto [minTile, maxTile] = GetTileRange(min, max);
+		for (uint32_t y = minTile.y; y <= maxTile.y; y++)
+		{
+			for (uint32_t x = minTile.x; x <= maxTile.x; x++)
 			{
-				const Shapes::AABB modelAABB{
-					model->GetAABBMin(),
-					model->GetAABBMax()
-				};
-				const Shapes::AABB transfAABB = modelAABB.Transform(transf);
-				if (!Shapes::Intersects(transfAABB, { aTile.myAABBMin, tileMax }))
+				const uint32_t slot = tileSlots[y * myTileCount.x + x];
+				if (slot != kInvalidTile)
 				{
-					continue;
+					tileTriangles[slot].push_back(i);
 				}
 			}
+		}
+	}
+
+	auto ProcessForTile = [&](Tile& aTile, std::span<const uint32_t> aTriangles) {
+		Profiler::ScopedMark scope("NavMeshGen::VoxelizeTiles::ProcessTile");
 
+		const Shapes::AABB tileAABB{ aTile.myAABBMin, aTile.GetAABBMax() };
+		for (const ModelInstance& instance : aModels)
+		{
+			if (!Shapes::Intersects(instance.myAABB, tileAABB))
+			{
+				continue;
+			}
+
+			const Model* model = instance.myModel.Get();
 			if (mySettings.myDrawValidTriangleChecks)
 			{
 				aTile.myDebugTriangles.reserve(
@@ -496,148 +903,92 @@ void NavMeshGen::GatherTriangles(AssetTracker& anAssetTracker)
 					const glm::vec4 v2LS{ vertices[indices[i + 1]].myPos, 1.f };
 					const glm::vec4 v3LS{ vertices[indices[i + 2]].myPos, 1.f };
 
-					const glm::vec3 v1 = transfMat * v1LS;
-					const glm::vec3 v2 = transfMat * v2LS;
-					const glm::vec3 v3 = transfMat * v3LS;
-
-					// angle against horizontal plane
-					const glm::vec3 normal = glm::normalize(glm::cross(v2 - v1, v3 - v1));
-					const float slopeCos = glm::dot(normal, { 0, 1, 0 });
-					const bool validTriangle = slopeCos >= maxSlopeCos;
-
-					if (mySettings.myDrawValidTriangleChecks)
-					{
-						const glm::vec3 center = (v1 + v2 + v3) / 3.f;
-						const glm::vec3 color = validTriangle ? glm::vec3{ 0, 1, 0 } : glm::vec3{ 1, 0, 0 };
-						aTile.myDebugTriangles.push_back({ center, center + normal / 4.f, color });
-					}
-
-					if (!validTriangle)
-					{
-						continue;
-					}
-
-					aTile.Insert(v1, v2, v3);
+					const glm::vec3 v1 = instance.myTransform * v1LS;
+					const glm::vec3 v2 = instance.myTransform * v2LS;
+					const glm::vec3 v3 = instance.myTransform * v3LS;
+					InsertTriangle(aTile, v1, v2, v3);
 				}
 			}
 		}
 
+		for (uint32_t triangle : aTriangles)
+		{
+			InsertTriangle(aTile, triangles[triangle], triangles[triangle + 1], triangles[triangle + 2]);
+		}
+
 		aTile.MergeColumns();
+		aTile.FilterColumns(mySettings.myMinFreeHeight);
 	};
 
-	myInput.myWorld->Access([&](const std::vector<Handle<GameObject>>& aGOs) {
-		tbb::parallel_for(tbb::blocked_range<size_t>(0, myTiles.size()),
-			[&](tbb::blocked_range<size_t> aRange) 
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aTiles.size()),
+		[&](tbb::blocked_range<size_t> aRange) 
+	{
+		for (size_t i = aRange.begin(); i < aRange.end(); i++)
 		{
-			for (size_t i = aRange.begin(); i < aRange.end(); i++)
-			{
-				Tile& tile = myTiles[i];
-				ProcessForTile(tile, aGOs);
-			}
-		});
+			ProcessForTile(*aTiles[i], tileTriangles[i]);
+		}
 	});
 }
 
-void NavMeshGen::Region::GatherCornerVerts(const std::vector<SpanPos>& aSpans)
+void NavMeshGen::Region::GatherCornerVerts(const Tile& aTile, const std::vector<SpanPos>& aSpans)
 {
-	auto ConvertToWS = [](glm::vec3 anOrigin, glm::u32vec2 aPos, uint32_t aHeight, uint8_t aVert)
-	{
-		constexpr static glm::vec3 kOffsets[]{
-			{0, 0, kVoxelSize},
-			{kVoxelSize, 0, kVoxelSize},
-			{0, 0, 0},
-			{kVoxelSize, 0, 0}
-		};
-		const glm::vec3 spanOrigin = anOrigin + glm::vec3{
-			aPos.x * kVoxelSize,
-			aHeight * kVoxelHeight,
-			aPos.y * kVoxelSize
-		};
-		return spanOrigin + kOffsets[aVert];
+	// offsets of span's vertices in the voxel grid, see IsVertexCorner
+	constexpr static glm::u32vec2 kOffsets[]{
+		{0, 1},
+		{1, 1},
+		{0, 0},
+		{1, 0}
 	};
-
-	struct CornerVertHash 
+	auto ConvertToWS = [&aTile, this](glm::u32vec2 aVertPos)
 	{
-		std::size_t operator()(const CornerVert& aVert) const noexcept
-		{
-			// We only want to deduplicate corners in a region, so we can 
-			// ignore the height and the type of corner. Additionally, because 
-			// float innacuracies can creep in we protect against it by 
-			// preserving only the significant part
-			static_assert(kVoxelSize >= 0.01f && kVoxelSize < 0.1f, 
-				"Update multiplier bellow!");
-			const glm::u32vec2 pos{
-				static_cast<uint32_t>(glm::round(aVert.myPos.x * 100)),
-				static_cast<uint32_t>(glm::round(aVert.myPos.z * 100))
-			};
-			return std::hash<glm::u32vec2>{}(pos);
-		}
+		return aTile.myAABBMin + glm::vec3{
+			aVertPos.x * aTile.myVoxelSize,
+			myHeight * aTile.myVoxelHeight,
+			aVertPos.y * aTile.myVoxelSize
+		};
 	};
 
-	struct CornerVertEq
-	{
-		bool operator()(const CornerVert& aLeft, const CornerVert& aRight) const noexcept 
-		{
-			static_assert(kVoxelSize >= 0.01f && kVoxelSize < 0.1f,
-				"Update multiplier bellow!");
-			const glm::u32vec2 left{
-				static_cast<uint32_t>(glm::round(aLeft.myPos.x * 100)),
-				static_cast<uint32_t>(glm::round(aLeft.myPos.z * 100))
-			};
-			const glm::u32vec2 right{
-				static_cast<uint32_t>(glm::round(aRight.myPos.x * 100)),
-				static_cast<uint32_t>(glm::round(aRight.myPos.z * 100))
-			};
-			return left == right;
-		}
-	};
-	std::unordered_set<CornerVert, CornerVertHash, CornerVertEq> slashPoints;
+	// We only want to deduplicate corners in a region, so we can
+	// ignore the height and the type of corner. Deduplicating by
+	// grid position protects us from float innacuracies
+	std::unordered_set<glm::u32vec2> usedVerts;
 	for (const SpanPos& span : aSpans)
 	{
 		for (uint8_t i = 0; i < 4; i++)
 		{
-			if (IsVertexSlashPoint(i, span.mySpan->myNeighbors))
+			const bool isSlashPoint = IsVertexSlashPoint(i, span.mySpan->myNeighbors);
+			if (!isSlashPoint && !IsVertexCorner(i, span.mySpan->myNeighbors))
 			{
-				CornerVert vert{
-					ConvertToWS(myTileAABBMin, span.myPos, myHeight, i),
-					(i == 1 || i == 2) ? 2u : 1u
-				};
-				if (slashPoints.contains(vert))
-				{
-					continue;
-				}
-				slashPoints.insert(vert);
-				myCornerVerts.push_back(vert);
+				continue;
 			}
-			else if(IsVertexCorner(i, span.mySpan->myNeighbors))
+
+			const glm::u32vec2 vertPos = span.myPos + kOffsets[i];
+			if (!usedVerts.insert(vertPos).second)
 			{
-				CornerVert vert{
-					ConvertToWS(myTileAABBMin, span.myPos, myHeight, i),
-					0
-				};
-				if (slashPoints.contains(vert))
-				{
-					continue;
-				}
-				slashPoints.insert(vert);
-				myCornerVerts.push_back(vert);
+				continue;
 			}
+
+			CornerVert vert;
+			vert.myPos = ConvertToWS(vertPos);
+			vert.myType = !isSlashPoint ? 0
+				: (i == 1 || i == 2) ? 2 : 1;
+			myCornerVerts.push_back(vert);
 		}
 	}
 }
 
-void NavMeshGen::CornerVert::Draw(DebugDrawer& aDrawer) const
+void NavMeshGen::CornerVert::Draw(DebugDrawer& aDrawer, float aRadius) const
 {
 	const glm::vec3 color = myType == 0 ? glm::vec3{ 0, 1, 0 }
 		: myType == 2 ? glm::vec3{ 1, 0, 0 } : glm::vec3{ 0, 0, 1 };
 	aDrawer.AddSphere(
 		myPos,
-		kVoxelSize / 5.f,
+		aRadius,
 		color
 	);
 }
 
-void NavMeshGen::Region::Draw(DebugDrawer& aDrawer) const
+void NavMeshGen::Region::Draw(DebugDrawer& aDrawer, const Tile& aTile) const
 {
 	constexpr float kComp = 1.f;
 	constexpr glm::vec3 kColorTable[]{
@@ -652,29 +1003,46 @@ void NavMeshGen::Region::Draw(DebugDrawer& aDrawer) const
 		{ kComp, kComp, 0.75f }
 	};
 	const glm::vec3 color = kColorTable[myRegionId % std::size(kColorTable)];
+	const float voxelSize = aTile.myVoxelSize;
 	for (const SpanPos& span : mySpans)
 	{
-		const glm::vec3 p1 = myTileAABBMin + glm::vec3{
-			span.myPos.x * kVoxelSize, 
-			myHeight * kVoxelHeight, 
-			span.myPos.y * kVoxelSize
+		const glm::vec3 p1 = aTile.myAABBMin + glm::vec3{
+			span.myPos.x * voxelSize, 
+			myHeight * aTile.myVoxelHeight, 
+			span.myPos.y * voxelSize
 		};
-		const glm::vec3 p2 = p1 + glm::vec3{ kVoxelSize, 0, 0 };
-		const glm::vec3 p3 = p2 + glm::vec3{ 0, 0, kVoxelSize };
-		const glm::vec3 p4 = p1 + glm::vec3{ 0, 0, kVoxelSize };
+		const glm::vec3 p2 = p1 + glm::vec3{ voxelSize, 0, 0 };
+		const glm::vec3 p3 = p2 + glm::vec3{ 0, 0, voxelSize };
+		const glm::vec3 p4 = p1 + glm::vec3{ 0, 0, voxelSize };
 		aDrawer.AddRect(p1, p2, p3, p4, color);
 	}
 }
 
-void NavMeshGen::Region::DrawCornerPoints(DebugDrawer& aDrawer) const
+void NavMeshGen::Region::DrawCornerPoints(DebugDrawer& aDrawer, const Tile& aTile) const
 {
 	for (const CornerVert& vert : myCornerVerts)
 	{
-		vert.Draw(aDrawer);
+		vert.Draw(aDrawer, aTile.myVoxelSize / 5.f);
 	}
 }
 
 void NavMeshGen::SegmentTiles()
+{
+	const uint32_t maxRegionSize = GetMaxRegionSize();
+	tbb::parallel_for(size_t(0), myTiles.size(), [this, maxRegionSize](size_t anIndex)
+	{
+		myTiles[anIndex].Segment(maxRegionSize);
+	});
+
+	// We generated corner points per tile in isolation meaning
+	// tile-edge voxels are missing their neighbors in another tile.
+	// The paper tries to fix this with eliminating these "extra" corner
+	// points. But I think it's beneficial to have them, as they 
+	// create natural points of merging the tiles, see MergeTiles.
+	// So I'll skip this step for now and see how it goes.
+}
+
+void NavMeshGen::Tile::Segment(uint32_t aMaxRegionSize)
 {
 	constexpr static uint8_t kNeighborEncTable[]{
 		32, 64, 128,
@@ -682,22 +1050,28 @@ void NavMeshGen::SegmentTiles()
 		1, 2, 4
 	};
 
-	auto FindNeighbours = [](std::vector<glm::u32vec2>& aToCheck, Region& aRegion, 
+	auto FindNeighbours = [aMaxRegionSize](std::vector<glm::u32vec2>& aToCheck, Region& aRegion, 
 		std::vector<Region::SpanPos>& aCornerSpans, Tile& aTile) {
 		const glm::u32vec2 spanIndex = aToCheck.back();
 		aToCheck.pop_back();
 
+		// regions don't grow past their chunk, so chunk
+		// borders are treated same as tile borders
+		const glm::u32vec2 chunkMin = spanIndex / aMaxRegionSize * aMaxRegionSize;
 		const glm::i32vec2 neighborOrigin{
 			spanIndex.x - 1,
 			spanIndex.y - 1
 		};
 		const glm::u32vec2 min = glm::max(
 			neighborOrigin,
-			glm::i32vec2{ 0,0 }
+			glm::i32vec2(chunkMin)
 		);
 		const glm::u32vec2 max = glm::min(
 			glm::u32vec2{ spanIndex.x + 1, spanIndex.y + 1 }, 
-			glm::u32vec2{ aTile.mySize.x - 1, aTile.mySize.z - 1 }
+			glm::min(
+				chunkMin + aMaxRegionSize - 1u,
+				glm::u32vec2{ aTile.mySize.x - 1, aTile.mySize.z - 1 }
+			)
 		);
 		
 		uint8_t neighbors = 0;
@@ -772,59 +1146,50 @@ void NavMeshGen::SegmentTiles()
 		}
 	};
 
-	for (Tile& tile : myTiles)
-	{
-		Profiler::ScopedMark scope("NavMeshGen::SegmentTiles::Tile");
+	Profiler::ScopedMark scope("NavMeshGen::Tile::Segment");
 
-		uint16_t regionCounter = 0;
-		std::vector<glm::u32vec2> spansToCheck;
-		// assume 1 span per voxel column
-		spansToCheck.reserve(kVoxelsPerTile * kVoxelsPerTile);
+	uint16_t regionCounter = 0;
+	std::vector<glm::u32vec2> spansToCheck;
+	// assume 1 span per voxel column
+	spansToCheck.reserve(kVoxelsPerTile * kVoxelsPerTile);
 
-		std::vector<Region::SpanPos> cornerSpans;
-		cornerSpans.reserve(64); // arbitrary
-		for (uint32_t z = 0; z < tile.mySize.z; z++)
+	std::vector<Region::SpanPos> cornerSpans;
+	cornerSpans.reserve(64); // arbitrary
+	for (uint32_t z = 0; z < mySize.z; z++)
+	{
+		for (uint32_t x = 0; x < mySize.x; x++)
 		{
-			for (uint32_t x = 0; x < tile.mySize.x; x++)
+			VoxelColumn& column = myVoxelGrid[z * mySize.x + x];
+			for (VoxelSpan& span : column.mySpans)
 			{
-				VoxelColumn& column = tile.myVoxelGrid[z * tile.mySize.x + x];
-				for (VoxelSpan& span : column.mySpans)
+				if (span.myRegionId != VoxelSpan::kInvalidRegion)
 				{
-					if (span.myRegionId != VoxelSpan::kInvalidRegion)
-					{
-						continue;
-					}
-
-					span.myRegionId = ++regionCounter;
-					myRegions.push_back({ 
-						{},
-						{},
-						tile.myAABBMin, 
-						span.myMaxY, 
-						span.myRegionId 
-					});
-					Region& region = myRegions.back();
-					region.mySpans.push_back({ &span, { x, z } });
-
-					spansToCheck.push_back({ x, z });
-					while (!spansToCheck.empty())
-					{
-						FindNeighbours(spansToCheck, region, cornerSpans, tile);
-					}
+					continue;
+				}
 
-					region.GatherCornerVerts(cornerSpans);
-					cornerSpans.clear();
+				ASSERT_STR(regionCounter < std::numeric_limits<uint16_t>::max(),
+					"Ran out of region ids!");
+				span.myRegionId = ++regionCounter;
+				myRegions.push_back({ 
+					{},
+					{},
+					span.myMaxY, 
+					span.myRegionId 
+				});
+				Region& region = myRegions.back();
+				region.mySpans.push_back({ &span, { x, z } });
+
+				spansToCheck.push_back({ x, z });
+				while (!spansToCheck.empty())
+				{
+					FindNeighbours(spansToCheck, region, cornerSpans, *this);
 				}
+
+				region.GatherCornerVerts(*this, cornerSpans);
+				cornerSpans.clear();
 			}
 		}
 	}
-
-	// We generated corner points per tile in isolation meaning
-	// tile-edge voxels are missing their neighbors in another tile.
-	// The paper tries to fix this with eliminating these "extra" corner
-	// points. But I think it's beneficial to have them, as they 
-	// create natural points of merging the tiles in the future. 
-	// So I'll skip this step for now and see how it goes.
 }
 
 void NavMeshGen::Contour::Draw(DebugDrawer& aDrawer) const
@@ -840,7 +1205,15 @@ void NavMeshGen::Contour::Draw(DebugDrawer& aDrawer) const
 
 void NavMeshGen::ExtractContours()
 {
-	Profiler::ScopedMark scope("NavMeshGen::ExtractContours");
+	tbb::parallel_for(size_t(0), myTiles.size(), [this](size_t anIndex)
+	{
+		myTiles[anIndex].ExtractContours();
+	});
+}
+
+void NavMeshGen::Tile::ExtractContours()
+{
+	Profiler::ScopedMark scope("NavMeshGen::Tile::ExtractContours");
 
 	struct CornerPoint
 	{
@@ -857,10 +1230,11 @@ void NavMeshGen::ExtractContours()
 	};
 
 	std::vector<CornerPoint> cornerPoints;
+	// corners lie on voxel edges, so there's 1 more of them than voxels
 	std::vector<std::vector<CornerPoint*>> rows;
-	rows.resize(kVoxelsPerTile);
+	rows.resize(mySize.z + 1);
 	std::vector<std::vector<CornerPoint*>> columns;
-	columns.resize(kVoxelsPerTile);
+	columns.resize(mySize.x + 1);
 	std::unordered_map<CornerPoint*, CornerPoint*> neighboursHor;
 	std::unordered_map<CornerPoint*, CornerPoint*> neighboursVer;
 	for (const Region& region : myRegions)
@@ -882,8 +1256,8 @@ void NavMeshGen::ExtractContours()
 		for (const CornerVert& cornerVert : region.myCornerVerts)
 		{
 			const glm::u32vec2 gridPos{
-				glm::round((cornerVert.myPos.x - region.myTileAABBMin.x) / kVoxelSize),
-				glm::round((cornerVert.myPos.z - region.myTileAABBMin.z) / kVoxelSize)
+				glm::round((cornerVert.myPos.x - myAABBMin.x) / myVoxelSize),
+				glm::round((cornerVert.myPos.z - myAABBMin.z) / myVoxelSize)
 			};
 			if (cornerVert.myType != 0)
 			{
@@ -1040,4 +1414,285 @@ void NavMeshGen::ExtractContours()
 			start->myIsConnected = 1;
 		}
 	}
-}
\ No newline at end of file
+}
+void NavMeshGen::Tile::LinkColumns(glm::u32vec2 aColumn, const Tile& anOtherTile, glm::u32vec2 anOtherColumn,
+	bool anIsNextOnX, uint32_t aMaxStep, std::vector<PolyEdge>& anEdges) const
+{
+	const VoxelColumn& column = myVoxelGrid[aColumn.y * mySize.x + aColumn.x];
+	const VoxelColumn& otherColumn = anOtherTile.myVoxelGrid[anOtherColumn.y * anOtherTile.mySize.x + anOtherColumn.x];
+	if (column.mySpans.empty() || otherColumn.mySpans.empty())
+	{
+		return;
+	}
+
+	// the voxel edge between the columns, in this tile's voxel grid
+	const glm::u32vec2 edgeStart = anIsNextOnX ? aColumn + glm::u32vec2{ 1, 0 } : aColumn + glm::u32vec2{ 0, 1 };
+	const glm::u32vec2 edgeEnd = aColumn + glm::u32vec2{ 1, 1 };
+	// spans are sorted, so skipping ones too low and stopping at ones too high
+	for (const VoxelSpan& span : column.mySpans)
+	{
+		ASSERT(span.myRegionId != VoxelSpan::kInvalidRegion);
+		for (const VoxelSpan& otherSpan : otherColumn.mySpans)
+		{
+			if (otherSpan.myMaxY + aMaxStep < span.myMaxY)
+			{
+				continue;
+			}
+			else if (otherSpan.myMaxY > span.myMaxY + aMaxStep)
+			{
+				break;
+			}
+
+			const PolyRef poly{ myIndex, span.myRegionId - 1u };
+			const PolyRef otherPoly{ anOtherTile.myIndex, otherSpan.myRegionId - 1u };
+			if (poly == otherPoly)
+			{
+				continue;
+			}
+
+			// Crossing from aColumn into anOtherColumn, the edge's start is on
+			// the left when going along X, and on the right when going along Z.
+			// Crossing from the other column flips the sides
+			const float height = (span.myMaxY + otherSpan.myMaxY) * myVoxelHeight / 2.f;
+			const glm::vec3 start = myAABBMin + glm::vec3{ edgeStart.x * myVoxelSize, height, edgeStart.y * myVoxelSize };
+			const glm::vec3 end = myAABBMin + glm::vec3{ edgeEnd.x * myVoxelSize, height, edgeEnd.y * myVoxelSize };
+			const bool isStartLeft = anIsNextOnX == (poly < otherPoly);
+			anEdges.push_back({
+				std::min(poly, otherPoly),
+				std::max(poly, otherPoly),
+				isStartLeft ? start : end,
+				isStartLeft ? end : start
+			});
+		}
+	}
+}
+
+void NavMeshGen::Tile::LinkRegions(uint32_t aMaxStep)
+{
+	for (Region& region : myRegions)
+	{
+		glm::vec2 center{ 0 };
+		for (const Region::SpanPos& span : region.mySpans)
+		{
+			center += glm::vec2(span.myPos);
+		}
+		center = (center / static_cast<float>(region.mySpans.size()) + 0.5f) * myVoxelSize;
+		region.myCenter = myAABBMin + glm::vec3{ 
+			center.x, 
+			region.myHeight * myVoxelHeight, 
+			center.y 
+		};
+	}
+
+	std::vector<PolyEdge> edges;
+	for (uint32_t z = 0; z < mySize.z; z++)
+	{
+		for (uint32_t x = 0; x < mySize.x; x++)
+		{
+			if (x + 1 < mySize.x)
+			{
+				LinkColumns({ x, z }, *this, { x + 1, z }, true, aMaxStep, edges);
+			}
+			if (z + 1 < mySize.z)
+			{
+				LinkColumns({ x, z }, *this, { x, z + 1 }, false, aMaxStep, edges);
+			}
+		}
+	}
+	myPortals.clear();
+	ReduceToPortals(edges, myPortals);
+}
+
+void NavMeshGen::Tile::LinkBorders(const Tile* aNextOnX, const Tile* aNextOnZ, uint32_t aMaxStep,
+	std::vector<PolyEdge>& aPortals) const
+{
+	std::vector<PolyEdge> edges;
+	if (aNextOnX)
+	{
+		const uint32_t lastX = mySize.x - 1;
+		for (uint32_t z = 0; z < glm::min(mySize.z, aNextOnX->mySize.z); z++)
+		{
+			LinkColumns({ lastX, z }, *aNextOnX, { 0, z }, true, aMaxStep, edges);
+		}
+	}
+	if (aNextOnZ)
+	{
+		const uint32_t lastZ = mySize.z - 1;
+		for (uint32_t x = 0; x < glm::min(mySize.x, aNextOnZ->mySize.x); x++)
+		{
+			LinkColumns({ x, lastZ }, *aNextOnZ, { x, 0 }, false, aMaxStep, edges);
+		}
+	}
+	aPortals.clear();
+	ReduceToPortals(edges, aPortals);
+}
+
+void NavMeshGen::MergeTiles()
+{
+	Profiler::ScopedMark scope("NavMeshGen::MergeTiles");
+
+	// Tiles got segmented in isolation, so regions spreading over tile
+	// borders got split up. Instead of merging them back together, they
+	// get connected via the edges of voxels along the borders. Every tile
+	// handles its borders with the next tiles on X and Z, so every border
+	// gets processed once and tiles only write to their own portals
+	const uint32_t maxStep = GetMaxStep();
+	tbb::parallel_for(size_t(0), myTiles.size(), [&](size_t anIndex)
+	{
+		const uint32_t nextOnX = GetNextTile(static_cast<uint32_t>(anIndex), true);
+		const uint32_t nextOnZ = GetNextTile(static_cast<uint32_t>(anIndex), false);
+		Tile& tile = myTiles[anIndex];
+		tile.LinkBorders(
+			nextOnX != kInvalidTile ? &myTiles[nextOnX] : nullptr,
+			nextOnZ != kInvalidTile ? &myTiles[nextOnZ] : nullptr,
+			maxStep,
+			tile.myBorderPortals
+		);
+	});
+}
+
+void NavMeshGen::BuildNavGraph()
+{
+	Profiler::ScopedMark scope("NavMeshGen::BuildNavGraph");
+
+	const uint32_t maxStep = GetMaxStep();
+	tbb::parallel_for(size_t(0), myTiles.size(), [&](size_t anIndex)
+	{
+		myTiles[anIndex].LinkRegions(maxStep);
+	});
+
+	std::vector<const Tile*> tiles(myTiles.size());
+	std::vector<const std::vector<PolyEdge>*> borderPortals(myTiles.size());
+	for (size_t i = 0; i < myTiles.size(); i++)
+	{
+		tiles[i] = &myTiles[i];
+		borderPortals[i] = &myTiles[i].myBorderPortals;
+	}
+	std::vector<uint32_t> firstPolys;
+	AssembleNavGraph(tiles, borderPortals, firstPolys, myPolys, myLinks);
+	for (size_t i = 0; i < myTiles.size(); i++)
+	{
+		myTiles[i].myFirstPoly = firstPolys[i];
+	}
+}
+
+void NavMeshGen::ReduceToPortals(std::vector<PolyEdge>& anEdges, std::vector<PolyEdge>& aPortals)
+{
+	// edges of the same pair of polys need to be next to each other
+	std::sort(anEdges.begin(), anEdges.end(), 
+		[](const PolyEdge& aLeft, const PolyEdge& aRight)
+		{
+			return aLeft.myPolyA != aRight.myPolyA ? aLeft.myPolyA < aRight.myPolyA
+				: aLeft.myPolyB < aRight.myPolyB;
+		}
+	);
+
+	// A pair of polys can share a lot of voxel edges, but they get
+	// a single portal - from the first to the last shared edge along
+	// the axis that the shared edges are spread out the most on
+	for (size_t start = 0; start < anEdges.size();)
+	{
+		const PolyEdge& first = anEdges[start];
+		glm::vec3 minX = first.myStart;
+		glm::vec3 maxX = first.myStart;
+		glm::vec3 minZ = first.myStart;
+		glm::vec3 maxZ = first.myStart;
+		// shared edges can be crossed in different directions
+		// if the border curves, so the portal follows the majority
+		glm::vec3 leftToRight{ 0 };
+		size_t end = start;
+		for (; end < anEdges.size() 
+			&& anEdges[end].myPolyA == first.myPolyA 
+			&& anEdges[end].myPolyB == first.myPolyB; end++)
+		{
+			for (glm::vec3 point : { anEdges[end].myStart, anEdges[end].myEnd })
+			{
+				minX = point.x < minX.x ? point : minX;
+				maxX = point.x > maxX.x ? point : maxX;
+				minZ = point.z < minZ.z ? point : minZ;
+				maxZ = point.z > maxZ.z ? point : maxZ;
+			}
+			leftToRight += anEdges[end].myEnd - anEdges[end].myStart;
+		}
+
+		const bool alongX = maxX.x - minX.x >= maxZ.z - minZ.z;
+		const glm::vec3 portalMin = alongX ? minX : minZ;
+		const glm::vec3 portalMax = alongX ? maxX : maxZ;
+		const bool isMinLeft = glm::dot(portalMax - portalMin, leftToRight) >= 0;
+		aPortals.push_back({
+			first.myPolyA,
+			first.myPolyB,
+			isMinLeft ? portalMin : portalMax,
+			isMinLeft ? portalMax : portalMin
+		});
+		start = end;
+	}
+}
+
+void NavMeshGen::AssembleNavGraph(std::span<const Tile* const> aTiles,
+	std::span<const std::vector<PolyEdge>* const> aBorderPortals,
+	std::vector<uint32_t>& aFirstPolys, std::vector<NavPoly>& aPolys, std::vector<NavLink>& aLinks) const
+{
+	Profiler::ScopedMark scope("NavMeshGen::AssembleNavGraph");
+
+	// polys of every tile follow the previous tile's
+	aFirstPolys.resize(aTiles.size());
+	uint32_t polyCount = 0;
+	for (size_t i = 0; i < aTiles.size(); i++)
+	{
+		aFirstPolys[i] = polyCount;
+		polyCount += static_cast<uint32_t>(aTiles[i]->myRegions.size());
+	}
+	aPolys.clear();
+	aPolys.resize(polyCount, NavPoly{ {}, 0, 0 });
+	for (size_t i = 0; i < aTiles.size(); i++)
+	{
+		for (const Region& region : aTiles[i]->myRegions)
+		{
+			aPolys[aFirstPolys[i] + region.myRegionId - 1].myCenter = region.myCenter;
+		}
+	}
+
+	auto GetPoly = [&](PolyRef aRef)
+	{
+		return aFirstPolys[aRef.myTile] + aRef.myRegion;
+	};
+	auto ForEachPortal = [&](const auto& aFunc)
+	{
+		for (size_t i = 0; i < aTiles.size(); i++)
+		{
+			for (const PolyEdge& portal : aTiles[i]->myPortals)
+			{
+				aFunc(portal);
+			}
+			for (const PolyEdge& portal : *aBorderPortals[i])
+			{
+				aFunc(portal);
+			}
+		}
+	};
+
+	// links of a poly are laid out next to each other
+	ForEachPortal([&](const PolyEdge& aPortal)
+	{
+		aPolys[GetPoly(aPortal.myPolyA)].myLinkCount++;
+		aPolys[GetPoly(aPortal.myPolyB)].myLinkCount++;
+	});
+	uint32_t linkCount = 0;
+	for (NavPoly& poly : aPolys)
+	{
+		poly.myFirstLink = linkCount;
+		linkCount += poly.myLinkCount;
+		poly.myLinkCount = 0;
+	}
+	aLinks.resize(linkCount);
+	ForEachPortal([&](const PolyEdge& aPortal)
+	{
+		const uint32_t polyIndexA = GetPoly(aPortal.myPolyA);
+		const uint32_t polyIndexB = GetPoly(aPortal.myPolyB);
+		NavPoly& polyA = aPolys[polyIndexA];
+		aLinks[polyA.myFirstLink + polyA.myLinkCount++] = { polyIndexB, aPortal.myStart, aPortal.myEnd };
+		NavPoly& polyB = aPolys[polyIndexB];
+		aLinks[polyB.myFirstLink + polyB.myLinkCount++] = { polyIndexA, aPortal.myEnd, aPortal.myStart };
+	});
+}
@@ -1,23 +1,29 @@
 #pragma once
 
 class World;
-class Game;
 class AssetTracker;
 class DebugDrawer;
 
 // Based on "Robust and Scalable Navmesh Generation with multiple
-// levels and stairs support". Guillaume Saupin, Olivier Roussel 
+// levels and stairs support". Guillaume Saupin, Olivier Roussel
 // and Jeremie Le Garrec, 2013 paper
 class NavMeshGen
 {
-	constexpr static float kVoxelSize = 0.05f; // 5cm
-	constexpr static float kVoxelHeight = 0.01f; // 1cm
-	constexpr static uint32_t kVoxelsPerTile = 256; // 12.8m
+	constexpr static uint32_t kVoxelsPerTile = 256; // 12.8m with default voxels
+	constexpr static uint32_t kInvalidTile = std::numeric_limits<uint32_t>::max();
 public:
+	constexpr static uint32_t kInvalidPoly = std::numeric_limits<uint32_t>::max();
+
 	struct Settings
 	{
 		float myMaxSlope; // deg, how steep it is to be impassable
-		float myMinFreeHeight; // NYI, how much free space between floor and ceil is needed
+		float myMinFreeHeight; // how much free space between floor and ceil is needed
+		float myMaxStepHeight = 0.3f; // how high of a ledge can be stepped on
+		float myVoxelSize = 0.05f; // 5cm
+		float myVoxelHeight = 0.01f; // 1cm
+		// regions get split up into squares of this size, to keep the nav
+		// polys from getting long and winding, like along slopes
+		float myMaxRegionSize = 8.f;
 
 		// Debug
 		bool myDrawGenAABB = false;
@@ -26,22 +32,113 @@ public:
 		bool myDrawRegions = false;
 		bool myDrawCornerPoints = false;
 		bool myDrawContours = false;
+		bool myDrawNavGraph = false;
 	};
 
 	struct Input
 	{
+		// optional, models of its game objects get voxelized
 		World* myWorld;
 		glm::vec3 myMin;
 		glm::vec3 myMax;
+		// optional, world space triangles (3 vertices each)
+		// voxelized in addition to myWorld's models
+		std::span<const glm::vec3> myTriangles;
+	};
+
+	// Wall time spent in each stage of the last Generate call
+	struct Stats
+	{
+		enum Stage : uint8_t
+		{
+			CreateTiles,
+			Voxelize,
+			SegmentTiles,
+			ExtractContours,
+			MergeTiles,
+			BuildNavGraph,
+			Count
+		};
+		constexpr static std::string_view kStageNames[Stage::Count] = {
+			"CreateTiles",
+			"Voxelize",
+			"SegmentTiles",
+			"ExtractContours",
+			"MergeTiles",
+			"BuildNavGraph"
+		};
+
+		std::chrono::nanoseconds myStageTimes[Stage::Count]{};
+		size_t myTileCount = 0;
+		size_t mySpanCount = 0;
+		size_t myContourCount = 0;
+	};
+
+	// A walkable region of the navmesh, a node of the navigation graph
+	struct NavPoly
+	{
+		glm::vec3 myCenter;
+		// myLinks range of connections to neighbouring polys
+		uint32_t myFirstLink;
+		uint32_t myLinkCount;
+	};
+
+	struct NavLink
+	{
+		uint32_t myPoly; // the neighbour poly
+		// Portal - edge shared between the polys that has to be crossed
+		// to get from one to the other. When crossing it into myPoly,
+		// the start is on the left and the end is on the right
+		glm::vec3 myPortalStart;
+		glm::vec3 myPortalEnd;
 	};
 
 public:
-	void Generate(const Input& anInput, const Settings& aSettings, Game& aGame);
+	NavMeshGen();
+	// waits for a running rebuild to finish
+	~NavMeshGen();
+
+	// anAssetTracker is needed only if anInput has a World to gather models from
+	void Generate(const Input& anInput, const Settings& aSettings, AssetTracker* anAssetTracker);
 	void DebugDraw(DebugDrawer& aDrawer) const;
 
+	// Returns the poly of the span in the voxel column under aPos that's
+	// closest to it in height, or kInvalidPoly if the column is empty
+	// or that span isn't walkable
+	uint32_t FindPoly(glm::vec3 aPos) const;
+
+	std::span<const NavPoly> GetPolys() const { return myPolys; }
+	std::span<const NavLink> GetLinks(const NavPoly& aPoly) const
+	{
+		return { myLinks.data() + aPoly.myFirstLink, aPoly.myLinkCount };
+	}
+	const Stats& GetStats() const { return myStats; }
+
+	// Incremental rebuilds. There are no notifications of World changes,
+	// so whoever changes static geometry has to mark the area it covered
+	// before and after the change. Only tiles overlapping it on XZ get
+	// rebuilt, along with the portals over their borders
+
+	// Tiles marked while a rebuild is running wait for the next one
+	void MarkDirty(glm::vec3 aMin, glm::vec3 aMax);
+	bool HasDirtyTiles() const { return !myDirtyTiles.empty(); }
+	// Starts rebuilding dirty tiles in the background, returns false if
+	// there's nothing to rebuild or a rebuild is already running. Models
+	// of myWorld are gathered before it returns, so the World can change
+	// right after, but myTriangles mustn't until the rebuild is applied
+	bool StartRebuild(AssetTracker* anAssetTracker);
+	// Swaps in the rebuilt tiles and the new nav graph all at once, if the
+	// rebuild has finished. Returns true if it did, in which case poly
+	// indices from before are no longer valid
+	bool ApplyRebuild();
+	bool IsRebuilding() const { return myIsRebuilding; }
+	// tiles are squares of this size, except at the far edges of the input
+	float GetTileSize() const { return myTileSize; }
+
 private:
 	Settings mySettings;
 	Input myInput;
+	Stats myStats;
 
 
 	// Indexing is done as follows (top down)
@@ -72,41 +169,18 @@ private:
 		void AddBoth(uint32_t aHeight);
 
 		void Merge();
+		// removes spans without aMinFreeHeight voxels of space above them
+		void Filter(uint32_t aMinFreeHeight);
 	};
 
-	struct Tile
-	{
-		std::vector<VoxelColumn> myVoxelGrid;
-		glm::u32vec3 mySize; // in voxels
-		float myMinHeight;
-		glm::vec3 myAABBMin;
-		float myMaxHeight;
-
-		void Insert(glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3);
-		void MergeColumns();
-
-		// Debug
-		struct Line
-		{
-			glm::vec3 myStart;
-			glm::vec3 myEnd;
-			glm::vec3 myColor;
-		};
-		std::vector<Line> myDebugTriangles;
-		void DrawValidTriangleChecks(DebugDrawer& aDrawer) const;
-		void DrawVoxelSpans(DebugDrawer& aDrawer) const;
-	};
-	std::vector<Tile> myTiles;
-
-	void CreateTiles();
-	void GatherTriangles(AssetTracker& anAssetTracker);
+	struct Tile;
 
 	struct CornerVert
 	{
 		glm::vec3 myPos;
 		uint8_t myType : 2; // 0 - normal, 1 - antislash, 2 - slash
 
-		void Draw(DebugDrawer& aDrawer) const;
+		void Draw(DebugDrawer& aDrawer, float aRadius) const;
 	};
 
 	struct Region
@@ -118,18 +192,15 @@ private:
 		};
 		std::vector<SpanPos> mySpans;
 		std::vector<CornerVert> myCornerVerts;
-		glm::vec3 myTileAABBMin; // Note: only for debug drawing
 		uint32_t myHeight;
 		uint16_t myRegionId;
+		glm::vec3 myCenter; // of the NavPoly
 
-		void GatherCornerVerts(const std::vector<SpanPos>& aSpans);
+		void GatherCornerVerts(const Tile& aTile, const std::vector<SpanPos>& aSpans);
 
-		void Draw(DebugDrawer& aDrawer) const;
-		void DrawCornerPoints(DebugDrawer& aDrawer) const;
+		void Draw(DebugDrawer& aDrawer, const Tile& aTile) const;
+		void DrawCornerPoints(DebugDrawer& aDrawer, const Tile& aTile) const;
 	};
-	std::vector<Region> myRegions;
-
-	void SegmentTiles();
 
 	struct Contour
 	{
@@ -138,10 +209,147 @@ private:
 
 		void Draw(DebugDrawer& aDrawer) const;
 	};
-	std::vector<Contour> myContours;
 
-	void ExtractContours();
+	// Poly by its tile and region. Unlike an index into myPolys,
+	// it stays the same when other tiles get rebuilt
+	struct PolyRef
+	{
+		uint32_t myTile;
+		uint32_t myRegion; // region id - 1
+
+		auto operator<=>(const PolyRef&) const = default;
+	};
+
+	// Pair of polys sharing an edge of a voxel, myPolyA < myPolyB.
+	// myStart is on the left when crossing from myPolyA into myPolyB
+	struct PolyEdge
+	{
+		PolyRef myPolyA;
+		PolyRef myPolyB;
+		glm::vec3 myStart;
+		glm::vec3 myEnd;
+	};
+
+	struct Tile
+	{
+		std::vector<VoxelColumn> myVoxelGrid;
+		glm::u32vec3 mySize; // in voxels
+		float myMinHeight;
+		glm::vec3 myAABBMin;
+		float myMaxHeight;
+		float myVoxelSize;
+		float myVoxelHeight;
+
+		// regions are stored in the order of their ids, starting with 1
+		std::vector<Region> myRegions;
+		std::vector<Contour> myContours;
+		uint32_t myIndex;
+		// index of the first region's NavPoly
+		uint32_t myFirstPoly;
+		// portals between this tile's polys
+		std::vector<PolyEdge> myPortals;
+		// portals from this tile's polys to the ones of the next tiles on X
+		// and Z, so they have to be relinked when either tile gets rebuilt
+		std::vector<PolyEdge> myBorderPortals;
 
+		void Insert(glm::vec3 aV1, glm::vec3 aV2, glm::vec3 aV3);
+		void MergeColumns();
+		void FilterColumns(float aMinFreeHeight);
+		// regions get split into squares of up to aMaxRegionSize voxels
+		void Segment(uint32_t aMaxRegionSize);
+		void ExtractContours();
+		// Records edges between spans of aColumn and spans of anOtherColumn
+		// of anOtherTile within aMaxStep of them. anOtherColumn must be
+		// the next column on X or Z, counting over into the next tile
+		void LinkColumns(glm::u32vec2 aColumn, const Tile& anOtherTile, glm::u32vec2 anOtherColumn,
+			bool anIsNextOnX, uint32_t aMaxStep, std::vector<PolyEdge>& anEdges) const;
+		// Computes region centers and portals between this tile's regions
+		void LinkRegions(uint32_t aMaxStep);
+		// Fills in portals to the regions of the next tiles, if there are any
+		void LinkBorders(const Tile* aNextOnX, const Tile* aNextOnZ, uint32_t aMaxStep,
+			std::vector<PolyEdge>& aPortals) const;
+
+		glm::vec3 GetAABBMax() const
+		{
+			return myAABBMin + glm::vec3(mySize) * glm::vec3{ myVoxelSize, myVoxelHeight, myVoxelSize };
+		}
+
+		// Debug
+		struct Line
+		{
+			glm::vec3 myStart;
+			glm::vec3 myEnd;
+			glm::vec3 myColor;
+		};
+		std::vector<Line> myDebugTriangles;
+		void DrawValidTriangleChecks(DebugDrawer& aDrawer) const;
+		void DrawVoxelSpans(DebugDrawer& aDrawer) const;
+	};
+	std::vector<Tile> myTiles;
+	glm::u32vec2 myTileCount;
+	// world XZ of the tile grid's corner, tiles at the edges can be smaller
+	glm::vec2 myTileOrigin;
+	float myTileSize;
+
+	// Model of a World's game object, gathered up front so that tiles
+	// can be voxelized without accessing the World
+	struct ModelInstance;
+
+	void CreateTiles();
+	void InitTile(Tile& aTile, uint32_t anIndex) const;
+	// inclusive range of tiles overlapping aMin-aMax on XZ, clamped to the grid
+	std::pair<glm::u32vec2, glm::u32vec2> GetTileRange(glm::vec3 aMin, glm::vec3 aMax) const;
+	// index of the next tile on X or Z, kInvalidTile past the grid's edge
+	uint32_t GetNextTile(uint32_t anIndex, bool anIsOnX) const;
+	uint32_t GetMaxRegionSize() const;
+	uint32_t GetMaxStep() const;
+	std::vector<ModelInstance> GatherModels(AssetTracker* anAssetTracker, glm::vec3 aMin, glm::vec3 aMax) const;
+	// Voxelizes triangles and models overlapping the tiles, which
+	// can be ones outside of myTiles, taking their place
+	void VoxelizeTiles(std::span<Tile* const> aTiles, std::span<const ModelInstance> aModels) const;
+	void SegmentTiles();
+	void ExtractContours();
 	void MergeTiles();
 	void BuildNavGraph();
-};
\ No newline at end of file
+	// Merges edges of the same pair of polys into a single portal, anEdges get sorted
+	static void ReduceToPortals(std::vector<PolyEdge>& anEdges, std::vector<PolyEdge>& aPortals);
+	// Lays out polys and links of aTiles, whose border portals are aBorderPortals
+	void AssembleNavGraph(std::span<const Tile* const> aTiles,
+		std::span<const std::vector<PolyEdge>* const> aBorderPortals,
+		std::vector<uint32_t>& aFirstPolys, std::vector<NavPoly>& aPolys, std::vector<NavLink>& aLinks) const;
+
+	std::vector<NavPoly> myPolys;
+	std::vector<NavLink> myLinks;
+
+	// Incremental rebuilds
+	struct Rebuild
+	{
+		// sorted, along with their new versions
+		std::vector<uint32_t> myTileIndices;
+		std::vector<Tile> myTiles;
+		// tiles before the rebuilt ones on X or Z that weren't rebuilt
+		// themselves, their border portals point into rebuilt tiles
+		std::vector<uint32_t> myRelinkedIndices;
+		std::vector<std::vector<PolyEdge>> myRelinkedPortals;
+		std::vector<ModelInstance> myModels;
+		// for every tile, the new nav graph with the rebuilt tiles
+		std::vector<uint32_t> myFirstPolys;
+		std::vector<NavPoly> myPolys;
+		std::vector<NavLink> myLinks;
+	};
+
+	void RebuildTiles();
+	void WaitForRebuild();
+
+	std::vector<uint32_t> myDirtyTiles;
+	std::vector<uint8_t> myIsTileDirty;
+	Rebuild myRebuild;
+	// low priority to not get in the way of frames
+	tbb::task_arena myRebuildArena{
+		int(glm::max(std::thread::hardware_concurrency() / 2u, 1u)),
+		0,
+		tbb::task_arena::priority::low
+	};
+	std::atomic<bool> myIsRebuildDone = false;
+	bool myIsRebuilding = false;
+};
@@ -0,0 +1,328 @@
+#include "Precomp.h"
+#include "NavMeshPathfinder.h"
+
+#include <Core/Profiler.h>
+
+#include <bit>
+
+namespace
+{
+	// Twice the signed area of abc on XZ plane, positive
+	// if c is to the right of ab, Y being up
+	float TriArea2(glm::vec3 aA, glm::vec3 aB, glm::vec3 aC)
+	{
+		const glm::vec2 ab{ aB.x - aA.x, aB.z - aA.z };
+		const glm::vec2 ac{ aC.x - aA.x, aC.z - aA.z };
+		return ab.x * ac.y - ac.x * ab.y;
+	}
+
+	bool IsSamePoint(glm::vec3 aA, glm::vec3 aB)
+	{
+		constexpr float kEpsilon = 0.001f * 0.001f;
+		return glm::distance2(aA, aB) < kEpsilon;
+	}
+}
+
+NavMeshPathfinder::NavMeshPathfinder(const NavMeshGen& aNavMesh, uint32_t aCacheSize)
+	: myNavMesh(aNavMesh)
+	, myCache(std::bit_ceil(glm::max(aCacheSize, 1u)))
+{
+	OnNavMeshChanged();
+}
+
+void NavMeshPathfinder::OnNavMeshChanged()
+{
+	for (CacheEntry& entry : myCache)
+	{
+		entry.myStartPoly = NavMeshGen::kInvalidPoly;
+		entry.myEndPoly = NavMeshGen::kInvalidPoly;
+	}
+
+	// flood filling connected polys, links go both ways
+	const std::span<const NavMeshGen::NavPoly> polys = myNavMesh.GetPolys();
+	myComponents.assign(polys.size(), NavMeshGen::kInvalidPoly);
+	std::vector<uint32_t> toVisit;
+	uint32_t component = 0;
+	for (uint32_t start = 0; start < polys.size(); start++)
+	{
+		if (myComponents[start] != NavMeshGen::kInvalidPoly)
+		{
+			continue;
+		}
+
+		myComponents[start] = component;
+		toVisit.push_back(start);
+		while (!toVisit.empty())
+		{
+			const uint32_t poly = toVisit.back();
+			toVisit.pop_back();
+			for (const NavMeshGen::NavLink& link : myNavMesh.GetLinks(polys[poly]))
+			{
+				if (myComponents[link.myPoly] == NavMeshGen::kInvalidPoly)
+				{
+					myComponents[link.myPoly] = component;
+					toVisit.push_back(link.myPoly);
+				}
+			}
+		}
+		component++;
+	}
+}
+
+void NavMeshPathfinder::FindPaths(std::span<const Request> aRequests, std::vector<Path>& aPaths)
+{
+	Profiler::ScopedMark scope("NavMeshPathfinder::FindPaths");
+
+	aPaths.resize(aRequests.size());
+	myOutcomes.resize(aRequests.size());
+	// cache is only read from in parallel, new corridors
+	// get stored once all of the requests are done
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, aRequests.size()),
+		[&](const tbb::blocked_range<size_t>& aRange)
+		{
+			// search ids of nodes stay valid on navmesh changes,
+			// so the nodes only have to match the poly count
+			SearchContext& context = mySearchContexts.local();
+			if (context.myNodes.size() != myComponents.size())
+			{
+				context.myNodes.resize(myComponents.size(), SearchNode{});
+				context.myOpen.reserve(myComponents.size());
+			}
+			for (size_t i = aRange.begin(); i < aRange.end(); i++)
+			{
+				myOutcomes[i] = FindPath(context, aRequests[i], aPaths[i]);
+			}
+		}
+	);
+
+	myStats = {};
+	for (size_t i = 0; i < aRequests.size(); i++)
+	{
+		switch (myOutcomes[i])
+		{
+		case Outcome::CacheHit:
+			myStats.myCacheHits++;
+			break;
+		case Outcome::Searched:
+		{
+			myStats.mySearches++;
+			const std::vector<uint32_t>& polys = aPaths[i].myPolys;
+			CacheEntry& entry = myCache[GetCacheIndex(polys.front(), polys.back())];
+			entry.myStartPoly = polys.front();
+			entry.myEndPoly = polys.back();
+			entry.myPolys = polys;
+			break;
+		}
+		case Outcome::Failed:
+			myStats.myFailed++;
+			break;
+		}
+	}
+}
+
+NavMeshPathfinder::Outcome NavMeshPathfinder::FindPath(SearchContext& aContext,
+	const Request& aRequest, Path& aPath) const
+{
+	aPath.myPolys.clear();
+	aPath.myPoints.clear();
+
+	const uint32_t startPoly = myNavMesh.FindPoly(aRequest.myStart);
+	const uint32_t endPoly = myNavMesh.FindPoly(aRequest.myEnd);
+	if (startPoly == NavMeshGen::kInvalidPoly || endPoly == NavMeshGen::kInvalidPoly
+		|| myComponents[startPoly] != myComponents[endPoly])
+	{
+		return Outcome::Failed;
+	}
+
+	Outcome outcome;
+	const CacheEntry& entry = myCache[GetCacheIndex(startPoly, endPoly)];
+	if (entry.myStartPoly == startPoly && entry.myEndPoly == endPoly)
+	{
+		aPath.myPolys.assign(entry.myPolys.begin(), entry.myPolys.end());
+		outcome = Outcome::CacheHit;
+	}
+	else if (Search(aContext, aRequest, startPoly, endPoly, aPath.myPolys))
+	{
+		outcome = Outcome::Searched;
+	}
+	else
+	{
+		return Outcome::Failed;
+	}
+
+	StringPull(aContext, aRequest, aPath);
+	return outcome;
+}
+
+bool NavMeshPathfinder::Search(SearchContext& aContext, const Request& aRequest, uint32_t aStartPoly,
+	uint32_t anEndPoly, std::vector<uint32_t>& aPolys) const
+{
+	// instead of clearing all nodes, nodes from previous searches are
+	// treated as unvisited, until the id wraps around
+	aContext.mySearchId++;
+	if (aContext.mySearchId == 0)
+	{
+		for (SearchNode& node : aContext.myNodes)
+		{
+			node.mySearchId = 0;
+		}
+		aContext.mySearchId = 1;
+	}
+	const uint32_t searchId = aContext.mySearchId;
+	std::vector<SearchNode>& nodes = aContext.myNodes;
+	std::vector<OpenEntry>& open = aContext.myOpen;
+
+	// Polys aren't convex and can be long and thin, so their centers can
+	// be far away from where they get walked through. Instead the costs
+	// are measured between the middles of portals the polys are entered at
+	const std::span<const NavMeshGen::NavPoly> polys = myNavMesh.GetPolys();
+	const glm::vec3 endPos = aRequest.myEnd;
+	// std heap functions keep the greatest on top
+	constexpr auto IsWorse = [](const OpenEntry& aLeft, const OpenEntry& aRight)
+	{
+		return aLeft.myEstimate > aRight.myEstimate;
+	};
+
+	nodes[aStartPoly] = { aRequest.myStart, 0.f, NavMeshGen::kInvalidPoly, searchId, false };
+	open.clear();
+	open.push_back({ glm::distance(aRequest.myStart, endPos), aStartPoly });
+	while (!open.empty())
+	{
+		std::pop_heap(open.begin(), open.end(), IsWorse);
+		const uint32_t current = open.back().myPoly;
+		open.pop_back();
+
+		// polys get pushed again on finding a cheaper way to
+		// them, so older entries get skipped
+		SearchNode& currentNode = nodes[current];
+		if (currentNode.myIsClosed)
+		{
+			continue;
+		}
+		currentNode.myIsClosed = true;
+
+		if (current == anEndPoly)
+		{
+			for (uint32_t poly = anEndPoly; poly != NavMeshGen::kInvalidPoly; poly = nodes[poly].myParent)
+			{
+				aPolys.push_back(poly);
+			}
+			std::reverse(aPolys.begin(), aPolys.end());
+			return true;
+		}
+
+		for (const NavMeshGen::NavLink& link : myNavMesh.GetLinks(polys[current]))
+		{
+			SearchNode& node = nodes[link.myPoly];
+			if (node.mySearchId != searchId)
+			{
+				node.mySearchId = searchId;
+				node.myCost = std::numeric_limits<float>::max();
+				node.myIsClosed = false;
+			}
+
+			const glm::vec3 pos = (link.myPortalStart + link.myPortalEnd) / 2.f;
+			float cost = currentNode.myCost + glm::distance(currentNode.myPos, pos);
+			float heuristic = glm::distance(pos, endPos);
+			if (link.myPoly == anEndPoly)
+			{
+				// to not pick an end portal that's far away from the end,
+				// the last leg is part of the cost, so there's nothing left to estimate
+				cost += heuristic;
+				heuristic = 0.f;
+			}
+			if (node.myIsClosed || cost >= node.myCost)
+			{
+				continue;
+			}
+			node.myPos = pos;
+			node.myCost = cost;
+			node.myParent = current;
+			open.push_back({ cost + heuristic, link.myPoly });
+			std::push_heap(open.begin(), open.end(), IsWorse);
+		}
+	}
+	return false;
+}
+
+void NavMeshPathfinder::StringPull(SearchContext& aContext, const Request& aRequest, Path& aPath) const
+{
+	const std::span<const NavMeshGen::NavPoly> polys = myNavMesh.GetPolys();
+	std::vector<Portal>& portals = aContext.myPortals;
+	portals.clear();
+	portals.push_back({ aRequest.myStart, aRequest.myStart });
+	for (size_t i = 0; i + 1 < aPath.myPolys.size(); i++)
+	{
+		const std::span<const NavMeshGen::NavLink> links = myNavMesh.GetLinks(polys[aPath.myPolys[i]]);
+		const auto linkIter = std::ranges::find(links, aPath.myPolys[i + 1], &NavMeshGen::NavLink::myPoly);
+		ASSERT(linkIter != links.end());
+		portals.push_back({ linkIter->myPortalStart, linkIter->myPortalEnd });
+	}
+	portals.push_back({ aRequest.myEnd, aRequest.myEnd });
+
+	// "Simple Stupid Funnel Algorithm", Mikko Mononen, 2010.
+	// Narrows down the funnel from the apex with every portal, and once a
+	// side crosses over the other one, the other side becomes a new apex
+	std::vector<glm::vec3>& points = aPath.myPoints;
+	points.push_back(aRequest.myStart);
+	glm::vec3 apex = aRequest.myStart;
+	glm::vec3 left = aRequest.myStart;
+	glm::vec3 right = aRequest.myStart;
+	size_t apexIndex = 0;
+	size_t leftIndex = 0;
+	size_t rightIndex = 0;
+	for (size_t i = 1; i < portals.size(); i++)
+	{
+		const Portal& portal = portals[i];
+		if (TriArea2(apex, right, portal.myRight) <= 0)
+		{
+			if (IsSamePoint(apex, right) || TriArea2(apex, left, portal.myRight) > 0)
+			{
+				right = portal.myRight;
+				rightIndex = i;
+			}
+			else
+			{
+				apex = left;
+				apexIndex = leftIndex;
+				points.push_back(apex);
+				right = apex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+
+		if (TriArea2(apex, left, portal.myLeft) >= 0)
+		{
+			if (IsSamePoint(apex, left) || TriArea2(apex, right, portal.myLeft) < 0)
+			{
+				left = portal.myLeft;
+				leftIndex = i;
+			}
+			else
+			{
+				apex = right;
+				apexIndex = rightIndex;
+				points.push_back(apex);
+				left = apex;
+				leftIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+
+	if (!IsSamePoint(points.back(), aRequest.myEnd))
+	{
+		points.push_back(aRequest.myEnd);
+	}
+}
+
+uint32_t NavMeshPathfinder::GetCacheIndex(uint32_t aStartPoly, uint32_t anEndPoly) const
+{
+	// Fibonacci hashing, top bits of the product are the best mixed
+	const uint64_t key = (static_cast<uint64_t>(aStartPoly) << 32) | anEndPoly;
+	const uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+	return static_cast<uint32_t>(hash >> 32) & static_cast<uint32_t>(myCache.size() - 1);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "NavMeshGen.h"
+
+// Answers batches of path requests over NavMeshGen's nav graph. Requests
+// get processed in parallel, each running A* over the polys and then
+// string-pulling the found corridor of polys through the portals between
+// them. Corridors get cached by their start and end polys, so repeated
+// requests between the same places only pay for the string-pulling.
+// Polys aren't convex, so paths can cut corners within a poly
+class NavMeshPathfinder
+{
+public:
+	struct Request
+	{
+		glm::vec3 myStart;
+		glm::vec3 myEnd;
+	};
+
+	struct Path
+	{
+		// corridor of polys, from the start's poly to the end's
+		std::vector<uint32_t> myPolys;
+		// from start to end, empty if there's no path
+		std::vector<glm::vec3> myPoints;
+	};
+
+	// Of the last FindPaths call
+	struct Stats
+	{
+		size_t myCacheHits = 0;
+		size_t mySearches = 0;
+		// requests without a path, either off the navmesh or unreachable
+		size_t myFailed = 0;
+	};
+
+	// aCacheSize gets rounded up to a power of 2
+	NavMeshPathfinder(const NavMeshGen& aNavMesh, uint32_t aCacheSize = 1 << 12);
+
+	// Has to be called after the navmesh got regenerated, or after
+	// NavMeshGen::ApplyRebuild swapped in rebuilt tiles
+	void OnNavMeshChanged();
+
+	// Fills in paths for all of aRequests, aPaths gets resized to match them.
+	// Reusing aPaths between calls avoids reallocating the paths
+	void FindPaths(std::span<const Request> aRequests, std::vector<Path>& aPaths);
+
+	const Stats& GetStats() const { return myStats; }
+
+private:
+	enum class Outcome : uint8_t
+	{
+		CacheHit,
+		Searched,
+		Failed
+	};
+
+	struct SearchNode
+	{
+		// where the poly was entered at - at the middle of the portal
+		glm::vec3 myPos;
+		float myCost;
+		uint32_t myParent;
+		// node is only valid during the search with this id
+		uint32_t mySearchId;
+		bool myIsClosed;
+	};
+
+	struct OpenEntry
+	{
+		float myEstimate; // cost so far + heuristic to the end
+		uint32_t myPoly;
+	};
+
+	struct Portal
+	{
+		glm::vec3 myLeft;
+		glm::vec3 myRight;
+	};
+
+	// Preallocated per thread, so searches don't allocate
+	struct SearchContext
+	{
+		std::vector<SearchNode> myNodes; // for every poly
+		std::vector<OpenEntry> myOpen; // binary heap
+		std::vector<Portal> myPortals;
+		uint32_t mySearchId = 0;
+	};
+
+	struct CacheEntry
+	{
+		uint32_t myStartPoly = NavMeshGen::kInvalidPoly;
+		uint32_t myEndPoly = NavMeshGen::kInvalidPoly;
+		std::vector<uint32_t> myPolys;
+	};
+
+	Outcome FindPath(SearchContext& aContext, const Request& aRequest, Path& aPath) const;
+	bool Search(SearchContext& aContext, const Request& aRequest, uint32_t aStartPoly,
+		uint32_t anEndPoly, std::vector<uint32_t>& aPolys) const;
+	void StringPull(SearchContext& aContext, const Request& aRequest, Path& aPath) const;
+	uint32_t GetCacheIndex(uint32_t aStartPoly, uint32_t anEndPoly) const;
+
+	const NavMeshGen& myNavMesh;
+	tbb::enumerable_thread_specific<SearchContext> mySearchContexts;
+	// direct mapped, newer corridors replace older ones
+	std::vector<CacheEntry> myCache;
+	// requests between polys in different components are rejected
+	// without searching the whole component of the start poly
+	std::vector<uint32_t> myComponents;
+	std::vector<Outcome> myOutcomes;
+	Stats myStats;
+};
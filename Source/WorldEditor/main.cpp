@@ -1,6 +1,7 @@
 #include "Precomp.h"
 
 #include "EditorMode.h"
+#include "NavMeshBench.h"
 
 #include <Engine/Game.h>
 
@@ -9,8 +10,19 @@ void glfwErrorReporter(int code, const char* desc)
 	std::println("GLFW error({}): {}", code, desc);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
+	const std::span<char* const> args(argv + 1, static_cast<size_t>(argc - 1));
+	if (NavMeshBench::IsRequested(args))
+	{
+		NavMeshBench::Settings settings;
+		if (!NavMeshBench::ParseArgs(args, settings))
+		{
+			return 1;
+		}
+		return NavMeshBench(settings).Run();
+	}
+
 	// TODO: get rid of this and all rand() calls
 	srand(static_cast<uint32_t>(time(0)));
 